@@ -0,0 +1,34 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <compiler/generation/writeFileToDataPack.h>
+#include <TempDirectory.h>
+
+static void BM_writeFileToDataPack(benchmark::State& state) {
+  const TempDirectory dir("mcfunc_bench_writeFileToDataPack");
+  const auto fileCount = static_cast<size_t>(state.range(0));
+  const std::string contents(static_cast<size_t>(state.range(1)), 'x');
+
+  // the files are spread across directories like function files are
+  std::vector<std::filesystem::path> outputPaths;
+  for (size_t i = 0; i < fileCount; i++) {
+    outputPaths.push_back(std::filesystem::path("bench") / "function" /
+                          ("dir_" + std::to_string(i % 16)) /
+                          ("f_" + std::to_string(i) + ".mcfunction"));
+  }
+
+  for (auto _ : state) {
+    for (const std::filesystem::path& outputPath : outputPaths)
+      writeFileToDataPack(dir.path(), outputPath, contents);
+  }
+
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(fileCount * contents.size()));
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(fileCount));
+}
+BENCHMARK(BM_writeFileToDataPack)
+    ->ArgsProduct({{64, 1024}, {64, 16384}})
+    ->ArgNames({"files", "bytes"})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <compiler/CompileOptions.h>
+#include <compiler/SourceFiles.h>
+#include <compiler/linking/link.h>
+#include <generateProject.h>
+#include <TempDirectory.h>
+
+static void BM_link(benchmark::State& state) {
+  // a whole project so that imports and file writes are linked too
+  const TempDirectory dir("mcfunc_bench_link");
+  ProjectShape shape;
+  shape.fileCount = static_cast<size_t>(state.range(0));
+  shape.functionsPerFile = static_cast<size_t>(state.range(1));
+  shape.copyWritesPerFile = 1;
+  const std::vector<GeneratedFile> project = generateProject(shape);
+  writeProject(project, dir.path());
+
+  SourceFiles sourceFiles;
+  std::vector<FileWriteSourceFile> fileWriteSourceFiles;
+  for (const GeneratedFile& file : project) {
+    if (file.path.extension() == ".mcfunc")
+      sourceFiles.emplace_back(dir.path() / file.path, dir.path());
+    else
+      fileWriteSourceFiles.emplace_back(dir.path() / file.path, dir.path());
+  }
+
+  const CompileOptions compileOptions;
+  const std::vector<CompiledSourceFile> compiledSourceFiles =
+      sourceFiles.evaluateAll(compileOptions);
+
+  size_t outputFileCount = 0;
+  for (auto _ : state) {
+    const LinkResult linkResult =
+        link(compiledSourceFiles, sourceFiles, fileWriteSourceFiles, compileOptions);
+    outputFileCount = linkResult.fileWriteMap.size() + linkResult.fileCopyMap.size();
+  }
+
+  state.counters["outputFiles"] = benchmark::Counter(
+      static_cast<double>(outputFileCount), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_link)
+    ->ArgsProduct({{1, 16, 256}, {16, 256}})
+    ->ArgNames({"files", "functions"})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_unlinkedTextToText(benchmark::State& state) {
+  const TempDirectory dir("mcfunc_bench_unlinkedTextToText");
+  ProjectShape shape;
+  shape.fileCount = 1;
+  shape.importsPerFile = 0;
+  shape.functionsPerFile = static_cast<size_t>(state.range(0));
+  shape.commandsPerFunction = static_cast<size_t>(state.range(1));
+  const std::vector<GeneratedFile> project = generateProject(shape);
+  writeProject(project, dir.path());
+  SourceFiles sourceFiles;
+  sourceFiles.emplace_back(dir.path() / project.front().path, dir.path());
+  const std::vector<CompiledSourceFile> compiledSourceFiles =
+      sourceFiles.evaluateAll(CompileOptions());
+
+  // every function call is linked to a made up name
+  std::vector<const UnlinkedText*> unlinkedTexts;
+  std::unordered_map<std::string, std::string> funcCallStrings;
+  for (const auto& [_, funcFileWrite] : compiledSourceFiles[0].unlinkedFileWrites()) {
+    unlinkedTexts.push_back(&funcFileWrite.unlinkedText);
+    for (const UnlinkedTextSection& section : funcFileWrite.unlinkedText.sections()) {
+      if (section.kind() == UnlinkedTextSection::Kind::FUNCTION)
+        funcCallStrings[section.funcName()] = "zzz__.bench:" + section.funcName();
+    }
+  }
+
+  int64_t bytesPerIteration = 0;
+  for (auto _ : state) {
+    bytesPerIteration = 0;
+    for (const UnlinkedText* unlinkedText : unlinkedTexts) {
+      const std::string text = unlinkedTextToText(*unlinkedText, "bench", funcCallStrings);
+      bytesPerIteration += static_cast<int64_t>(text.size());
+    }
+  }
+
+  state.SetBytesProcessed(state.iterations() * bytesPerIteration);
+}
+BENCHMARK(BM_unlinkedTextToText)
+    ->ArgsProduct({{16, 1024}, {1, 64}})
+    ->ArgNames({"functions", "commands"})
+    ->Unit(benchmark::kMicrosecond);
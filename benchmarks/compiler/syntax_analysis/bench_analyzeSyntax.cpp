@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include <compiler/SourceFiles.h>
+#include <generateProject.h>
+#include <TempDirectory.h>
+
+static void BM_analyzeSyntax(benchmark::State& state) {
+  const TempDirectory dir("mcfunc_bench_analyzeSyntax");
+  ProjectShape shape;
+  shape.fileCount = 1;
+  shape.importsPerFile = 0;
+  shape.functionsPerFile = static_cast<size_t>(state.range(0));
+  shape.maxScopeDepth = static_cast<size_t>(state.range(1));
+  const std::vector<GeneratedFile> project = generateProject(shape);
+  writeProject(project, dir.path());
+  SourceFiles sourceFiles;
+  sourceFiles.emplace_back(dir.path() / project.front().path, dir.path());
+  size_t tokenCount = 0;
+
+  for (auto _ : state) {
+    // a source file can only be analyzed once
+    state.PauseTiming();
+    sourceFiles[0].clearEvaluation();
+    sourceFiles[0].tokenize();
+    tokenCount = sourceFiles[0].tokens().size();
+    state.ResumeTiming();
+
+    sourceFiles[0].analyzeSyntax(sourceFiles);
+  }
+
+  state.counters["tokens"] = benchmark::Counter(static_cast<double>(tokenCount),
+                                                benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_analyzeSyntax)
+    ->ArgsProduct({{16, 256, 4096}, {0, 4}})
+    ->ArgNames({"functions", "maxDepth"})
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include <compiler/SourceFiles.h>
+#include <compiler/vfs.h>
+#include <generateProject.h>
+
+static void BM_tokenize(benchmark::State& state) {
+  ProjectShape shape;
+  shape.fileCount = 1;
+  shape.importsPerFile = 0;
+  shape.functionsPerFile = static_cast<size_t>(state.range(0));
+  shape.maxScopeDepth = static_cast<size_t>(state.range(1));
+  const std::vector<GeneratedFile> project = generateProject(shape);
+
+  // the file is read on every iteration, so it's kept in memory (so the disk
+  // isn't timed too)
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::filesystem::path path = mount.path() / project.front().path;
+  if (!files->createDirectories(path.parent_path()) ||
+      !files->writeFile(path, project.front().contents)) {
+    state.SkipWithError("Failed to write the source file.");
+    return;
+  }
+  SourceFiles sourceFiles;
+  sourceFiles.emplace_back(path, mount.path());
+
+  for (auto _ : state) {
+    sourceFiles[0].tokenize();
+    benchmark::DoNotOptimize(sourceFiles[0].tokens().data());
+  }
+
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(project.front().contents.size()));
+  state.counters["tokens"] =
+      benchmark::Counter(static_cast<double>(sourceFiles[0].tokens().size()),
+                         benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_tokenize)
+    ->ArgsProduct({{16, 256, 4096}, {0, 4}})
+    ->ArgNames({"functions", "maxDepth"})
+    ->Unit(benchmark::kMicrosecond);
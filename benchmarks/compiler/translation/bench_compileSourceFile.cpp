@@ -0,0 +1,37 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include <compiler/CompileOptions.h>
+#include <compiler/SourceFiles.h>
+#include <compiler/translation/compileSourceFile.h>
+#include <generateProject.h>
+#include <TempDirectory.h>
+
+static void BM_compileSourceFile(benchmark::State& state) {
+  const TempDirectory dir("mcfunc_bench_compileSourceFile");
+  ProjectShape shape;
+  shape.fileCount = 1;
+  shape.importsPerFile = 0;
+  shape.functionsPerFile = static_cast<size_t>(state.range(0));
+  shape.maxScopeDepth = static_cast<size_t>(state.range(1));
+  const std::vector<GeneratedFile> project = generateProject(shape);
+  writeProject(project, dir.path());
+  SourceFiles sourceFiles;
+  sourceFiles.emplace_back(dir.path() / project.front().path, dir.path());
+  sourceFiles[0].tokenize();
+  sourceFiles[0].analyzeSyntax(sourceFiles);
+
+  CompileOptions compileOptions;
+  compileOptions.inlineTrivialScopes = state.range(2) != 0;
+
+  for (auto _ : state)
+    benchmark::DoNotOptimize(compileSourceFile(sourceFiles[0], compileOptions));
+
+  state.counters["functions"] = benchmark::Counter(static_cast<double>(shape.functionsPerFile),
+                                                   benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_compileSourceFile)
+    ->ArgsProduct({{16, 256, 4096}, {0, 4}, {0, 1}})
+    ->ArgNames({"functions", "maxDepth", "inline"})
+    ->Unit(benchmark::kMicrosecond);
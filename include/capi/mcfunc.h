@@ -0,0 +1,159 @@
+#pragma once
+/// \file The C API for embedding the MCFunc compiler (link with the 'libmcfunc'
+/// library). A project's files are given to the compiler from memory and the
+/// compiled data pack is handed back in memory, so nothing is read from or
+/// written to the disk.
+///
+/// Example:
+///   mcfunc_project* project = mcfunc_project_create();
+///   mcfunc_project_add_file(project, "main.mcfunc", source, sourceSize);
+///   mcfunc_result* result = mcfunc_compile(project);
+///   for (size_t i = 0; i < mcfunc_result_output_count(result); i++) {
+///     mcfunc_output output;
+///     mcfunc_result_output(result, i, &output);
+///     ...
+///   }
+///   mcfunc_result_destroy(result);
+///   mcfunc_project_destroy(project);
+///
+/// Nothing in this API throws. Separate projects can be used on separate
+/// threads at the same time, but a project (and the results compiled from it)
+/// must only be used by 1 thread at a time.
+
+#include <stddef.h>
+
+/// Marks the functions the shared library exports (everything else in the
+/// library is hidden). \p MCFUNC_STATIC is defined when the library is static.
+#if defined(MCFUNC_STATIC)
+#define MCFUNC_API
+#elif defined(_WIN32) && defined(MCFUNC_BUILDING_LIBRARY)
+#define MCFUNC_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define MCFUNC_API __declspec(dllimport)
+#else
+#define MCFUNC_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Changes whenever this API changes in a way that isn't backwards compatible.
+#define MCFUNC_API_VERSION 1
+
+/// What every function that can fail returns.
+typedef enum mcfunc_status {
+  MCFUNC_OK = 0,
+  /// A null handle, an index that's out of range, a bad file path, etc.
+  MCFUNC_INVALID_ARGUMENT = 1,
+  /// Memory couldn't be allocated (or something else unexpected happened).
+  MCFUNC_INTERNAL_ERROR = 2,
+} mcfunc_status;
+
+/// Options that change how a project is compiled (see the matching command
+/// line flags). Every option is off (0) by default.
+typedef enum mcfunc_option {
+  /// '--inline-scopes' (0 or 1).
+  MCFUNC_OPTION_INLINE_TRIVIAL_SCOPES = 0,
+  /// '--dedup-functions' (0 or 1).
+  MCFUNC_OPTION_DEDUPLICATE_FUNCTIONS = 1,
+  /// '--factor-execute' (0 or 1).
+  MCFUNC_OPTION_FACTOR_EXECUTE_PREFIXES = 2,
+  /// '--max-tick-commands' (0 means there's no limit).
+  MCFUNC_OPTION_MAX_TICK_COMMANDS = 3,
+  /// '--instrument' (0 or 1).
+  MCFUNC_OPTION_INSTRUMENT = 4,
+} mcfunc_option;
+
+/// A project's files and options.
+typedef struct mcfunc_project mcfunc_project;
+
+/// What compiling a project produced (diagnostics and output files).
+typedef struct mcfunc_result mcfunc_result;
+
+/// A problem found while compiling. The strings are owned by the result they
+/// came from.
+typedef struct mcfunc_diagnostic {
+  /// The message on its own (no location or highlighted code).
+  const char* message;
+  /// The full message the command line compiler would print.
+  const char* full_message;
+  /// The project file the problem is in ("" if it isn't tied to a file).
+  const char* file;
+  /// Where in \p file the problem is (starting at 1, 0 if unknown).
+  size_t line;
+  size_t column;
+} mcfunc_diagnostic;
+
+/// A file in the compiled data pack. The strings are owned by the result they
+/// came from.
+typedef struct mcfunc_output {
+  /// Relative to the data pack's "data" directory (e.g.
+  /// "example/function/main.mcfunction"), always with '/' separators.
+  const char* path;
+  /// Null terminated, but \p size should be used since contents can hold
+  /// null characters.
+  const char* contents;
+  size_t size;
+} mcfunc_output;
+
+/// \p MCFUNC_API_VERSION for the library that's linked.
+MCFUNC_API int mcfunc_api_version(void);
+
+/// The compiler's version (e.g. "0.1.0").
+MCFUNC_API const char* mcfunc_version(void);
+
+/// Whether full messages use color (escape codes). This is shared by every
+/// project and is on by default.
+MCFUNC_API void mcfunc_set_color(int enabled);
+
+/// Returns a new empty project (or null if memory couldn't be allocated).
+MCFUNC_API mcfunc_project* mcfunc_project_create(void);
+
+/// Frees \p project (null is ignored). Results compiled from it stay valid.
+MCFUNC_API void mcfunc_project_destroy(mcfunc_project* project);
+
+/// Adds a file to \p project (or replaces the file with the same path). Files
+/// ending with ".mcfunc" are source files and anything else can be used by
+/// file writes. \p path is relative to the project's root, uses '/'
+/// separators, and is used for imports (e.g. "lib/util.mcfunc"). \p contents
+/// is copied.
+MCFUNC_API mcfunc_status mcfunc_project_add_file(mcfunc_project* project, const char* path,
+                                                 const char* contents, size_t size);
+
+/// Removes the file at \p path from \p project .
+MCFUNC_API mcfunc_status mcfunc_project_remove_file(mcfunc_project* project, const char* path);
+
+/// Sets \p option to \p value for future compiles of \p project .
+MCFUNC_API mcfunc_status mcfunc_project_set_option(mcfunc_project* project,
+                                                   mcfunc_option option, size_t value);
+
+/// Compiles \p project . Returns null if \p project is null or if memory
+/// couldn't be allocated. A project that fails to compile still gives a result
+/// (check \p mcfunc_result_succeeded ), and so does an unexpected error inside
+/// of the compiler (its diagnostic's full message starts with "Internal
+/// Error: ").
+MCFUNC_API mcfunc_result* mcfunc_compile(const mcfunc_project* project);
+
+/// Frees \p result (null is ignored).
+MCFUNC_API void mcfunc_result_destroy(mcfunc_result* result);
+
+/// 1 if \p result has outputs, 0 if compiling failed (see the diagnostics).
+MCFUNC_API int mcfunc_result_succeeded(const mcfunc_result* result);
+
+MCFUNC_API size_t mcfunc_result_diagnostic_count(const mcfunc_result* result);
+
+/// Sets \p diagnostic to diagnostic \p index in \p result .
+MCFUNC_API mcfunc_status mcfunc_result_diagnostic(const mcfunc_result* result, size_t index,
+                                                  mcfunc_diagnostic* diagnostic);
+
+/// Output files are sorted by path.
+MCFUNC_API size_t mcfunc_result_output_count(const mcfunc_result* result);
+
+/// Sets \p output to output file \p index in \p result .
+MCFUNC_API mcfunc_status mcfunc_result_output(const mcfunc_result* result, size_t index,
+                                              mcfunc_output* output);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+/// \file Contains the \p FileWatcher class.
+
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#if !defined(__linux__)
+#include <cstdint>
+#endif
+
+/// Waits for changes to a set of files and directories (used by '--watch').
+/// inotify is used on Linux, other platforms check every file's modification
+/// time and size a few times a second.
+class FileWatcher {
+public:
+  /// Watches each file in \param files and everything under each directory in
+  /// \param directories (including files and directories added later).
+  /// \throws std::system_error if the files can't be watched.
+  FileWatcher(const std::vector<std::filesystem::path>& files,
+              const std::vector<std::filesystem::path>& directories);
+  ~FileWatcher();
+
+  FileWatcher(const FileWatcher&) = delete;
+  FileWatcher& operator=(const FileWatcher&) = delete;
+
+  /// Blocks until something changes and returns the path of everything that
+  /// was modified, added, or removed. Changes that happen very close together
+  /// (e.g. an editor saving several files) are returned together.
+  /// \throws std::system_error if something goes wrong while waiting.
+  std::vector<std::filesystem::path> waitForChanges();
+
+private:
+#if defined(__linux__)
+  /// Adds a watch for \param directory (and every directory under it if
+  /// \param recursive is true).
+  void addDirectoryWatch(const std::filesystem::path& directory, bool recursive);
+
+  /// Reads the events that are ready and adds the paths they're about to
+  /// \param changedPaths . Waits up to \param timeoutMs milliseconds for events
+  /// (-1 waits forever). Returns whether any events were read.
+  bool readEvents(std::unordered_set<std::filesystem::path>& changedPaths, int timeoutMs);
+
+private:
+  struct WatchedDirectory {
+    std::filesystem::path path;
+    /// Whether everything in the directory is watched (or only the files in
+    /// \p m_files ).
+    bool recursive;
+  };
+
+  int m_inotifyFD = -1;
+  std::unordered_map<int, WatchedDirectory> m_watchedDirectories;
+#else
+  struct FileStamp {
+    std::filesystem::file_time_type lastWriteTime;
+    uintmax_t size;
+
+    bool operator==(const FileStamp& other) const;
+  };
+
+  /// Returns the stamp of every watched file that exists.
+  std::unordered_map<std::filesystem::path, FileStamp> takeSnapshot() const;
+
+private:
+  std::vector<std::filesystem::path> m_directories;
+  std::unordered_map<std::filesystem::path, FileStamp> m_snapshot;
+#endif
+
+  std::unordered_set<std::filesystem::path> m_files;
+};
@@ -0,0 +1,80 @@
+#pragma once
+/// \file Contains the \p InputFilter class, which decides which files in the
+/// input directories ('-i') are compiled.
+///
+/// Globs are matched against paths relative to the input directory (using
+/// '/'). A '*' matches anything but a '/', a '**' matches anything (including
+/// '/'), and a '?' matches any 1 character but a '/'. A glob without a '/'
+/// (like "*.png") matches the name of a file or directory at any depth,
+/// otherwise it matches the whole path (like "assets/**/*.png"). A glob ending
+/// in a '/' only matches directories.
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class InputFilter {
+public:
+  /// The name of the file in an input directory that lists globs to exclude.
+  static constexpr std::string_view ignoreFileName = ".mcfuncignore";
+
+public:
+  InputFilter() = default;
+
+  /// Only files matching one of \param includeGlobs (or inside a directory
+  /// matching one) are included, unless it's empty. Files and directories
+  /// matching one of \param excludeGlobs are excluded.
+  InputFilter(const std::vector<std::string>& includeGlobs,
+              const std::vector<std::string>& excludeGlobs);
+
+  /// Reads the ignore file at the top of \param inputDirectory (if there is
+  /// one). Every line is a glob to exclude from that directory, and blank lines
+  /// and lines starting with '#' are skipped.
+  void readIgnoreFile(const std::filesystem::path& inputDirectory);
+
+  /// Whether the file or directory at \param path inside of
+  /// \param inputDirectory is included, assuming every directory between them
+  /// is (so it can be used while walking the directory). Both paths must be
+  /// absolute and normal.
+  bool includes(const std::filesystem::path& inputDirectory, const std::filesystem::path& path,
+                bool isDirectory) const;
+
+  /// Whether the file at \param path inside of \param inputDirectory is
+  /// included, checking every directory between them too.
+  bool includesFile(const std::filesystem::path& inputDirectory,
+                    const std::filesystem::path& path) const;
+
+  /// Whether \param path matches \param glob (see the syntax above, but
+  /// \param glob is always matched against the whole path).
+  static bool globMatches(std::string_view glob, std::string_view path);
+
+private:
+  struct Pattern {
+    std::string glob;
+    /// Whether the glob is matched against the name (not the whole path).
+    bool matchesName;
+    /// Whether only directories can match.
+    bool directoryOnly;
+
+    explicit Pattern(std::string_view globStr);
+
+    /// Whether \param relativePath (of a file or directory) matches.
+    bool matches(std::string_view relativePath, bool isDirectory) const;
+  };
+
+  /// Whether \param relativePath is excluded (ignoring the directories it's
+  /// in) by \param patterns or \p m_excludePatterns .
+  bool isExcluded(const std::vector<Pattern>* patterns, std::string_view relativePath,
+                  bool isDirectory) const;
+
+  /// The ignore file patterns for \param inputDirectory (or \p nullptr ).
+  const std::vector<Pattern>* ignorePatternsFor(const std::filesystem::path& inputDirectory) const;
+
+private:
+  std::vector<Pattern> m_includePatterns;
+  std::vector<Pattern> m_excludePatterns;
+  /// Input directory -> the patterns in its ignore file.
+  std::unordered_map<std::filesystem::path, std::vector<Pattern>> m_ignorePatterns;
+};
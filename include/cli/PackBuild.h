@@ -0,0 +1,46 @@
+#pragma once
+/// \file Contains the \p PackBuild class.
+
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <cli/parseArgs.h>
+#include <compiler/generation/BuildStamp.h>
+#include <compiler/translation/CompiledSourceFile.h>
+
+/// A build of 1 data pack from parsed arguments (what running the compiler once
+/// does without '--watch'). It's split into steps so that the source files of
+/// several packs can be evaluated together (see 'mcfunc batch').
+class PackBuild {
+public:
+  /// \param stampKey identifies the arguments (see \p BuildStamp::keyFromArgs()
+  /// ).
+  PackBuild(std::string&& stampKey, ParseArgsResult&& parsedArgs);
+
+  /// If nothing changed since the last build with the same arguments, prints
+  /// what that build printed to \param out and returns true. Builds are never
+  /// skipped if the output directory should be cleared or the build is being
+  /// timed or traced.
+  bool skipIfUpToDate(std::ostream& out) const;
+
+  SourceFiles& sourceFiles();
+
+  const CompileOptions& compileOptions() const;
+
+  /// Links \param compiledSourceFiles (from evaluating \p sourceFiles() ) and
+  /// writes the data pack and anything else the arguments asked for (like a
+  /// source map or a depfile). Messages are printed to \param out . The source
+  /// files are freed.
+  /// \throws compile_error::Generic (or a subclass of it) if anything goes
+  /// wrong.
+  void linkAndWrite(std::vector<CompiledSourceFile>&& compiledSourceFiles, std::ostream& out);
+
+  const std::filesystem::path& outputDirectory() const;
+
+private:
+  ParseArgsResult m_args;
+  BuildStamp m_buildStamp;
+  std::filesystem::path m_buildStampPath;
+};
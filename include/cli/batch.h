@@ -0,0 +1,18 @@
+#pragma once
+/// \file Contains the \p batch function for the 'batch' command.
+
+#include <string>
+#include <vector>
+
+/// The arguments for each data pack in the manifest \param manifestText (not
+/// including the program name). Each input that's a directory is passed with
+/// '-i', other inputs are passed as files.
+/// \throws json::ParseError if the manifest isn't valid.
+std::vector<std::vector<std::string>> packArgsFromManifest(const std::string& manifestText);
+
+/// Runs 'mcfunc batch <MANIFEST>', which builds every data pack in a manifest
+/// in one process. The source files of every pack are evaluated by the same
+/// threads and files used by several packs are only read and tokenized once.
+/// Packs that are up to date are skipped and one pack failing doesn't stop the
+/// others. Returns the exit code.
+int batch(int argc, const char** argv);
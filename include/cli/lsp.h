@@ -0,0 +1,16 @@
+#pragma once
+/// \file Contains the \p lsp function for the 'lsp' command.
+
+#include <istream>
+#include <ostream>
+
+/// Runs a language server that reads Language Server Protocol messages from
+/// \param in and writes responses and notifications to \param out (until an
+/// 'exit' notification is read or \param in ends). The source files in the
+/// workspace's root directory are kept analyzed in a \p Workspace . Supports
+/// diagnostics, go-to-definition and find-references. Returns the exit code.
+int runLanguageServer(std::istream& in, std::ostream& out);
+
+/// Runs 'mcfunc lsp', which runs a language server over stdin and stdout.
+/// Returns the exit code.
+int lsp(int argc, const char** argv);
@@ -1,27 +1,58 @@
 #pragma once
 /// \file Contains the \p parseArgs function and the \p ParseArgsResult type.
 
+#include <exception>
 #include <filesystem>
 #include <vector>
 
+#include <cli/InputFilter.h>
+#include <compiler/CompileOptions.h>
 #include <compiler/FileWriteSourceFile.h>
 #include <compiler/SourceFiles.h>
 
 /// The result of calling the \p parseArgs function. Holds a list of source
-/// files and an output directory.
+/// files, an output directory, and the options to compile with.
 struct ParseArgsResult {
   std::filesystem::path outputDirectory;
   SourceFiles sourceFiles;
   std::vector<FileWriteSourceFile> fileWriteSourceFiles;
   bool clearOutputDirectory;
+  CompileOptions compileOptions;
+  /// Where to write the source map (empty if one shouldn't be written).
+  std::filesystem::path sourceMapPath;
+  /// Where to write a Make dependency file (empty if one shouldn't be written).
+  std::filesystem::path depfilePath;
+  /// Where to write a cross-reference index (empty if one shouldn't be
+  /// written).
+  std::filesystem::path xrefPath;
+  /// The directories passed with '-i' (used to watch for new files).
+  std::vector<std::filesystem::path> inputDirectories;
+  /// Which files in \p inputDirectories are compiled ('--include',
+  /// '--exclude', and ignore files).
+  InputFilter inputFilter;
+  /// Whether to keep running and rebuild when files change ('--watch').
+  bool watchForChanges;
 
   ParseArgsResult(std::filesystem::path&& outputDirectory, SourceFiles&& sourceFiles,
                   std::vector<FileWriteSourceFile>&& fileWriteSourceFiles,
-                  bool clearOutputDirectory);
+                  bool clearOutputDirectory, const CompileOptions& compileOptions,
+                  std::filesystem::path&& sourceMapPath, std::filesystem::path&& depfilePath,
+                  std::filesystem::path&& xrefPath,
+                  std::vector<std::filesystem::path>&& inputDirectories,
+                  InputFilter&& inputFilter, bool watchForChanges);
+};
+
+/// Thrown by \p parseArgs instead of exiting when the arguments are invalid (if
+/// it was told not to exit). The error has already been printed.
+class InvalidArgsError : public std::exception {
+public:
+  virtual const char* what() const noexcept override;
 };
 
 /// Parses all of the passed arguments, updating the source files list.
 /// If the function determines that no compilation should happen (e.g. there was
 /// an input error or the only argument was --help) the function will call
-/// \p std::exit with the proper exit code.
-ParseArgsResult parseArgs(int argc, const char** argv);
+/// \p std::exit with the proper exit code. If \param exitOnError isn't set,
+/// input errors throw \p InvalidArgsError instead (so '--watch' can keep going
+/// when the input files change).
+ParseArgsResult parseArgs(int argc, const char** argv, bool exitOnError = true);
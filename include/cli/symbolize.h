@@ -0,0 +1,16 @@
+#pragma once
+/// \file Contains the \p symbolize function for the 'symbolize' command.
+
+#include <string>
+
+/// Adds where each generated function name in \param text came from using the
+/// contents of a source map written with '--source-map'
+/// (\param sourceMapText ). For example, "zzz__.foo:f_00000_0002b" becomes
+/// "zzz__.foo:f_00000_0002b (bar at src/main.mcfunc:3:6)". Names that aren't
+/// in the source map are left alone.
+/// \throws json::ParseError if the source map isn't valid.
+std::string symbolizeText(const std::string& text, const std::string& sourceMapText);
+
+/// Runs 'mcfunc symbolize <SOURCE_MAP> [FILE]', which prints the symbolized
+/// contents of FILE (or stdin). Returns the exit code.
+int symbolize(int argc, const char** argv);
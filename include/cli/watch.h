@@ -0,0 +1,13 @@
+#pragma once
+/// \file Contains the \p watch function for '--watch'.
+
+#include <cli/parseArgs.h>
+
+/// Builds the data pack described by \param parsedArgs and then keeps running,
+/// rebuilding whenever an input file changes. Only source files that changed
+/// are compiled again and only files in the data pack that changed are
+/// written. If files are added or removed the arguments (\param argc and
+/// \param argv ) are parsed again and everything is rebuilt. Compile errors
+/// are printed and don't stop watching. Only returns if files can't be watched
+/// (returning the exit code).
+int watch(int argc, const char** argv, ParseArgsResult&& parsedArgs);
@@ -0,0 +1,18 @@
+#pragma once
+/// \file Contains the \p xref function for the 'xref' command.
+
+#include <string>
+#include <string_view>
+
+#include <compiler/XrefIndex.h>
+
+/// Every entry for \param name in \param index as a line like
+/// "src/main.mcfunc:3:6: call". Line and column numbers are found by reading
+/// the source files (only the byte offset is printed if one can't be read).
+/// \throws XrefIndex::FormatError if the index is corrupt.
+std::string xrefText(const XrefIndex& index, std::string_view name);
+
+/// Runs 'mcfunc xref <INDEX> <NAME>', which prints everywhere NAME is defined,
+/// declared, or used using an index written with '--xref'. Returns the exit
+/// code.
+int xref(int argc, const char** argv);
@@ -0,0 +1,42 @@
+#pragma once
+/// \file Contains the \p CompileOptions type.
+
+#include <cstddef>
+
+/// Options that change how source files are translated into a data pack. Every
+/// option is off by default so that the output matches a plain compilation.
+struct CompileOptions {
+  /// Replace scopes that only hold 1 statement with that statement (e.g.
+  /// 'execute as @a run: { /say hi; }' becomes 'execute as @a run say hi')
+  /// instead of giving each one its own function file. Scopes are still given
+  /// a function file if inlining them could change what they do.
+  bool inlineTrivialScopes = false;
+
+  /// Merge function files in the hidden namespace that end up with the exact
+  /// same contents after linking, rewriting calls to point at the one that's
+  /// kept.
+  bool deduplicateFunctions = false;
+
+  /// Move adjacent commands in a scope that start with the same execute
+  /// modifiers (e.g. 'execute as @e[type=pig] at @s run ...') into 1 function
+  /// that's run behind those modifiers. The modifiers are only evaluated once,
+  /// but each entity runs every command before the next entity runs any (rather
+  /// than each command running for every entity before the next command).
+  bool factorExecutePrefixes = false;
+
+  /// Estimate how many commands run each tick and print a report.
+  bool reportTickCost = false;
+
+  /// Fail if the busiest tick is estimated to run more than this many commands
+  /// (0 means there's no limit).
+  size_t maxTickCommands = 0;
+
+  /// Make every generated function file add 1 to its own scoreboard counter
+  /// when it runs, and generate functions that print and reset the counters
+  /// along with a map from each counter to the code it came from.
+  bool instrument = false;
+
+  /// Generate a source map that ties every generated function back to the code
+  /// it came from (see \p LinkResult::sourceMap ).
+  bool generateSourceMap = false;
+};
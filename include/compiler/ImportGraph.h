@@ -0,0 +1,45 @@
+#pragma once
+/// \file Contains the \p ImportGraph class.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <compiler/SourceFiles.h>
+
+/// Tracks which source files import which (in both directions) using the
+/// indices of the source files in a \p SourceFiles object. Source files have
+/// to be analyzed before their imports can be added.
+class ImportGraph {
+public:
+  ImportGraph() = default;
+
+  /// Adds the imports of every source file in \param sourceFiles .
+  explicit ImportGraph(const SourceFiles& sourceFiles);
+
+  /// Replaces the imports of the source file at \param index with the ones it
+  /// has now (e.g. after it's analyzed again).
+  void updateImports(const SourceFiles& sourceFiles, size_t index);
+
+  /// Makes room for source files that were added to the end of the
+  /// \p SourceFiles object (they don't import anything yet). The number of
+  /// source files can only grow.
+  void resize(size_t sourceFileCount);
+
+  /// The indices of the source files that the source file at \param index
+  /// imports.
+  const std::vector<size_t>& importsOf(size_t index) const;
+
+  /// The indices of the source files that import the source file at
+  /// \param index .
+  const std::vector<size_t>& importersOf(size_t index) const;
+
+  /// A hash of everything that files importing \param sourceFile can see (the
+  /// name and qualifiers of every public function declaration). Edits that
+  /// only change private functions or function bodies don't change the hash.
+  static uint64_t interfaceHash(const SourceFile& sourceFile);
+
+private:
+  std::vector<std::vector<size_t>> m_imports;
+  std::vector<std::vector<size_t>> m_importers;
+};
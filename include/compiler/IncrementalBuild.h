@@ -0,0 +1,125 @@
+#pragma once
+/// \file Contains the \p IncrementalBuild class.
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <compiler/CompileOptions.h>
+#include <compiler/FileWriteSourceFile.h>
+#include <compiler/ImportGraph.h>
+#include <compiler/SourceFiles.h>
+#include <compiler/linking/link.h>
+#include <compiler/translation/CompiledSourceFile.h>
+
+/// Keeps every source file and its compiled result in memory between builds so
+/// that only source files that change have to be compiled again (used by
+/// '--watch'). The set of files can't change, a new \p IncrementalBuild should
+/// be made if files are added or removed.
+class IncrementalBuild {
+public:
+  struct UpdateResult {
+    /// Whether anything was linked and written again.
+    bool rebuilt = false;
+    size_t recompiledSourceFileCount = 0;
+    /// The number of source files whose imports were checked again.
+    size_t checkedImporterCount = 0;
+    /// The number of files in the data pack that were written or removed.
+    size_t changedOutputFileCount = 0;
+  };
+
+public:
+  /// \param sourceMapPath can be empty if no source map should be written.
+  /// \param xrefPath can be empty if no cross-reference index should be
+  /// written.
+  IncrementalBuild(std::filesystem::path&& outputDirectory, SourceFiles&& sourceFiles,
+                   std::vector<FileWriteSourceFile>&& fileWriteSourceFiles,
+                   const CompileOptions& compileOptions, std::filesystem::path&& sourceMapPath,
+                   std::filesystem::path&& xrefPath);
+
+  /// Makes the next build only write what changed since \param previous last
+  /// wrote the data pack (so files from sources that were removed get removed
+  /// too). Does nothing if \param previous had a different output directory.
+  void continueFrom(IncrementalBuild&& previous);
+
+  /// Evaluates and links every source file and writes the whole data pack (or
+  /// only what changed if \p continueFrom() was called).
+  /// \throws compile_error::Generic (or a subclass of it) if anything goes
+  /// wrong (the next call to \p update() will build everything again).
+  void buildAll(bool clearOutputDirectory);
+
+  /// Recompiles the source files in \param changedPaths whose contents changed
+  /// (and any that failed to compile last time), then links everything again
+  /// and writes only the parts of the data pack that changed. Files that
+  /// import a recompiled file only have their imports checked again if the
+  /// recompiled file's interface changed (see
+  /// \p ImportGraph::interfaceHash() ). Changed paths that aren't source files
+  /// (e.g. files that are written into the data pack) only cause a link.
+  /// Nothing is rebuilt if nothing changed.
+  /// \throws compile_error::Generic (or a subclass of it) if anything goes
+  /// wrong. The data pack from the last successful build is left in place.
+  UpdateResult update(const std::vector<std::filesystem::path>& changedPaths);
+
+  /// Whether \param path is one of the files in the build.
+  bool hasFile(const std::filesystem::path& path) const;
+
+  const CompileOptions& compileOptions() const;
+
+  /// The result of the last successful link.
+  const LinkResult& linkResult() const;
+
+private:
+  /// Tokenizes, analyzes and compiles the source file at \param index again,
+  /// marking which source files need their imports checked.
+  void reevaluate(size_t index);
+
+  /// Links every compiled source file and writes what changed in the data pack
+  /// (or the whole data pack if nothing has been written yet). Returns the
+  /// number of files in the data pack that were written or removed.
+  size_t linkAndWrite(bool clearOutputDirectory);
+
+private:
+  std::filesystem::path m_outputDirectory;
+  SourceFiles m_sourceFiles;
+  std::vector<FileWriteSourceFile> m_fileWriteSourceFiles;
+  CompileOptions m_compileOptions;
+  std::filesystem::path m_sourceMapPath;
+  std::filesystem::path m_xrefPath;
+  /// The last cross-reference index that was written.
+  std::string m_xrefIndex;
+
+  /// Lines up with \p m_sourceFiles.
+  std::vector<CompiledSourceFile> m_compiledSourceFiles;
+
+  /// The hash of each source file's contents the last time it was compiled
+  /// (lines up with \p m_sourceFiles, empty if the last full build failed).
+  std::vector<std::optional<uint64_t>> m_contentHashes;
+
+  std::unordered_map<std::filesystem::path, size_t> m_sourceFileIndices;
+
+  ImportGraph m_importGraph;
+
+  /// The interface hash of each source file (lines up with \p m_sourceFiles ).
+  std::vector<uint64_t> m_interfaceHashes;
+
+  /// The source files that need their imports checked during the next link
+  /// (lines up with \p m_sourceFiles ).
+  std::vector<bool> m_importsToCheck;
+
+  /// Source files that changed but haven't been compiled successfully yet.
+  std::set<size_t> m_dirtySourceFiles;
+
+  /// File write source files that changed since the data pack was last
+  /// written (their copies in the data pack are out of date).
+  std::set<std::filesystem::path> m_changedFileWriteSourcePaths;
+
+  bool m_needsFullBuild = true;
+  bool m_needsLink = true;
+  bool m_hasWrittenDataPack = false;
+  LinkResult m_linkResult;
+};
@@ -0,0 +1,54 @@
+#pragma once
+/// \file Contains the \p Jobserver class.
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// A client for GNU Make's jobserver (so that 'make -j' across several data
+/// packs doesn't run more threads than it was given). Make starts every job
+/// with 1 implicit token, any more threads have to take a token first and give
+/// it back when they're done. Only POSIX jobservers (a pipe or a named FIFO)
+/// are supported, otherwise the client isn't connected.
+class Jobserver {
+public:
+  /// Connects to the jobserver in the 'MAKEFLAGS' environment variable (if
+  /// there is one and it can be used).
+  Jobserver();
+  /// Gives back any tokens that are still held.
+  ~Jobserver();
+
+  Jobserver(const Jobserver&) = delete;
+  Jobserver& operator=(const Jobserver&) = delete;
+
+  /// Whether there's a jobserver to take tokens from (if there isn't, any
+  /// number of threads can be used).
+  bool isConnected() const;
+
+  /// Takes a token without waiting for one. Returns whether a token was taken
+  /// (always false if not connected).
+  bool tryAcquire();
+
+  /// Gives back a token taken with \p tryAcquire() (safe to call from any
+  /// thread).
+  void release();
+
+private:
+  /// Connects to the jobserver described by \param auth (what's after
+  /// '--jobserver-auth=' in 'MAKEFLAGS'). Returns whether it worked.
+  bool connect(const std::string& auth);
+
+  void disconnect();
+
+private:
+  int m_readFD = -1;
+  int m_writeFD = -1;
+  /// Whether the file descriptors were opened by us (and need to be closed).
+  bool m_ownsFDs = false;
+  /// Whether reads from \p m_readFD can block (it's only polled first).
+  bool m_readCanBlock = false;
+
+  /// The tokens that are held (the same bytes have to be written back).
+  std::vector<char> m_tokens;
+  std::mutex m_tokensMutex;
+};
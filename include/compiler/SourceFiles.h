@@ -1,9 +1,15 @@
 #pragma once
 /// \file Contains the \p SourceFiles and \p SourceFile types.
 
+#include <cstdint>
+#include <exception>
 #include <filesystem>
+#include <memory>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include <compiler/CompileOptions.h>
 #include <compiler/FileWriteSourceFile.h>
 #include <compiler/UniqueID.h>
 #include <compiler/syntax_analysis/symbol.h>
@@ -28,6 +34,11 @@ public:
   /// open or if tokenization encounters unexpected data.
   void tokenize();
 
+  /// Sets this file's tokens to copies of \param other's tokens instead of
+  /// tokenizing it again (\param other has to have been tokenized from the
+  /// same file).
+  void copyTokensFrom(const SourceFile& other);
+
   /// Analyzes the file's tokens and validates that the order of the tokens
   /// creates valid constructs in the language. These constructs are used to
   /// generate symbol tables for the file.
@@ -43,12 +54,26 @@ public:
   /// Get the path that this file will be imported as.
   const std::filesystem::path& importPath() const;
 
-  /// A unique file ID that is generated for this specific source file.
+  /// A unique file ID for this source file (set when it's analyzed).
   UniqueID fileID() const;
 
+  /// A new ID for something in this file (e.g. a function or a scope) that no
+  /// other file it's linked with can have. The numbers start over each time
+  /// the file is analyzed (everything with an ID is made again then), so a
+  /// file can be evaluated again any number of times.
+  UniqueID newID(UniqueID::Kind kind) const;
+
   /// The tokens (groups of characters) in this file.
   const std::vector<Token>& tokens() const;
 
+  /// The index in the file that each line starts at (set while tokenizing so
+  /// that positions can be turned into lines without reading the file again).
+  const std::vector<size_t>& lineStarts() const;
+
+  /// The hash of the file's contents when it was tokenized (see
+  /// \p fnv1aHash() ).
+  uint64_t contentHash() const;
+
   /// The function symbol table.
   const symbol::FunctionTable& functionSymbolTable() const;
 
@@ -65,6 +90,11 @@ public:
   /// The namespace expose symbol.
   const symbol::NamespaceExpose& namespaceExposeSymbol() const;
 
+  /// Clears everything that \p tokenize() and \p analyzeSyntax() found so they
+  /// can be run again (e.g. after the file changes). The path and file ID are
+  /// kept, so imports of this file from other source files stay valid.
+  void clearEvaluation();
+
   /// Clears all fields of the source file so that memory is deallocated. This
   /// puts the source file in a somewhat invalid state, do not use the source
   /// file after doing this.
@@ -73,8 +103,15 @@ public:
 private:
   std::filesystem::path m_filePath;
   std::filesystem::path m_importFilePath;
-  UniqueID m_fileID;
+  /// This file's index in the source files it was analyzed with (part of
+  /// every ID from \p newID() ).
+  uint32_t m_fileNumber = 0;
+  /// The number of the next ID from \p newID() (mutable because scopes are
+  /// given IDs while compiling, when the file is const).
+  mutable uint32_t m_nextIDNumber = 1;
   std::vector<Token> m_tokens;
+  std::vector<size_t> m_lineStarts;
+  uint64_t m_contentHash = 0;
   symbol::FunctionTable m_functionSymbolTable;
   symbol::UnresolvedFunctionNames m_unresolvedFunctionNames;
   symbol::FileWriteTable m_fileWriteSymbolTable;
@@ -88,12 +125,54 @@ private:
 /// The exact same as \p std::vector<SourceFile> except there's a few extra
 /// methods attached for linking and compiling.
 class SourceFiles : public std::vector<SourceFile> {
+public:
+  /// What evaluating one of the lists given to \p evaluateBatch() resulted in.
+  struct BatchResult {
+    std::vector<CompiledSourceFile> compiledSourceFiles;
+    /// What \p evaluateAll() would have thrown (null if nothing was thrown).
+    std::exception_ptr exception;
+  };
+
 public:
   /// Evaluates every source file by tokenizing, performing syntax analysis,
   /// generating symbol tables, and compiling into a new vector of compiled
-  /// source files. Source files are evaluated in parallel. After this the
+  /// source files. Source files are evaluated in parallel (only using as many
+  /// threads as make's jobserver allows if there is one). After this the
   /// linking stage can begin.
   /// \throws compile_error::Generic (or a subclass of it) if anything goes
   /// wrong.
-  std::vector<CompiledSourceFile> evaluateAll();
+  std::vector<CompiledSourceFile> evaluateAll(const CompileOptions& compileOptions);
+
+  /// Evaluates every list in \param batch like \p evaluateAll() (using the
+  /// compile options at the same index in \param compileOptions ), with the
+  /// source files from every list sharing the same threads. Source files that
+  /// are in more than one list (with the same path) are only read and
+  /// tokenized once. One list failing doesn't stop the others from being
+  /// evaluated, each result holds the exception its list would have thrown.
+  static std::vector<BatchResult> evaluateBatch(const std::vector<SourceFiles*>& batch,
+                                                const std::vector<CompileOptions>& compileOptions);
+
+  /// Finds the source files with the import path \param importPath . Returns
+  /// how many there are and sets \param found to the first one (if there are
+  /// any). The table this looks in is built the first time it's needed and
+  /// again whenever the number of source files changes, so source files may
+  /// only be added to the end of the list once it's been built. Removing,
+  /// replacing, or reordering source files has to be done by assigning a new
+  /// \p SourceFiles (which has no table).
+  size_t findByImportPath(const std::filesystem::path& importPath,
+                          const SourceFile*& found) const;
+
+private:
+  struct ImportPathTable {
+    size_t sourceFileCount;
+    /// import path -> the index of the first source file with the import path
+    /// and the number of source files with it
+    std::unordered_map<std::filesystem::path, std::pair<size_t, size_t>> entries;
+  };
+
+  /// The import path table (built if it's out of date). Threads can share it
+  /// because a table is never changed once it's built, only replaced.
+  std::shared_ptr<const ImportPathTable> importPathTable() const;
+
+  mutable std::shared_ptr<const ImportPathTable> m_importPathTable;
 };
@@ -0,0 +1,28 @@
+#pragma once
+/// \file Contains the \p TickSchedule type.
+
+#include <cstdint>
+
+/// How often a tick function runs. Tick functions without a schedule (just the
+/// 'tick' keyword) run every tick.
+struct TickSchedule {
+  enum class Kind {
+    EVERY_TICK, /// e.g. 'tick void foo()'.
+    EVERY,      /// e.g. 'tick(every 20) void foo()'.
+    SPREAD,     /// e.g. 'tick(spread 4) void foo()'.
+  };
+
+  /// \p EVERY functions always run on the 1st of every \p period ticks (so all
+  /// functions with the same period run on the same tick). \p SPREAD functions
+  /// run on whichever of the \p period ticks the compiler picks to keep the
+  /// cost of every tick as even as possible.
+  Kind kind = Kind::EVERY_TICK;
+
+  /// The function runs once every \p period ticks.
+  uint32_t period = 1;
+
+  bool operator==(const TickSchedule& other) const {
+    return kind == other.kind && period == other.period;
+  }
+  bool operator!=(const TickSchedule& other) const { return !(*this == other); }
+};
@@ -14,37 +14,37 @@ public:
   };
 
 public:
-  /// Generates a new unique ID object. Every \p UniqueID has a different ID
-  /// value.
+  /// Creates ID \param number of the source file numbered \param fileNumber
+  /// (see \p SourceFile::newID() ). IDs are unique as long as no 2 source files
+  /// being linked together share a file number and no file hands out the same
+  /// number twice.
   /// \param kind The kind of object that this ID is for.
-  UniqueID(Kind kind);
+  /// \throws compile_error::Generic if either number is too big for an ID.
+  UniqueID(Kind kind, uint32_t fileNumber, uint32_t number);
 
   /// \warning Do not use the default constructor for this class. It is only
   /// here so that you can use this class in data structures that require it.
   UniqueID() { assert(false && "Do not use the UniqueID default constructor."); };
 
-  /// String representation of this ID (e.g. 's_00001' is a \p SOURCE_FILE ID).
+  /// String representation of this ID (e.g. 'f_00001_0002a' is the 42nd
+  /// \p FUNCTION ID from source file 1).
   const char* str() const;
 
   /// The kind/type of this ID (e.g. \p SOURCE_FILE ).
   Kind kind() const;
 
-  /// The ID number.
+  /// The ID number (with the file number in the upper 32 bits).
   uint64_t value() const;
 
   bool operator==(UniqueID other) const;
   bool operator!=(UniqueID other) const;
 
 private:
-  union {
-    char m_idStr[8];
-    uint64_t m_idValue;
-  };
-  static_assert(sizeof(char[8]) == sizeof(uint64_t));
+  uint32_t m_fileNumber;
+  uint32_t m_number;
+  char m_idStr[14];
 };
 
-static_assert(sizeof(UniqueID) == sizeof(uint64_t));
-
 /// This allows \p UniqueID to be used in data structures like
 /// \p std::unordered_map as a key.
 template <> struct std::hash<UniqueID> {
@@ -0,0 +1,197 @@
+#pragma once
+/// \file Contains the \p Workspace class.
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <compiler/ImportGraph.h>
+#include <compiler/SourceFiles.h>
+#include <compiler/vfs.h>
+
+/// Keeps every source file in a directory tokenized and analyzed in memory so
+/// that an editor can be told about errors (and where functions are defined
+/// and called) as the files are edited (used by 'mcfunc lsp'). When a file
+/// changes only that file is tokenized and analyzed again. Files that import it
+/// only have their function calls checked again if its interface changed (see
+/// \p ImportGraph::interfaceHash() ). Unsaved editor buffers are laid over the
+/// files in the directory. Nothing is compiled or linked, so errors that are
+/// only found while linking (like a public function being defined twice)
+/// aren't reported.
+class Workspace {
+public:
+  /// The first error in a source file (lines and columns start at 1).
+  struct Diagnostic {
+    std::string message;
+    size_t line = 1;
+    size_t column = 1;
+    /// The number of characters the error covers.
+    size_t length = 1;
+
+    bool operator==(const Diagnostic& other) const;
+    bool operator!=(const Diagnostic& other) const;
+  };
+
+  /// A range of characters in a source file (lines and columns start at 1).
+  struct Location {
+    std::filesystem::path path;
+    size_t line = 1;
+    size_t column = 1;
+    size_t length = 1;
+  };
+
+public:
+  /// Loads every source file in \param rootDirectory (which is also the
+  /// directory source files are imported relative to). Unsaved buffers are
+  /// mounted over \param rootDirectory until this is destroyed.
+  explicit Workspace(const std::filesystem::path& rootDirectory);
+
+  Workspace(const Workspace&) = delete;
+  Workspace& operator=(const Workspace&) = delete;
+
+  /// The (absolute) directory the source files are in.
+  const std::filesystem::path& rootDirectory() const;
+
+  size_t sourceFileCount() const;
+
+  // These update the workspace after something changes and return the paths of
+  // the source files whose diagnostic changed (sorted). Paths can be relative
+  // to the working directory and paths outside of the root directory are
+  // ignored.
+
+  /// Sets the unsaved contents of the file at \param path (which hide the
+  /// contents of the saved file until \p closeBuffer() is called).
+  std::vector<std::filesystem::path> setBuffer(const std::filesystem::path& path,
+                                               const std::string& contents);
+
+  /// Removes the unsaved contents of the file at \param path (so the saved
+  /// file is used again).
+  std::vector<std::filesystem::path> closeBuffer(const std::filesystem::path& path);
+
+  /// Updates the file at \param path after it was created, saved or deleted.
+  std::vector<std::filesystem::path> fileChanged(const std::filesystem::path& path);
+
+  /// The diagnostic for the source file at \param path (or \p nullptr if the
+  /// source file doesn't have any errors or doesn't exist).
+  const Diagnostic* diagnostic(const std::filesystem::path& path) const;
+
+  /// The paths of every source file that has a diagnostic (sorted).
+  std::vector<std::filesystem::path> pathsWithDiagnostics() const;
+
+  /// Where the function whose name is at \param line and \param column in the
+  /// source file at \param path is defined. Public functions that aren't
+  /// defined anywhere return every declaration instead.
+  std::vector<Location> definitionAt(const std::filesystem::path& path, size_t line,
+                                     size_t column) const;
+
+  /// Everywhere that the function whose name is at \param line and
+  /// \param column in the source file at \param path is called (and declared
+  /// or defined if \param includeDeclarations is set).
+  std::vector<Location> referencesAt(const std::filesystem::path& path, size_t line,
+                                     size_t column, bool includeDeclarations) const;
+
+  /// The text of line \param line (starting at 1) of the source file at
+  /// \param path the last time it was analyzed (without the newline), or an
+  /// empty string if there isn't one. It's valid until the workspace changes.
+  std::string_view lineAt(const std::filesystem::path& path, size_t line) const;
+
+private:
+  /// What's known about a source file (besides what's in the \p SourceFile ).
+  struct FileState {
+    /// The hash of the contents the last time the file was analyzed.
+    std::optional<uint64_t> contentHash;
+    /// The contents the last time the file was analyzed.
+    std::string contents;
+    /// The index in the file where each line starts.
+    std::vector<size_t> lineStarts;
+    /// Whether the source file was tokenized and analyzed without errors.
+    bool isAnalyzed = false;
+    std::optional<Diagnostic> diagnostic;
+    uint64_t interfaceHash = 0;
+    /// The names this file adds to \p m_publicFunctionFiles .
+    std::vector<std::string> publicFunctionNames;
+    /// The names this file adds to \p m_importedCallFiles .
+    std::vector<std::string> importedCallNames;
+    /// The indices of the name tokens of every function call (by name).
+    std::unordered_map<std::string, std::vector<size_t>> calls;
+  };
+
+  /// Finds and analyzes every source file again. Used when files are removed
+  /// (which would leave other source files pointing at them) or when adding a
+  /// file would move the source files.
+  std::vector<std::filesystem::path> reload();
+
+  /// Analyzes the source file at \param index again if its contents changed
+  /// (or if \param force is set) and checks the calls of any files that import
+  /// it if its interface changed. Adds the indices of source files whose
+  /// diagnostic changed to \param changed .
+  void update(size_t index, bool force, std::vector<size_t>& changed);
+
+  /// Adds the source file at \param path (which must exist and not already be
+  /// a source file).
+  std::vector<std::filesystem::path> addSourceFile(std::filesystem::path&& path);
+
+  /// Tokenizes and analyzes the source file at \param index and indexes its
+  /// functions (it must have been cleared first). Returns the error if there is
+  /// one.
+  std::optional<Diagnostic> analyze(size_t index, const std::string& contents);
+
+  /// Removes what the source file at \param index added to the indices of
+  /// public functions and function calls, and clears its evaluation.
+  void clear(size_t index);
+
+  /// Returns the error if the source file at \param index calls a function
+  /// that isn't declared in it or in a file it imports.
+  std::optional<Diagnostic> checkImportedCalls(size_t index) const;
+
+  /// Sets the diagnostic of the source file at \param index , adding it to
+  /// \param changed if it's different.
+  void setDiagnostic(size_t index, std::optional<Diagnostic>&& diagnostic,
+                     std::vector<size_t>& changed);
+
+  /// Converts \param changed to a list of paths (sorted without duplicates).
+  std::vector<std::filesystem::path> pathsOf(std::vector<size_t>& changed) const;
+
+  /// The index of the source file at \param path (or \p std::nullopt ).
+  std::optional<size_t> indexOf(const std::filesystem::path& path) const;
+
+  /// The index of the word token at \param line and \param column in the
+  /// source file at \param index (or \p std::nullopt ).
+  std::optional<size_t> wordTokenAt(size_t index, size_t line, size_t column) const;
+
+  /// Where \param token (from one of the source files) is.
+  Location locationOf(const Token& token) const;
+
+  /// Whether the calls to \param name in the source file at \param index call a
+  /// public function (rather than one that's private to the file).
+  bool callsPublicFunction(size_t index, const std::string& name) const;
+
+  /// The absolute and normal version of \param path (or an empty path if it's
+  /// outside of the root directory).
+  std::filesystem::path pathInRoot(const std::filesystem::path& path) const;
+
+private:
+  std::shared_ptr<vfs::MemoryFileSystem> m_buffers;
+  vfs::Mount m_mount;
+
+  /// Holds more source files than there are so adding one usually doesn't
+  /// move them (which would break references between them).
+  SourceFiles m_sourceFiles;
+  /// Lines up with \p m_sourceFiles .
+  std::vector<FileState> m_fileStates;
+  std::unordered_map<std::filesystem::path, size_t> m_sourceFileIndices;
+  ImportGraph m_importGraph;
+
+  /// Function name -> the source files that declare a public function with
+  /// the name.
+  std::unordered_map<std::string, std::vector<size_t>> m_publicFunctionFiles;
+  /// Function name -> the source files that call a function with the name that
+  /// they don't declare themselves.
+  std::unordered_map<std::string, std::vector<size_t>> m_importedCallFiles;
+};
@@ -0,0 +1,131 @@
+#pragma once
+/// \file Contains the \p XrefIndex class, which reads the cross-reference
+/// indices written with '--xref'.
+///
+/// An index is one file that can be memory mapped and searched without parsing
+/// it. Every number is a little-endian unsigned 32-bit integer.
+///
+/// \code
+/// header   magic ("MCFXREF\0", 8 bytes), version, file count, name count,
+///          entry count
+/// files    (string offset, string length) for each source file path, sorted
+/// names    (string offset, string length, first entry, entry count) for each
+///          name, sorted by the bytes in the name
+/// entries  (kind, file index, index in file) for each entry, grouped by name
+///          and sorted by kind, file, and index in file
+/// strings  the bytes of every path and name (offsets are from the start of
+///          this section)
+/// \endcode
+///
+/// Names are function names for functions, output paths for file writes (e.g.
+/// "foo/bar.json"), and import paths for imports (e.g. "lib/foo.mcfunc").
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// A cross-reference index that's searched in place (see the format above).
+class XrefIndex {
+public:
+  /// The kinds of entry in an index (the values are part of the format).
+  enum class Kind : uint32_t {
+    FUNCTION_DEFINITION = 0, /// e.g. 'foo' in 'void foo() {}'.
+    FUNCTION_DECLARATION,    /// e.g. 'foo' in 'public void foo();'.
+    FUNCTION_CALL,           /// e.g. 'foo' in 'foo();'.
+    FILE_WRITE,              /// e.g. '"foo.json"' in 'file "foo.json" = "{}";'.
+    IMPORT,                  /// e.g. '"foo.mcfunc"' in 'import "foo.mcfunc";'.
+  };
+
+  /// Where something with a name was found.
+  struct Entry {
+    Kind kind;
+    /// The path of the source file (as it was given to the compiler).
+    std::string_view filePath;
+    /// The index of the name (or the path string) in the source file.
+    size_t indexInFile;
+  };
+
+  /// Thrown when an index isn't valid.
+  class FormatError : public std::runtime_error {
+  public:
+    explicit FormatError(const std::string& msg);
+  };
+
+  /// The first 8 bytes of every index.
+  static constexpr std::string_view magic{"MCFXREF\0", 8};
+  static constexpr uint32_t version = 1;
+
+  // The size in bytes of each part of an index.
+  static constexpr size_t headerSize = magic.size() + 4 * sizeof(uint32_t);
+  static constexpr size_t fileRecordSize = 2 * sizeof(uint32_t);
+  static constexpr size_t nameRecordSize = 4 * sizeof(uint32_t);
+  static constexpr size_t entryRecordSize = 3 * sizeof(uint32_t);
+
+public:
+  /// Opens the index at \param path (memory mapping it if it's on the disk).
+  /// Only the header is read, everything else is read as it's searched.
+  /// \throws compile_error::CouldntOpenFile if the file can't be opened.
+  /// \throws XrefIndex::FormatError if the file isn't an index.
+  explicit XrefIndex(const std::filesystem::path& path);
+
+  ~XrefIndex();
+
+  XrefIndex(const XrefIndex&) = delete;
+  XrefIndex& operator=(const XrefIndex&) = delete;
+
+  size_t fileCount() const;
+
+  /// The path of the source file at \param index (sorted).
+  /// \throws XrefIndex::FormatError if the index is corrupt.
+  std::string_view filePath(size_t index) const;
+
+  size_t nameCount() const;
+
+  /// The name at \param index (sorted).
+  /// \throws XrefIndex::FormatError if the index is corrupt.
+  std::string_view name(size_t index) const;
+
+  /// Every entry for \param name (binary searched).
+  /// \throws XrefIndex::FormatError if the index is corrupt.
+  std::vector<Entry> find(std::string_view name) const;
+
+  /// Every entry of the kind \param kind for \param name (binary searched).
+  /// \throws XrefIndex::FormatError if the index is corrupt.
+  std::vector<Entry> find(std::string_view name, Kind kind) const;
+
+  /// A printable name for \param kind (e.g. "call").
+  static const char* kindName(Kind kind);
+
+private:
+  /// The number at \param offset in the index.
+  uint32_t readU32(size_t offset) const;
+
+  /// The string at \param offset and \param length in the strings section.
+  std::string_view readString(uint32_t offset, uint32_t length) const;
+
+  /// The entry at \param index .
+  Entry readEntry(size_t index) const;
+
+  /// The index of \param name in the names table (or \p nameCount() if it
+  /// isn't there).
+  size_t findName(std::string_view name) const;
+
+private:
+  /// Only used if the index wasn't memory mapped.
+  std::string m_contents;
+  /// The start of the memory mapping (or \p nullptr ).
+  void* m_mapping = nullptr;
+  const char* m_data = nullptr;
+  size_t m_size = 0;
+
+  uint32_t m_fileCount = 0;
+  uint32_t m_nameCount = 0;
+  uint32_t m_entryCount = 0;
+  size_t m_namesOffset = 0;
+  size_t m_entriesOffset = 0;
+  size_t m_stringsOffset = 0;
+};
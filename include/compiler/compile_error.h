@@ -2,6 +2,7 @@
 /// \file Holds the \p compile_error namespace which contains exceptions that
 /// can be thrown during compilation to stop the process.
 
+#include <cstddef>
 #include <exception>
 #include <filesystem>
 #include <string>
@@ -26,7 +27,8 @@
 /// │   ├── \p NameError
 /// │   └── \p UnresolvedSymbol
 /// │   ├── \p SharedFuncTagParseError
-/// └── \p DeclarationConflict
+/// ├── \p DeclarationConflict
+/// └── \p TickBudgetExceeded
 ///
 /// A newline is added to the end of all \p msg parameters.
 namespace compile_error {
@@ -40,8 +42,31 @@ public:
   /// Returns an error message.
   virtual const char* what() const noexcept override;
 
+  /// The error message on its own (without a "Compilation Error: " prefix or
+  /// the highlighted code).
+  const std::string& message() const;
+
+  /// The file the error is in (empty if the error isn't tied to a file).
+  const std::filesystem::path& filePath() const;
+
+  /// The line and column the error is at (starting at 1). They're 0 if the
+  /// error isn't tied to a spot in a file (or if the file can't be read).
+  size_t line() const;
+  size_t column() const;
+
+protected:
+  /// Sets what \p message() , \p filePath() , \p line() , and \p column()
+  /// return. The line and column are found from \param indexInFile (when it
+  /// isn't \p std::string::npos ).
+  void setDetails(const std::string& message, const std::filesystem::path& filePath = "",
+                  size_t indexInFile = std::string::npos);
+
 protected:
   std::string m_msg;
+  std::string m_message;
+  std::filesystem::path m_filePath;
+  size_t m_line = 0;
+  size_t m_column = 0;
 };
 
 /// Throw when something fails during code (data pack) generation.
@@ -51,10 +76,12 @@ public:
   explicit CodeGenFailure(const std::string& msg);
 };
 
-/// Throw when no namespace is ever exposed after linking.
+/// Throw when no namespace is ever exposed after linking (or when a source file
+/// isn't in a directory that any of the exposed namespaces cover).
 class NoExposedNamespace : public Generic {
 public:
   explicit NoExposedNamespace();
+  explicit NoExposedNamespace(const std::filesystem::path& filePath);
 };
 
 /// Throw when an attempt to open a file fails.
@@ -128,4 +155,12 @@ public:
   explicit DeclarationConflict(const std::string& msg, const Token& token1, const Token& token2);
 };
 
+/// Throw when the estimated cost of a tick is more than the budget given with
+/// '--max-tick-commands'.
+class TickBudgetExceeded : public Generic {
+public:
+  /// \param report A human readable report of where the cost comes from.
+  explicit TickBudgetExceeded(size_t estimatedCost, size_t budget, const std::string& report);
+};
+
 } // namespace compile_error
@@ -0,0 +1,12 @@
+#pragma once
+/// \file Has \p fnv1aHash for hashing file contents and other text.
+
+#include <cstdint>
+#include <string_view>
+
+/// The value a 64-bit FNV-1a hash starts at.
+constexpr uint64_t fnv1aHashStart = 0xcbf29ce484222325;
+
+/// Returns the 64-bit FNV-1a hash of \param data . Pass the hash of earlier
+/// data as \param hash to hash several pieces of data together.
+uint64_t fnv1aHash(std::string_view data, uint64_t hash = fnv1aHashStart);
@@ -0,0 +1,63 @@
+#pragma once
+/// \file Contains the \p BuildStamp class.
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+/// A record of a finished build (written to a file in the output directory) so
+/// that a build with nothing to do can exit without compiling anything. A build
+/// has nothing to do if the compiler version and the arguments are the same as
+/// last time, and none of the input or output files were added, removed, or
+/// changed size or modification time since then.
+class BuildStamp {
+public:
+  /// The name of the stamp file in the output directory.
+  static constexpr const char* fileName = ".mcfunc_stamp";
+
+public:
+  /// Looks at the size and modification time of every file in \param inputPaths
+  /// (in parallel). \param key should identify everything other than the input
+  /// files that affects the build (see \p keyFromArgs() ).
+  BuildStamp(std::string&& key, std::vector<std::filesystem::path>&& inputPaths);
+
+  /// If the stamp file at \param stampPath was written by a build with the
+  /// same key and files, returns what that build printed. Returns
+  /// \p std::nullopt if a new build is needed (or the stamp file can't be
+  /// read).
+  std::optional<std::string> messagesIfUpToDate(const std::filesystem::path& stampPath) const;
+
+  /// Writes the stamp file to \param stampPath after a successful build that
+  /// wrote \param outputPaths (absolute paths) and printed \param messages .
+  /// Failing to write the stamp file isn't an error (the next build just can't
+  /// be skipped).
+  void write(const std::filesystem::path& stampPath,
+             const std::vector<std::filesystem::path>& outputPaths,
+             const std::string& messages) const;
+
+  /// A key made from the compiler version, the working directory, and every
+  /// argument.
+  static std::string keyFromArgs(int argc, const char** argv);
+
+private:
+  struct FileStat {
+    bool exists = false;
+    uintmax_t size = 0;
+    int64_t lastWriteTime = 0;
+
+    bool operator==(const FileStat& other) const;
+  };
+
+  /// Gets the stat of every file in \param paths , splitting the work across
+  /// threads when there are a lot of files (see \p runInParallel() ).
+  static std::vector<FileStat> statFiles(const std::vector<std::filesystem::path>& paths);
+
+  static FileStat statFile(const std::filesystem::path& path);
+
+private:
+  std::string m_key;
+  std::vector<std::filesystem::path> m_inputPaths;
+  std::vector<FileStat> m_inputStats;
+};
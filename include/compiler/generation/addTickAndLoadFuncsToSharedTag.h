@@ -7,8 +7,12 @@
 
 /// Enters the shared namespace (usually "minecraft") and writes to the function
 /// tags, modifying what's there if they already exist (preserving what's there
-/// from other namespaces).
+/// from namespaces that aren't in \param exposedNamespaces ).
 void addTickAndLoadFuncsToSharedTag(const std::filesystem::path& outputDirectory,
                                     const std::vector<std::string>& tickFuncCallNames,
                                     const std::vector<std::string>& loadFuncCallNames,
-                                    const std::string& exposedNamespace);
+                                    const std::vector<std::string>& exposedNamespaces);
+
+/// Returns the contents of a function tag file that lists \param callNames (in
+/// the same format \p addTickAndLoadFuncsToSharedTag() writes).
+std::string funcTagFileContents(const std::vector<std::string>& callNames);
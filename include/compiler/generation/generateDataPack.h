@@ -1,13 +1,44 @@
 #pragma once
 /// \file Contains the \p generateDataPack function.
 
+#include <cstddef>
 #include <filesystem>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+/// Writes \param fileWriteMap into the data pack at \param outputDirectory and
+/// copies the files in \param fileCopyMap into it, replacing the directories
+/// of every namespace in \param exposedNamespaces (and their hidden
+/// namespaces).
 void generateDataPack(const std::filesystem::path& outputDirectory,
-                      const std::string& exposedNamespace,
+                      const std::vector<std::string>& exposedNamespaces,
                       const std::unordered_map<std::filesystem::path, std::string>& fileWriteMap,
+                      const std::unordered_map<std::filesystem::path, std::filesystem::path>&
+                          fileCopyMap,
                       bool clearOutputDirectory, const std::vector<std::string>& tickFuncCallNames,
                       const std::vector<std::string>& loadFuncCallNames);
+
+/// Every file (relative to the output directory) that \p generateDataPack()
+/// writes given \param fileWriteMap and \param fileCopyMap , including the
+/// function tags.
+std::vector<std::filesystem::path> dataPackFilePaths(
+    const std::unordered_map<std::filesystem::path, std::string>& fileWriteMap,
+    const std::unordered_map<std::filesystem::path, std::filesystem::path>& fileCopyMap);
+
+/// Updates a data pack that was last written with \param previousFileWriteMap
+/// and \param previousFileCopyMap so that it matches \param fileWriteMap and
+/// \param fileCopyMap. Only files with different contents are written, files
+/// are only copied again if their source changed (or is in
+/// \param changedCopySources ), and files that aren't in either map anymore are
+/// removed. Returns the number of files that were written, copied or removed.
+/// \note Function tags aren't touched (see
+/// \p addTickAndLoadFuncsToSharedTag() ).
+size_t updateDataPack(
+    const std::filesystem::path& outputDirectory,
+    const std::unordered_map<std::filesystem::path, std::string>& previousFileWriteMap,
+    const std::unordered_map<std::filesystem::path, std::string>& fileWriteMap,
+    const std::unordered_map<std::filesystem::path, std::filesystem::path>& previousFileCopyMap,
+    const std::unordered_map<std::filesystem::path, std::filesystem::path>& fileCopyMap,
+    const std::set<std::filesystem::path>& changedCopySources);
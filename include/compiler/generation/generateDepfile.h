@@ -0,0 +1,17 @@
+#pragma once
+/// \file Contains the \p generateDepfile function.
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/// Generates a dependency file (in the syntax Make and Ninja understand) that
+/// says \param targets depend on \param inputPaths . Every input directory in
+/// \param inputDirectories (and every directory under one that has an input
+/// file in it) is a dependency too so that adding or removing a file causes a
+/// rebuild. Each dependency also gets an empty rule so that removing it isn't
+/// an error (like 'gcc -MP'). Paths inside the working directory are written
+/// relative to it.
+std::string generateDepfile(const std::vector<std::filesystem::path>& targets,
+                            const std::vector<std::filesystem::path>& inputPaths,
+                            const std::vector<std::filesystem::path>& inputDirectories);
@@ -0,0 +1,11 @@
+#pragma once
+/// \file Contains the \p generateXrefIndex function.
+
+#include <string>
+
+#include <compiler/SourceFiles.h>
+
+/// Generates a cross-reference index (see \p XrefIndex for the format) of
+/// every function definition, function declaration, function call, file write,
+/// and import in \param sourceFiles (which have to be analyzed).
+std::string generateXrefIndex(const SourceFiles& sourceFiles);
@@ -1,5 +1,6 @@
 #pragma once
-/// \file Contains the \p writeFileToDataPack function.
+/// \file Contains the \p writeFileToDataPack and \p copyFileToDataPack
+/// functions.
 
 #include <filesystem>
 #include <string>
@@ -13,3 +14,9 @@
 void writeFileToDataPack(const std::filesystem::path& outputDir,
                                 const std::filesystem::path& outputPath,
                                 const std::string& contents);
+
+/// The same as \p writeFileToDataPack() except the new file is a byte for byte
+/// copy of the file at \param sourcePath (see \p vfs::copyFile() ).
+void copyFileToDataPack(const std::filesystem::path& outputDir,
+                        const std::filesystem::path& outputPath,
+                        const std::filesystem::path& sourcePath);
@@ -0,0 +1,85 @@
+#pragma once
+/// \file Holds the \p json namespace which contains a small JSON reader and
+/// helpers for writing JSON (for the files the compiler writes and reads back).
+
+#include <cstddef>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace json {
+
+/// Thrown by \p json::parse() when the text isn't valid JSON.
+class ParseError : public std::runtime_error {
+public:
+  ParseError(const std::string& msg, size_t index);
+
+  /// The index in the text where the error was found.
+  size_t index() const;
+
+private:
+  size_t m_index;
+};
+
+/// A parsed JSON value.
+class Value {
+public:
+  enum class Kind { NULL_VALUE, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+public:
+  /// Creates a \p NULL_VALUE value.
+  Value();
+  explicit Value(bool boolValue);
+  explicit Value(double numberValue);
+  explicit Value(std::string&& stringValue);
+  explicit Value(std::vector<Value>&& arrayValue);
+  explicit Value(std::map<std::string, Value>&& objectValue);
+
+  Kind kind() const;
+
+  bool isNull() const;
+  bool isBool() const;
+  bool isNumber() const;
+  bool isString() const;
+  bool isArray() const;
+  bool isObject() const;
+
+  /// Only call for \p BOOL values.
+  bool asBool() const;
+
+  /// Only call for \p NUMBER values.
+  double asNumber() const;
+
+  /// Only call for \p STRING values.
+  const std::string& asString() const;
+
+  /// Only call for \p ARRAY values.
+  const std::vector<Value>& asArray() const;
+
+  /// Only call for \p OBJECT values.
+  const std::map<std::string, Value>& asObject() const;
+
+  /// Returns the member \param key of an object, or a \p NULL_VALUE value if
+  /// this isn't an object or doesn't have that member.
+  const Value& operator[](const std::string& key) const;
+
+private:
+  Kind m_kind;
+  bool m_bool;
+  double m_number;
+  std::string m_string;
+  std::vector<Value> m_array;
+  std::map<std::string, Value> m_object;
+};
+
+/// Parses \param text as a single JSON value (surrounding whitespace is
+/// allowed).
+/// \throws json::ParseError if \param text isn't valid JSON.
+Value parse(const std::string& text);
+
+/// Returns \param str as a quoted JSON string (escaping anything that needs to
+/// be escaped).
+std::string quote(const std::string& str);
+
+} // namespace json
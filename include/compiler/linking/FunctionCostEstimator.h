@@ -0,0 +1,56 @@
+#pragma once
+/// \file Contains the \p FunctionCostEstimator class.
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/// Estimates how expensive it is to run a function from the linked contents of
+/// the function files in a file write map. The estimate is a number of commands
+/// where every command costs 1 plus the cost of any function it runs. What a
+/// command runs for each entity (e.g. 'execute as @e run ...') is multiplied by
+/// the number of entities the selector is guessed to match, and selectors that
+/// have to check every entity cost extra. Costs are cached, so the file write
+/// map shouldn't change while this object is used.
+class FunctionCostEstimator {
+public:
+  /// The number of entities '@a' is guessed to match.
+  static constexpr size_t playerCount = 8;
+  /// The number of entities '@e' with a 'type' argument is guessed to match.
+  static constexpr size_t typedEntityCount = 16;
+  /// The number of entities '@e' without a 'type' argument is guessed to match.
+  static constexpr size_t entityCount = 64;
+  /// The extra cost of a selector that has to check every entity ('@e' without
+  /// a 'type' or 'limit' argument).
+  static constexpr size_t unfilteredSelectorCost = 8;
+
+public:
+  /// \param fileWriteMap The linked file write map (paths start with the
+  /// namespace, like the map in \p LinkResult ).
+  FunctionCostEstimator(const std::unordered_map<std::filesystem::path, std::string>& fileWriteMap);
+
+  /// The estimated cost of running the function \param funcCallName (e.g.
+  /// "foo:bar"). Functions that aren't in the file write map (like ones from
+  /// other data packs) cost 1. Recursive calls back into a function that's
+  /// already being estimated cost nothing.
+  size_t functionCost(const std::string& funcCallName);
+
+  /// The estimated cost of running a single command (with any line
+  /// continuations removed).
+  size_t commandCost(const std::string& command);
+
+  /// The number of entities \param selector (e.g. "@e[type=pig]") is guessed
+  /// to match.
+  static size_t selectorEntityCount(const std::string& selector);
+
+  /// Whether \param selector has to check every entity.
+  static bool isUnfilteredSelector(const std::string& selector);
+
+private:
+  const std::unordered_map<std::filesystem::path, std::string>& m_fileWriteMap;
+  std::unordered_map<std::string, size_t> m_funcCosts;
+  std::unordered_set<std::string> m_funcsBeingEstimated;
+};
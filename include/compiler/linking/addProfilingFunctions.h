@@ -0,0 +1,22 @@
+#pragma once
+/// \file Contains the \p addProfilingFunctions function.
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <compiler/translation/CompiledSourceFile.h>
+
+/// Generates the functions and files that go with the counters '--instrument'
+/// adds to every function file (see \p CompiledSourceFile::FuncFileOrigin ).
+/// Everything is written into the hidden namespace:
+///  * A load function that creates the scoreboard the counters are stored on
+///    (added to the front of \param loadFuncCallNames ).
+///  * A function that prints every counter along with where it came from.
+///  * A function that resets every counter.
+///  * A JSON file that maps each counter to its source file, line and function.
+void addProfilingFunctions(const std::vector<CompiledSourceFile>& compiledSourceFiles,
+                           std::unordered_map<std::filesystem::path, std::string>& fileWriteMap,
+                           std::vector<std::string>& loadFuncCallNames,
+                           const std::string& exposedNamespace);
@@ -0,0 +1,24 @@
+#pragma once
+/// \file Contains the \p deduplicateFunctions function.
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// Finds function files in the hidden namespace that have the exact same
+/// contents and keeps only 1 of them, rewriting every call to the others so
+/// they call the one that's kept. This is repeated until no duplicates are left
+/// (rewriting calls can make more function files identical).
+///
+/// Functions in \param tickFuncCallNames and \param loadFuncCallNames are never
+/// removed because they're referenced from function tags (they can still
+/// replace other functions).
+///
+/// \param fileWriteMap The linked files to write (modified in place).
+/// \returns The number of function files that were removed.
+size_t deduplicateFunctions(std::unordered_map<std::filesystem::path, std::string>& fileWriteMap,
+                            const std::string& exposedNamespace,
+                            const std::vector<std::string>& tickFuncCallNames,
+                            const std::vector<std::string>& loadFuncCallNames);
@@ -0,0 +1,48 @@
+#pragma once
+/// \file Contains the \p estimateTickCost function and the \p TickCostReport
+/// type.
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <compiler/linking/scheduleTickFunctions.h>
+
+/// The estimated number of commands a data pack runs each tick (see
+/// \p FunctionCostEstimator for how commands are counted).
+struct TickCostReport {
+  struct FuncCost {
+    std::string funcCallName;
+    size_t estimatedCost;
+  };
+
+  /// Functions that run every tick, most expensive first.
+  std::vector<FuncCost> tickFuncCosts;
+
+  /// Functions that run on a schedule, most expensive first.
+  std::vector<ScheduledTickFunction> scheduledTickFuncs;
+
+  /// The cost of the commands that run on every tick (including the ones the
+  /// tick schedule function always runs).
+  size_t everyTickCost = 0;
+
+  /// The cost of the busiest tick (the cost of every tick plus the scheduled
+  /// functions on that tick).
+  size_t busiestTickCost = 0;
+
+  /// A human readable version of the report (ends with a newline).
+  std::string str() const;
+};
+
+/// Estimates the cost of every tick, starting from the functions in the
+/// \p minecraft:tick function tag (\param tickFuncCallNames ) and the scheduled
+/// tick functions (which should already have their phases set). The dispatcher
+/// for scheduled tick functions is counted by what it runs each tick rather
+/// than as a normal tick function.
+TickCostReport estimateTickCost(
+    const std::unordered_map<std::filesystem::path, std::string>& fileWriteMap,
+    const std::vector<std::string>& tickFuncCallNames,
+    const std::vector<ScheduledTickFunction>& scheduledTickFuncs,
+    const std::string& exposedNamespace);
@@ -0,0 +1,36 @@
+#pragma once
+/// \file Contains the \p generateSourceMap function.
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <compiler/translation/CompiledSourceFile.h>
+
+/// Returns a JSON source map that ties the call name of every function in
+/// \param fileWriteMap (e.g. "zzz__.foo:f_00000_0002b") to the source file,
+/// line, column and function it came from. Functions that the compiler
+/// generates itself (e.g. the tick schedule dispatcher) are listed with the
+/// kind "generated" and no source. \param fileWriteMap should be fully linked
+/// (so function files that were merged away aren't listed).
+///
+/// \param sourceFileNamespaces The namespace of each compiled source file
+/// (lines up with \param compiledSourceFiles ).
+/// \param exposedNamespaces Every namespace (the main one is 1st).
+///
+/// \code{.json}
+/// {
+///   "namespace": "foo",
+///   "namespaces": ["foo"],
+///   "functions": {
+///     "zzz__.foo:f_00000_0002b": {"kind": "function", "function": "bar",
+///                           "file": "src/main.mcfunc", "line": 3, "column": 6}
+///   }
+/// }
+/// \endcode
+std::string generateSourceMap(
+    const std::vector<CompiledSourceFile>& compiledSourceFiles,
+    const std::unordered_map<std::filesystem::path, std::string>& fileWriteMap,
+    const std::vector<std::string>& sourceFileNamespaces,
+    const std::vector<std::string>& exposedNamespaces);
@@ -4,37 +4,89 @@
 #include <filesystem>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+#include <compiler/CompileOptions.h>
 #include <compiler/FileWriteSourceFile.h>
+#include <compiler/linking/estimateTickCost.h>
+#include <compiler/linking/scheduleTickFunctions.h>
 #include <compiler/translation/CompiledSourceFile.h>
 
 struct LinkResult {
   std::unordered_map<std::filesystem::path, std::string> fileWriteMap;
+  /// Output path -> the file write source file that's copied there byte for
+  /// byte (file writes set to an import path rather than a snippet). These are
+  /// never function files.
+  std::unordered_map<std::filesystem::path, std::filesystem::path> fileCopyMap;
   std::vector<std::string> tickFuncCallNames;
   std::vector<std::string> loadFuncCallNames;
+  /// The main namespace (the one exposed from the highest directory). Functions
+  /// that the compiler generates itself (e.g. the tick schedule dispatcher) go
+  /// in it.
   std::string exposedNamespace;
+  /// Every namespace that was exposed (the main one is 1st).
+  std::vector<std::string> exposedNamespaces;
+  /// Tick functions that don't run every tick (they're run by a dispatcher
+  /// function that's in \p tickFuncCallNames ).
+  std::vector<ScheduledTickFunction> scheduledTickFuncs;
+  /// The estimated cost of each tick (only when
+  /// \p CompileOptions::reportTickCost or \p CompileOptions::maxTickCommands
+  /// is set).
+  TickCostReport tickCostReport;
+  /// The number of duplicate function files that were merged away (only when
+  /// \p CompileOptions::deduplicateFunctions is set).
+  size_t deduplicatedFunctionCount = 0;
+  /// A JSON map from every generated function to the code it came from (only
+  /// when \p CompileOptions::generateSourceMap is set).
+  std::string sourceMap;
+  /// Every file write source file that was read for a file write (sorted).
+  std::vector<std::filesystem::path> readFileWriteSourcePaths;
 };
 
-/// Merges all source files into a table of files to write.
+/// Merges all source files into a table of files to write. The source files are
+/// freed part way through to save memory.
 LinkResult link(std::vector<CompiledSourceFile>&& compiledSourceFiles, SourceFiles&& sourceFiles,
-                std::vector<FileWriteSourceFile>&& fileWriteSourceFiles);
+                std::vector<FileWriteSourceFile>&& fileWriteSourceFiles,
+                const CompileOptions& compileOptions);
+
+/// The same as the other overload except nothing that's passed in is changed or
+/// freed, so the same source files can be linked again after some of them are
+/// recompiled (e.g. by '--watch'). If \param importsToCheck isn't empty it
+/// lines up with \param sourceFiles and only the source files marked \p true
+/// have their calls to imported functions checked (the rest are assumed to be
+/// the same as the last time they were checked).
+LinkResult link(const std::vector<CompiledSourceFile>& compiledSourceFiles,
+                const SourceFiles& sourceFiles,
+                const std::vector<FileWriteSourceFile>& fileWriteSourceFiles,
+                const CompileOptions& compileOptions, const std::vector<bool>& importsToCheck = {});
+
+/// Replaces all unlinked text sections in unlinked text assuming
+/// \param funcCallStrings contains everything needed.
+std::string
+unlinkedTextToText(const UnlinkedText& unlinkedText, const std::string& exposedNamespace,
+                   const std::unordered_map<std::string, std::string>& funcCallStrings);
 
 // Things this functon will do:
 
 // Validation:
-//  * The namespace is exposed exactly once.
+//  * At least 1 namespace is exposed, no namespace is exposed twice, and no 2
+//    namespaces are exposed from the same directory.
+//  * Every source file belongs to a namespace (the one exposed from the closest
+//    directory above it).
 //  * For all source files ensure all unresolved functions are publicly declared
 //    in one of the imports.
 //  * Ensure matching functions in different files have matching qualifiers.
 //  * Ensure all public functons are defined exactly once.
 //  * Warn/error about private (local) functions shadowing public ones.
-//  * Ensure no exposed functions share the same expose path.
+//  * Ensure no exposed functions in the same namespace share the same expose
+//    path.
 //  * Ensure file writes don't write into the "function" directory.
 //  * Ensure all file writes are defined exactly once.
 
 // Symbol Validation:
-//  * Save the namespace.
-//  * Save an "call string" for all public functions.
+//  * Save the namespaces and the namespace of each source file.
+//  * Save an "call string" for all public functions (using the namespace of the
+//    file that defines them so calls between namespaces work).
 
 // Linking:
 // * Iterate through functions and transform them into file writes by filling in
@@ -42,5 +94,11 @@ LinkResult link(std::vector<CompiledSourceFile>&& compiledSourceFiles, SourceFil
 // * Create a final list of tick/load functions and store them in input order
 //   (should be in the order they are declared in the order that source files
 //   appear).
-// * Iterating through file writes and prepend the namespace to the path,
-//   resolve file writes that aren't sourced from a snippet.
+// * Iterating through file writes and prepend their namespace to the path,
+//   resolve the file write source files of file writes that aren't sourced
+//   from a snippet (they're copied, not read).
+// * Optionally generate the functions and map for '--instrument' counters.
+// * Generate a dispatcher for tick functions that don't run every tick.
+// * Optionally estimate the cost of each tick and enforce a budget.
+// * Optionally merge hidden function files with identical contents.
+// * Optionally generate a source map for every function file.
@@ -0,0 +1,43 @@
+#pragma once
+/// \file Contains the \p scheduleTickFunctions function.
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <compiler/TickSchedule.h>
+
+/// A tick function that doesn't run every tick (e.g. 'tick(spread 4)').
+struct ScheduledTickFunction {
+  std::string funcCallName;
+  TickSchedule tickSchedule;
+
+  /// Which of the function's \p tickSchedule.period ticks it runs on (set by
+  /// \p scheduleTickFunctions() ).
+  uint32_t phase = 0;
+
+  /// The estimated cost of running the function (set by
+  /// \p scheduleTickFunctions() ).
+  size_t estimatedCost = 0;
+};
+
+/// Picks the tick each scheduled tick function runs on and generates a
+/// dispatcher function (in the hidden namespace) that runs them. Functions with
+/// a \p SPREAD schedule are placed so that the estimated cost of the busiest
+/// tick is as low as possible. The dispatcher is added to \param fileWriteMap
+/// and \param tickFuncCallNames, and a function that creates the scoreboard it
+/// counts ticks with is added to the front of \param loadFuncCallNames.
+/// \param fileWriteMap should already be linked.
+void scheduleTickFunctions(std::vector<ScheduledTickFunction>& scheduledTickFuncs,
+                           std::unordered_map<std::filesystem::path, std::string>& fileWriteMap,
+                           std::vector<std::string>& tickFuncCallNames,
+                           std::vector<std::string>& loadFuncCallNames,
+                           const std::string& exposedNamespace);
+
+/// Returns the estimated cost of the busiest tick for \param scheduledTickFuncs
+/// (after \p scheduleTickFunctions() has set their phases). This doesn't
+/// include the cost of the dispatcher function itself.
+size_t busiestScheduledTickCost(const std::vector<ScheduledTickFunction>& scheduledTickFuncs);
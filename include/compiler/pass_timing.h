@@ -0,0 +1,75 @@
+#pragma once
+/// \file Times each pass of the compiler for '--time-passes'.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pass_timing {
+
+/// The parts of a build that are timed.
+enum class Pass {
+  TOKENIZE,
+  ANALYZE_SYNTAX,
+  TRANSLATE,
+  LINK,
+  ADD_TICK_AND_LOAD_FUNCS,
+  GENERATE_DATA_PACK,
+};
+
+enum class ReportFormat {
+  NONE,
+  TABLE,
+  JSON,
+};
+
+/// How \p report() formats the pass times. Nothing is timed unless this isn't
+/// \p ReportFormat::NONE .
+extern ReportFormat reportFormat;
+
+/// Adds the time between it being created and destroyed to a pass (along with
+/// the bytes and tokens it's told about). Timers can be nested, the time spent
+/// in an inner timer only counts for the inner timer's pass. Timers on
+/// different threads are added together. Does nothing if \p reportFormat is
+/// \p ReportFormat::NONE when it's created.
+class ScopedTimer {
+public:
+  explicit ScopedTimer(Pass pass);
+  ~ScopedTimer();
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+  /// Whether time is being recorded (so work that's only needed for the report
+  /// can be skipped).
+  bool isActive() const;
+
+  void addBytes(size_t bytes);
+  void addTokens(size_t tokens);
+
+private:
+  Pass m_pass;
+  bool m_isActive;
+  /// The timer this one is nested in (on the same thread).
+  ScopedTimer* m_parent = nullptr;
+
+  int64_t m_startWallNs = 0;
+  int64_t m_startCpuNs = 0;
+  /// Time spent in nested timers (not counted for this timer's pass).
+  int64_t m_childWallNs = 0;
+  int64_t m_childCpuNs = 0;
+
+  uint64_t m_bytes = 0;
+  uint64_t m_tokens = 0;
+};
+
+/// The span (first start to last end), busy time and CPU time (both added up
+/// across threads), the process's peak resident memory (when the pass last
+/// ended), bytes, and tokens of every pass, formatted according to
+/// \p reportFormat .
+std::string report();
+
+/// Forgets everything that's been recorded.
+void reset();
+
+} // namespace pass_timing
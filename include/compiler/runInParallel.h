@@ -0,0 +1,15 @@
+#pragma once
+/// \file Contains the \p runInParallel function.
+
+#include <cstddef>
+#include <functional>
+
+/// Calls \param task with every index from 0 up to (but not including)
+/// \param taskCount , spreading the calls across threads (this thread is used
+/// too). Threads take the next index one at a time, so earlier indices start
+/// first. At most 1 thread per core is used, and if there's a make jobserver an
+/// extra thread is only started once it has a token (see \p Jobserver ). A call
+/// made from inside of another call's \param task runs every task on the
+/// calling thread (so nested calls never use more threads than there are
+/// cores). \param task must not throw.
+void runInParallel(size_t taskCount, const std::function<void(size_t)>& task);
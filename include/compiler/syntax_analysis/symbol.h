@@ -8,6 +8,7 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include <compiler/TickSchedule.h>
 #include <compiler/UniqueID.h>
 #include <compiler/syntax_analysis/statement.h>
 #include <compiler/tokenization/Token.h>
@@ -41,6 +42,11 @@ public:
 
   const Token& tickKWToken() const;
 
+  /// How often the function runs (only for tick functions).
+  const TickSchedule& tickSchedule() const;
+
+  void setTickSchedule(const TickSchedule& tickSchedule);
+
   bool isLoadFunc() const;
 
   const Token& loadKWToken() const;
@@ -68,6 +74,7 @@ private:
   const Token* m_nameTokenPtr;
   const Token* m_publicTokenPtr;
   const Token* m_tickTokenPtr;
+  TickSchedule m_tickSchedule;
   const Token* m_loadTokenPtr;
   const Token* m_exposeAddressTokenPtr;
   std::filesystem::path m_exposeAddressPath;
@@ -163,6 +170,13 @@ public:
   /// \throws compile_error::Generic (or a subclass of it).
   void ensureTableIsEmpty() const;
 
+  /// Throws an error if any name in the table isn't in \param resolvedNames,
+  /// highlighting the first function call of an undefined function. Unlike
+  /// \p remove() and \p ensureTableIsEmpty() this doesn't change the table, so
+  /// the same names can be checked again later.
+  /// \throws compile_error::Generic (or a subclass of it).
+  void ensureAllNamesAreIn(const std::unordered_set<std::string>& resolvedNames) const;
+
   /// Enables iteration.
   auto begin() { return m_symbolNames.begin(); }
   auto begin() const { return m_symbolNames.cbegin(); }
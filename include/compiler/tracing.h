@@ -0,0 +1,92 @@
+#pragma once
+/// \file Records a timeline of what each thread was doing for '--trace' (in the
+/// Chrome trace event format, which can be opened with
+/// https://ui.perfetto.dev). Tracing is only compiled in when \p DO_TRACING is
+/// defined (the 'DO_TRACING' CMake option), otherwise every macro in this file
+/// compiles to nothing.
+
+#if defined(DO_TRACING)
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+/// Records a span named \p name (a string literal) from here to the end of the
+/// scope.
+#define TRACE_SPAN(name) tracing::Span TRACE_CONCAT(traceSpan_, __LINE__)(name)
+
+/// Like \p TRACE_SPAN() but \p detail (a string, e.g. a file path) is added to
+/// the span's name. \p detail is only evaluated if tracing is on.
+#define TRACE_SPAN_DETAIL(name, detail)                                                            \
+  tracing::Span TRACE_CONCAT(traceSpan_, __LINE__)(name, [&]() { return std::string(detail); })
+
+/// Whether spans are being recorded.
+#define TRACE_IS_ENABLED() tracing::isEnabled()
+
+/// Writes every span recorded so far to the trace file.
+#define TRACE_WRITE() tracing::write()
+
+/// Forgets every span recorded so far (spans are still recorded).
+#define TRACE_RESET() tracing::reset()
+
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_CONCAT_IMPL(a, b) a##b
+
+namespace tracing {
+
+/// Starts recording spans, to be written to \param outputPath . Should be
+/// called from the main thread.
+void start(std::filesystem::path&& outputPath);
+
+bool isEnabled();
+
+/// Writes every span recorded so far to the path given to \p start() (the
+/// file is replaced each time).
+/// \throws compile_error::Generic (or a subclass of it) if the file can't be
+/// written.
+void write();
+
+/// Forgets every span recorded so far and starts the timeline over (e.g. so
+/// that each rebuild in '--watch' gets its own trace). Should be called from
+/// the main thread while no other thread is recording spans.
+void reset();
+
+/// Stops recording spans and forgets every span recorded so far. Should be
+/// called from the main thread while no other thread is recording spans.
+void stop();
+
+/// Records the time between it being created and destroyed on the thread it
+/// was created on (use \p TRACE_SPAN() instead of this directly).
+class Span {
+public:
+  explicit Span(const char* name);
+
+  template <typename DetailFunc>
+  Span(const char* name, DetailFunc&& detailFunc) : Span(name) {
+    if (m_isActive)
+      m_detail = detailFunc();
+  }
+
+  ~Span();
+
+  Span(const Span&) = delete;
+  Span& operator=(const Span&) = delete;
+
+private:
+  const char* m_name;
+  std::string m_detail;
+  bool m_isActive;
+  int64_t m_startNs = 0;
+};
+
+} // namespace tracing
+
+#else
+
+#define TRACE_SPAN(name) ((void)0)
+#define TRACE_SPAN_DETAIL(name, detail) ((void)0)
+#define TRACE_IS_ENABLED() false
+#define TRACE_WRITE() ((void)0)
+#define TRACE_RESET() ((void)0)
+
+#endif
@@ -2,11 +2,13 @@
 /// \file Contains the \p CompiledSourceFile class and all of its related
 /// classes.
 
+#include <cstddef>
 #include <filesystem>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include <compiler/TickSchedule.h>
 #include <compiler/syntax_analysis/symbol.h>
 #include <compiler/tokenization/Token.h>
 
@@ -83,12 +85,39 @@ private:
 /// be retrieved through the source file reference that it holds.
 class CompiledSourceFile {
 public:
+  /// Where the code in a function file came from.
+  struct FuncFileOrigin {
+    enum class Kind { FUNCTION, SCOPE, EXECUTE_GROUP };
+
+    Kind kind;
+    /// The ID of the function file (e.g. "f_00000_0002b").
+    std::string fileID;
+    /// The source function the function file was generated from.
+    std::string funcName;
+    /// Where the function or scope starts in the source file.
+    size_t indexInFile;
+    /// Set from \p indexInFile once the whole file has been compiled (only
+    /// when \p CompileOptions::instrument or
+    /// \p CompileOptions::generateSourceMap is set, otherwise these are 0).
+    size_t line = 0;
+    size_t column = 0;
+
+    /// The name of the kind as it's written to maps (e.g. "execute group").
+    const char* kindName() const;
+  };
+
   struct FuncFileWrite {
     UnlinkedText unlinkedText;
     bool belongsInHiddenNamespace;
+    FuncFileOrigin origin;
   };
   using FileWriteMap = std::unordered_map<std::filesystem::path, FuncFileWrite>;
 
+  struct ScheduledTickFunc {
+    UnlinkedText funcCallName;
+    TickSchedule tickSchedule;
+  };
+
 public:
   CompiledSourceFile(SourceFile& sourceFile);
 
@@ -98,18 +127,28 @@ public:
   const SourceFile& sourceFile() const;
   SourceFile& sourceFile();
 
+  /// The path of the source file.
+  /// \note This does NOT rely on an existing source file, this is always safe.
+  const std::filesystem::path& sourceFilePath() const;
+
   const FileWriteMap& unlinkedFileWrites() const;
   FileWriteMap& unlinkedFileWrites();
 
   const std::vector<UnlinkedText>& tickFunctions() const;
   std::vector<UnlinkedText>& tickFunctions();
 
+  /// Tick functions that don't run every tick (e.g. 'tick(every 20)').
+  const std::vector<ScheduledTickFunc>& scheduledTickFunctions() const;
+  std::vector<ScheduledTickFunc>& scheduledTickFunctions();
+
   const std::vector<UnlinkedText>& loadFunctions() const;
   std::vector<UnlinkedText>& loadFunctions();
 
 private:
   SourceFile* m_sourceFile;
+  std::filesystem::path m_sourceFilePath;
   FileWriteMap m_unlinkedFileWriteMap;
   std::vector<UnlinkedText> m_tickFunctions;
+  std::vector<ScheduledTickFunc> m_scheduledTickFunctions;
   std::vector<UnlinkedText> m_loadFunctions;
 };
@@ -2,7 +2,8 @@
 /// \file Contains the \p compileSourceFile function that translates a source file into a
 /// compiled source file.
 
+#include <compiler/CompileOptions.h>
 #include <compiler/SourceFiles.h>
 #include <compiler/translation/CompiledSourceFile.h>
 
-CompiledSourceFile compileSourceFile(SourceFile& sourceFile);
+CompiledSourceFile compileSourceFile(SourceFile& sourceFile, const CompileOptions& compileOptions);
@@ -21,3 +21,31 @@ extern const std::filesystem::path tickFuncTagPath;
 
 /// The minecraft:load function tag file ("minecraft/tags/function/load.json").
 extern const std::filesystem::path loadFuncTagPath;
+
+/// The name of the generated function in the hidden namespace that runs tick
+/// functions with a schedule ("tick_schedule").
+extern const char* const tickScheduleFuncName;
+
+/// The name of the generated function in the hidden namespace that sets up the
+/// scoreboard for the tick schedule function ("tick_schedule_load").
+extern const char* const tickScheduleLoadFuncName;
+
+/// Appended to the hidden namespace to get the scoreboard objective that
+/// '--instrument' counters are stored on (".profile").
+extern const char* const profileObjectiveSuffix;
+
+/// The name of the generated function in the hidden namespace that creates the
+/// '--instrument' scoreboard ("profile_load").
+extern const char* const profileLoadFuncName;
+
+/// The name of the generated function in the hidden namespace that prints every
+/// '--instrument' counter ("profile_dump").
+extern const char* const profileDumpFuncName;
+
+/// The name of the generated function in the hidden namespace that resets every
+/// '--instrument' counter ("profile_reset").
+extern const char* const profileResetFuncName;
+
+/// The file in the hidden namespace that ties each '--instrument' counter back
+/// to its source ("profile_map.json").
+extern const char* const profileMapFileName;
@@ -0,0 +1,181 @@
+#pragma once
+/// \file A virtual file system that everything the compiler reads and writes
+/// goes through. Paths use the disk unless they're inside a directory that
+/// another file system is mounted at, so projects can be compiled from (and
+/// into) memory or from unsaved editor buffers laid over the disk.
+
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace vfs {
+
+/// A file found by \p FileSystem::listFiles() .
+struct DirectoryEntry {
+  std::filesystem::path path;
+  /// False for things like sockets (and broken symlinks on the disk).
+  bool isRegularFile;
+};
+
+/// Decides whether \p FileSystem::listFiles() lists a file or descends into a
+/// directory, given its path and whether it's a directory. It can be called
+/// from several threads at once.
+using ListFilter = std::function<bool(const std::filesystem::path& path, bool isDirectory)>;
+
+/// Somewhere files can be read from and written to. Paths given to a file
+/// system are always absolute and normal (even when it's mounted), and every
+/// method can be called from any thread. Nothing throws, failures return
+/// false.
+class FileSystem {
+public:
+  virtual ~FileSystem() = default;
+
+  /// Copies the contents of the regular file at \param path into
+  /// \param contents .
+  virtual bool readFile(const std::filesystem::path& path, std::string& contents) const = 0;
+
+  /// Creates or replaces the file at \param path (its parent directory must
+  /// already exist).
+  virtual bool writeFile(const std::filesystem::path& path, const std::string& contents) = 0;
+
+  virtual bool isRegularFile(const std::filesystem::path& path) const = 0;
+  virtual bool isDirectory(const std::filesystem::path& path) const = 0;
+
+  /// Creates \param path and any of its parent directories that don't exist.
+  virtual bool createDirectories(const std::filesystem::path& path) = 0;
+
+  /// Removes the file or directory (and everything in it) at \param path . It
+  /// isn't an error if there's nothing there.
+  virtual bool removeAll(const std::filesystem::path& path) = 0;
+
+  /// Adds every file inside of \param directory (and its sub-directories) to
+  /// \param entries , sorted by path. Files and directories that
+  /// \param filter rejects are skipped (the directories aren't read at all).
+  /// Fails if \param directory isn't a directory.
+  virtual bool listFiles(const std::filesystem::path& directory,
+                         std::vector<DirectoryEntry>& entries,
+                         const ListFilter& filter) const = 0;
+};
+
+/// The real file system. Directories are listed by several threads at once and
+/// the type of each entry comes from the directory itself where the platform
+/// allows it (so listing doesn't need a stat call for every file).
+class DiskFileSystem final : public FileSystem {
+public:
+  bool readFile(const std::filesystem::path& path, std::string& contents) const override;
+  bool writeFile(const std::filesystem::path& path, const std::string& contents) override;
+  bool isRegularFile(const std::filesystem::path& path) const override;
+  bool isDirectory(const std::filesystem::path& path) const override;
+  bool createDirectories(const std::filesystem::path& path) override;
+  bool removeAll(const std::filesystem::path& path) override;
+  bool listFiles(const std::filesystem::path& directory, std::vector<DirectoryEntry>& entries,
+                 const ListFilter& filter) const override;
+};
+
+/// Files that only exist in memory. Any directory that has a file in it
+/// exists (directories can also exist on their own).
+class MemoryFileSystem final : public FileSystem {
+public:
+  bool readFile(const std::filesystem::path& path, std::string& contents) const override;
+  bool writeFile(const std::filesystem::path& path, const std::string& contents) override;
+  bool isRegularFile(const std::filesystem::path& path) const override;
+  bool isDirectory(const std::filesystem::path& path) const override;
+  bool createDirectories(const std::filesystem::path& path) override;
+  bool removeAll(const std::filesystem::path& path) override;
+  bool listFiles(const std::filesystem::path& directory, std::vector<DirectoryEntry>& entries,
+                 const ListFilter& filter) const override;
+
+private:
+  /// Whether \param path is a directory (the mutex must be locked).
+  bool isDirectoryLocked(const std::filesystem::path& path) const;
+
+private:
+  mutable std::mutex m_mutex;
+  /// Sorted so that everything inside of a directory is next to each other.
+  std::map<std::filesystem::path, std::string> m_files;
+  std::set<std::filesystem::path> m_directories;
+};
+
+/// Lays one file system over another (e.g. unsaved editor buffers in memory
+/// over the disk). Files in the upper file system hide the ones at the same
+/// path in the lower one. Writes and removals only change the upper file
+/// system, so removing a file reveals the lower file system's version again.
+class OverlayFileSystem final : public FileSystem {
+public:
+  OverlayFileSystem(std::shared_ptr<FileSystem> upper, std::shared_ptr<FileSystem> lower);
+
+  bool readFile(const std::filesystem::path& path, std::string& contents) const override;
+  bool writeFile(const std::filesystem::path& path, const std::string& contents) override;
+  bool isRegularFile(const std::filesystem::path& path) const override;
+  bool isDirectory(const std::filesystem::path& path) const override;
+  bool createDirectories(const std::filesystem::path& path) override;
+  bool removeAll(const std::filesystem::path& path) override;
+  bool listFiles(const std::filesystem::path& directory, std::vector<DirectoryEntry>& entries,
+                 const ListFilter& filter) const override;
+
+private:
+  std::shared_ptr<FileSystem> m_upper;
+  std::shared_ptr<FileSystem> m_lower;
+};
+
+/// Makes \param fileSystem handle every path inside of \param directory (and
+/// \param directory itself) until it's destroyed. Nothing inside of a mount is
+/// ever read from or written to the disk (unless the mounted file system does
+/// that itself). When mounts are nested the innermost one is used, and a mount
+/// at a directory that's already mounted hides the old mount until it's
+/// destroyed (mounts at the same directory have to be destroyed in reverse
+/// order).
+class Mount {
+public:
+  Mount(const std::filesystem::path& directory, std::shared_ptr<FileSystem> fileSystem);
+
+  /// Mounts \param fileSystem at a new unique directory (in the temporary
+  /// directory) that nothing else uses.
+  explicit Mount(std::shared_ptr<FileSystem> fileSystem);
+
+  ~Mount();
+
+  Mount(const Mount&) = delete;
+  Mount& operator=(const Mount&) = delete;
+
+  /// The (absolute) directory this is mounted at.
+  const std::filesystem::path& path() const;
+
+private:
+  std::filesystem::path m_path;
+  /// What was mounted at \p m_path before this (null if nothing was).
+  std::shared_ptr<FileSystem> m_hiddenFileSystem;
+};
+
+/// The file system that handles \param path (the disk unless \param path is in
+/// a mounted directory).
+std::shared_ptr<FileSystem> fileSystemFor(const std::filesystem::path& path);
+
+/// Whether \param path is handled by the disk (isn't in a mounted directory).
+bool isOnDisk(const std::filesystem::path& path);
+
+// These call the matching method on the file system that handles the path. The
+// path can be relative to the working directory.
+
+bool readFile(const std::filesystem::path& path, std::string& contents);
+bool writeFile(const std::filesystem::path& path, const std::string& contents);
+bool isRegularFile(const std::filesystem::path& path);
+bool isDirectory(const std::filesystem::path& path);
+/// Whether there's a regular file or directory at \param path .
+bool exists(const std::filesystem::path& path);
+bool createDirectories(const std::filesystem::path& path);
+bool removeAll(const std::filesystem::path& path);
+bool listFiles(const std::filesystem::path& directory, std::vector<DirectoryEntry>& entries,
+               const ListFilter& filter = nullptr);
+
+/// Copies the file at \param from to \param to byte for byte (replacing it).
+/// When both are on the disk the kernel copies the data (sharing the file
+/// system blocks when it can), so the contents are never read into memory.
+bool copyFile(const std::filesystem::path& from, const std::filesystem::path& to);
+
+} // namespace vfs
@@ -0,0 +1,289 @@
+#include <capi/mcfunc.h>
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cli/style_text.h>
+#include <compiler/CompileOptions.h>
+#include <compiler/FileWriteSourceFile.h>
+#include <compiler/SourceFiles.h>
+#include <compiler/compile_error.h>
+#include <compiler/generation/addTickAndLoadFuncsToSharedTag.h>
+#include <compiler/linking/link.h>
+#include <compiler/translation/constants.h>
+#include <compiler/vfs.h>
+#include <version.h>
+
+struct mcfunc_project {
+  std::shared_ptr<vfs::MemoryFileSystem> files = std::make_shared<vfs::MemoryFileSystem>();
+  /// Where \p files can be found.
+  vfs::Mount root{files};
+  /// Relative paths in the order they were first added (source files are
+  /// compiled in this order).
+  std::vector<std::filesystem::path> filePaths;
+  CompileOptions compileOptions;
+};
+
+struct mcfunc_result {
+  struct Diagnostic {
+    std::string message;
+    std::string fullMessage;
+    std::string file;
+    size_t line = 0;
+    size_t column = 0;
+  };
+  struct Output {
+    std::string path;
+    std::string contents;
+  };
+
+  std::vector<Diagnostic> diagnostics;
+  std::vector<Output> outputs;
+};
+
+namespace {
+namespace helper {
+
+/// Converts \param path to a relative path inside of a project (or an empty
+/// path if it's absolute or leaves the project).
+static std::filesystem::path projectPath(const char* path);
+
+/// Compiles \param project into \param result , throwing on failure.
+static void compile(const mcfunc_project& project, mcfunc_result& result);
+
+/// Removes any outputs from \param result and gives it \param diagnostic .
+static void fail(mcfunc_result& result, mcfunc_result::Diagnostic diagnostic);
+
+/// A diagnostic for an unexpected error (not a problem with the project) with
+/// \param message .
+static mcfunc_result::Diagnostic internalError(const char* message);
+
+} // namespace helper
+} // namespace
+
+int mcfunc_api_version(void) { return MCFUNC_API_VERSION; }
+
+const char* mcfunc_version(void) { return MCFUNC_VERSION; }
+
+void mcfunc_set_color(int enabled) { style_text::doColor = (enabled != 0); }
+
+mcfunc_project* mcfunc_project_create(void) {
+  try {
+    return new mcfunc_project();
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void mcfunc_project_destroy(mcfunc_project* project) { delete project; }
+
+mcfunc_status mcfunc_project_add_file(mcfunc_project* project, const char* path,
+                                      const char* contents, size_t size) {
+  if (!project || !path || (!contents && size != 0))
+    return MCFUNC_INVALID_ARGUMENT;
+
+  try {
+    const std::filesystem::path filePath = helper::projectPath(path);
+    if (filePath.empty())
+      return MCFUNC_INVALID_ARGUMENT;
+
+    const std::filesystem::path fullPath = project->root.path() / filePath;
+    if (!project->files->createDirectories(fullPath.parent_path()) ||
+        !project->files->writeFile(fullPath, std::string(contents, size)))
+      return MCFUNC_INVALID_ARGUMENT; // e.g. a file is already where a directory would be
+    if (std::find(project->filePaths.begin(), project->filePaths.end(), filePath) ==
+        project->filePaths.end())
+      project->filePaths.push_back(filePath);
+    return MCFUNC_OK;
+  } catch (...) {
+    return MCFUNC_INTERNAL_ERROR;
+  }
+}
+
+mcfunc_status mcfunc_project_remove_file(mcfunc_project* project, const char* path) {
+  if (!project || !path)
+    return MCFUNC_INVALID_ARGUMENT;
+
+  try {
+    const std::filesystem::path filePath = helper::projectPath(path);
+    const auto it = std::find(project->filePaths.begin(), project->filePaths.end(), filePath);
+    if (filePath.empty() || it == project->filePaths.end())
+      return MCFUNC_INVALID_ARGUMENT;
+
+    project->files->removeAll(project->root.path() / filePath);
+    project->filePaths.erase(it);
+    return MCFUNC_OK;
+  } catch (...) {
+    return MCFUNC_INTERNAL_ERROR;
+  }
+}
+
+mcfunc_status mcfunc_project_set_option(mcfunc_project* project, mcfunc_option option,
+                                        size_t value) {
+  if (!project)
+    return MCFUNC_INVALID_ARGUMENT;
+
+  CompileOptions& compileOptions = project->compileOptions;
+  switch (option) {
+  case MCFUNC_OPTION_INLINE_TRIVIAL_SCOPES:
+    compileOptions.inlineTrivialScopes = (value != 0);
+    return MCFUNC_OK;
+  case MCFUNC_OPTION_DEDUPLICATE_FUNCTIONS:
+    compileOptions.deduplicateFunctions = (value != 0);
+    return MCFUNC_OK;
+  case MCFUNC_OPTION_FACTOR_EXECUTE_PREFIXES:
+    compileOptions.factorExecutePrefixes = (value != 0);
+    return MCFUNC_OK;
+  case MCFUNC_OPTION_MAX_TICK_COMMANDS:
+    compileOptions.maxTickCommands = value;
+    return MCFUNC_OK;
+  case MCFUNC_OPTION_INSTRUMENT:
+    compileOptions.instrument = (value != 0);
+    return MCFUNC_OK;
+  }
+  return MCFUNC_INVALID_ARGUMENT;
+}
+
+mcfunc_result* mcfunc_compile(const mcfunc_project* project) {
+  if (!project)
+    return nullptr;
+
+  mcfunc_result* result;
+  try {
+    result = new mcfunc_result();
+  } catch (...) {
+    return nullptr;
+  }
+
+  try {
+    try {
+      helper::compile(*project, *result);
+    } catch (const compile_error::Generic& e) {
+      mcfunc_result::Diagnostic diagnostic;
+      diagnostic.message = e.message();
+      diagnostic.fullMessage = e.what();
+      if (!e.filePath().empty())
+        diagnostic.file = e.filePath().lexically_relative(project->root.path()).generic_string();
+      diagnostic.line = e.line();
+      diagnostic.column = e.column();
+      helper::fail(*result, std::move(diagnostic));
+    } catch (const std::exception& e) {
+      helper::fail(*result, helper::internalError(e.what()));
+    } catch (...) {
+      helper::fail(*result, helper::internalError("Unknown error."));
+    }
+    return result;
+
+  } catch (...) { // the diagnostic couldn't be allocated
+    delete result;
+    return nullptr;
+  }
+}
+
+void mcfunc_result_destroy(mcfunc_result* result) { delete result; }
+
+int mcfunc_result_succeeded(const mcfunc_result* result) {
+  return (result && result->diagnostics.empty()) ? 1 : 0;
+}
+
+size_t mcfunc_result_diagnostic_count(const mcfunc_result* result) {
+  return (result) ? result->diagnostics.size() : 0;
+}
+
+mcfunc_status mcfunc_result_diagnostic(const mcfunc_result* result, size_t index,
+                                       mcfunc_diagnostic* diagnostic) {
+  if (!result || !diagnostic || index >= result->diagnostics.size())
+    return MCFUNC_INVALID_ARGUMENT;
+
+  const mcfunc_result::Diagnostic& found = result->diagnostics[index];
+  diagnostic->message = found.message.c_str();
+  diagnostic->full_message = found.fullMessage.c_str();
+  diagnostic->file = found.file.c_str();
+  diagnostic->line = found.line;
+  diagnostic->column = found.column;
+  return MCFUNC_OK;
+}
+
+size_t mcfunc_result_output_count(const mcfunc_result* result) {
+  return (result) ? result->outputs.size() : 0;
+}
+
+mcfunc_status mcfunc_result_output(const mcfunc_result* result, size_t index,
+                                   mcfunc_output* output) {
+  if (!result || !output || index >= result->outputs.size())
+    return MCFUNC_INVALID_ARGUMENT;
+
+  const mcfunc_result::Output& found = result->outputs[index];
+  output->path = found.path.c_str();
+  output->contents = found.contents.c_str();
+  output->size = found.contents.size();
+  return MCFUNC_OK;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static std::filesystem::path helper::projectPath(const char* path) {
+  const std::filesystem::path ret = std::filesystem::path(path).lexically_normal();
+  if (ret.empty() || ret.is_absolute() || ret.has_root_name() || *ret.begin() == ".." ||
+      ret == "." || !ret.has_filename())
+    return std::filesystem::path();
+  return ret;
+}
+
+static void helper::compile(const mcfunc_project& project, mcfunc_result& result) {
+  const std::filesystem::path& rootPath = project.root.path();
+
+  SourceFiles sourceFiles;
+  std::vector<FileWriteSourceFile> fileWriteSourceFiles;
+  for (const std::filesystem::path& filePath : project.filePaths) {
+    if (filePath.extension() == ".mcfunc")
+      sourceFiles.emplace_back(rootPath / filePath, rootPath);
+    else
+      fileWriteSourceFiles.emplace_back(rootPath / filePath, rootPath);
+  }
+
+  LinkResult linkResult =
+      link(sourceFiles.evaluateAll(project.compileOptions), std::move(sourceFiles),
+           std::move(fileWriteSourceFiles), project.compileOptions);
+
+  // the function tags are written by every build (see 'generateDataPack()')
+  result.outputs.reserve(linkResult.fileWriteMap.size() + linkResult.fileCopyMap.size() + 2);
+  result.outputs.push_back(
+      {tickFuncTagPath.generic_string(), funcTagFileContents(linkResult.tickFuncCallNames)});
+  result.outputs.push_back(
+      {loadFuncTagPath.generic_string(), funcTagFileContents(linkResult.loadFuncCallNames)});
+  for (auto& [outputPath, contents] : linkResult.fileWriteMap)
+    result.outputs.push_back({outputPath.generic_string(), std::move(contents)});
+
+  // results are returned in memory so copied files have to be read
+  for (const auto& [outputPath, sourcePath] : linkResult.fileCopyMap) {
+    std::string contents;
+    if (!vfs::readFile(sourcePath, contents))
+      throw compile_error::CouldntOpenFile(sourcePath);
+    result.outputs.push_back({outputPath.generic_string(), std::move(contents)});
+  }
+
+  std::sort(result.outputs.begin(), result.outputs.end(),
+            [](const mcfunc_result::Output& a, const mcfunc_result::Output& b) {
+              return a.path < b.path;
+            });
+}
+
+static void helper::fail(mcfunc_result& result, mcfunc_result::Diagnostic diagnostic) {
+  result.outputs.clear();
+  result.diagnostics.push_back(std::move(diagnostic));
+}
+
+static mcfunc_result::Diagnostic helper::internalError(const char* message) {
+  mcfunc_result::Diagnostic diagnostic;
+  diagnostic.message = message;
+  diagnostic.fullMessage = style_text::styleAsError("Internal Error: ") + message + '\n';
+  return diagnostic;
+}
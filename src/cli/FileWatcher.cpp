@@ -0,0 +1,205 @@
+#include <cli/FileWatcher.h>
+
+#include <system_error>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstdint>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+#if defined(__linux__)
+
+/// How long to keep waiting for more changes after one is seen (ms).
+static constexpr int debounceTimeMs = 15;
+
+/// The inotify events that mean a file was changed, added, or removed.
+static constexpr uint32_t watchMask =
+    IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE;
+
+FileWatcher::FileWatcher(const std::vector<std::filesystem::path>& files,
+                         const std::vector<std::filesystem::path>& directories)
+    : m_inotifyFD(inotify_init1(IN_CLOEXEC)), m_files(files.begin(), files.end()) {
+  if (m_inotifyFD < 0)
+    throw std::system_error(errno, std::generic_category(), "Couldn't start inotify");
+
+  for (const std::filesystem::path& directory : directories)
+    addDirectoryWatch(directory, true);
+
+  // files are watched through the directory they're in
+  for (const std::filesystem::path& file : files)
+    addDirectoryWatch(file.parent_path(), false);
+}
+
+FileWatcher::~FileWatcher() { close(m_inotifyFD); }
+
+std::vector<std::filesystem::path> FileWatcher::waitForChanges() {
+  std::unordered_set<std::filesystem::path> changedPaths;
+
+  // events for files in a directory that aren't watched are skipped
+  while (changedPaths.empty())
+    readEvents(changedPaths, -1);
+  while (readEvents(changedPaths, debounceTimeMs)) {
+  }
+
+  return std::vector<std::filesystem::path>(changedPaths.begin(), changedPaths.end());
+}
+
+void FileWatcher::addDirectoryWatch(const std::filesystem::path& directory, bool recursive) {
+  const int watchDescriptor = inotify_add_watch(m_inotifyFD, directory.c_str(), watchMask);
+  if (watchDescriptor < 0) {
+    // it may have been removed since we found it
+    if (errno == ENOENT || errno == ENOTDIR)
+      return;
+    throw std::system_error(errno, std::generic_category(),
+                            "Couldn't watch directory '" + directory.string() + "'");
+  }
+
+  // the same directory can be added for a file and as an input directory
+  WatchedDirectory& watchedDirectory = m_watchedDirectories[watchDescriptor];
+  watchedDirectory.path = directory;
+  watchedDirectory.recursive = watchedDirectory.recursive || recursive;
+
+  if (!recursive)
+    return;
+
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+    if (entry.is_directory(ec) && !entry.is_symlink(ec))
+      addDirectoryWatch(entry.path(), true);
+  }
+}
+
+bool FileWatcher::readEvents(std::unordered_set<std::filesystem::path>& changedPaths,
+                             int timeoutMs) {
+  pollfd pollFD = {m_inotifyFD, POLLIN, 0};
+  const int pollResult = poll(&pollFD, 1, timeoutMs);
+  if (pollResult < 0 && errno != EINTR)
+    throw std::system_error(errno, std::generic_category(), "Couldn't wait for file changes");
+  if (pollResult <= 0)
+    return false;
+
+  alignas(inotify_event) char buffer[4096];
+  const ssize_t bytesRead = read(m_inotifyFD, buffer, sizeof(buffer));
+  if (bytesRead < 0) {
+    if (errno == EINTR || errno == EAGAIN)
+      return false;
+    throw std::system_error(errno, std::generic_category(), "Couldn't read file changes");
+  }
+
+  for (ssize_t i = 0; i < bytesRead;) {
+    const auto* event = reinterpret_cast<const inotify_event*>(buffer + i);
+    i += sizeof(inotify_event) + event->len;
+
+    // Too many events happened to keep track of them, so every watched
+    // directory is reported (which causes a full rebuild).
+    if (event->mask & IN_Q_OVERFLOW) {
+      for (const auto& [_, watchedDirectory] : m_watchedDirectories)
+        changedPaths.insert(watchedDirectory.path);
+      continue;
+    }
+
+    const auto it = m_watchedDirectories.find(event->wd);
+    if (it == m_watchedDirectories.end())
+      continue;
+    if (event->mask & IN_IGNORED) {
+      m_watchedDirectories.erase(it);
+      continue;
+    }
+    if (event->len == 0)
+      continue;
+
+    const WatchedDirectory& watchedDirectory = it->second;
+    std::filesystem::path path = watchedDirectory.path / event->name;
+
+    if (!watchedDirectory.recursive && !m_files.count(path))
+      continue;
+
+    if (watchedDirectory.recursive && (event->mask & IN_ISDIR) &&
+        (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+      addDirectoryWatch(path, true);
+    }
+
+    changedPaths.insert(std::move(path));
+  }
+
+  return true;
+}
+
+#else
+
+/// How often every file is checked for changes (ms).
+static constexpr int pollIntervalMs = 100;
+
+FileWatcher::FileWatcher(const std::vector<std::filesystem::path>& files,
+                         const std::vector<std::filesystem::path>& directories)
+    : m_directories(directories), m_files(files.begin(), files.end()) {
+  m_snapshot = takeSnapshot();
+}
+
+FileWatcher::~FileWatcher() = default;
+
+std::vector<std::filesystem::path> FileWatcher::waitForChanges() {
+  std::vector<std::filesystem::path> ret;
+
+  while (ret.empty()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(pollIntervalMs));
+    std::unordered_map<std::filesystem::path, FileStamp> snapshot = takeSnapshot();
+
+    for (const auto& [path, stamp] : snapshot) {
+      const auto it = m_snapshot.find(path);
+      if (it == m_snapshot.end() || !(it->second == stamp))
+        ret.push_back(path);
+    }
+    for (const auto& [path, _] : m_snapshot) {
+      if (!snapshot.count(path))
+        ret.push_back(path);
+    }
+
+    m_snapshot = std::move(snapshot);
+  }
+
+  return ret;
+}
+
+bool FileWatcher::FileStamp::operator==(const FileStamp& other) const {
+  return lastWriteTime == other.lastWriteTime && size == other.size;
+}
+
+std::unordered_map<std::filesystem::path, FileWatcher::FileStamp>
+FileWatcher::takeSnapshot() const {
+  std::unordered_map<std::filesystem::path, FileStamp> ret;
+  std::error_code ec;
+
+  const auto addStamp = [&ret](const std::filesystem::path& path) {
+    std::error_code ec;
+    const std::filesystem::file_time_type lastWriteTime =
+        std::filesystem::last_write_time(path, ec);
+    if (ec)
+      return;
+    const uintmax_t size = std::filesystem::file_size(path, ec);
+    if (ec)
+      return;
+    ret[path] = {lastWriteTime, size};
+  };
+
+  for (const std::filesystem::path& file : m_files)
+    addStamp(file);
+
+  for (const std::filesystem::path& directory : m_directories) {
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, ec)) {
+      if (entry.is_regular_file(ec))
+        addStamp(entry.path());
+    }
+    ec.clear();
+  }
+
+  return ret;
+}
+
+#endif
@@ -0,0 +1,206 @@
+#include <cli/InputFilter.h>
+
+#include <cassert>
+
+#include <compiler/vfs.h>
+
+namespace {
+namespace helper {
+
+/// \param path relative to \param directory using '/' as the separator
+/// (\param path must be inside of \param directory ).
+static std::string relativeGenericPath(const std::filesystem::path& path,
+                                       const std::filesystem::path& directory);
+
+/// \param str without leading or trailing whitespace.
+static std::string_view trim(std::string_view str);
+
+} // namespace helper
+} // namespace
+
+InputFilter::InputFilter(const std::vector<std::string>& includeGlobs,
+                         const std::vector<std::string>& excludeGlobs) {
+  m_includePatterns.reserve(includeGlobs.size());
+  for (const std::string& glob : includeGlobs)
+    m_includePatterns.emplace_back(glob);
+  m_excludePatterns.reserve(excludeGlobs.size());
+  for (const std::string& glob : excludeGlobs)
+    m_excludePatterns.emplace_back(glob);
+}
+
+void InputFilter::readIgnoreFile(const std::filesystem::path& inputDirectory) {
+  std::string contents;
+  if (!vfs::readFile(inputDirectory / ignoreFileName, contents))
+    return;
+
+  std::vector<Pattern> patterns;
+  size_t lineStart = 0;
+  while (lineStart < contents.size()) {
+    size_t lineEnd = contents.find('\n', lineStart);
+    if (lineEnd == std::string::npos)
+      lineEnd = contents.size();
+
+    const std::string_view line =
+        helper::trim(std::string_view(contents).substr(lineStart, lineEnd - lineStart));
+    if (!line.empty() && line[0] != '#')
+      patterns.emplace_back(line);
+
+    lineStart = lineEnd + 1;
+  }
+  m_ignorePatterns[inputDirectory] = std::move(patterns);
+}
+
+bool InputFilter::includes(const std::filesystem::path& inputDirectory,
+                           const std::filesystem::path& path, bool isDirectory) const {
+  const std::string relativePath = helper::relativeGenericPath(path, inputDirectory);
+  if (isExcluded(ignorePatternsFor(inputDirectory), relativePath, isDirectory))
+    return false;
+
+  // include globs only apply to files (a directory could have a file that
+  // matches in it)
+  if (isDirectory)
+    return true;
+
+  // the ignore file isn't a file write source file
+  if (relativePath == ignoreFileName)
+    return false;
+
+  if (m_includePatterns.empty())
+    return true;
+
+  // a file is included if it or any directory it's in matches
+  std::string_view prefix = relativePath;
+  while (true) {
+    for (const Pattern& pattern : m_includePatterns) {
+      if (pattern.matches(prefix, prefix.size() != relativePath.size()))
+        return true;
+    }
+
+    const size_t slashIndex = prefix.rfind('/');
+    if (slashIndex == std::string_view::npos)
+      return false;
+    prefix = prefix.substr(0, slashIndex);
+  }
+}
+
+bool InputFilter::includesFile(const std::filesystem::path& inputDirectory,
+                               const std::filesystem::path& path) const {
+  const std::vector<Pattern>* ignorePatterns = ignorePatternsFor(inputDirectory);
+  const std::string relativePath = helper::relativeGenericPath(path, inputDirectory);
+
+  for (size_t slashIndex = relativePath.find('/'); slashIndex != std::string::npos;
+       slashIndex = relativePath.find('/', slashIndex + 1)) {
+    if (isExcluded(ignorePatterns, std::string_view(relativePath).substr(0, slashIndex), true))
+      return false;
+  }
+  return includes(inputDirectory, path, false);
+}
+
+bool InputFilter::globMatches(std::string_view glob, std::string_view path) {
+  while (!glob.empty()) {
+    // '**' matches anything, and '**/' can match nothing (e.g. "**/foo"
+    // matches "foo")
+    if (glob.substr(0, 2) == "**") {
+      glob.remove_prefix(2);
+      if (!glob.empty() && glob[0] == '/' && globMatches(glob.substr(1), path))
+        return true;
+      for (size_t i = 0; i <= path.size(); i++) {
+        if (globMatches(glob, path.substr(i)))
+          return true;
+      }
+      return false;
+    }
+
+    // '*' matches anything up to the next '/'
+    if (glob[0] == '*') {
+      glob.remove_prefix(1);
+      for (size_t i = 0;; i++) {
+        if (globMatches(glob, path.substr(i)))
+          return true;
+        if (i == path.size() || path[i] == '/')
+          return false;
+      }
+    }
+
+    if (path.empty())
+      return false;
+    if ((glob[0] == '?') ? path[0] == '/' : glob[0] != path[0])
+      return false;
+    glob.remove_prefix(1);
+    path.remove_prefix(1);
+  }
+  return path.empty();
+}
+
+InputFilter::Pattern::Pattern(std::string_view globStr) : matchesName(false), directoryOnly(false) {
+  if (!globStr.empty() && globStr.back() == '/') {
+    directoryOnly = true;
+    globStr.remove_suffix(1);
+  }
+
+  // a leading '/' means the glob matches the whole path even without another
+  // '/' in it
+  if (!globStr.empty() && globStr.front() == '/')
+    globStr.remove_prefix(1);
+  else
+    matchesName = globStr.find('/') == std::string_view::npos;
+
+  glob = globStr;
+}
+
+bool InputFilter::Pattern::matches(std::string_view relativePath, bool isDirectory) const {
+  if (directoryOnly && !isDirectory)
+    return false;
+  if (!matchesName)
+    return globMatches(glob, relativePath);
+
+  const size_t slashIndex = relativePath.rfind('/');
+  return globMatches(glob, (slashIndex == std::string_view::npos)
+                               ? relativePath
+                               : relativePath.substr(slashIndex + 1));
+}
+
+bool InputFilter::isExcluded(const std::vector<Pattern>* patterns, std::string_view relativePath,
+                             bool isDirectory) const {
+  for (const Pattern& pattern : m_excludePatterns) {
+    if (pattern.matches(relativePath, isDirectory))
+      return true;
+  }
+  if (patterns != nullptr) {
+    for (const Pattern& pattern : *patterns) {
+      if (pattern.matches(relativePath, isDirectory))
+        return true;
+    }
+  }
+  return false;
+}
+
+const std::vector<InputFilter::Pattern>*
+InputFilter::ignorePatternsFor(const std::filesystem::path& inputDirectory) const {
+  const auto it = m_ignorePatterns.find(inputDirectory);
+  return (it == m_ignorePatterns.end()) ? nullptr : &it->second;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static std::string helper::relativeGenericPath(const std::filesystem::path& path,
+                                               const std::filesystem::path& directory) {
+  std::string directoryStr = directory.generic_string();
+  if (directoryStr.empty() || directoryStr.back() != '/')
+    directoryStr += '/';
+
+  std::string ret = path.generic_string();
+  assert(ret.compare(0, directoryStr.size(), directoryStr) == 0 &&
+         "the path should be inside of the directory");
+  ret.erase(0, directoryStr.size());
+  return ret;
+}
+
+static std::string_view helper::trim(std::string_view str) {
+  const size_t start = str.find_first_not_of(" \t\r");
+  if (start == std::string_view::npos)
+    return {};
+  return str.substr(start, str.find_last_not_of(" \t\r") - start + 1);
+}
@@ -0,0 +1,140 @@
+#include <cli/PackBuild.h>
+
+#include <optional>
+#include <sstream>
+#include <system_error>
+
+#include <compiler/generation/generateDataPack.h>
+#include <compiler/generation/generateDepfile.h>
+#include <compiler/generation/generateXrefIndex.h>
+#include <compiler/generation/writeFileToDataPack.h>
+#include <compiler/linking/link.h>
+#include <compiler/pass_timing.h>
+#include <compiler/tracing.h>
+
+namespace {
+namespace helper {
+
+/// The path of every source file and file write source file in
+/// \param parsedArgs .
+static std::vector<std::filesystem::path> inputPaths(const ParseArgsResult& parsedArgs);
+
+} // namespace helper
+} // namespace
+
+PackBuild::PackBuild(std::string&& stampKey, ParseArgsResult&& parsedArgs)
+    : m_args(std::move(parsedArgs)),
+      m_buildStamp(std::move(stampKey), helper::inputPaths(m_args)),
+      m_buildStampPath(m_args.outputDirectory / BuildStamp::fileName) {}
+
+bool PackBuild::skipIfUpToDate(std::ostream& out) const {
+  if (m_args.clearOutputDirectory || pass_timing::reportFormat != pass_timing::ReportFormat::NONE ||
+      TRACE_IS_ENABLED())
+    return false;
+
+  const std::optional<std::string> messages = m_buildStamp.messagesIfUpToDate(m_buildStampPath);
+  if (!messages.has_value())
+    return false;
+
+  // Make compares the stamp's modification time with the dependencies (an
+  // input directory could have changed without changing the build)
+  if (!m_args.depfilePath.empty()) {
+    std::error_code ec;
+    std::filesystem::last_write_time(m_buildStampPath,
+                                     std::filesystem::file_time_type::clock::now(), ec);
+  }
+  out << *messages;
+  return true;
+}
+
+SourceFiles& PackBuild::sourceFiles() { return m_args.sourceFiles; }
+
+const CompileOptions& PackBuild::compileOptions() const { return m_args.compileOptions; }
+
+void PackBuild::linkAndWrite(std::vector<CompiledSourceFile>&& compiledSourceFiles,
+                             std::ostream& out) {
+  const CompileOptions& compileOptions = m_args.compileOptions;
+  const std::filesystem::path& outputDirectory = m_args.outputDirectory;
+  const std::filesystem::path& sourceMapPath = m_args.sourceMapPath;
+  const std::filesystem::path& depfilePath = m_args.depfilePath;
+  const std::filesystem::path& xrefPath = m_args.xrefPath;
+
+  // the source files are freed while linking so their paths are saved first
+  std::vector<std::filesystem::path> depfileInputPaths;
+  if (!depfilePath.empty()) {
+    depfileInputPaths.reserve(m_args.sourceFiles.size());
+    for (const SourceFile& sourceFile : m_args.sourceFiles)
+      depfileInputPaths.push_back(sourceFile.path());
+  }
+
+  // the index is made before linking frees the source files (but it's only
+  // written if linking succeeds)
+  std::string xrefIndex;
+  if (!xrefPath.empty())
+    xrefIndex = generateXrefIndex(m_args.sourceFiles);
+
+  auto [fileWriteMap, fileCopyMap, tickFuncCallNames, loadFuncCallNames, exposedNamespace,
+        exposedNamespaces, scheduledTickFuncs, tickCostReport, deduplicatedFunctionCount,
+        sourceMap, readFileWriteSourcePaths] =
+      link(std::move(compiledSourceFiles), std::move(m_args.sourceFiles),
+           std::move(m_args.fileWriteSourceFiles), compileOptions);
+
+  // messages are saved in the build stamp so a skipped build prints them too
+  std::ostringstream messages;
+
+  if (compileOptions.reportTickCost)
+    messages << tickCostReport.str();
+
+  if (compileOptions.deduplicateFunctions) {
+    messages << "Merged " << deduplicatedFunctionCount << " duplicate function file"
+             << ((deduplicatedFunctionCount == 1) ? "" : "s") << ".\n";
+  }
+
+  out << messages.str();
+
+  generateDataPack(outputDirectory, exposedNamespaces, fileWriteMap, fileCopyMap,
+                   m_args.clearOutputDirectory, tickFuncCallNames, loadFuncCallNames);
+
+  if (compileOptions.generateSourceMap)
+    writeFileToDataPack(sourceMapPath.parent_path(), sourceMapPath.filename(), sourceMap);
+
+  if (!xrefPath.empty())
+    writeFileToDataPack(xrefPath.parent_path(), xrefPath.filename(), xrefIndex);
+
+  // everything that was written (so a build isn't skipped if any of it is
+  // missing, and Make knows every file it can rebuild)
+  std::vector<std::filesystem::path> outputPaths = dataPackFilePaths(fileWriteMap, fileCopyMap);
+  outputPaths.reserve(outputPaths.size() + 2);
+  for (std::filesystem::path& outputPath : outputPaths)
+    outputPath = outputDirectory / outputPath;
+  if (compileOptions.generateSourceMap)
+    outputPaths.push_back(sourceMapPath);
+  if (!xrefPath.empty())
+    outputPaths.push_back(xrefPath);
+  m_buildStamp.write(m_buildStampPath, outputPaths, messages.str());
+
+  // the stamp is the first target because it's written by every build
+  if (!depfilePath.empty()) {
+    depfileInputPaths.insert(depfileInputPaths.end(), readFileWriteSourcePaths.begin(),
+                             readFileWriteSourcePaths.end());
+    outputPaths.insert(outputPaths.begin(), m_buildStampPath);
+    writeFileToDataPack(depfilePath.parent_path(), depfilePath.filename(),
+                        generateDepfile(outputPaths, depfileInputPaths, m_args.inputDirectories));
+  }
+}
+
+const std::filesystem::path& PackBuild::outputDirectory() const { return m_args.outputDirectory; }
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static std::vector<std::filesystem::path> helper::inputPaths(const ParseArgsResult& parsedArgs) {
+  std::vector<std::filesystem::path> ret;
+  ret.reserve(parsedArgs.sourceFiles.size() + parsedArgs.fileWriteSourceFiles.size());
+  for (const SourceFile& sourceFile : parsedArgs.sourceFiles)
+    ret.push_back(sourceFile.path());
+  for (const FileWriteSourceFile& fileWriteSourceFile : parsedArgs.fileWriteSourceFiles)
+    ret.push_back(fileWriteSourceFile.path());
+  return ret;
+}
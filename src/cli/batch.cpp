@@ -0,0 +1,192 @@
+#include <cli/batch.h>
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <unordered_set>
+
+#include <cli/PackBuild.h>
+#include <cli/parseArgs.h>
+#include <cli/style_text.h>
+#include <compiler/compile_error.h>
+#include <compiler/fileToStr.h>
+#include <compiler/json.h>
+#include <compiler/pass_timing.h>
+#include <compiler/runInParallel.h>
+#include <compiler/tracing.h>
+#include <compiler/vfs.h>
+
+namespace {
+namespace helper {
+
+/// Every string in the array \param value (which is called \param name in
+/// error messages).
+/// \throws json::ParseError if \param value isn't an array of strings.
+static std::vector<std::string> stringArray(const json::Value& value, const std::string& name);
+
+} // namespace helper
+} // namespace
+
+std::vector<std::vector<std::string>> packArgsFromManifest(const std::string& manifestText) {
+  const json::Value manifest = json::parse(manifestText);
+  if (!manifest["packs"].isArray())
+    throw json::ParseError("Expected the manifest to have a \"packs\" array", 0);
+
+  // arguments for every pack
+  std::vector<std::string> sharedArgs;
+  if (!manifest["args"].isNull())
+    sharedArgs = helper::stringArray(manifest["args"], "\"args\"");
+
+  std::vector<std::vector<std::string>> ret;
+  for (const json::Value& pack : manifest["packs"].asArray()) {
+    const std::string packName = "pack " + std::to_string(ret.size() + 1);
+    if (!pack["output"].isString())
+      throw json::ParseError("Expected " + packName + " to have an \"output\" string", 0);
+
+    std::vector<std::string> args;
+    for (std::string& input : helper::stringArray(pack["inputs"], packName + "'s \"inputs\"")) {
+      if (vfs::isDirectory(input))
+        args.emplace_back("-i");
+      args.push_back(std::move(input));
+    }
+    args.emplace_back("-o");
+    args.push_back(pack["output"].asString());
+    args.insert(args.end(), sharedArgs.begin(), sharedArgs.end());
+    if (!pack["args"].isNull()) {
+      for (std::string& arg : helper::stringArray(pack["args"], packName + "'s \"args\""))
+        args.push_back(std::move(arg));
+    }
+
+    ret.push_back(std::move(args));
+  }
+  return ret;
+}
+
+int batch(int argc, const char** argv) {
+  if (argc != 3) {
+    std::cerr << style_text::styleAsError("CLI Error: ") << "Expected "
+              << style_text::styleAsCode(std::string(argv[0]) + " batch <MANIFEST>") << ".\n";
+    return EXIT_FAILURE;
+  }
+
+  std::vector<std::vector<std::string>> packArgs;
+  try {
+    packArgs = packArgsFromManifest(fileToStr(argv[2]));
+  } catch (const compile_error::Generic& e) {
+    std::cerr << e.what();
+    return EXIT_FAILURE;
+  } catch (const json::ParseError& e) {
+    std::cerr << style_text::styleAsError("CLI Error: ") << "The manifest "
+              << style_text::styleAsCode(argv[2]) << " is invalid: " << e.what() << ".\n";
+    return EXIT_FAILURE;
+  }
+
+  // every pack's arguments are parsed (and checked) before anything is built
+  std::vector<std::unique_ptr<PackBuild>> builds;
+  std::unordered_set<std::filesystem::path> outputDirectories;
+  for (const std::vector<std::string>& args : packArgs) {
+    std::vector<const char*> packArgv{argv[0]};
+    for (const std::string& arg : args)
+      packArgv.push_back(arg.c_str());
+    const int packArgc = static_cast<int>(packArgv.size());
+
+    ParseArgsResult parsedArgs = parseArgs(packArgc, packArgv.data());
+    if (parsedArgs.watchForChanges) {
+      std::cerr << style_text::styleAsError("CLI Error: ") << style_text::styleAsCode("--watch")
+                << " can't be used in a batch.\n";
+      return EXIT_FAILURE;
+    }
+    if (!outputDirectories.insert(parsedArgs.outputDirectory).second) {
+      std::cerr << style_text::styleAsError("CLI Error: ") << "More than 1 pack has the output "
+                << "directory " << style_text::styleAsCode(parsedArgs.outputDirectory.string())
+                << ".\n";
+      return EXIT_FAILURE;
+    }
+
+    builds.push_back(std::make_unique<PackBuild>(
+        BuildStamp::keyFromArgs(packArgc, packArgv.data()), std::move(parsedArgs)));
+  }
+
+  // what each pack printed (printed in order once everything is done)
+  std::vector<std::ostringstream> outputs(builds.size());
+  std::vector<std::string> errors(builds.size());
+
+  std::vector<size_t> packsToBuild;
+  for (size_t i = 0; i < builds.size(); i++) {
+    if (!builds[i]->skipIfUpToDate(outputs[i]))
+      packsToBuild.push_back(i);
+  }
+
+  std::vector<SourceFiles*> batchSourceFiles;
+  std::vector<CompileOptions> batchCompileOptions;
+  for (const size_t i : packsToBuild) {
+    batchSourceFiles.push_back(&builds[i]->sourceFiles());
+    batchCompileOptions.push_back(builds[i]->compileOptions());
+  }
+  std::vector<SourceFiles::BatchResult> results =
+      SourceFiles::evaluateBatch(batchSourceFiles, batchCompileOptions);
+
+  // packs are linked and written in parallel too
+  runInParallel(packsToBuild.size(), [&](size_t j) {
+    const size_t i = packsToBuild[j];
+    try {
+      if (results[j].exception)
+        std::rethrow_exception(results[j].exception);
+      builds[i]->linkAndWrite(std::move(results[j].compiledSourceFiles), outputs[i]);
+    } catch (const compile_error::Generic& e) {
+      errors[i] = e.what();
+    } catch (const std::exception& e) {
+      // tasks can't throw so anything else is reported as an internal error
+      errors[i] = style_text::styleAsError("Internal Error: ") + e.what() + '\n';
+    } catch (...) {
+      errors[i] = style_text::styleAsError("Internal Error: ") + "Unknown error.\n";
+    }
+  });
+
+  size_t failedCount = 0;
+  for (size_t i = 0; i < builds.size(); i++) {
+    const std::string output = outputs[i].str();
+    if (output.empty() && errors[i].empty())
+      continue;
+    std::cout << style_text::styleAsCode(builds[i]->outputDirectory().string()) << ":\n"
+              << output;
+    std::cout.flush();
+    if (!errors[i].empty()) {
+      std::cerr << errors[i];
+      failedCount++;
+    }
+  }
+
+  if (pass_timing::reportFormat != pass_timing::ReportFormat::NONE)
+    std::cerr << pass_timing::report();
+
+  TRACE_WRITE();
+
+  if (failedCount != 0) {
+    std::cerr << failedCount << " of " << builds.size() << " data pack"
+              << ((builds.size() == 1) ? "" : "s") << " failed to build.\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static std::vector<std::string> helper::stringArray(const json::Value& value,
+                                                    const std::string& name) {
+  if (!value.isArray())
+    throw json::ParseError("Expected " + name + " to be an array of strings", 0);
+
+  std::vector<std::string> ret;
+  ret.reserve(value.asArray().size());
+  for (const json::Value& element : value.asArray()) {
+    if (!element.isString())
+      throw json::ParseError("Expected " + name + " to be an array of strings", 0);
+    ret.push_back(element.asString());
+  }
+  return ret;
+}
@@ -0,0 +1,498 @@
+#include <cli/lsp.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <cli/style_text.h>
+#include <compiler/Workspace.h>
+#include <compiler/compile_error.h>
+#include <compiler/json.h>
+#include <version.h>
+
+namespace {
+namespace helper {
+
+// JSON-RPC error codes.
+static constexpr int parseErrorCode = -32700;
+static constexpr int methodNotFoundCode = -32601;
+static constexpr int internalErrorCode = -32603;
+static constexpr int serverNotInitializedCode = -32002;
+
+/// How the client counts the characters in a line.
+enum class PositionEncoding { UTF8, UTF16 };
+
+/// Reads the body of the next message from \param in into \param body .
+/// Returns false if \param in ended (or a message has no length).
+static bool readMessage(std::istream& in, std::string& body);
+
+/// Writes \param body to \param out as a message.
+static void writeMessage(std::ostream& out, const std::string& body);
+
+/// A response to the request with the id \param id (as JSON).
+static std::string response(const std::string& id, const std::string& result);
+
+/// An error response to the request with the id \param id (as JSON).
+static std::string errorResponse(const std::string& id, int code, const std::string& message);
+
+/// A notification (or a request if \param id isn't empty) sent to the client.
+static std::string clientMessage(const std::string& method, const std::string& params,
+                                 const std::string& id = "");
+
+/// Returns \param id as JSON (ids can be numbers or strings).
+static std::string idToJson(const json::Value& id);
+
+/// Returns \param value as a size (or 0 if it isn't a positive number).
+static size_t toSize(const json::Value& value);
+
+/// Converts a 'file://' URI to a path (or an empty path if \param uri isn't a
+/// file URI).
+static std::filesystem::path uriToPath(const json::Value& uri);
+
+/// Converts an absolute path to a 'file://' URI.
+static std::string pathToUri(const std::filesystem::path& path);
+
+/// The directory that the client opened (from the 'initialize' request's
+/// \param params ).
+static std::filesystem::path rootDirectory(const json::Value& params);
+
+/// UTF-8 if the client supports it (from the 'initialize' request's
+/// \param params ) since columns are counted in bytes, otherwise UTF-16 (which
+/// every client supports).
+static PositionEncoding positionEncoding(const json::Value& params);
+
+/// The protocol's character (starting at 0) for the byte \param column
+/// (starting at 1) in \param lineText .
+static size_t toCharacter(std::string_view lineText, size_t column, PositionEncoding encoding);
+
+/// The byte column (starting at 1) for the protocol's \param character
+/// (starting at 0) in \param lineText .
+static size_t toColumn(std::string_view lineText, size_t character, PositionEncoding encoding);
+
+/// A JSON range from a line, column, and length in bytes in the source file at
+/// \param path (lines and columns start at 1 here but at 0 in the protocol).
+static std::string range(const Workspace& workspace, const std::filesystem::path& path,
+                         size_t line, size_t column, size_t length, PositionEncoding encoding);
+
+/// \param locations as a JSON array of locations.
+static std::string locationsToJson(const Workspace& workspace,
+                                   const std::vector<Workspace::Location>& locations,
+                                   PositionEncoding encoding);
+
+/// Sends the diagnostics of every source file in \param paths to the client.
+static void publishDiagnostics(std::ostream& out, const Workspace& workspace,
+                               const std::vector<std::filesystem::path>& paths,
+                               PositionEncoding encoding);
+
+/// Tells the client about an error that was thrown while handling a message
+/// with the \param params . It's shown as a diagnostic at the start of the
+/// document the message is about (or as a message if it isn't about one) and
+/// requests (with an \param id ) get an error response.
+static void publishError(std::ostream& out, const json::Value& params, const std::string& id,
+                         const std::string& message);
+
+} // namespace helper
+} // namespace
+
+int runLanguageServer(std::istream& in, std::ostream& out) {
+  // messages are shown by the editor
+  style_text::doColor = false;
+
+  std::unique_ptr<Workspace> workspace;
+  bool canRegisterFileWatchers = false;
+  helper::PositionEncoding encoding = helper::PositionEncoding::UTF16;
+  bool isShutDown = false;
+
+  std::string body;
+  while (helper::readMessage(in, body)) {
+    json::Value message;
+    try {
+      message = json::parse(body);
+    } catch (const json::ParseError& e) {
+      helper::writeMessage(out, helper::errorResponse("null", helper::parseErrorCode, e.what()));
+      continue;
+    }
+
+    // responses to requests sent by the server don't have a method
+    if (!message["method"].isString())
+      continue;
+    const std::string& method = message["method"].asString();
+    const json::Value& params = message["params"];
+    const bool isRequest = !message["id"].isNull();
+    const std::string id = helper::idToJson(message["id"]);
+
+    if (method == "exit")
+      return isShutDown ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    try {
+      if (method == "initialize") {
+        // the old workspace's buffers are mounted at the same path, so it has
+        // to be gone before the new one mounts its own
+        workspace.reset();
+        workspace = std::make_unique<Workspace>(helper::rootDirectory(params));
+        canRegisterFileWatchers =
+            params["capabilities"]["workspace"]["didChangeWatchedFiles"]["dynamicRegistration"]
+                .isBool() &&
+            params["capabilities"]["workspace"]["didChangeWatchedFiles"]["dynamicRegistration"]
+                .asBool();
+        encoding = helper::positionEncoding(params);
+        // the whole document is sent after each change
+        helper::writeMessage(
+            out, helper::response(
+                     id, std::string("{\"capabilities\":{\"positionEncoding\":") +
+                             ((encoding == helper::PositionEncoding::UTF8) ? "\"utf-8\""
+                                                                           : "\"utf-16\"") +
+                             ",\"textDocumentSync\":{\"openClose\":true,\"change\":1},"
+                             "\"definitionProvider\":true,\"referencesProvider\":true},"
+                             "\"serverInfo\":{\"name\":\"mcfunc\",\"version\":" +
+                             json::quote(MCFUNC_VERSION) + "}}"));
+
+      } else if (method == "shutdown") {
+        isShutDown = true;
+        helper::writeMessage(out, helper::response(id, "null"));
+
+      } else if (!workspace) {
+        if (isRequest) {
+          helper::writeMessage(out, helper::errorResponse(id, helper::serverNotInitializedCode,
+                                                          "The server isn't initialized."));
+        }
+
+      } else if (method == "initialized") {
+        // files that are created, saved, or deleted outside of the editor
+        if (canRegisterFileWatchers) {
+          helper::writeMessage(
+              out, helper::clientMessage(
+                       "client/registerCapability",
+                       "{\"registrations\":[{\"id\":\"mcfunc-files\",\"method\":"
+                       "\"workspace/didChangeWatchedFiles\",\"registerOptions\":{\"watchers\":[{"
+                       "\"globPattern\":\"**/*.mcfunc\"}]}}]}",
+                       "\"register-file-watchers\""));
+        }
+        helper::publishDiagnostics(out, *workspace, workspace->pathsWithDiagnostics(), encoding);
+
+      } else if (method == "textDocument/didOpen") {
+        const json::Value& textDocument = params["textDocument"];
+        if (textDocument["text"].isString()) {
+          helper::publishDiagnostics(
+              out, *workspace,
+              workspace->setBuffer(helper::uriToPath(textDocument["uri"]),
+                                   textDocument["text"].asString()),
+              encoding);
+        }
+
+      } else if (method == "textDocument/didChange") {
+        const json::Value& changes = params["contentChanges"];
+        if (changes.isArray() && !changes.asArray().empty() &&
+            changes.asArray().back()["text"].isString()) {
+          helper::publishDiagnostics(
+              out, *workspace,
+              workspace->setBuffer(helper::uriToPath(params["textDocument"]["uri"]),
+                                   changes.asArray().back()["text"].asString()),
+              encoding);
+        }
+
+      } else if (method == "textDocument/didClose") {
+        helper::publishDiagnostics(
+            out, *workspace,
+            workspace->closeBuffer(helper::uriToPath(params["textDocument"]["uri"])), encoding);
+
+      } else if (method == "workspace/didChangeWatchedFiles") {
+        std::vector<std::filesystem::path> changedPaths;
+        if (params["changes"].isArray()) {
+          for (const json::Value& change : params["changes"].asArray()) {
+            const std::vector<std::filesystem::path> paths =
+                workspace->fileChanged(helper::uriToPath(change["uri"]));
+            changedPaths.insert(changedPaths.end(), paths.begin(), paths.end());
+          }
+        }
+        std::sort(changedPaths.begin(), changedPaths.end());
+        changedPaths.erase(std::unique(changedPaths.begin(), changedPaths.end()),
+                           changedPaths.end());
+        helper::publishDiagnostics(out, *workspace, changedPaths, encoding);
+
+      } else if (method == "textDocument/definition" || method == "textDocument/references") {
+        const std::filesystem::path path = helper::uriToPath(params["textDocument"]["uri"]);
+        const size_t line = helper::toSize(params["position"]["line"]) + 1;
+        const size_t column =
+            helper::toColumn(workspace->lineAt(path, line),
+                             helper::toSize(params["position"]["character"]), encoding);
+        const bool includeDeclarations = params["context"]["includeDeclaration"].isBool() &&
+                                         params["context"]["includeDeclaration"].asBool();
+        helper::writeMessage(
+            out, helper::response(
+                     id, helper::locationsToJson(
+                             *workspace,
+                             (method == "textDocument/definition")
+                                 ? workspace->definitionAt(path, line, column)
+                                 : workspace->referencesAt(path, line, column,
+                                                           includeDeclarations),
+                             encoding)));
+
+      } else if (isRequest) {
+        helper::writeMessage(out, helper::errorResponse(id, helper::methodNotFoundCode,
+                                                        "Unknown method '" + method + "'."));
+      }
+
+    } catch (const compile_error::Generic& e) {
+      helper::publishError(out, params, isRequest ? id : "", e.message());
+    } catch (const std::exception& e) {
+      helper::publishError(out, params, isRequest ? id : "",
+                           std::string("Internal error: ") + e.what());
+    }
+  }
+
+  return EXIT_FAILURE;
+}
+
+int lsp(int argc, const char** argv) {
+  if (argc != 2) {
+    std::cerr << style_text::styleAsError("CLI Error: ") << "Expected "
+              << style_text::styleAsCode(std::string(argv[0]) + " lsp") << ".\n";
+    return EXIT_FAILURE;
+  }
+
+  std::ios::sync_with_stdio(false);
+  return runLanguageServer(std::cin, std::cout);
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static bool helper::readMessage(std::istream& in, std::string& body) {
+  static constexpr std::string_view contentLengthHeader = "Content-Length:";
+
+  // headers end with an empty line
+  size_t contentLength = std::string::npos;
+  std::string line;
+  while (true) {
+    if (!std::getline(in, line))
+      return false;
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (line.empty())
+      break;
+    if (line.compare(0, contentLengthHeader.size(), contentLengthHeader) == 0)
+      contentLength = std::strtoull(line.c_str() + contentLengthHeader.size(), nullptr, 10);
+  }
+  if (contentLength == std::string::npos)
+    return false;
+
+  body.resize(contentLength);
+  in.read(body.data(), contentLength);
+  return static_cast<size_t>(in.gcount()) == contentLength;
+}
+
+static void helper::writeMessage(std::ostream& out, const std::string& body) {
+  out << "Content-Length: " << body.size() << "\r\n\r\n" << body;
+  out.flush();
+}
+
+static std::string helper::response(const std::string& id, const std::string& result) {
+  return "{\"jsonrpc\":\"2.0\",\"id\":" + id + ",\"result\":" + result + '}';
+}
+
+static std::string helper::errorResponse(const std::string& id, int code,
+                                         const std::string& message) {
+  return "{\"jsonrpc\":\"2.0\",\"id\":" + id + ",\"error\":{\"code\":" + std::to_string(code) +
+         ",\"message\":" + json::quote(message) + "}}";
+}
+
+static std::string helper::clientMessage(const std::string& method, const std::string& params,
+                                         const std::string& id) {
+  std::string ret = "{\"jsonrpc\":\"2.0\",";
+  if (!id.empty())
+    ret += "\"id\":" + id + ',';
+  return ret + "\"method\":" + json::quote(method) + ",\"params\":" + params + '}';
+}
+
+static std::string helper::idToJson(const json::Value& id) {
+  if (id.isString())
+    return json::quote(id.asString());
+  if (id.isNumber())
+    return std::to_string(static_cast<long long>(id.asNumber()));
+  return "null";
+}
+
+static size_t helper::toSize(const json::Value& value) {
+  if (!value.isNumber() || value.asNumber() < 0)
+    return 0;
+  return static_cast<size_t>(value.asNumber());
+}
+
+static std::filesystem::path helper::uriToPath(const json::Value& uri) {
+  static constexpr std::string_view fileScheme = "file://";
+  if (!uri.isString() || uri.asString().compare(0, fileScheme.size(), fileScheme) != 0)
+    return std::filesystem::path();
+  const std::string& uriStr = uri.asString();
+
+  // the authority (usually empty) comes before the path
+  const size_t pathStart = uriStr.find('/', fileScheme.size());
+  if (pathStart == std::string::npos)
+    return std::filesystem::path();
+
+  std::string path;
+  for (size_t i = pathStart; i < uriStr.size(); i++) {
+    if (uriStr[i] == '%' && i + 2 < uriStr.size() &&
+        std::isxdigit(static_cast<unsigned char>(uriStr[i + 1])) &&
+        std::isxdigit(static_cast<unsigned char>(uriStr[i + 2]))) {
+      path += static_cast<char>(std::stoi(uriStr.substr(i + 1, 2), nullptr, 16));
+      i += 2;
+    } else {
+      path += uriStr[i];
+    }
+  }
+
+  // Windows paths look like '/C:/foo'
+  if (path.size() >= 3 && path[2] == ':' && std::isalpha(static_cast<unsigned char>(path[1])))
+    path.erase(0, 1);
+  return std::filesystem::path(path);
+}
+
+static std::string helper::pathToUri(const std::filesystem::path& path) {
+  static constexpr char hexDigits[] = "0123456789ABCDEF";
+
+  std::string pathStr = path.generic_string();
+  if (pathStr.empty() || pathStr.front() != '/')
+    pathStr.insert(pathStr.begin(), '/');
+
+  std::string ret = "file://";
+  for (const char c : pathStr) {
+    if (std::isalnum(static_cast<unsigned char>(c)) || c == '/' || c == '-' || c == '.' ||
+        c == '_' || c == '~') {
+      ret += c;
+    } else {
+      ret += '%';
+      ret += hexDigits[static_cast<unsigned char>(c) >> 4];
+      ret += hexDigits[static_cast<unsigned char>(c) & 0xf];
+    }
+  }
+  return ret;
+}
+
+static std::filesystem::path helper::rootDirectory(const json::Value& params) {
+  const std::filesystem::path rootUriPath = uriToPath(params["rootUri"]);
+  if (!rootUriPath.empty())
+    return rootUriPath;
+  if (params["rootPath"].isString())
+    return params["rootPath"].asString();
+  return std::filesystem::current_path();
+}
+
+static helper::PositionEncoding helper::positionEncoding(const json::Value& params) {
+  const json::Value& encodings = params["capabilities"]["general"]["positionEncodings"];
+  if (encodings.isArray()) {
+    for (const json::Value& encoding : encodings.asArray()) {
+      if (encoding.isString() && encoding.asString() == "utf-8")
+        return PositionEncoding::UTF8;
+    }
+  }
+  return PositionEncoding::UTF16;
+}
+
+static size_t helper::toCharacter(std::string_view lineText, size_t column,
+                                  PositionEncoding encoding) {
+  const size_t byteCount = (column == 0) ? 0 : column - 1;
+  if (encoding == PositionEncoding::UTF8)
+    return byteCount;
+
+  // continuation bytes don't start a character and 4 byte characters take 2
+  // UTF-16 code units (bytes past the end of the line count as 1 each)
+  size_t ret = 0;
+  for (size_t i = 0; i < byteCount; i++) {
+    const unsigned char c = (i < lineText.size()) ? lineText[i] : 0;
+    if ((c & 0xc0) != 0x80)
+      ret += (c >= 0xf0) ? 2 : 1;
+  }
+  return ret;
+}
+
+static size_t helper::toColumn(std::string_view lineText, size_t character,
+                               PositionEncoding encoding) {
+  if (encoding == PositionEncoding::UTF8)
+    return character + 1;
+
+  size_t codeUnits = 0;
+  size_t i = 0;
+  while (i < lineText.size() && codeUnits < character) {
+    const unsigned char c = lineText[i];
+    codeUnits += (c >= 0xf0) ? 2 : 1;
+    i++;
+    while (i < lineText.size() && (static_cast<unsigned char>(lineText[i]) & 0xc0) == 0x80)
+      i++;
+  }
+  return i + 1 + ((character > codeUnits) ? character - codeUnits : 0);
+}
+
+static std::string helper::range(const Workspace& workspace, const std::filesystem::path& path,
+                                 size_t line, size_t column, size_t length,
+                                 PositionEncoding encoding) {
+  const std::string_view lineText = workspace.lineAt(path, line);
+  const std::string lineStr = std::to_string(line - 1);
+  return "{\"start\":{\"line\":" + lineStr +
+         ",\"character\":" + std::to_string(toCharacter(lineText, column, encoding)) +
+         "},\"end\":{\"line\":" + lineStr + ",\"character\":" +
+         std::to_string(toCharacter(lineText, column + length, encoding)) + "}}";
+}
+
+static std::string helper::locationsToJson(const Workspace& workspace,
+                                           const std::vector<Workspace::Location>& locations,
+                                           PositionEncoding encoding) {
+  std::string ret = "[";
+  for (const Workspace::Location& location : locations) {
+    if (ret.size() > 1)
+      ret += ',';
+    ret += "{\"uri\":" + json::quote(pathToUri(location.path)) + ",\"range\":" +
+           range(workspace, location.path, location.line, location.column, location.length,
+                 encoding) +
+           '}';
+  }
+  return ret + ']';
+}
+
+static void helper::publishDiagnostics(std::ostream& out, const Workspace& workspace,
+                                       const std::vector<std::filesystem::path>& paths,
+                                       PositionEncoding encoding) {
+  for (const std::filesystem::path& path : paths) {
+    std::string diagnostics = "[";
+    if (const Workspace::Diagnostic* diagnostic = workspace.diagnostic(path)) {
+      diagnostics += "{\"range\":" +
+                     range(workspace, path, diagnostic->line, diagnostic->column,
+                           diagnostic->length, encoding) +
+                     ",\"severity\":1,\"source\":\"mcfunc\",\"message\":" +
+                     json::quote(diagnostic->message) + '}';
+    }
+    diagnostics += ']';
+
+    writeMessage(out, clientMessage("textDocument/publishDiagnostics",
+                                    "{\"uri\":" + json::quote(pathToUri(path)) +
+                                        ",\"diagnostics\":" + diagnostics + '}'));
+  }
+}
+
+static void helper::publishError(std::ostream& out, const json::Value& params,
+                                 const std::string& id, const std::string& message) {
+  if (!id.empty())
+    writeMessage(out, errorResponse(id, internalErrorCode, message));
+
+  const json::Value& uri = params["textDocument"]["uri"];
+  if (uri.isString()) {
+    writeMessage(out, clientMessage("textDocument/publishDiagnostics",
+                                    "{\"uri\":" + json::quote(uri.asString()) +
+                                        ",\"diagnostics\":[{\"range\":{\"start\":{\"line\":0,"
+                                        "\"character\":0},\"end\":{\"line\":0,\"character\":"
+                                        "0}},\"severity\":1,\"source\":\"mcfunc\",\"message\":" +
+                                        json::quote(message) + "}]}"));
+  } else {
+    // 1 is an error
+    writeMessage(out, clientMessage("window/showMessage",
+                                    "{\"type\":1,\"message\":" + json::quote(message) + '}'));
+  }
+}
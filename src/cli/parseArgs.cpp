@@ -5,34 +5,68 @@
 #include <exception>
 #include <filesystem>
 #include <iostream>
+#include <string>
 #include <string_view>
 #include <system_error>
+#include <unordered_set>
+#include <vector>
 
 #include <cli/style_text.h>
+#include <compiler/pass_timing.h>
+#include <compiler/tracing.h>
+#include <compiler/vfs.h>
 #include <version.h>
 
 // ParseArgsResult
 
 ParseArgsResult::ParseArgsResult(std::filesystem::path&& outputDirectory, SourceFiles&& sourceFiles,
                                  std::vector<FileWriteSourceFile>&& fileWriteSourceFiles,
-                                 bool clearOutputDirectory)
+                                 bool clearOutputDirectory, const CompileOptions& compileOptions,
+                                 std::filesystem::path&& sourceMapPath,
+                                 std::filesystem::path&& depfilePath,
+                                 std::filesystem::path&& xrefPath,
+                                 std::vector<std::filesystem::path>&& inputDirectories,
+                                 InputFilter&& inputFilter, bool watchForChanges)
     : outputDirectory(std::move(outputDirectory)), sourceFiles(std::move(sourceFiles)),
       fileWriteSourceFiles(std::move(fileWriteSourceFiles)),
-      clearOutputDirectory(clearOutputDirectory) {}
+      clearOutputDirectory(clearOutputDirectory), compileOptions(compileOptions),
+      sourceMapPath(std::move(sourceMapPath)), depfilePath(std::move(depfilePath)),
+      xrefPath(std::move(xrefPath)), inputDirectories(std::move(inputDirectories)),
+      inputFilter(std::move(inputFilter)), watchForChanges(watchForChanges) {}
+
+// InvalidArgsError
+
+const char* InvalidArgsError::what() const noexcept { return "The arguments are invalid."; }
 
 // parseArgs helper functions
 
 namespace {
 namespace helper {
 
+/// Whether input errors exit (see \p parseArgs() ).
+static bool exitOnError = true;
+
+/// The help line for '--trace' (left out when tracing isn't compiled in).
+#if defined(DO_TRACING)
+static constexpr const char* traceHelpLine =
+    "  --trace <FILE>              Write a timeline of the build for Perfetto.\n";
+#else
+static constexpr const char* traceHelpLine = "";
+#endif
+
 static void printErrorPrefix();
 
 static void printWarningPrefix();
 
 /// Prints a message about running the program with the help flag to
-/// \p std::cerr and exits with \p EXIT_FAILURE as the exit code.
+/// \p std::cerr and exits with \p EXIT_FAILURE as the exit code (see
+/// \p exitWithFailure() ).
 static void exitWithHelpPageInfo(const char* arg0);
 
+/// Exits with \p EXIT_FAILURE as the exit code, or throws
+/// \p InvalidArgsError if \p exitOnError isn't set.
+static void exitWithFailure();
+
 /// Ensures the argument at index \param i is the only argument.
 static void ensureArgIsOnlyArg(int argc, const char** argv, int i);
 
@@ -46,30 +80,56 @@ static bool isSubpath(const std::filesystem::path& path, const std::filesystem::
 static std::filesystem::path directorySuppliedAfterArg(int argc, const char** argv, int i,
                                                        bool allowWorkingDirToBeContained = false);
 
+/// Ensures that the argument at index \param i is followed by another argument
+/// that is a file path in an existing directory and returns that path cleaned
+/// and made absolute.
+static std::filesystem::path outputFileSuppliedAfterArg(int argc, const char** argv, int i);
+
+/// Ensures that the argument at index \param i is followed by another argument
+/// that is a positive whole number and returns it.
+static size_t positiveNumberSuppliedAfterArg(int argc, const char** argv, int i);
+
+/// Ensures that the argument at index \param i is followed by another argument
+/// that isn't empty and returns it (as a glob).
+static std::string globSuppliedAfterArg(int argc, const char** argv, int i);
+
 static void warnAboutFileSuppliedMoreThanOnce(const std::filesystem::path& path);
 
 /// Add a source file or file write source file given a new path and the prefix
-/// to remove for it's import path.
+/// to remove for it's import path. \param addedPaths holds every path that's
+/// been added so far (so duplicates can be found without a linear search).
 static void addSourceFileGivenPath(std::filesystem::path&& path,
                                    std::filesystem::path&& pathPrefixToRemove,
                                    SourceFiles& sourceFiles,
-                                   std::vector<FileWriteSourceFile>& fileWriteSourceFiles);
+                                   std::vector<FileWriteSourceFile>& fileWriteSourceFiles,
+                                   std::unordered_set<std::filesystem::path>& addedPaths);
 
 } // namespace helper
 } // namespace
 
 // parseArgs
 
-ParseArgsResult parseArgs(int argc, const char** argv) {
+ParseArgsResult parseArgs(int argc, const char** argv, bool exitOnError) {
+  helper::exitOnError = exitOnError;
+
   SourceFiles sourceFiles;
   std::vector<FileWriteSourceFile> fileWriteSourceFiles;
 
   std::filesystem::path outputDirectory;
   bool outputDirectoryAlreadyGiven = false;
   bool clearOutputDirectory = false;
+  CompileOptions compileOptions;
+  std::filesystem::path sourceMapPath;
+  std::filesystem::path depfilePath;
+  bool writeDepfile = false;
+  std::filesystem::path xrefPath;
+  bool watchForChanges = false;
 
   std::vector<std::filesystem::path> inputDirectories;
+  std::vector<std::string> includeGlobs;
+  std::vector<std::string> excludeGlobs;
   std::vector<std::string_view> inputFileArgs;
+  std::unordered_set<std::filesystem::path> addedPaths;
 
   // pre-scan for the "--no-color" option in case there's an error parsing
   // arguments before we get to it
@@ -92,6 +152,91 @@ ParseArgsResult parseArgs(int argc, const char** argv) {
       continue;
     }
 
+    if (arg == "--inline-scopes") {
+      compileOptions.inlineTrivialScopes = true;
+      continue;
+    }
+
+    if (arg == "--dedup-functions") {
+      compileOptions.deduplicateFunctions = true;
+      continue;
+    }
+
+    if (arg == "--factor-execute") {
+      compileOptions.factorExecutePrefixes = true;
+      continue;
+    }
+
+    if (arg == "--tick-report") {
+      compileOptions.reportTickCost = true;
+      continue;
+    }
+
+    if (arg == "--max-tick-commands") {
+      compileOptions.maxTickCommands = helper::positiveNumberSuppliedAfterArg(argc, argv, i);
+      i++;
+      continue;
+    }
+
+    if (arg == "--instrument") {
+      compileOptions.instrument = true;
+      continue;
+    }
+
+    if (arg == "--source-map") {
+      sourceMapPath = helper::outputFileSuppliedAfterArg(argc, argv, i);
+      compileOptions.generateSourceMap = true;
+      i++;
+      continue;
+    }
+
+    if (arg == "--xref") {
+      xrefPath = helper::outputFileSuppliedAfterArg(argc, argv, i);
+      i++;
+      continue;
+    }
+
+    if (arg == "-MD") {
+      writeDepfile = true;
+      continue;
+    }
+
+    if (arg == "-MF") {
+      depfilePath = helper::outputFileSuppliedAfterArg(argc, argv, i);
+      writeDepfile = true;
+      i++;
+      continue;
+    }
+
+    if (arg == "--time-passes") {
+      pass_timing::reportFormat = pass_timing::ReportFormat::TABLE;
+      continue;
+    }
+
+    if (arg == "--time-passes-json") {
+      pass_timing::reportFormat = pass_timing::ReportFormat::JSON;
+      continue;
+    }
+
+    if (arg == "--trace") {
+#if defined(DO_TRACING)
+      tracing::start(helper::outputFileSuppliedAfterArg(argc, argv, i));
+      i++;
+      continue;
+#else
+      helper::printErrorPrefix();
+      std::cerr << style_text::styleAsCode("--trace")
+                << " isn't supported by this build of the compiler (it has to be built with "
+                << style_text::styleAsCode("-DDO_TRACING=ON") << ").\n\n";
+      helper::exitWithHelpPageInfo(argv[0]);
+#endif
+    }
+
+    if (arg == "--watch") {
+      watchForChanges = true;
+      continue;
+    }
+
     // -v, --version
     if (arg == "-v" || arg == "--version") {
       helper::ensureArgIsOnlyArg(argc, argv, i);
@@ -109,13 +254,48 @@ ParseArgsResult parseArgs(int argc, const char** argv) {
       // -------------------------------------------------------------------------------- (80 chars)
         MCFUNC_BUILD_INFO_MSG "\n\n"
         "Usage: " << argv[0] << " [files] [arguments]\n"
+        "       " << argv[0] << " symbolize <SOURCE_MAP> [FILE]\n"
+        "       " << argv[0] << " batch <MANIFEST>\n"
+        "       " << argv[0] << " xref <INDEX> <NAME>\n"
+        "       " << argv[0] << " lsp\n"
         "Options:\n"
         "  -o <DIRECTORY>              Set the output directory (defaults to './data').\n"
         "  -i <DIRECTORY>              Recursively add files from an input directory.\n"
+        "  --include <GLOB>            Only add input directory files that match GLOB.\n"
+        "  --exclude <GLOB>            Skip paths in input directories that match GLOB.\n"
         "  -v, --version               Print version info.\n"
         "  -h, --help                  Print help info.\n"
         "  --no-color                  Disable styled printing (no color or bold text).\n"
-        "  --fresh                     Clear the output directory before compiling.\n";
+        "  --fresh                     Clear the output directory before compiling.\n"
+        "  --inline-scopes             Inline scopes that only hold 1 statement.\n"
+        "  --dedup-functions           Merge function files with identical contents.\n"
+        "  --factor-execute            Share execute prefixes where it's safe to.\n"
+        "  --tick-report               Print the estimated number of commands per tick.\n"
+        "  --max-tick-commands <N>     Fail if a tick is estimated to run over N commands.\n"
+        "  --instrument                Count how many times each function file runs.\n"
+        "  --source-map <FILE>         Write a source map for generated functions.\n"
+        "  --xref <FILE>               Write a cross-reference index for other tools.\n"
+        "  -MD                         Write a Make depfile to '<output directory>.d'.\n"
+        "  -MF <FILE>                  Write a Make depfile to FILE.\n"
+        "  --time-passes               Print how long each compiler pass took.\n"
+        "  --time-passes-json          Print how long each compiler pass took as JSON.\n"
+        << helper::traceHelpLine <<
+        "  --watch                     Rebuild whenever an input file changes.\n"
+        "\n"
+        "Paths matching a glob in an input directory's '.mcfuncignore' file (1 per line)\n"
+        "are skipped too. Globs without a '/' match names at any depth, '*' doesn't\n"
+        "match '/', and '**' matches anything.\n"
+        "\n"
+        "The symbolize command adds the source of every generated function name in FILE\n"
+        "(or stdin) using a source map, and prints the result.\n"
+        "\n"
+        "The batch command builds every data pack listed in a JSON manifest at once,\n"
+        "sharing threads and source files used by several packs.\n"
+        "\n"
+        "The xref command prints everywhere NAME (a function, output path, or import\n"
+        "path) is defined, declared, or used, using an index written with '--xref'.\n"
+        "\n"
+        "The lsp command runs a language server over stdin and stdout for editors.\n";
       // clang-format on
 
       exit(EXIT_SUCCESS);
@@ -144,6 +324,18 @@ ParseArgsResult parseArgs(int argc, const char** argv) {
       continue;
     }
 
+    if (arg == "--include") {
+      includeGlobs.push_back(helper::globSuppliedAfterArg(argc, argv, i));
+      i++;
+      continue;
+    }
+
+    if (arg == "--exclude") {
+      excludeGlobs.push_back(helper::globSuppliedAfterArg(argc, argv, i));
+      i++;
+      continue;
+    }
+
     // blank arguments
     if (arg.size() == 0) {
       helper::printErrorPrefix();
@@ -166,6 +358,10 @@ ParseArgsResult parseArgs(int argc, const char** argv) {
   if (!outputDirectoryAlreadyGiven)
     outputDirectory = std::filesystem::current_path() / "data";
 
+  // the default dependency file goes next to the output directory
+  if (writeDepfile && depfilePath.empty())
+    depfilePath = outputDirectory.string() + ".d";
+
   // handle input file arguments
   for (const std::string_view inputFileArg : inputFileArgs) {
     std::filesystem::path inputFile = inputFileArg;
@@ -192,9 +388,11 @@ ParseArgsResult parseArgs(int argc, const char** argv) {
     }
 
     helper::addSourceFileGivenPath(std::move(inputFile), std::move(inputFilePrefixToRemove),
-                                   sourceFiles, fileWriteSourceFiles);
+                                   sourceFiles, fileWriteSourceFiles, addedPaths);
   }
 
+  InputFilter inputFilter(includeGlobs, excludeGlobs);
+
   // handle input directory arguments
   for (const std::filesystem::path& inputDir : inputDirectories) {
 
@@ -215,40 +413,39 @@ ParseArgsResult parseArgs(int argc, const char** argv) {
       helper::exitWithHelpPageInfo(argv[0]);
     }
 
-    std::error_code ec;
-    if (!std::filesystem::exists(inputDir, ec) || ec ||
-        !std::filesystem::is_directory(inputDir, ec) || ec) {
+    if (!vfs::isDirectory(inputDir)) {
       helper::printWarningPrefix();
       std::cerr << "Ignoring input directory " << style_text::styleAsCode(inputDir.string())
                 << " because it doesn't exist or isn't a directory.\n";
       continue;
     }
 
-    // go through and recursively add all files
-    for (const auto& entry : std::filesystem::recursive_directory_iterator(inputDir, ec)) {
-      if (ec) {
-        helper::printErrorPrefix();
-        std::cerr << "Something went wrong with recursive directory iteration for input directory "
-                  << style_text::styleAsCode(inputDir.string()) << ".\n";
-        std::exit(EXIT_FAILURE);
-      }
-
-      std::filesystem::path entryPath = entry.path();
-
-      if (std::filesystem::is_directory(entryPath, ec))
-        continue;
+    // go through and recursively add all files (directories that are filtered
+    // out aren't read)
+    inputFilter.readIgnoreFile(inputDir);
+    std::vector<vfs::DirectoryEntry> entries;
+    if (!vfs::listFiles(inputDir, entries,
+                        [&inputFilter, &inputDir](const std::filesystem::path& path,
+                                                  bool isDirectory) {
+                          return inputFilter.includes(inputDir, path, isDirectory);
+                        })) {
+      helper::printErrorPrefix();
+      std::cerr << "Something went wrong with recursive directory iteration for input directory "
+                << style_text::styleAsCode(inputDir.string()) << ".\n";
+      helper::exitWithFailure();
+    }
 
-      if (ec || !std::filesystem::is_regular_file(entryPath, ec) || ec) {
+    for (vfs::DirectoryEntry& entry : entries) {
+      if (!entry.isRegularFile) {
         helper::printWarningPrefix();
-        std::cerr << "Ignoring file " << style_text::styleAsCode(entryPath.string())
+        std::cerr << "Ignoring file " << style_text::styleAsCode(entry.path.string())
                   << " from input directory " << style_text::styleAsCode(inputDir.string())
                   << " (file is not regular).\n";
-        ec.clear();
         continue;
       }
 
-      helper::addSourceFileGivenPath(inputDir / entryPath, std::filesystem::path(inputDir),
-                                     sourceFiles, fileWriteSourceFiles);
+      helper::addSourceFileGivenPath(std::move(entry.path), std::filesystem::path(inputDir),
+                                     sourceFiles, fileWriteSourceFiles, addedPaths);
     }
   }
 
@@ -259,7 +456,9 @@ ParseArgsResult parseArgs(int argc, const char** argv) {
   }
 
   return ParseArgsResult(std::move(outputDirectory), std::move(sourceFiles),
-                         std::move(fileWriteSourceFiles), clearOutputDirectory);
+                         std::move(fileWriteSourceFiles), clearOutputDirectory, compileOptions,
+                         std::move(sourceMapPath), std::move(depfilePath), std::move(xrefPath),
+                         std::move(inputDirectories), std::move(inputFilter), watchForChanges);
 }
 
 // ---------------------------------------------------------------------------//
@@ -276,6 +475,12 @@ static void helper::exitWithHelpPageInfo(const char* arg0) {
   std::cerr << "Try running " << style_text::styleAsCode(std::string(arg0) + " -h")
             << " for help info.\n";
 
+  exitWithFailure();
+}
+
+static void helper::exitWithFailure() {
+  if (!exitOnError)
+    throw InvalidArgsError();
   std::exit(EXIT_FAILURE);
 }
 
@@ -336,6 +541,68 @@ static std::filesystem::path helper::directorySuppliedAfterArg(int argc, const c
   return ret;
 }
 
+static std::filesystem::path helper::outputFileSuppliedAfterArg(int argc, const char** argv,
+                                                                int i) {
+  if (i + 1 >= argc) {
+    printErrorPrefix();
+    std::cerr << "No file was supplied after " << style_text::styleAsCode(argv[i]) << ".\n\n";
+    exitWithHelpPageInfo(argv[0]);
+  }
+
+  std::filesystem::path ret = argv[i + 1];
+  std::error_code ec;
+
+  if (!ret.is_absolute())
+    ret = std::filesystem::absolute(std::move(ret), ec);
+  ret = ret.lexically_normal();
+  if (ec || !ret.has_filename() || vfs::isDirectory(ret) ||
+      !vfs::isDirectory(ret.parent_path())) {
+    printErrorPrefix();
+    std::cerr << "The file " << style_text::styleAsCode(argv[i + 1])
+              << " is invalid (it can't be a directory and the directory it's in must exist).\n\n";
+    exitWithHelpPageInfo(argv[0]);
+  }
+
+  return ret;
+}
+
+static size_t helper::positiveNumberSuppliedAfterArg(int argc, const char** argv, int i) {
+  if (i + 1 >= argc) {
+    printErrorPrefix();
+    std::cerr << "No number was supplied after " << style_text::styleAsCode(argv[i]) << ".\n\n";
+    exitWithHelpPageInfo(argv[0]);
+  }
+
+  const std::string_view numberStr = argv[i + 1];
+  size_t ret = 0;
+  bool isValid = !numberStr.empty() && numberStr.size() <= 18;
+  for (size_t j = 0; isValid && j < numberStr.size(); j++) {
+    if (numberStr[j] < '0' || numberStr[j] > '9')
+      isValid = false;
+    else
+      ret = ret * 10 + (numberStr[j] - '0');
+  }
+
+  if (!isValid || ret == 0) {
+    printErrorPrefix();
+    std::cerr << "The number " << style_text::styleAsCode(argv[i + 1]) << " supplied after "
+              << style_text::styleAsCode(argv[i]) << " is invalid (it should be above 0).\n\n";
+    exitWithHelpPageInfo(argv[0]);
+  }
+
+  return ret;
+}
+
+static std::string helper::globSuppliedAfterArg(int argc, const char** argv, int i) {
+  if (i + 1 >= argc || argv[i + 1][0] == '\0') {
+    printErrorPrefix();
+    std::cerr << "No glob was supplied after " << style_text::styleAsCode(argv[i]) << ".\n\n";
+    exitWithHelpPageInfo(argv[0]);
+  }
+
+  return argv[i + 1];
+}
+
 static void helper::warnAboutFileSuppliedMoreThanOnce(const std::filesystem::path& path) {
   helper::printWarningPrefix();
   std::cerr << "The file " << style_text::styleAsCode(path.string()) << " was supplied twice.\n";
@@ -344,36 +611,19 @@ static void helper::warnAboutFileSuppliedMoreThanOnce(const std::filesystem::pat
 static void helper::addSourceFileGivenPath(std::filesystem::path&& path,
                                            std::filesystem::path&& pathPrefixToRemove,
                                            SourceFiles& sourceFiles,
-                                           std::vector<FileWriteSourceFile>& fileWriteSourceFiles) {
-  // if it's a *source* file
-  if (path.extension() == ".mcfunc") {
-
-    // warn about the same file being added twice
-    // Note: this does not handle the case where the same file is added twice
-    // via symlink
-    for (const SourceFile& sourceFile : sourceFiles) {
-      if (sourceFile.path() == path) {
-        helper::warnAboutFileSuppliedMoreThanOnce(path);
-        break;
-      }
-    }
+                                           std::vector<FileWriteSourceFile>& fileWriteSourceFiles,
+                                           std::unordered_set<std::filesystem::path>& addedPaths) {
+  // warn about the same file being added twice
+  // Note: this does not handle the case where the same file is added twice
+  // via symlink
+  if (!addedPaths.insert(path).second)
+    helper::warnAboutFileSuppliedMoreThanOnce(path);
 
+  // if it's a *source* file
+  if (path.extension() == ".mcfunc")
     sourceFiles.emplace_back(std::move(path), std::move(pathPrefixToRemove));
-  }
 
   // if it's a file write source file
-  else {
-
-    // warn about the same file being added twice
-    // Note: this does not handle the case where the same file is added twice
-    // via symlink
-    for (const FileWriteSourceFile& fileWriteSourceFile : fileWriteSourceFiles) {
-      if (fileWriteSourceFile.path() == path) {
-        helper::warnAboutFileSuppliedMoreThanOnce(path);
-        break;
-      }
-    }
-
+  else
     fileWriteSourceFiles.emplace_back(std::move(path), std::move(pathPrefixToRemove));
-  }
 }
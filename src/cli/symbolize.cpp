@@ -0,0 +1,120 @@
+#include <cli/symbolize.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <unordered_map>
+
+#include <cli/style_text.h>
+#include <compiler/compile_error.h>
+#include <compiler/fileToStr.h>
+#include <compiler/json.h>
+
+namespace {
+namespace helper {
+
+/// Whether \param c can be part of a function call name (e.g. "foo:bar/baz").
+static bool isFuncCallNameChar(char c);
+
+/// Returns what's added after a function call name given its source map entry
+/// (e.g. " (scope in bar at src/main.mcfunc:5:27)"), or an empty string if
+/// there's nothing to add.
+static std::string annotationFromEntry(const json::Value& entry);
+
+} // namespace helper
+} // namespace
+
+std::string symbolizeText(const std::string& text, const std::string& sourceMapText) {
+  const json::Value sourceMap = json::parse(sourceMapText);
+  if (!sourceMap["functions"].isObject())
+    throw json::ParseError("Expected the source map to have a \"functions\" object", 0);
+
+  std::unordered_map<std::string, std::string> annotations;
+  for (const auto& [funcCallName, entry] : sourceMap["functions"].asObject()) {
+    std::string annotation = helper::annotationFromEntry(entry);
+    if (!annotation.empty())
+      annotations[funcCallName] = std::move(annotation);
+  }
+
+  // look at each run of characters that could be a function call name
+  std::string ret;
+  ret.reserve(text.size());
+  size_t i = 0;
+  while (i < text.size()) {
+    if (!helper::isFuncCallNameChar(text[i])) {
+      ret += text[i++];
+      continue;
+    }
+
+    const size_t start = i;
+    while (i < text.size() && helper::isFuncCallNameChar(text[i]))
+      i++;
+    const std::string word = text.substr(start, i - start);
+    ret += word;
+
+    const auto it = annotations.find(word);
+    if (it != annotations.end())
+      ret += it->second;
+  }
+
+  return ret;
+}
+
+int symbolize(int argc, const char** argv) {
+  if (argc < 3 || argc > 4) {
+    std::cerr << style_text::styleAsError("CLI Error: ") << "Expected "
+              << style_text::styleAsCode(std::string(argv[0]) + " symbolize <SOURCE_MAP> [FILE]")
+              << ".\n";
+    return EXIT_FAILURE;
+  }
+
+  try {
+    const std::string sourceMapText = fileToStr(argv[2]);
+
+    std::string text;
+    if (argc == 4)
+      text = fileToStr(argv[3]);
+    else
+      text.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+
+    std::cout << symbolizeText(text, sourceMapText);
+
+  } catch (const compile_error::Generic& e) {
+    std::cerr << e.what();
+    return EXIT_FAILURE;
+  } catch (const json::ParseError& e) {
+    std::cerr << style_text::styleAsError("CLI Error: ") << "The source map "
+              << style_text::styleAsCode(argv[2]) << " is invalid: " << e.what() << ".\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static bool helper::isFuncCallNameChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '-' || c == '.' ||
+         c == '/' || c == ':';
+}
+
+static std::string helper::annotationFromEntry(const json::Value& entry) {
+  const json::Value& kind = entry["kind"];
+  const json::Value& funcName = entry["function"];
+  const json::Value& file = entry["file"];
+  if (!kind.isString() || !funcName.isString() || !file.isString())
+    return "";
+
+  std::string ret = " (";
+  if (kind.asString() != "function")
+    ret += kind.asString() + " in ";
+  ret += funcName.asString() + " at " + file.asString();
+  if (entry["line"].isNumber()) {
+    ret += ':' + std::to_string(static_cast<size_t>(entry["line"].asNumber()));
+    if (entry["column"].isNumber())
+      ret += ':' + std::to_string(static_cast<size_t>(entry["column"].asNumber()));
+  }
+  return ret + ')';
+}
@@ -0,0 +1,208 @@
+#include <cli/watch.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <system_error>
+
+#include <cli/FileWatcher.h>
+#include <cli/style_text.h>
+#include <compiler/IncrementalBuild.h>
+#include <compiler/compile_error.h>
+#include <compiler/pass_timing.h>
+#include <compiler/tracing.h>
+
+namespace {
+namespace helper {
+
+/// Watches every file and input directory in \param parsedArgs .
+static std::unique_ptr<FileWatcher> watchInputs(const ParseArgsResult& parsedArgs);
+
+/// Whether any of \param changedPaths is a new file or a file that was
+/// removed (meaning the build has to start over). New files that the input
+/// filter in \param parsedArgs skips don't count.
+static bool filesWereAddedOrRemoved(const IncrementalBuild& build,
+                                    const ParseArgsResult& parsedArgs,
+                                    const std::vector<std::filesystem::path>& changedPaths);
+
+/// Whether \param path is in one of the input directories in
+/// \param parsedArgs but the input filter skips it.
+static bool isFilteredOut(const ParseArgsResult& parsedArgs, const std::filesystem::path& path);
+
+/// Prints the tick report and how many functions were merged (if those options
+/// are on).
+static void printLinkInfo(const IncrementalBuild& build);
+
+/// Prints how long each pass took since the last time this was called (if
+/// '--time-passes' was given).
+static void printPassTimes();
+
+/// The number of milliseconds since \param startTime .
+static long long millisecondsSince(std::chrono::steady_clock::time_point startTime);
+
+} // namespace helper
+} // namespace
+
+int watch(int argc, const char** argv, ParseArgsResult&& parsedArgs) {
+  std::unique_ptr<IncrementalBuild> build;
+
+  while (true) {
+    // start watching before building so changes made during the build are seen
+    std::unique_ptr<FileWatcher> fileWatcher;
+    try {
+      fileWatcher = helper::watchInputs(parsedArgs);
+    } catch (const std::system_error& e) {
+      std::cerr << style_text::styleAsError("CLI Error: ") << e.what() << ".\n";
+      return EXIT_FAILURE;
+    }
+
+    auto newBuild = std::make_unique<IncrementalBuild>(
+        std::move(parsedArgs.outputDirectory), std::move(parsedArgs.sourceFiles),
+        std::move(parsedArgs.fileWriteSourceFiles), parsedArgs.compileOptions,
+        std::move(parsedArgs.sourceMapPath), std::move(parsedArgs.xrefPath));
+    if (build)
+      newBuild->continueFrom(std::move(*build));
+    build = std::move(newBuild);
+
+    auto startTime = std::chrono::steady_clock::now();
+    try {
+      build->buildAll(parsedArgs.clearOutputDirectory);
+      helper::printLinkInfo(*build);
+      helper::printPassTimes();
+      TRACE_WRITE();
+      std::cout << "Built in " << helper::millisecondsSince(startTime) << " ms.\n";
+    } catch (const compile_error::Generic& e) {
+      std::cerr << e.what();
+    }
+    std::cout << "Watching for changes..." << std::endl;
+
+    while (true) {
+      std::vector<std::filesystem::path> changedPaths;
+      try {
+        changedPaths = fileWatcher->waitForChanges();
+      } catch (const std::system_error& e) {
+        std::cerr << style_text::styleAsError("CLI Error: ") << e.what() << ".\n";
+        return EXIT_FAILURE;
+      }
+
+      if (helper::filesWereAddedOrRemoved(*build, parsedArgs, changedPaths)) {
+        std::cout << "Files were added or removed, rebuilding everything." << std::endl;
+        TRACE_RESET();
+        try {
+          parsedArgs = parseArgs(argc, argv, false);
+        } catch (const InvalidArgsError&) {
+          // the last build is kept until the arguments work again
+          std::cout << "Watching for changes..." << std::endl;
+          continue;
+        }
+        // only clear the output directory the first time
+        parsedArgs.clearOutputDirectory = false;
+        break;
+      }
+
+      // each trace only has the latest build
+      TRACE_RESET();
+      startTime = std::chrono::steady_clock::now();
+      try {
+        const IncrementalBuild::UpdateResult result = build->update(changedPaths);
+        if (!result.rebuilt)
+          continue;
+
+        helper::printLinkInfo(*build);
+        helper::printPassTimes();
+        TRACE_WRITE();
+        std::cout << "Rebuilt in " << helper::millisecondsSince(startTime) << " ms ("
+                  << result.recompiledSourceFileCount << " source file"
+                  << ((result.recompiledSourceFileCount == 1) ? "" : "s") << " compiled, "
+                  << result.checkedImporterCount << " importer"
+                  << ((result.checkedImporterCount == 1) ? "" : "s") << " checked, "
+                  << result.changedOutputFileCount << " output file"
+                  << ((result.changedOutputFileCount == 1) ? "" : "s") << " changed)."
+                  << std::endl;
+      } catch (const compile_error::Generic& e) {
+        std::cerr << e.what() << std::flush;
+      }
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static std::unique_ptr<FileWatcher> helper::watchInputs(const ParseArgsResult& parsedArgs) {
+  std::vector<std::filesystem::path> files;
+  files.reserve(parsedArgs.sourceFiles.size() + parsedArgs.fileWriteSourceFiles.size());
+  for (const SourceFile& sourceFile : parsedArgs.sourceFiles)
+    files.push_back(sourceFile.path());
+  for (const FileWriteSourceFile& fileWriteSourceFile : parsedArgs.fileWriteSourceFiles)
+    files.push_back(fileWriteSourceFile.path());
+
+  return std::make_unique<FileWatcher>(files, parsedArgs.inputDirectories);
+}
+
+static bool helper::filesWereAddedOrRemoved(
+    const IncrementalBuild& build, const ParseArgsResult& parsedArgs,
+    const std::vector<std::filesystem::path>& changedPaths) {
+  for (const std::filesystem::path& path : changedPaths) {
+    std::error_code ec;
+    const bool exists = std::filesystem::exists(path, ec) && !ec;
+
+    // files that were added and removed again before we looked don't matter
+    if (build.hasFile(path) == exists)
+      continue;
+    if (exists && helper::isFilteredOut(parsedArgs, path))
+      continue;
+    return true;
+  }
+  return false;
+}
+
+static bool helper::isFilteredOut(const ParseArgsResult& parsedArgs,
+                                  const std::filesystem::path& path) {
+  // a changed ignore file changes which files are compiled
+  if (path.filename() == InputFilter::ignoreFileName)
+    return false;
+
+  bool isInInputDirectory = false;
+  for (const std::filesystem::path& inputDirectory : parsedArgs.inputDirectories) {
+    const auto [directoryEnd, _] =
+        std::mismatch(inputDirectory.begin(), inputDirectory.end(), path.begin(), path.end());
+    if (directoryEnd != inputDirectory.end() || path == inputDirectory)
+      continue;
+
+    isInInputDirectory = true;
+    if (parsedArgs.inputFilter.includesFile(inputDirectory, path))
+      return false;
+  }
+  return isInInputDirectory;
+}
+
+static void helper::printLinkInfo(const IncrementalBuild& build) {
+  const CompileOptions& compileOptions = build.compileOptions();
+  const LinkResult& linkResult = build.linkResult();
+
+  if (compileOptions.reportTickCost)
+    std::cout << linkResult.tickCostReport.str();
+
+  if (compileOptions.deduplicateFunctions) {
+    std::cout << "Merged " << linkResult.deduplicatedFunctionCount << " duplicate function file"
+              << ((linkResult.deduplicatedFunctionCount == 1) ? "" : "s") << ".\n";
+  }
+}
+
+static void helper::printPassTimes() {
+  if (pass_timing::reportFormat == pass_timing::ReportFormat::NONE)
+    return;
+
+  std::cerr << pass_timing::report();
+  pass_timing::reset();
+}
+
+static long long helper::millisecondsSince(std::chrono::steady_clock::time_point startTime) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                               startTime)
+      .count();
+}
@@ -0,0 +1,91 @@
+#include <cli/xref.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <unordered_map>
+
+#include <cli/style_text.h>
+#include <compiler/compile_error.h>
+#include <compiler/vfs.h>
+
+namespace {
+namespace helper {
+
+/// The line and column (both starting at 1) of \param indexInFile in
+/// \param contents .
+static std::string lineAndColumn(const std::string& contents, size_t indexInFile);
+
+} // namespace helper
+} // namespace
+
+std::string xrefText(const XrefIndex& index, std::string_view name) {
+  // each file is only read once (or not at all if it can't be)
+  std::unordered_map<std::string_view, std::optional<std::string>> fileContents;
+
+  std::string ret;
+  for (const XrefIndex::Entry& entry : index.find(name)) {
+    auto it = fileContents.find(entry.filePath);
+    if (it == fileContents.end()) {
+      std::string contents;
+      std::optional<std::string> value;
+      if (vfs::readFile(entry.filePath, contents))
+        value = std::move(contents);
+      it = fileContents.emplace(entry.filePath, std::move(value)).first;
+    }
+
+    ret += entry.filePath;
+    if (it->second.has_value() && entry.indexInFile < it->second->size())
+      ret += ':' + helper::lineAndColumn(*it->second, entry.indexInFile);
+    else
+      ret += " (byte " + std::to_string(entry.indexInFile) + ')';
+    ret += ": ";
+    ret += XrefIndex::kindName(entry.kind);
+    ret += '\n';
+  }
+  return ret;
+}
+
+int xref(int argc, const char** argv) {
+  if (argc != 4) {
+    std::cerr << style_text::styleAsError("CLI Error: ") << "Expected "
+              << style_text::styleAsCode(std::string(argv[0]) + " xref <INDEX> <NAME>") << ".\n";
+    return EXIT_FAILURE;
+  }
+
+  try {
+    const XrefIndex index(argv[2]);
+    const std::string text = xrefText(index, argv[3]);
+    if (text.empty()) {
+      std::cerr << style_text::styleAsCode(argv[3]) << " isn't in the index.\n";
+      return EXIT_FAILURE;
+    }
+    std::cout << text;
+
+  } catch (const compile_error::Generic& e) {
+    std::cerr << e.what();
+    return EXIT_FAILURE;
+  } catch (const XrefIndex::FormatError& e) {
+    std::cerr << style_text::styleAsError("CLI Error: ") << "The index "
+              << style_text::styleAsCode(argv[2]) << " is invalid: " << e.what() << ".\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static std::string helper::lineAndColumn(const std::string& contents, size_t indexInFile) {
+  size_t line = 1;
+  size_t lineStart = 0;
+  for (size_t i = 0; i < indexInFile; i++) {
+    if (contents[i] == '\n') {
+      line++;
+      lineStart = i + 1;
+    }
+  }
+  return std::to_string(line) + ':' + std::to_string(indexInFile - lineStart + 1);
+}
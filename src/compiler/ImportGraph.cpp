@@ -0,0 +1,75 @@
+#include <compiler/ImportGraph.h>
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+#include <compiler/fnv1aHash.h>
+
+ImportGraph::ImportGraph(const SourceFiles& sourceFiles)
+    : m_imports(sourceFiles.size()), m_importers(sourceFiles.size()) {
+  for (size_t i = 0; i < sourceFiles.size(); i++)
+    updateImports(sourceFiles, i);
+}
+
+void ImportGraph::updateImports(const SourceFiles& sourceFiles, size_t index) {
+  assert(index < m_imports.size() && "source file index is out of range");
+
+  for (const size_t importedIndex : m_imports[index]) {
+    std::vector<size_t>& importers = m_importers[importedIndex];
+    importers.erase(std::find(importers.begin(), importers.end(), index));
+  }
+  m_imports[index].clear();
+
+  for (const symbol::Import& importSymbol : sourceFiles[index].importSymbolTable()) {
+    // imports point into the same source files object
+    const size_t importedIndex = &importSymbol.sourceFile() - sourceFiles.data();
+    assert(importedIndex < sourceFiles.size() && "import points to a different source file list");
+
+    m_imports[index].push_back(importedIndex);
+    m_importers[importedIndex].push_back(index);
+  }
+}
+
+void ImportGraph::resize(size_t sourceFileCount) {
+  assert(sourceFileCount >= m_imports.size() && "source files can't be removed");
+  m_imports.resize(sourceFileCount);
+  m_importers.resize(sourceFileCount);
+}
+
+const std::vector<size_t>& ImportGraph::importsOf(size_t index) const {
+  assert(index < m_imports.size() && "source file index is out of range");
+  return m_imports[index];
+}
+
+const std::vector<size_t>& ImportGraph::importersOf(size_t index) const {
+  assert(index < m_importers.size() && "source file index is out of range");
+  return m_importers[index];
+}
+
+uint64_t ImportGraph::interfaceHash(const SourceFile& sourceFile) {
+  // declarations are sorted so that moving them around doesn't change the hash
+  std::vector<std::string> declarations;
+  for (const symbol::Function& func : sourceFile.functionSymbolTable()) {
+    if (!func.isPublic())
+      continue;
+
+    std::string declaration = func.name();
+    declaration += func.isDefined() ? " defined" : " declared";
+    if (func.isTickFunc()) {
+      declaration += " tick " + std::to_string(static_cast<int>(func.tickSchedule().kind)) + ' ' +
+                     std::to_string(func.tickSchedule().period);
+    }
+    if (func.isLoadFunc())
+      declaration += " load";
+    if (func.isExposed())
+      declaration += " expose " + func.exposeAddress();
+    declarations.push_back(std::move(declaration));
+  }
+  std::sort(declarations.begin(), declarations.end());
+
+  uint64_t ret = fnv1aHashStart;
+  for (const std::string& declaration : declarations)
+    ret = fnv1aHash(std::string_view(declaration.c_str(), declaration.size() + 1), ret);
+  return ret;
+}
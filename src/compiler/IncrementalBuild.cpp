@@ -0,0 +1,194 @@
+#include <compiler/IncrementalBuild.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include <compiler/fileToStr.h>
+#include <compiler/fnv1aHash.h>
+#include <compiler/generation/addTickAndLoadFuncsToSharedTag.h>
+#include <compiler/generation/generateDataPack.h>
+#include <compiler/generation/generateXrefIndex.h>
+#include <compiler/generation/writeFileToDataPack.h>
+#include <compiler/translation/compileSourceFile.h>
+
+IncrementalBuild::IncrementalBuild(std::filesystem::path&& outputDirectory,
+                                   SourceFiles&& sourceFiles,
+                                   std::vector<FileWriteSourceFile>&& fileWriteSourceFiles,
+                                   const CompileOptions& compileOptions,
+                                   std::filesystem::path&& sourceMapPath,
+                                   std::filesystem::path&& xrefPath)
+    : m_outputDirectory(std::move(outputDirectory)), m_sourceFiles(std::move(sourceFiles)),
+      m_fileWriteSourceFiles(std::move(fileWriteSourceFiles)), m_compileOptions(compileOptions),
+      m_sourceMapPath(std::move(sourceMapPath)), m_xrefPath(std::move(xrefPath)),
+      m_contentHashes(m_sourceFiles.size()) {
+  m_sourceFileIndices.reserve(m_sourceFiles.size());
+  for (size_t i = 0; i < m_sourceFiles.size(); i++)
+    m_sourceFileIndices[m_sourceFiles[i].path()] = i;
+}
+
+void IncrementalBuild::continueFrom(IncrementalBuild&& previous) {
+  if (!previous.m_hasWrittenDataPack || previous.m_outputDirectory != m_outputDirectory)
+    return;
+  m_hasWrittenDataPack = true;
+  m_linkResult = std::move(previous.m_linkResult);
+}
+
+void IncrementalBuild::buildAll(bool clearOutputDirectory) {
+  m_needsFullBuild = true;
+  m_dirtySourceFiles.clear();
+  m_compiledSourceFiles.clear();
+  for (SourceFile& sourceFile : m_sourceFiles)
+    sourceFile.clearEvaluation();
+  std::fill(m_contentHashes.begin(), m_contentHashes.end(), std::nullopt);
+
+  m_compiledSourceFiles = m_sourceFiles.evaluateAll(m_compileOptions);
+  // saving a file without changing it shouldn't compile it again
+  for (size_t i = 0; i < m_sourceFiles.size(); i++)
+    m_contentHashes[i] = m_sourceFiles[i].contentHash();
+  m_importGraph = ImportGraph(m_sourceFiles);
+  m_interfaceHashes.resize(m_sourceFiles.size());
+  for (size_t i = 0; i < m_sourceFiles.size(); i++)
+    m_interfaceHashes[i] = ImportGraph::interfaceHash(m_sourceFiles[i]);
+  m_importsToCheck.assign(m_sourceFiles.size(), true);
+  m_needsFullBuild = false;
+
+  m_needsLink = true;
+  linkAndWrite(clearOutputDirectory);
+  m_needsLink = false;
+}
+
+IncrementalBuild::UpdateResult IncrementalBuild::update(
+    const std::vector<std::filesystem::path>& changedPaths) {
+  UpdateResult ret;
+
+  if (m_needsFullBuild) {
+    buildAll(false);
+    ret.rebuilt = true;
+    ret.recompiledSourceFileCount = m_sourceFiles.size();
+    return ret;
+  }
+
+  bool needsLink = m_needsLink;
+  for (const std::filesystem::path& path : changedPaths) {
+    const auto it = m_sourceFileIndices.find(path);
+    if (it == m_sourceFileIndices.end()) {
+      // file write source files are copied again when the data pack is written
+      if (hasFile(path)) {
+        m_changedFileWriteSourcePaths.insert(path);
+        needsLink = true;
+      }
+      continue;
+    }
+
+    // editors often save files without changing them
+    const uint64_t hash = fnv1aHash(fileToStr(path));
+    if (m_contentHashes[it->second] == hash)
+      continue;
+    m_contentHashes[it->second] = hash;
+    m_dirtySourceFiles.insert(it->second);
+  }
+
+  if (m_dirtySourceFiles.empty() && !needsLink)
+    return ret;
+
+  // files are compiled in order so the same error is always reported first
+  while (!m_dirtySourceFiles.empty()) {
+    const size_t index = *m_dirtySourceFiles.begin();
+    reevaluate(index);
+    m_dirtySourceFiles.erase(m_dirtySourceFiles.begin());
+    ret.recompiledSourceFileCount++;
+  }
+
+  ret.checkedImporterCount = std::count(m_importsToCheck.begin(), m_importsToCheck.end(), true) -
+                            ret.recompiledSourceFileCount;
+
+  m_needsLink = true;
+  ret.changedOutputFileCount = linkAndWrite(false);
+  m_needsLink = false;
+  ret.rebuilt = true;
+  return ret;
+}
+
+bool IncrementalBuild::hasFile(const std::filesystem::path& path) const {
+  if (m_sourceFileIndices.count(path))
+    return true;
+  return std::any_of(m_fileWriteSourceFiles.begin(), m_fileWriteSourceFiles.end(),
+                     [&path](const FileWriteSourceFile& file) { return file.path() == path; });
+}
+
+const CompileOptions& IncrementalBuild::compileOptions() const { return m_compileOptions; }
+
+const LinkResult& IncrementalBuild::linkResult() const { return m_linkResult; }
+
+void IncrementalBuild::reevaluate(size_t index) {
+  assert(index < m_sourceFiles.size() && "source file index is out of range");
+
+  // Other source files that import this one hold a reference to it, so it's
+  // evaluated again in place rather than being replaced.
+  SourceFile& sourceFile = m_sourceFiles[index];
+  sourceFile.clearEvaluation();
+  sourceFile.tokenize();
+  sourceFile.analyzeSyntax(m_sourceFiles);
+  m_compiledSourceFiles[index] = compileSourceFile(sourceFile, m_compileOptions);
+
+  m_importGraph.updateImports(m_sourceFiles, index);
+  m_importsToCheck[index] = true;
+
+  // early cutoff: files importing this one only see its public declarations
+  const uint64_t interfaceHash = ImportGraph::interfaceHash(sourceFile);
+  if (interfaceHash == m_interfaceHashes[index])
+    return;
+  m_interfaceHashes[index] = interfaceHash;
+  for (const size_t importerIndex : m_importGraph.importersOf(index))
+    m_importsToCheck[importerIndex] = true;
+}
+
+size_t IncrementalBuild::linkAndWrite(bool clearOutputDirectory) {
+  LinkResult linkResult = link(m_compiledSourceFiles, m_sourceFiles, m_fileWriteSourceFiles,
+                               m_compileOptions, m_importsToCheck);
+  std::fill(m_importsToCheck.begin(), m_importsToCheck.end(), false);
+
+  size_t ret;
+  if (!m_hasWrittenDataPack) {
+    generateDataPack(m_outputDirectory, linkResult.exposedNamespaces, linkResult.fileWriteMap,
+                     linkResult.fileCopyMap, clearOutputDirectory, linkResult.tickFuncCallNames,
+                     linkResult.loadFuncCallNames);
+    ret = linkResult.fileWriteMap.size() + linkResult.fileCopyMap.size();
+  } else {
+    ret = updateDataPack(m_outputDirectory, m_linkResult.fileWriteMap, linkResult.fileWriteMap,
+                         m_linkResult.fileCopyMap, linkResult.fileCopyMap,
+                         m_changedFileWriteSourcePaths);
+    if (linkResult.tickFuncCallNames != m_linkResult.tickFuncCallNames ||
+        linkResult.loadFuncCallNames != m_linkResult.loadFuncCallNames ||
+        linkResult.exposedNamespaces != m_linkResult.exposedNamespaces) {
+      // entries from namespaces that are no longer exposed are removed too
+      std::vector<std::string> exposedNamespaces = linkResult.exposedNamespaces;
+      for (const std::string& previousNamespace : m_linkResult.exposedNamespaces) {
+        if (std::find(exposedNamespaces.begin(), exposedNamespaces.end(), previousNamespace) ==
+            exposedNamespaces.end())
+          exposedNamespaces.push_back(previousNamespace);
+      }
+      addTickAndLoadFuncsToSharedTag(m_outputDirectory, linkResult.tickFuncCallNames,
+                                     linkResult.loadFuncCallNames, exposedNamespaces);
+    }
+  }
+
+  if (m_compileOptions.generateSourceMap &&
+      (!m_hasWrittenDataPack || linkResult.sourceMap != m_linkResult.sourceMap)) {
+    writeFileToDataPack(m_sourceMapPath.parent_path(), m_sourceMapPath.filename(),
+                        linkResult.sourceMap);
+  }
+
+  if (!m_xrefPath.empty()) {
+    std::string xrefIndex = generateXrefIndex(m_sourceFiles);
+    if (!m_hasWrittenDataPack || xrefIndex != m_xrefIndex) {
+      writeFileToDataPack(m_xrefPath.parent_path(), m_xrefPath.filename(), xrefIndex);
+      m_xrefIndex = std::move(xrefIndex);
+    }
+  }
+
+  m_hasWrittenDataPack = true;
+  m_changedFileWriteSourcePaths.clear();
+  m_linkResult = std::move(linkResult);
+  return ret;
+}
@@ -0,0 +1,171 @@
+#include <compiler/Jobserver.h>
+
+#include <cstdlib>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace {
+namespace helper {
+
+/// Gets what's after the last '--jobserver-auth=' (or '--jobserver-fds=' from
+/// before Make 4.2) in \param makeFlags . Returns an empty string if there
+/// isn't one.
+static std::string jobserverAuthFromMakeFlags(std::string_view makeFlags);
+
+} // namespace helper
+} // namespace
+
+Jobserver::Jobserver() {
+  const char* makeFlags = std::getenv("MAKEFLAGS");
+  if (makeFlags == nullptr)
+    return;
+
+  const std::string auth = helper::jobserverAuthFromMakeFlags(makeFlags);
+  if (!auth.empty() && !connect(auth))
+    disconnect();
+}
+
+Jobserver::~Jobserver() {
+  while (!m_tokens.empty())
+    release();
+  disconnect();
+}
+
+bool Jobserver::isConnected() const { return m_readFD != -1; }
+
+#if defined(__unix__) || defined(__APPLE__)
+
+bool Jobserver::tryAcquire() {
+  if (!isConnected())
+    return false;
+
+  if (m_readCanBlock) {
+    // another process could take the token between the poll and the read, so
+    // this is only used when a non-blocking file descriptor couldn't be opened
+    pollfd pollFD{m_readFD, POLLIN, 0};
+    if (poll(&pollFD, 1, 0) != 1 || !(pollFD.revents & POLLIN))
+      return false;
+  }
+
+  char token;
+  ssize_t bytesRead;
+  do {
+    bytesRead = read(m_readFD, &token, 1);
+  } while (bytesRead == -1 && errno == EINTR);
+  if (bytesRead != 1)
+    return false;
+
+  std::lock_guard<std::mutex> lock(m_tokensMutex);
+  m_tokens.push_back(token);
+  return true;
+}
+
+void Jobserver::release() {
+  std::lock_guard<std::mutex> lock(m_tokensMutex);
+  if (m_tokens.empty())
+    return;
+
+  const char token = m_tokens.back();
+  m_tokens.pop_back();
+
+  ssize_t bytesWritten;
+  do {
+    bytesWritten = write(m_writeFD, &token, 1);
+  } while (bytesWritten == -1 && errno == EINTR);
+}
+
+bool Jobserver::connect(const std::string& auth) {
+  // Make 4.4+ uses a named FIFO ("fifo:PATH")
+  if (auth.compare(0, 5, "fifo:") == 0) {
+    m_readFD = open(auth.c_str() + 5, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    m_writeFD = m_readFD;
+    m_ownsFDs = true;
+    return m_readFD != -1;
+  }
+
+  // older versions pass the 2 ends of a pipe ("R,W")
+  char* end;
+  const long readFD = std::strtol(auth.c_str(), &end, 10);
+  if (end == auth.c_str() || *end != ',')
+    return false;
+  const char* writeFDStr = end + 1;
+  const long writeFD = std::strtol(writeFDStr, &end, 10);
+  if (end == writeFDStr || *end != '\0' || readFD < 0 || writeFD < 0)
+    return false;
+
+  // Make closes the pipe for commands it doesn't think are recursive makes
+  // (unless they're marked with '+'), the numbers could be reused by now
+  if (fcntl(static_cast<int>(readFD), F_GETFD) == -1 ||
+      fcntl(static_cast<int>(writeFD), F_GETFD) == -1) {
+    return false;
+  }
+
+  // the pipe is shared with Make so it can't be made non-blocking, but opening
+  // it again gives a separate file description that can be
+#if defined(__linux__)
+  const std::string procPath = "/proc/self/fd/" + std::to_string(readFD);
+  const int ownReadFD = open(procPath.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+  if (ownReadFD != -1) {
+    m_readFD = ownReadFD;
+    m_writeFD = static_cast<int>(writeFD);
+    m_ownsFDs = true;
+    return true;
+  }
+#endif
+
+  m_readFD = static_cast<int>(readFD);
+  m_writeFD = static_cast<int>(writeFD);
+  m_readCanBlock = true;
+  return true;
+}
+
+void Jobserver::disconnect() {
+  if (m_ownsFDs && m_readFD != -1)
+    close(m_readFD);
+  m_readFD = -1;
+  m_writeFD = -1;
+  m_ownsFDs = false;
+}
+
+#else
+
+bool Jobserver::tryAcquire() { return false; }
+
+void Jobserver::release() {}
+
+bool Jobserver::connect(const std::string&) { return false; }
+
+void Jobserver::disconnect() {}
+
+#endif
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static std::string helper::jobserverAuthFromMakeFlags(std::string_view makeFlags) {
+  std::string_view ret;
+
+  size_t wordStart = 0;
+  while (wordStart < makeFlags.size()) {
+    size_t wordEnd = makeFlags.find(' ', wordStart);
+    if (wordEnd == std::string_view::npos)
+      wordEnd = makeFlags.size();
+    const std::string_view word = makeFlags.substr(wordStart, wordEnd - wordStart);
+
+    for (const std::string_view prefix : {"--jobserver-auth=", "--jobserver-fds="}) {
+      if (word.compare(0, prefix.size(), prefix) == 0)
+        ret = word.substr(prefix.size());
+    }
+
+    wordStart = wordEnd + 1;
+  }
+
+  return std::string(ret);
+}
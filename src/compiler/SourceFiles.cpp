@@ -4,18 +4,31 @@
 #include <cassert>
 #include <exception>
 #include <filesystem>
-#include <future>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <cli/style_text.h>
+#include <compiler/CompileOptions.h>
 #include <compiler/UniqueID.h>
 #include <compiler/compile_error.h>
 #include <compiler/generateImportPath.h>
+#include <compiler/runInParallel.h>
 #include <compiler/syntax_analysis/symbol.h>
 #include <compiler/tokenization/Token.h>
+#include <compiler/tracing.h>
 #include <compiler/translation/compileSourceFile.h>
 
+/// How many chunks of source files there are for each thread that could be
+/// used by \p SourceFiles::evaluateAll() (more chunks balance the work better).
+static constexpr size_t chunksPerThread = 8;
+
+/// The most threads that \p runInParallel() will use.
+static size_t maxThreadCount() { return std::max(1u, std::thread::hardware_concurrency()); }
+
 // NOTE: SourceFile::tokenize() and SourceFile::analyzeSyntax(), and are defined
 // in separate files.
 
@@ -24,23 +37,31 @@
 SourceFile::SourceFile(const std::filesystem::path& filePath,
                        const std::filesystem::path& prefixToRemoveForImporting)
     : m_filePath(filePath),
-      m_importFilePath(generateImportPath(m_filePath, prefixToRemoveForImporting)),
-      m_fileID(UniqueID::Kind::SOURCE_FILE) {}
+      m_importFilePath(generateImportPath(m_filePath, prefixToRemoveForImporting)) {}
 
 SourceFile::SourceFile(std::filesystem::path&& filePath,
                        const std::filesystem::path& prefixToRemoveForImporting)
     : m_filePath(std::move(filePath)),
-      m_importFilePath(generateImportPath(m_filePath, prefixToRemoveForImporting)),
-      m_fileID(UniqueID::Kind::SOURCE_FILE) {}
+      m_importFilePath(generateImportPath(m_filePath, prefixToRemoveForImporting)) {}
 
 const std::filesystem::path& SourceFile::path() const { return m_filePath; }
 
 const std::filesystem::path& SourceFile::importPath() const { return m_importFilePath; }
 
-UniqueID SourceFile::fileID() const { return m_fileID; }
+UniqueID SourceFile::fileID() const {
+  return UniqueID(UniqueID::Kind::SOURCE_FILE, m_fileNumber, 0);
+}
+
+UniqueID SourceFile::newID(UniqueID::Kind kind) const {
+  return UniqueID(kind, m_fileNumber, m_nextIDNumber++);
+}
 
 const std::vector<Token>& SourceFile::tokens() const { return m_tokens; }
 
+const std::vector<size_t>& SourceFile::lineStarts() const { return m_lineStarts; }
+
+uint64_t SourceFile::contentHash() const { return m_contentHash; }
+
 const symbol::FunctionTable& SourceFile::functionSymbolTable() const {
   return m_functionSymbolTable;
 }
@@ -62,11 +83,21 @@ const symbol::NamespaceExpose& SourceFile::namespaceExposeSymbol() const {
   return m_namespaceExpose;
 }
 
+void SourceFile::clearEvaluation() {
+  m_tokens.clear();
+  m_functionSymbolTable.clear();
+  m_unresolvedFunctionNames.clear();
+  m_fileWriteSymbolTable.clear();
+  m_importSymbolTable.clear();
+  m_namespaceExpose = symbol::NamespaceExpose();
+}
+
 void SourceFile::fullyClearEverything() {
   m_filePath.clear();
   m_importFilePath.clear();
-  // m_fileID has no allocated memory
+  // m_fileNumber and m_nextIDNumber have no allocated memory
   m_tokens.clear();
+  m_lineStarts.clear();
   m_functionSymbolTable.clear();
   m_functionSymbolTable.clear();
   m_unresolvedFunctionNames.clear();
@@ -77,78 +108,194 @@ void SourceFile::fullyClearEverything() {
 
 // SourceFiles
 
-std::vector<CompiledSourceFile> SourceFiles::evaluateAll() {
+std::vector<CompiledSourceFile> SourceFiles::evaluateAll(const CompileOptions& compileOptions) {
   if (!size())
     return {};
 
-  const unsigned threadCount =
-      std::max(1u, std::min(static_cast<unsigned>(size()), std::thread::hardware_concurrency()));
+  // The source files are split into chunks that threads take one at a time so
+  // that threads can join part way through (when make's jobserver gives us
+  // another token). Each chunk gets its own result because any of them can
+  // throw and we need the first of those exceptions to propagate outwards onto
+  // the main thread.
+  const size_t chunkCount = std::min(size(), maxThreadCount() * chunksPerThread);
+  std::vector<std::vector<CompiledSourceFile>> chunkResults(chunkCount);
+  std::vector<std::exception_ptr> chunkExceptions(chunkCount);
+
+  const auto evaluateChunk = [this, &compileOptions, chunkCount, &chunkResults,
+                              &chunkExceptions](size_t chunk) {
+    // no chunk will have more than 1 more source file than any other
+    const size_t start = chunk * size() / chunkCount;
+    const size_t end = (chunk + 1) * size() / chunkCount;
+    assert(start < end && "start index must be < the end index");
 
-  // Each thread we spawn here needs a promise because they all can throw and we
-  // need the first of those exceptions to propagate outwards onto the main
-  // thread.
-  std::vector<std::promise<std::vector<CompiledSourceFile>>> promises(threadCount);
+    try {
+      for (size_t j = start; j < end; j++) {
+        TRACE_SPAN_DETAIL("evaluate", this->at(j).path().string());
+        this->at(j).tokenize();
+        this->at(j).analyzeSyntax(*this);
+        chunkResults[chunk].emplace_back(compileSourceFile(this->at(j), compileOptions));
+      }
+    } catch (...) {
+      chunkExceptions[chunk] = std::current_exception();
+    }
+  };
 
-  // We're spawning the number of threads equal to the number of hardware
-  // threads (or less if we don't have that many source files to evaluate,
-  // minimum 1). Then we split the load of source files across the threads
-  // equally (no thread will need to do more than 1 extra source file).
+  TRACE_SPAN("evaluate all");
 
-  std::vector<std::thread> threads;
-  threads.reserve(threadCount);
+  // built now so that every thread doesn't try to build it at once
+  importPathTable();
 
-  const size_t sourceFilesPerThread = size() / threadCount;
-  size_t threadsToDoAnExtraSourceFile = size() % threadCount;
+  runInParallel(chunkCount, evaluateChunk);
 
-  size_t start = 0;
-  for (unsigned i = 0; i < threadCount; i++) {
-    size_t end = start + sourceFilesPerThread;
-    if (threadsToDoAnExtraSourceFile) {
-      end++;
-      threadsToDoAnExtraSourceFile--;
-    }
+  std::vector<CompiledSourceFile> ret;
+  ret.reserve(size());
 
-    assert(start < end && "start index must be < the end index");
-    assert(end <= size() && "end cannot be > the number of source files");
-
-    threads.emplace_back(
-        [this](std::promise<std::vector<CompiledSourceFile>>& promise, size_t start, size_t end) {
-          try {
-            std::vector<CompiledSourceFile> compiledSourceFiles;
-            for (size_t j = start; j < end; j++) {
-              this->at(j).tokenize();
-              this->at(j).analyzeSyntax(*this);
-              compiledSourceFiles.emplace_back(compileSourceFile(this->at(j)));
-            }
-            promise.set_value(std::move(compiledSourceFiles));
-          } catch (...) {
-            promise.set_exception(std::current_exception());
-          }
-        },
-        // std::ref used because std::thread copies reference objects otherwise
-        std::ref(promises[i]), start, end);
-
-    start = end;
+  // Doing it like this ensures that the exception that is thrown is
+  // reproducible because the exception we throw (if any) will be from the
+  // chunk that contained the source file with the lowest index, not the one
+  // from the first thread that threw an exception. It also ensures that the
+  // order of the compiled source files is the same as the order of the source
+  // files.
+  for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+    if (chunkExceptions[chunk])
+      std::rethrow_exception(chunkExceptions[chunk]);
+
+    ret.insert(ret.end(), std::make_move_iterator(chunkResults[chunk].begin()),
+               std::make_move_iterator(chunkResults[chunk].end()));
   }
-  assert(start == size() && "all source files may not have been evaluated");
 
-  for (auto& t : threads) {
-    t.join();
+  return ret;
+}
+
+std::vector<SourceFiles::BatchResult>
+SourceFiles::evaluateBatch(const std::vector<SourceFiles*>& batch,
+                           const std::vector<CompileOptions>& compileOptions) {
+  assert(batch.size() == compileOptions.size() && "every list needs compile options");
+
+  // every source file in the batch as (list index, index in list)
+  std::vector<std::pair<size_t, size_t>> items;
+  for (size_t i = 0; i < batch.size(); i++) {
+    for (size_t j = 0; j < batch[i]->size(); j++)
+      items.emplace_back(i, j);
   }
 
-  std::vector<CompiledSourceFile> ret;
+  // The first source file with each path is tokenized, every other source
+  // file with that path copies its tokens (the index of the source file that
+  // tokens are copied from lines up with the items).
+  std::vector<size_t> tokenizedItems;
+  std::vector<size_t> tokenSources(items.size());
+  {
+    std::unordered_map<std::filesystem::path, size_t> firstItemWithPath;
+    for (size_t i = 0; i < items.size(); i++) {
+      const auto [it, isNew] =
+          firstItemWithPath.try_emplace((*batch[items[i].first])[items[i].second].path(), i);
+      tokenSources[i] = it->second;
+      if (isNew)
+        tokenizedItems.push_back(i);
+    }
+  }
 
-  // Doing it like this ensures that the exception that is thrown is
-  // reproducible because the promise we throw from (if any) will be the one
-  // that contained the source file with the lowest index, not the one from the
-  // first thread that threw an exception. It also ensures that the order of the
-  // compiled source files is the same as the order of the source files.
-  for (std::promise<std::vector<CompiledSourceFile>>& p : promises) {
-    std::vector<CompiledSourceFile> compiledFiles = p.get_future().get();
-
-    ret.insert(ret.end(), std::make_move_iterator(compiledFiles.begin()),
-               std::make_move_iterator(compiledFiles.end()));
+  const auto sourceFileAt = [&batch, &items](size_t item) -> SourceFile& {
+    return (*batch[items[item].first])[items[item].second];
+  };
+
+  TRACE_SPAN("evaluate batch");
+
+  // built now so that every thread doesn't try to build them at once
+  for (SourceFiles* sourceFiles : batch)
+    sourceFiles->importPathTable();
+
+  std::vector<std::exception_ptr> tokenizeExceptions(items.size());
+  const size_t tokenizeChunkCount =
+      std::min(tokenizedItems.size(), maxThreadCount() * chunksPerThread);
+  runInParallel(tokenizeChunkCount, [&](size_t chunk) {
+    const size_t start = chunk * tokenizedItems.size() / tokenizeChunkCount;
+    const size_t end = (chunk + 1) * tokenizedItems.size() / tokenizeChunkCount;
+    for (size_t j = start; j < end; j++) {
+      const size_t item = tokenizedItems[j];
+      try {
+        TRACE_SPAN_DETAIL("tokenize", sourceFileAt(item).path().string());
+        sourceFileAt(item).tokenize();
+      } catch (...) {
+        tokenizeExceptions[item] = std::current_exception();
+      }
+    }
+  });
+
+  // results line up with the items
+  std::vector<std::optional<CompiledSourceFile>> results(items.size());
+  std::vector<std::exception_ptr> exceptions(items.size());
+  const size_t chunkCount = std::min(items.size(), maxThreadCount() * chunksPerThread);
+  runInParallel(chunkCount, [&](size_t chunk) {
+    const size_t start = chunk * items.size() / chunkCount;
+    const size_t end = (chunk + 1) * items.size() / chunkCount;
+    for (size_t j = start; j < end; j++) {
+      // every file is evaluated (even after a file in its list fails) so that
+      // the exception that's kept doesn't depend on timing
+      SourceFile& sourceFile = sourceFileAt(j);
+      try {
+        TRACE_SPAN_DETAIL("evaluate", sourceFile.path().string());
+        if (tokenizeExceptions[tokenSources[j]])
+          std::rethrow_exception(tokenizeExceptions[tokenSources[j]]);
+        if (tokenSources[j] != j)
+          sourceFile.copyTokensFrom(sourceFileAt(tokenSources[j]));
+        sourceFile.analyzeSyntax(*batch[items[j].first]);
+        results[j].emplace(compileSourceFile(sourceFile, compileOptions[items[j].first]));
+      } catch (...) {
+        exceptions[j] = std::current_exception();
+      }
+    }
+  });
+
+  // like evaluateAll(), each list keeps the exception from its source file
+  // with the lowest index
+  std::vector<BatchResult> ret(batch.size());
+  for (size_t i = 0; i < batch.size(); i++)
+    ret[i].compiledSourceFiles.reserve(batch[i]->size());
+  for (size_t j = 0; j < items.size(); j++) {
+    BatchResult& result = ret[items[j].first];
+    if (result.exception)
+      continue;
+    if (exceptions[j]) {
+      result.exception = exceptions[j];
+      result.compiledSourceFiles.clear();
+      continue;
+    }
+    result.compiledSourceFiles.emplace_back(std::move(*results[j]));
   }
 
   return ret;
 }
+
+size_t SourceFiles::findByImportPath(const std::filesystem::path& importPath,
+                                     const SourceFile*& found) const {
+  const std::shared_ptr<const ImportPathTable> table = importPathTable();
+
+  const auto it = table->entries.find(importPath);
+  if (it == table->entries.end())
+    return 0;
+
+  assert(it->second.first < size() && (*this)[it->second.first].importPath() == importPath &&
+         "source files were removed, replaced, or reordered after the import path table was "
+         "built");
+  found = &(*this)[it->second.first];
+  return it->second.second;
+}
+
+std::shared_ptr<const SourceFiles::ImportPathTable> SourceFiles::importPathTable() const {
+  std::shared_ptr<const ImportPathTable> table = std::atomic_load(&m_importPathTable);
+  if (table && table->sourceFileCount == size())
+    return table;
+
+  auto newTable = std::make_shared<ImportPathTable>();
+  newTable->sourceFileCount = size();
+  newTable->entries.reserve(size());
+  for (size_t i = 0; i < size(); i++) {
+    const auto [it, isNew] = newTable->entries.try_emplace((*this)[i].importPath(), i, 0);
+    it->second.second++;
+  }
+
+  table = std::move(newTable);
+  std::atomic_store(&m_importPathTable, table);
+  return table;
+}
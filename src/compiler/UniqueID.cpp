@@ -1,41 +1,55 @@
 #include <compiler/UniqueID.h>
 
-#include <atomic>
 #include <cassert>
 #include <cstdint>
-#include <cstdlib>
 #include <cstring>
+#include <string>
 
-/// Get the next ID value (uses \p std::atomic so that it's thread safe.)
-static uint32_t getNextIdValue() {
-  static std::atomic<uint32_t> nextIdValue{1};
-  return nextIdValue.fetch_add(1);
-}
+#include <compiler/compile_error.h>
 
-UniqueID::UniqueID(Kind kind) {
-  const uint32_t val = getNextIdValue();
+/// The biggest file number or ID number (both are 5 hex digits in an ID's
+/// string).
+static constexpr uint32_t maxIdNumber = 0xfffff;
 
-  // there's is a maximum ID value of 1,048,575
-  if (val > 0xfffff)
-    std::abort();
+/// Writes \param val as 5 hex digits to \param str .
+static void writeHexDigits(uint32_t val, char* str) {
+  for (int i = 0; i < 5; i++) {
+    const char nibble = static_cast<char>((val >> (16 - i * 4)) & 0xf);
+    str[i] = static_cast<char>((nibble < 10) ? '0' + nibble : 'a' + (nibble - 10));
+  }
+}
 
-  std::strcpy(m_idStr, "?_00000");
+UniqueID::UniqueID(Kind kind, uint32_t fileNumber, uint32_t number)
+    : m_fileNumber(fileNumber), m_number(number) {
+  if (fileNumber > maxIdNumber) {
+    throw compile_error::Generic("There are too many source files (the limit is " +
+                                 std::to_string(maxIdNumber + 1) + ").");
+  }
+  if (number > maxIdNumber) {
+    throw compile_error::Generic("A source file has too many functions and scopes (the limit is " +
+                                 std::to_string(maxIdNumber) + ").");
+  }
+
+  std::strcpy(m_idStr, "?_00000_00000");
 
   // the 'Kind' enum is 'char' under the hood, the enum values are set to the
-  // character that represents the type (like 'S' for 'SOURCE_FILE').
+  // character that represents the type (like 's' for 'SOURCE_FILE').
   m_idStr[0] = static_cast<char>(kind);
 
-  for (char i = 0; i < 5; i++) {
-    char nibble = (val >> (16 - i * 4)) & 0xf;
-    m_idStr[2 + i] = (nibble < 10) ? '0' + nibble : 'a' + (nibble - 10);
-  }
+  writeHexDigits(fileNumber, m_idStr + 2);
+  writeHexDigits(number, m_idStr + 8);
 }
 
 UniqueID::Kind UniqueID::kind() const { return static_cast<Kind>(m_idStr[0]); }
 
-uint64_t UniqueID::value() const { return (m_idValue & 0x0000ffffffffffff00) >> 8; }
+uint64_t UniqueID::value() const {
+  return (static_cast<uint64_t>(m_fileNumber) << 32) | m_number;
+}
 
-bool UniqueID::operator==(UniqueID other) const { return m_idValue == other.m_idValue; }
-bool UniqueID::operator!=(UniqueID other) const { return m_idValue != other.m_idValue; }
+bool UniqueID::operator==(UniqueID other) const {
+  return m_fileNumber == other.m_fileNumber && m_number == other.m_number &&
+         kind() == other.kind();
+}
+bool UniqueID::operator!=(UniqueID other) const { return !(*this == other); }
 
 const char* UniqueID::str() const { return m_idStr; }
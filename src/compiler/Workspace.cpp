@@ -0,0 +1,626 @@
+#include <compiler/Workspace.h>
+
+#include <algorithm>
+#include <cassert>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+
+#include <compiler/compile_error.h>
+#include <compiler/fnv1aHash.h>
+#include <compiler/syntax_analysis/statement.h>
+#include <compiler/syntax_analysis/symbol.h>
+#include <compiler/tokenization/Token.h>
+
+namespace {
+namespace helper {
+
+/// The index in a file of \param line and \param column (which start at 1)
+/// given where each line in the file starts (or \p std::string::npos if it's
+/// out of range).
+static size_t indexInFile(const std::vector<size_t>& lineStarts, size_t line, size_t column);
+
+/// The number of characters \param token takes up in its file.
+static size_t tokenLength(const Token& token);
+
+/// The index of the token in \param tokens that covers the character at
+/// \param indexInFile (or \p std::string::npos if there isn't one).
+static size_t tokenAt(const std::vector<Token>& tokens, size_t indexInFile);
+
+/// Adds the index of the name token of every function call in \param statement
+/// (and the statements inside of it) to \param calls .
+static void addCalls(const statement::Generic& statement, const std::vector<Token>& tokens,
+                     std::unordered_map<std::string, std::vector<size_t>>& calls);
+
+/// Removes \param index from the source files listed for \param name in
+/// \param fileIndex (removing \param name if nothing is left).
+static void removeFromFileIndex(std::unordered_map<std::string, std::vector<size_t>>& fileIndex,
+                                const std::string& name, size_t index);
+
+/// Whether \param path is \param directory or is inside of it (both have to be
+/// absolute and normal).
+static bool isInside(const std::filesystem::path& path, const std::filesystem::path& directory);
+
+} // namespace helper
+} // namespace
+
+bool Workspace::Diagnostic::operator==(const Diagnostic& other) const {
+  return std::tie(message, line, column, length) ==
+         std::tie(other.message, other.line, other.column, other.length);
+}
+
+bool Workspace::Diagnostic::operator!=(const Diagnostic& other) const { return !(*this == other); }
+
+Workspace::Workspace(const std::filesystem::path& rootDirectory)
+    : m_buffers(std::make_shared<vfs::MemoryFileSystem>()),
+      m_mount(rootDirectory, std::make_shared<vfs::OverlayFileSystem>(
+                                 m_buffers, vfs::fileSystemFor(rootDirectory))) {
+  reload();
+}
+
+const std::filesystem::path& Workspace::rootDirectory() const { return m_mount.path(); }
+
+size_t Workspace::sourceFileCount() const { return m_sourceFiles.size(); }
+
+std::vector<std::filesystem::path> Workspace::setBuffer(const std::filesystem::path& path,
+                                                        const std::string& contents) {
+  std::filesystem::path fullPath = pathInRoot(path);
+  if (fullPath.empty() || !m_buffers->createDirectories(fullPath.parent_path()) ||
+      !m_buffers->writeFile(fullPath, contents))
+    return {};
+  return fileChanged(fullPath);
+}
+
+std::vector<std::filesystem::path> Workspace::closeBuffer(const std::filesystem::path& path) {
+  const std::filesystem::path fullPath = pathInRoot(path);
+  if (fullPath.empty() || !m_buffers->isRegularFile(fullPath))
+    return {};
+  m_buffers->removeAll(fullPath);
+  return fileChanged(fullPath);
+}
+
+std::vector<std::filesystem::path> Workspace::fileChanged(const std::filesystem::path& path) {
+  std::filesystem::path fullPath = pathInRoot(path);
+  if (fullPath.empty())
+    return {};
+
+  const bool exists = vfs::isRegularFile(fullPath);
+  const std::optional<size_t> index = indexOf(fullPath);
+  if (index.has_value()) {
+    // other source files could be pointing at a removed one
+    if (!exists)
+      return reload();
+    std::vector<size_t> changed;
+    update(*index, false, changed);
+    return pathsOf(changed);
+  }
+
+  if (exists) {
+    if (fullPath.extension() == ".mcfunc")
+      return addSourceFile(std::move(fullPath));
+    return {};
+  }
+
+  // a whole directory of source files could have been removed
+  for (const auto& [sourceFilePath, _] : m_sourceFileIndices) {
+    if (helper::isInside(sourceFilePath, fullPath))
+      return reload();
+  }
+  return {};
+}
+
+const Workspace::Diagnostic* Workspace::diagnostic(const std::filesystem::path& path) const {
+  const std::optional<size_t> index = indexOf(pathInRoot(path));
+  if (!index.has_value() || !m_fileStates[*index].diagnostic.has_value())
+    return nullptr;
+  return &*m_fileStates[*index].diagnostic;
+}
+
+std::vector<std::filesystem::path> Workspace::pathsWithDiagnostics() const {
+  std::vector<std::filesystem::path> ret;
+  for (size_t i = 0; i < m_sourceFiles.size(); i++) {
+    if (m_fileStates[i].diagnostic.has_value())
+      ret.push_back(m_sourceFiles[i].path());
+  }
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+std::vector<Workspace::Location> Workspace::definitionAt(const std::filesystem::path& path,
+                                                         size_t line, size_t column) const {
+  const std::optional<size_t> index = indexOf(pathInRoot(path));
+  if (!index.has_value())
+    return {};
+  const std::optional<size_t> tokenIndex = wordTokenAt(*index, line, column);
+  if (!tokenIndex.has_value())
+    return {};
+  const std::string& name = m_sourceFiles[*index].tokens()[*tokenIndex].contents();
+
+  if (!callsPublicFunction(*index, name))
+    return {locationOf(m_sourceFiles[*index].functionSymbolTable().getSymbol(name).nameToken())};
+
+  const auto it = m_publicFunctionFiles.find(name);
+  if (it == m_publicFunctionFiles.end())
+    return {};
+
+  std::vector<Location> definitions;
+  std::vector<Location> declarations;
+  for (const size_t declaringIndex : it->second) {
+    const symbol::Function& func =
+        m_sourceFiles[declaringIndex].functionSymbolTable().getSymbol(name);
+    (func.isDefined() ? definitions : declarations).push_back(locationOf(func.nameToken()));
+  }
+
+  std::vector<Location>& ret = definitions.empty() ? declarations : definitions;
+  std::sort(ret.begin(), ret.end(), [](const Location& a, const Location& b) {
+    return std::tie(a.path, a.line, a.column) < std::tie(b.path, b.line, b.column);
+  });
+  return std::move(ret);
+}
+
+std::vector<Workspace::Location> Workspace::referencesAt(const std::filesystem::path& path,
+                                                         size_t line, size_t column,
+                                                         bool includeDeclarations) const {
+  const std::optional<size_t> index = indexOf(pathInRoot(path));
+  if (!index.has_value())
+    return {};
+  const std::optional<size_t> tokenIndex = wordTokenAt(*index, line, column);
+  if (!tokenIndex.has_value())
+    return {};
+  const std::string& name = m_sourceFiles[*index].tokens()[*tokenIndex].contents();
+
+  std::vector<Location> ret;
+  std::vector<size_t> callingFiles;
+
+  if (!callsPublicFunction(*index, name)) {
+    if (includeDeclarations) {
+      ret.push_back(
+          locationOf(m_sourceFiles[*index].functionSymbolTable().getSymbol(name).nameToken()));
+    }
+    callingFiles.push_back(*index);
+
+  } else {
+    // calls to a public function in the files that declare it call it directly
+    const auto declaringIt = m_publicFunctionFiles.find(name);
+    if (declaringIt != m_publicFunctionFiles.end()) {
+      for (const size_t declaringIndex : declaringIt->second) {
+        if (includeDeclarations) {
+          ret.push_back(locationOf(
+              m_sourceFiles[declaringIndex].functionSymbolTable().getSymbol(name).nameToken()));
+        }
+        callingFiles.push_back(declaringIndex);
+      }
+    }
+
+    // other files call it if they import a file that declares it
+    const auto callingIt = m_importedCallFiles.find(name);
+    if (callingIt != m_importedCallFiles.end()) {
+      for (const size_t callingIndex : callingIt->second) {
+        const std::vector<size_t>& imports = m_importGraph.importsOf(callingIndex);
+        if (callingIndex == *index ||
+            std::any_of(imports.begin(), imports.end(), [&](size_t importedIndex) {
+              return m_sourceFiles[importedIndex].functionSymbolTable().hasPublicSymbol(name);
+            }))
+          callingFiles.push_back(callingIndex);
+      }
+    }
+  }
+
+  std::sort(callingFiles.begin(), callingFiles.end());
+  callingFiles.erase(std::unique(callingFiles.begin(), callingFiles.end()), callingFiles.end());
+  for (const size_t callingIndex : callingFiles) {
+    const auto it = m_fileStates[callingIndex].calls.find(name);
+    if (it == m_fileStates[callingIndex].calls.end())
+      continue;
+    for (const size_t callTokenIndex : it->second)
+      ret.push_back(locationOf(m_sourceFiles[callingIndex].tokens()[callTokenIndex]));
+  }
+
+  std::sort(ret.begin(), ret.end(), [](const Location& a, const Location& b) {
+    return std::tie(a.path, a.line, a.column) < std::tie(b.path, b.line, b.column);
+  });
+  return ret;
+}
+
+std::string_view Workspace::lineAt(const std::filesystem::path& path, size_t line) const {
+  const std::optional<size_t> index = indexOf(pathInRoot(path));
+  if (!index.has_value())
+    return {};
+  const FileState& state = m_fileStates[*index];
+  if (line == 0 || line > state.lineStarts.size())
+    return {};
+
+  const size_t start = state.lineStarts[line - 1];
+  const size_t end =
+      (line < state.lineStarts.size()) ? state.lineStarts[line] - 1 : state.contents.size();
+  return std::string_view(state.contents).substr(start, end - start);
+}
+
+std::vector<std::filesystem::path> Workspace::reload() {
+  // every index changes so old diagnostics are found by path
+  std::unordered_map<std::filesystem::path, Diagnostic> oldDiagnostics;
+  for (size_t i = 0; i < m_sourceFiles.size(); i++) {
+    if (m_fileStates[i].diagnostic.has_value())
+      oldDiagnostics.emplace(m_sourceFiles[i].path(), std::move(*m_fileStates[i].diagnostic));
+  }
+
+  std::vector<std::filesystem::path> paths;
+  std::vector<vfs::DirectoryEntry> entries;
+  vfs::listFiles(rootDirectory(), entries);
+  for (vfs::DirectoryEntry& entry : entries) {
+    if (entry.isRegularFile && entry.path.extension() == ".mcfunc")
+      paths.push_back(std::move(entry.path));
+  }
+  std::sort(paths.begin(), paths.end());
+
+  m_publicFunctionFiles.clear();
+  m_importedCallFiles.clear();
+  m_sourceFileIndices.clear();
+
+  // every source file has to exist before any can be analyzed (for imports)
+  m_sourceFiles = SourceFiles();
+  m_sourceFiles.reserve(paths.size() * 2 + 16);
+  for (std::filesystem::path& path : paths) {
+    m_sourceFileIndices.emplace(path, m_sourceFiles.size());
+    m_sourceFiles.emplace_back(std::move(path), rootDirectory());
+  }
+  m_fileStates.assign(m_sourceFiles.size(), FileState());
+
+  for (size_t i = 0; i < m_sourceFiles.size(); i++) {
+    std::string contents;
+    vfs::readFile(m_sourceFiles[i].path(), contents);
+    m_fileStates[i].contentHash = fnv1aHash(contents);
+    m_fileStates[i].diagnostic = analyze(i, contents);
+  }
+
+  m_importGraph = ImportGraph(m_sourceFiles);
+  for (size_t i = 0; i < m_sourceFiles.size(); i++) {
+    FileState& state = m_fileStates[i];
+    state.interfaceHash = ImportGraph::interfaceHash(m_sourceFiles[i]);
+    if (state.isAnalyzed)
+      state.diagnostic = checkImportedCalls(i);
+  }
+
+  std::vector<std::filesystem::path> ret;
+  for (size_t i = 0; i < m_sourceFiles.size(); i++) {
+    const auto it = oldDiagnostics.find(m_sourceFiles[i].path());
+    const std::optional<Diagnostic>& diagnostic = m_fileStates[i].diagnostic;
+    if (it == oldDiagnostics.end()) {
+      if (diagnostic.has_value())
+        ret.push_back(m_sourceFiles[i].path());
+      continue;
+    }
+    if (diagnostic != it->second)
+      ret.push_back(m_sourceFiles[i].path());
+    oldDiagnostics.erase(it);
+  }
+  // the diagnostics of removed files are cleared
+  for (auto& [path, _] : oldDiagnostics)
+    ret.push_back(path);
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+void Workspace::update(size_t index, bool force, std::vector<size_t>& changed) {
+  assert(index < m_sourceFiles.size() && "source file index is out of range");
+  FileState& state = m_fileStates[index];
+
+  // editors often save files without changing them
+  std::string contents;
+  vfs::readFile(m_sourceFiles[index].path(), contents);
+  const uint64_t contentHash = fnv1aHash(contents);
+  if (!force && state.contentHash == contentHash)
+    return;
+  state.contentHash = contentHash;
+
+  // Other source files that import this one hold a reference to it, so it's
+  // analyzed again in place rather than being replaced.
+  clear(index);
+  std::optional<Diagnostic> diagnostic = analyze(index, contents);
+  m_importGraph.updateImports(m_sourceFiles, index);
+  if (state.isAnalyzed)
+    diagnostic = checkImportedCalls(index);
+  setDiagnostic(index, std::move(diagnostic), changed);
+
+  // early cutoff: files importing this one only see its public declarations
+  const uint64_t interfaceHash = ImportGraph::interfaceHash(m_sourceFiles[index]);
+  if (interfaceHash == state.interfaceHash)
+    return;
+  state.interfaceHash = interfaceHash;
+  for (const size_t importerIndex : m_importGraph.importersOf(index)) {
+    if (m_fileStates[importerIndex].isAnalyzed)
+      setDiagnostic(importerIndex, checkImportedCalls(importerIndex), changed);
+  }
+}
+
+std::vector<std::filesystem::path> Workspace::addSourceFile(std::filesystem::path&& path) {
+  assert(!m_sourceFileIndices.count(path) && "the source file was already added");
+
+  // adding a source file can't move the others
+  if (m_sourceFiles.size() == m_sourceFiles.capacity())
+    return reload();
+
+  const size_t index = m_sourceFiles.size();
+  m_sourceFileIndices.emplace(path, index);
+  m_sourceFiles.emplace_back(std::move(path), rootDirectory());
+  m_fileStates.emplace_back();
+  m_importGraph.resize(m_sourceFiles.size());
+
+  std::vector<size_t> changed;
+  update(index, true, changed);
+
+  // source files that failed could have been importing the new one
+  for (size_t i = 0; i < index; i++) {
+    if (!m_fileStates[i].isAnalyzed)
+      update(i, true, changed);
+  }
+
+  return pathsOf(changed);
+}
+
+std::optional<Workspace::Diagnostic> Workspace::analyze(size_t index,
+                                                        const std::string& contents) {
+  SourceFile& sourceFile = m_sourceFiles[index];
+  FileState& state = m_fileStates[index];
+
+  state.contents = contents;
+  state.lineStarts.assign(1, 0);
+  for (size_t i = 0; i < contents.size(); i++) {
+    if (contents[i] == '\n')
+      state.lineStarts.push_back(i + 1);
+  }
+
+  std::optional<Diagnostic> ret;
+  try {
+    sourceFile.tokenize();
+    sourceFile.analyzeSyntax(m_sourceFiles);
+    state.isAnalyzed = true;
+  } catch (const compile_error::Generic& e) {
+    ret.emplace();
+    ret->message = e.message();
+    // errors without a place in this file are shown at the start of it
+    if (e.filePath() == sourceFile.path() && e.line() != 0) {
+      ret->line = e.line();
+      ret->column = e.column();
+      const size_t tokenIndex = helper::tokenAt(
+          sourceFile.tokens(), helper::indexInFile(state.lineStarts, ret->line, ret->column));
+      if (tokenIndex != std::string::npos)
+        ret->length = helper::tokenLength(sourceFile.tokens()[tokenIndex]);
+    }
+  }
+
+  // whatever was found before an error is still indexed so it can be found
+  for (const symbol::Function& func : sourceFile.functionSymbolTable()) {
+    if (func.isPublic()) {
+      state.publicFunctionNames.push_back(func.name());
+      m_publicFunctionFiles[func.name()].push_back(index);
+    }
+    if (func.isDefined())
+      helper::addCalls(func.definition(), sourceFile.tokens(), state.calls);
+  }
+  for (const std::string& name : sourceFile.unresolvedFunctionNames()) {
+    state.importedCallNames.push_back(name);
+    m_importedCallFiles[name].push_back(index);
+  }
+
+  return ret;
+}
+
+void Workspace::clear(size_t index) {
+  FileState& state = m_fileStates[index];
+  for (const std::string& name : state.publicFunctionNames)
+    helper::removeFromFileIndex(m_publicFunctionFiles, name, index);
+  for (const std::string& name : state.importedCallNames)
+    helper::removeFromFileIndex(m_importedCallFiles, name, index);
+
+  state.publicFunctionNames.clear();
+  state.importedCallNames.clear();
+  state.calls.clear();
+  state.isAnalyzed = false;
+  m_sourceFiles[index].clearEvaluation();
+}
+
+std::optional<Workspace::Diagnostic> Workspace::checkImportedCalls(size_t index) const {
+  const SourceFile& sourceFile = m_sourceFiles[index];
+  if (sourceFile.unresolvedFunctionNames().empty())
+    return std::nullopt;
+
+  std::unordered_set<std::string> importedFunctionNames;
+  for (const symbol::Import& importSymbol : sourceFile.importSymbolTable()) {
+    for (const symbol::Function& func : importSymbol.sourceFile().functionSymbolTable()) {
+      if (func.isPublic())
+        importedFunctionNames.insert(func.name());
+    }
+  }
+
+  try {
+    sourceFile.unresolvedFunctionNames().ensureAllNamesAreIn(importedFunctionNames);
+  } catch (const compile_error::Generic& e) {
+    Diagnostic ret;
+    ret.message = e.message();
+    ret.line = std::max<size_t>(e.line(), 1);
+    ret.column = std::max<size_t>(e.column(), 1);
+    const size_t tokenIndex = helper::tokenAt(
+        sourceFile.tokens(), helper::indexInFile(m_fileStates[index].lineStarts, ret.line,
+                                                 ret.column));
+    if (tokenIndex != std::string::npos)
+      ret.length = helper::tokenLength(sourceFile.tokens()[tokenIndex]);
+    return ret;
+  }
+  return std::nullopt;
+}
+
+void Workspace::setDiagnostic(size_t index, std::optional<Diagnostic>&& diagnostic,
+                              std::vector<size_t>& changed) {
+  if (m_fileStates[index].diagnostic == diagnostic)
+    return;
+  m_fileStates[index].diagnostic = std::move(diagnostic);
+  changed.push_back(index);
+}
+
+std::vector<std::filesystem::path> Workspace::pathsOf(std::vector<size_t>& changed) const {
+  std::sort(changed.begin(), changed.end());
+  changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+  std::vector<std::filesystem::path> ret;
+  ret.reserve(changed.size());
+  for (const size_t index : changed)
+    ret.push_back(m_sourceFiles[index].path());
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+std::optional<size_t> Workspace::indexOf(const std::filesystem::path& path) const {
+  const auto it = m_sourceFileIndices.find(path);
+  if (it == m_sourceFileIndices.end())
+    return std::nullopt;
+  return it->second;
+}
+
+std::optional<size_t> Workspace::wordTokenAt(size_t index, size_t line, size_t column) const {
+  const std::vector<Token>& tokens = m_sourceFiles[index].tokens();
+  const size_t indexInFile = helper::indexInFile(m_fileStates[index].lineStarts, line, column);
+  if (indexInFile == std::string::npos)
+    return std::nullopt;
+
+  // the cursor can also be just after the name (e.g. 'foo|()')
+  size_t tokenIndex = helper::tokenAt(tokens, indexInFile);
+  if ((tokenIndex == std::string::npos || tokens[tokenIndex].kind() != Token::WORD) &&
+      indexInFile != 0)
+    tokenIndex = helper::tokenAt(tokens, indexInFile - 1);
+
+  if (tokenIndex == std::string::npos || tokens[tokenIndex].kind() != Token::WORD)
+    return std::nullopt;
+  return tokenIndex;
+}
+
+Workspace::Location Workspace::locationOf(const Token& token) const {
+  // tokens point into the same source files object
+  const size_t index = &token.sourceFile() - m_sourceFiles.data();
+  assert(index < m_sourceFiles.size() && "token is from a different source file list");
+  const std::vector<size_t>& lineStarts = m_fileStates[index].lineStarts;
+
+  const auto lineIt =
+      std::upper_bound(lineStarts.begin(), lineStarts.end(), token.indexInFile()) - 1;
+
+  Location ret;
+  ret.path = m_sourceFiles[index].path();
+  ret.line = (lineIt - lineStarts.begin()) + 1;
+  ret.column = token.indexInFile() - *lineIt + 1;
+  ret.length = helper::tokenLength(token);
+  return ret;
+}
+
+bool Workspace::callsPublicFunction(size_t index, const std::string& name) const {
+  const symbol::FunctionTable& functionTable = m_sourceFiles[index].functionSymbolTable();
+  return !functionTable.hasSymbol(name) || functionTable.getSymbol(name).isPublic();
+}
+
+std::filesystem::path Workspace::pathInRoot(const std::filesystem::path& path) const {
+  if (path.empty())
+    return std::filesystem::path();
+  std::filesystem::path ret = std::filesystem::absolute(path).lexically_normal();
+  if (!ret.has_filename())
+    ret = ret.parent_path();
+  if (ret == rootDirectory() || !helper::isInside(ret, rootDirectory()))
+    return std::filesystem::path();
+  return ret;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static size_t helper::indexInFile(const std::vector<size_t>& lineStarts, size_t line,
+                                  size_t column) {
+  if (line == 0 || column == 0 || line > lineStarts.size())
+    return std::string::npos;
+  const size_t ret = lineStarts[line - 1] + column - 1;
+  // columns can't go past the end of the line
+  if (line < lineStarts.size() && ret >= lineStarts[line])
+    return std::string::npos;
+  return ret;
+}
+
+static size_t helper::tokenLength(const Token& token) {
+  switch (token.kind()) {
+  case Token::STRING:
+  case Token::SNIPPET:
+    return token.contents().size() + 2;
+  case Token::COMMAND:
+    return token.contents().size() + 1;
+  case Token::WORD:
+    return token.contents().size();
+  case Token::FILE_KW:
+  case Token::TICK_KW:
+  case Token::LOAD_KW:
+  case Token::VOID_KW:
+    return 4;
+  case Token::EXPOSE_KW:
+  case Token::PUBLIC_KW:
+  case Token::IMPORT_KW:
+    return 6;
+  default:
+    return 1;
+  }
+}
+
+static size_t helper::tokenAt(const std::vector<Token>& tokens, size_t indexInFile) {
+  if (indexInFile == std::string::npos)
+    return std::string::npos;
+
+  // tokens are in the order they appear in the file
+  const auto it = std::upper_bound(
+      tokens.begin(), tokens.end(), indexInFile,
+      [](size_t indexInFile, const Token& token) { return indexInFile < token.indexInFile(); });
+  if (it == tokens.begin())
+    return std::string::npos;
+
+  const Token& token = *(it - 1);
+  if (indexInFile >= token.indexInFile() + tokenLength(token))
+    return std::string::npos;
+  return (it - 1) - tokens.begin();
+}
+
+static void helper::addCalls(const statement::Generic& statement, const std::vector<Token>& tokens,
+                             std::unordered_map<std::string, std::vector<size_t>>& calls) {
+  switch (statement.kind()) {
+
+  case statement::Kind::FUNCTION_CALL: {
+    const size_t nameTokenIndex =
+        static_cast<const statement::FunctionCall&>(statement).functionNameTokenIndex();
+    calls[tokens[nameTokenIndex].contents()].push_back(nameTokenIndex);
+    return;
+  }
+
+  case statement::Kind::COMMAND: {
+    const auto& command = static_cast<const statement::Command&>(statement);
+    if (command.hasStatementAfterRun())
+      addCalls(*command.statementAfterRun(), tokens, calls);
+    return;
+  }
+
+  case statement::Kind::SCOPE:
+    for (const auto& innerStatement : static_cast<const statement::Scope&>(statement).statements())
+      addCalls(*innerStatement, tokens, calls);
+    return;
+  }
+}
+
+static void helper::removeFromFileIndex(
+    std::unordered_map<std::string, std::vector<size_t>>& fileIndex, const std::string& name,
+    size_t index) {
+  const auto it = fileIndex.find(name);
+  if (it == fileIndex.end())
+    return;
+  std::vector<size_t>& indices = it->second;
+  indices.erase(std::remove(indices.begin(), indices.end(), index), indices.end());
+  if (indices.empty())
+    fileIndex.erase(it);
+}
+
+static bool helper::isInside(const std::filesystem::path& path,
+                             const std::filesystem::path& directory) {
+  const std::filesystem::path relativePath = path.lexically_relative(directory);
+  return !relativePath.empty() && *relativePath.begin() != "..";
+}
@@ -0,0 +1,234 @@
+#include <compiler/XrefIndex.h>
+
+#include <fstream>
+#include <iterator>
+
+#include <compiler/compile_error.h>
+#include <compiler/vfs.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+namespace helper {
+
+/// Memory maps the file at \param path , setting \param mapping and
+/// \param size . Returns false if it can't be mapped (e.g. it's empty or this
+/// platform can't map files).
+static bool mapFile(const std::filesystem::path& path, void*& mapping, size_t& size);
+
+/// Reads the file at \param path into \param contents without translating
+/// line endings. Returns false if it can't be read.
+static bool readBinaryFile(const std::filesystem::path& path, std::string& contents);
+
+} // namespace helper
+} // namespace
+
+XrefIndex::FormatError::FormatError(const std::string& msg) : std::runtime_error(msg) {}
+
+XrefIndex::XrefIndex(const std::filesystem::path& path) {
+  // files in a mounted file system can't be mapped
+  if (vfs::isOnDisk(path) && helper::mapFile(path, m_mapping, m_size)) {
+    m_data = static_cast<const char*>(m_mapping);
+  } else {
+    const bool didRead = (vfs::isOnDisk(path)) ? helper::readBinaryFile(path, m_contents)
+                                               : vfs::readFile(path, m_contents);
+    if (!didRead)
+      throw compile_error::CouldntOpenFile(path);
+    m_data = m_contents.data();
+    m_size = m_contents.size();
+  }
+
+  if (m_size < headerSize || std::string_view(m_data, magic.size()) != magic)
+    throw FormatError("The file isn't a cross-reference index");
+  if (readU32(magic.size()) != version) {
+    throw FormatError("The index has version " + std::to_string(readU32(magic.size())) +
+                      " but version " + std::to_string(version) + " was expected");
+  }
+
+  m_fileCount = readU32(magic.size() + 4);
+  m_nameCount = readU32(magic.size() + 8);
+  m_entryCount = readU32(magic.size() + 12);
+  m_namesOffset = headerSize + m_fileCount * fileRecordSize;
+  m_entriesOffset = m_namesOffset + m_nameCount * nameRecordSize;
+  m_stringsOffset = m_entriesOffset + m_entryCount * entryRecordSize;
+  if (m_stringsOffset > m_size)
+    throw FormatError("The index is truncated");
+}
+
+XrefIndex::~XrefIndex() {
+#if defined(__unix__) || defined(__APPLE__)
+  if (m_mapping != nullptr)
+    munmap(m_mapping, m_size);
+#endif
+}
+
+size_t XrefIndex::fileCount() const { return m_fileCount; }
+
+std::string_view XrefIndex::filePath(size_t index) const {
+  const size_t offset = headerSize + index * fileRecordSize;
+  return readString(readU32(offset), readU32(offset + 4));
+}
+
+size_t XrefIndex::nameCount() const { return m_nameCount; }
+
+std::string_view XrefIndex::name(size_t index) const {
+  const size_t offset = m_namesOffset + index * nameRecordSize;
+  return readString(readU32(offset), readU32(offset + 4));
+}
+
+std::vector<XrefIndex::Entry> XrefIndex::find(std::string_view name) const {
+  const size_t nameIndex = findName(name);
+  if (nameIndex == m_nameCount)
+    return {};
+
+  const size_t offset = m_namesOffset + nameIndex * nameRecordSize;
+  const size_t firstEntry = readU32(offset + 8);
+  const size_t entryCount = readU32(offset + 12);
+  if (firstEntry + entryCount > m_entryCount)
+    throw FormatError("An entry in the index is out of range");
+
+  std::vector<Entry> ret;
+  ret.reserve(entryCount);
+  for (size_t i = firstEntry; i < firstEntry + entryCount; i++)
+    ret.push_back(readEntry(i));
+  return ret;
+}
+
+std::vector<XrefIndex::Entry> XrefIndex::find(std::string_view name, Kind kind) const {
+  const size_t nameIndex = findName(name);
+  if (nameIndex == m_nameCount)
+    return {};
+
+  const size_t offset = m_namesOffset + nameIndex * nameRecordSize;
+  size_t first = readU32(offset + 8);
+  size_t last = first + readU32(offset + 12);
+  if (last > m_entryCount)
+    throw FormatError("An entry in the index is out of range");
+
+  // the entries for a name are sorted by kind
+  const auto kindAt = [this](size_t index) {
+    return readU32(m_entriesOffset + index * entryRecordSize);
+  };
+  size_t low = first, high = last;
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    if (kindAt(middle) < static_cast<uint32_t>(kind))
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  first = low;
+  high = last;
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    if (kindAt(middle) <= static_cast<uint32_t>(kind))
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  last = low;
+
+  std::vector<Entry> ret;
+  ret.reserve(last - first);
+  for (size_t i = first; i < last; i++)
+    ret.push_back(readEntry(i));
+  return ret;
+}
+
+const char* XrefIndex::kindName(Kind kind) {
+  switch (kind) {
+  case Kind::FUNCTION_DEFINITION:
+    return "definition";
+  case Kind::FUNCTION_DECLARATION:
+    return "declaration";
+  case Kind::FUNCTION_CALL:
+    return "call";
+  case Kind::FILE_WRITE:
+    return "file write";
+  case Kind::IMPORT:
+    return "import";
+  }
+  return "unknown";
+}
+
+uint32_t XrefIndex::readU32(size_t offset) const {
+  if (offset + 4 > m_size)
+    throw FormatError("The index is truncated");
+  const auto* bytes = reinterpret_cast<const unsigned char*>(m_data + offset);
+  return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+         (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+std::string_view XrefIndex::readString(uint32_t offset, uint32_t length) const {
+  if (static_cast<size_t>(offset) + length > m_size - m_stringsOffset)
+    throw FormatError("A string in the index is out of range");
+  return std::string_view(m_data + m_stringsOffset + offset, length);
+}
+
+XrefIndex::Entry XrefIndex::readEntry(size_t index) const {
+  const size_t offset = m_entriesOffset + index * entryRecordSize;
+  const uint32_t kind = readU32(offset);
+  const uint32_t fileIndex = readU32(offset + 4);
+  if (kind > static_cast<uint32_t>(Kind::IMPORT) || fileIndex >= m_fileCount)
+    throw FormatError("An entry in the index is invalid");
+  return Entry{static_cast<Kind>(kind), filePath(fileIndex), readU32(offset + 8)};
+}
+
+size_t XrefIndex::findName(std::string_view name) const {
+  size_t low = 0, high = m_nameCount;
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    if (this->name(middle) < name)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  return (low < m_nameCount && this->name(low) == name) ? low : m_nameCount;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static bool helper::mapFile(const std::filesystem::path& path, void*& mapping, size_t& size) {
+#if defined(__unix__) || defined(__APPLE__)
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1)
+    return false;
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || fileStat.st_size == 0) {
+    close(fd);
+    return false;
+  }
+
+  void* ret = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping stays valid after the file is closed
+  close(fd);
+  if (ret == MAP_FAILED)
+    return false;
+
+  mapping = ret;
+  size = static_cast<size_t>(fileStat.st_size);
+  return true;
+#else
+  (void)path;
+  (void)mapping;
+  (void)size;
+  return false;
+#endif
+}
+
+static bool helper::readBinaryFile(const std::filesystem::path& path, std::string& contents) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file.is_open())
+    return false;
+
+  contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return !file.bad();
+}
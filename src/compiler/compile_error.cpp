@@ -2,7 +2,7 @@
 
 #include <cassert>
 #include <filesystem>
-#include <fstream>
+#include <sstream>
 #include <string>
 #include <system_error>
 
@@ -10,6 +10,7 @@
 #include <compiler/SourceFiles.h>
 #include <compiler/tokenization/Token.h>
 #include <compiler/translation/constants.h>
+#include <compiler/vfs.h>
 
 using namespace compile_error;
 
@@ -43,13 +44,10 @@ struct LnCol {
 static LnCol getLnColFromFile(const std::filesystem::path& filePath, size_t indexInFile) {
   LnCol ret;
 
-  std::error_code ec;
-  if (!std::filesystem::is_regular_file(filePath, ec) || ec)
-    return ret;
-
-  std::ifstream file(filePath);
-  if (!file.is_open())
+  std::string contents;
+  if (!vfs::readFile(filePath, contents))
     return ret;
+  std::istringstream file(std::move(contents));
 
   size_t i = 0;
 
@@ -183,8 +181,30 @@ static std::string highlightedLineAndPath(const Token& token) {
 
 const char* Generic::what() const noexcept { return m_msg.c_str(); }
 
-Generic::Generic(const std::string& msg) : m_msg(msg + '\n') {}
-Generic::Generic(std::string&& msg) : m_msg(std::move(msg) + '\n') {}
+Generic::Generic(const std::string& msg) : m_msg(msg + '\n'), m_message(msg) {}
+Generic::Generic(std::string&& msg) : m_msg(msg + '\n'), m_message(std::move(msg)) {}
+
+const std::string& Generic::message() const { return m_message; }
+
+const std::filesystem::path& Generic::filePath() const { return m_filePath; }
+
+size_t Generic::line() const { return m_line; }
+
+size_t Generic::column() const { return m_column; }
+
+void Generic::setDetails(const std::string& message, const std::filesystem::path& filePath,
+                         size_t indexInFile) {
+  m_message = message;
+  m_filePath = filePath;
+  if (indexInFile == std::string::npos)
+    return;
+
+  const LnCol lnCol = getLnColFromFile(filePath, indexInFile);
+  if (lnCol.isValid()) {
+    m_line = lnCol.ln;
+    m_column = lnCol.col;
+  }
+}
 
 // CodeGenFailure
 
@@ -196,32 +216,54 @@ CodeGenFailure::CodeGenFailure(const std::string& msg) : Generic(msg) {}
 NoExposedNamespace::NoExposedNamespace()
     : Generic(basicErrorMessage("The namespace was never exposed (try adding something like " +
                                 style_text::styleAsCode("expose \"example\";") +
-                                " to the top of your main file).")) {}
+                                " to the top of your main file).")) {
+  setDetails("The namespace was never exposed.");
+}
+
+NoExposedNamespace::NoExposedNamespace(const std::filesystem::path& filePath)
+    : Generic(basicErrorMessage("This source file doesn't belong to a namespace because no "
+                                "namespace is exposed from its directory or any directory above "
+                                "it.") +
+              '\n' + style_text::styleAsCode(filePath.string()) + '.') {
+  setDetails("This source file doesn't belong to a namespace.", filePath);
+}
 
 // CouldntOpenFile
 
 CouldntOpenFile::CouldntOpenFile(const std::filesystem::path& filePath, Mode mode)
     : Generic(basicErrorMessage(std::string("Failed to open the following file (") +
                                 ((mode == Mode::READ) ? "read" : "write") + " fail):\n") +
-              style_text::styleAsCode(FullPathStr(filePath)) + '.') {}
+              style_text::styleAsCode(FullPathStr(filePath)) + '.') {
+  setDetails(std::string("Failed to open a file (") + ((mode == Mode::READ) ? "read" : "write") +
+                 " fail).",
+             filePath);
+}
 
 // FilePathError
 
 ImportError::ImportError(const std::string& msg, const std::filesystem::path& filePath)
-    : Generic(basicErrorMessage(msg) + '\n' + style_text::styleAsCode(filePath.string()) + '.') {}
+    : Generic(basicErrorMessage(msg) + '\n' + style_text::styleAsCode(filePath.string()) + '.') {
+  setDetails(msg, filePath);
+}
 
 ImportError::ImportError(const std::string& msg, const Token& token)
-    : Generic(basicErrorMessage(msg) + '\n' + highlightedLineAndPath(token)) {}
+    : Generic(basicErrorMessage(msg) + '\n' + highlightedLineAndPath(token)) {
+  setDetails(msg, token.sourceFile().path(), token.indexInFile());
+}
 
 // SyntaxError
 
 SyntaxError::SyntaxError(const std::string& msg, size_t indexInFile,
                          const std::filesystem::path& filePath, size_t numChars)
     : Generic(basicErrorMessage(msg) + '\n' +
-              highlightedLineAndPath(filePath, indexInFile, numChars)) {}
+              highlightedLineAndPath(filePath, indexInFile, numChars)) {
+  setDetails(msg, filePath, indexInFile);
+}
 
 SyntaxError::SyntaxError(const std::string& msg, const Token& token)
-    : Generic(basicErrorMessage(msg) + '\n' + highlightedLineAndPath(token)) {}
+    : Generic(basicErrorMessage(msg) + '\n' + highlightedLineAndPath(token)) {
+  setDetails(msg, token.sourceFile().path(), token.indexInFile());
+}
 
 // SharedFuncTagParseError
 
@@ -244,9 +286,27 @@ DeclarationConflict::DeclarationConflict(const std::string& msg, const size_t in
                                          size_t numChars2)
     : Generic(basicErrorMessage(msg) + '\n' +
               highlightedLineAndPath(filePath1, indexInFile1, numChars1) + '\n' +
-              highlightedLineAndPath(filePath2, indexInFile2, numChars2)) {}
+              highlightedLineAndPath(filePath2, indexInFile2, numChars2)) {
+  setDetails(msg, filePath1, indexInFile1);
+}
 
 DeclarationConflict::DeclarationConflict(const std::string& msg, const Token& token1,
                                          const Token& token2)
     : Generic(basicErrorMessage(msg) + '\n' + highlightedLineAndPath(token1) + '\n' +
-              highlightedLineAndPath(token2)) {}
+              highlightedLineAndPath(token2)) {
+  setDetails(msg, token1.sourceFile().path(), token1.indexInFile());
+}
+
+// TickBudgetExceeded
+
+TickBudgetExceeded::TickBudgetExceeded(size_t estimatedCost, size_t budget,
+                                       const std::string& report)
+    : Generic(basicErrorMessage("The busiest tick is estimated to run " +
+                                std::to_string(estimatedCost) +
+                                " commands but the budget set with " +
+                                style_text::styleAsCode("--max-tick-commands") + " is " +
+                                std::to_string(budget) + ".\n") +
+              report) {
+  setDetails("The busiest tick is estimated to run " + std::to_string(estimatedCost) +
+             " commands but the budget is " + std::to_string(budget) + ".\n" + report);
+}
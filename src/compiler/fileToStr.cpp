@@ -1,27 +1,19 @@
 #include <compiler/fileToStr.h>
 
 #include <filesystem>
-#include <fstream>
 #include <string>
-#include <system_error>
 
 #include <compiler/compile_error.h>
+#include <compiler/vfs.h>
 
 std::string fileToStr(const std::filesystem::path& path) {
-  std::error_code ec;
-  if (!std::filesystem::is_regular_file(path, ec) || ec)
-    throw compile_error::CouldntOpenFile(path);
-
-  std::ifstream file(path);
-  if (!file.is_open())
+  std::string contents;
+  if (!vfs::readFile(path, contents))
     throw compile_error::CouldntOpenFile(path);
 
-  std::string contents;
-  std::string line;
-  while (std::getline(file, line)) {
-    contents += line;
-    contents += '\n';
-  }
+  // every line ends with a newline (including the last one)
+  if (!contents.empty() && contents.back() != '\n')
+    contents.push_back('\n');
 
   // possibly save some memory with very large files
   contents.shrink_to_fit();
@@ -0,0 +1,9 @@
+#include <compiler/fnv1aHash.h>
+
+uint64_t fnv1aHash(std::string_view data, uint64_t hash) {
+  for (const char c : data) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
@@ -1,6 +1,7 @@
 #include <filesystem>
 
 #include <compiler/compile_error.h>
+#include <compiler/vfs.h>
 
 std::filesystem::path generateImportPath(const std::filesystem::path& filePath,
                                          const std::filesystem::path& prefix) {
@@ -26,7 +27,18 @@ std::filesystem::path generateImportPath(const std::filesystem::path& filePath,
   if (ec)
     goto fail;
 
-  const auto ret = std::filesystem::relative(filePathAbsolute, prefixAbsolute, ec);
+  // When the file is inside the prefix directory the path can be worked out
+  // without touching the file system (std::filesystem::relative() resolves
+  // every part of both paths, which is slow for a lot of files).
+  std::filesystem::path ret = filePathAbsolute.lexically_relative(prefixAbsolute);
+  if (!ret.empty() && *ret.begin() != "..")
+    return ret;
+
+  // mounted paths don't exist on the disk so there's nothing to resolve
+  if (!ret.empty() && (!vfs::isOnDisk(filePathAbsolute) || !vfs::isOnDisk(prefixAbsolute)))
+    return ret;
+
+  ret = std::filesystem::relative(filePathAbsolute, prefixAbsolute, ec);
   if (ec)
     goto fail;
 
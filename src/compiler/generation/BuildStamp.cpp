@@ -0,0 +1,211 @@
+#include <compiler/generation/BuildStamp.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+#include <compiler/fnv1aHash.h>
+#include <compiler/runInParallel.h>
+#include <version.h>
+
+/// The first line of every stamp file (changing the format should change it).
+static constexpr const char* stampHeader = "mcfunc build stamp v2";
+
+/// Files are looked at in chunks of this many (in parallel).
+static constexpr size_t filesPerStatChunk = 512;
+
+// stamp files look like this (paths are last so they can have spaces):
+//
+// mcfunc build stamp v2
+// key <key>
+// input <size> <last write time> <path>
+// output <size> <last write time> <path>
+// messages
+// <everything the build printed>
+
+namespace {
+namespace helper {
+
+/// Parses "<size> <last write time> <path>" (what's after "input " or
+/// "output " in a stamp file). Returns whether it's valid.
+static bool parseStatLine(const std::string& line, uintmax_t& size, int64_t& lastWriteTime,
+                          std::string& path);
+
+} // namespace helper
+} // namespace
+
+BuildStamp::BuildStamp(std::string&& key, std::vector<std::filesystem::path>&& inputPaths)
+    : m_key(std::move(key)), m_inputPaths(std::move(inputPaths)),
+      m_inputStats(statFiles(m_inputPaths)) {}
+
+std::optional<std::string>
+BuildStamp::messagesIfUpToDate(const std::filesystem::path& stampPath) const {
+  std::ifstream file(stampPath, std::ios::binary);
+  if (!file.is_open())
+    return std::nullopt;
+
+  std::string line;
+  if (!std::getline(file, line) || line != stampHeader)
+    return std::nullopt;
+  if (!std::getline(file, line) || line != "key " + m_key)
+    return std::nullopt;
+
+  // inputs have to be in the same order as last time
+  uintmax_t size;
+  int64_t lastWriteTime;
+  std::string path;
+  for (size_t i = 0; i < m_inputPaths.size(); i++) {
+    if (!std::getline(file, line) || line.compare(0, 6, "input ") != 0 ||
+        !helper::parseStatLine(line.substr(6), size, lastWriteTime, path) ||
+        path != m_inputPaths[i].string() || !m_inputStats[i].exists ||
+        m_inputStats[i].size != size || m_inputStats[i].lastWriteTime != lastWriteTime) {
+      return std::nullopt;
+    }
+  }
+
+  // outputs are checked in case they were changed or removed by something else
+  std::vector<std::filesystem::path> outputPaths;
+  std::vector<FileStat> expectedOutputStats;
+  while (std::getline(file, line) && line != "messages") {
+    if (line.compare(0, 7, "output ") != 0 ||
+        !helper::parseStatLine(line.substr(7), size, lastWriteTime, path)) {
+      return std::nullopt;
+    }
+    outputPaths.emplace_back(std::move(path));
+    expectedOutputStats.push_back({true, size, lastWriteTime});
+  }
+  if (line != "messages")
+    return std::nullopt;
+
+  if (statFiles(outputPaths) != expectedOutputStats)
+    return std::nullopt;
+
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void BuildStamp::write(const std::filesystem::path& stampPath,
+                       const std::vector<std::filesystem::path>& outputPaths,
+                       const std::string& messages) const {
+  const std::vector<FileStat> outputStats = statFiles(outputPaths);
+
+  std::string contents = stampHeader;
+  contents += "\nkey " + m_key + '\n';
+
+  const auto addStatLine = [&contents](const char* kind, const FileStat& stat,
+                                       const std::filesystem::path& path) {
+    contents += kind;
+    contents += ' ' + std::to_string(stat.size) + ' ' + std::to_string(stat.lastWriteTime) + ' ' +
+                path.string() + '\n';
+  };
+
+  for (size_t i = 0; i < m_inputPaths.size(); i++)
+    addStatLine("input", m_inputStats[i], m_inputPaths[i]);
+  for (size_t i = 0; i < outputPaths.size(); i++)
+    addStatLine("output", outputStats[i], outputPaths[i]);
+
+  // a stamp that can't be read back the same way would never match
+  const bool canBeWritten =
+      std::all_of(m_inputStats.begin(), m_inputStats.end(),
+                  [](const FileStat& stat) { return stat.exists; }) &&
+      std::all_of(outputStats.begin(), outputStats.end(),
+                  [](const FileStat& stat) { return stat.exists; }) &&
+      std::count(contents.begin(), contents.end(), '\n') ==
+          static_cast<std::ptrdiff_t>(2 + m_inputPaths.size() + outputPaths.size());
+
+  std::error_code ec;
+  if (!canBeWritten) {
+    std::filesystem::remove(stampPath, ec);
+    return;
+  }
+
+  contents += "messages\n";
+  contents += messages;
+
+  std::ofstream file(stampPath, std::ios::binary | std::ios::trunc);
+  file << contents;
+  file.close();
+  if (!file)
+    std::filesystem::remove(stampPath, ec);
+}
+
+std::string BuildStamp::keyFromArgs(int argc, const char** argv) {
+  std::error_code ec;
+  const std::filesystem::path workingDirectory = std::filesystem::current_path(ec);
+
+  uint64_t hash = fnv1aHash(MCFUNC_VERSION);
+  hash = fnv1aHash(std::string_view("\0", 1), hash);
+  hash = fnv1aHash(workingDirectory.string(), hash);
+  for (int i = 1; i < argc; i++) {
+    hash = fnv1aHash(std::string_view("\0", 1), hash);
+    hash = fnv1aHash(argv[i], hash);
+  }
+
+  char hashStr[17];
+  std::snprintf(hashStr, sizeof(hashStr), "%016llx", static_cast<unsigned long long>(hash));
+  return hashStr;
+}
+
+bool BuildStamp::FileStat::operator==(const FileStat& other) const {
+  return exists == other.exists && size == other.size && lastWriteTime == other.lastWriteTime;
+}
+
+std::vector<BuildStamp::FileStat>
+BuildStamp::statFiles(const std::vector<std::filesystem::path>& paths) {
+  std::vector<FileStat> ret(paths.size());
+
+  // each chunk fills in its own part of the result
+  const size_t chunkCount = (paths.size() + filesPerStatChunk - 1) / filesPerStatChunk;
+  runInParallel(chunkCount, [&paths, &ret](size_t chunk) {
+    const size_t end = std::min(paths.size(), (chunk + 1) * filesPerStatChunk);
+    for (size_t i = chunk * filesPerStatChunk; i < end; i++)
+      ret[i] = statFile(paths[i]);
+  });
+
+  return ret;
+}
+
+BuildStamp::FileStat BuildStamp::statFile(const std::filesystem::path& path) {
+  std::error_code ec;
+  FileStat ret;
+
+  const uintmax_t size = std::filesystem::file_size(path, ec);
+  if (ec)
+    return ret;
+  ret.size = size;
+
+  const std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(path, ec);
+  if (ec)
+    return ret;
+  ret.lastWriteTime = static_cast<int64_t>(lastWriteTime.time_since_epoch().count());
+
+  ret.exists = true;
+  return ret;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static bool helper::parseStatLine(const std::string& line, uintmax_t& size,
+                                  int64_t& lastWriteTime, std::string& path) {
+  // this is done by hand because string streams are slow with 10k+ lines
+  const char* start = line.c_str();
+  char* end;
+
+  size = std::strtoumax(start, &end, 10);
+  if (end == start || *end != ' ')
+    return false;
+
+  start = end + 1;
+  lastWriteTime = static_cast<int64_t>(std::strtoll(start, &end, 10));
+  if (end == start || *end != ' ')
+    return false;
+
+  path.assign(end + 1);
+  return !path.empty();
+}
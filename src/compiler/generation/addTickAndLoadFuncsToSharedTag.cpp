@@ -3,15 +3,17 @@
 #include <array>
 #include <cassert>
 #include <cctype>
-#include <cstring>
 #include <filesystem>
-#include <system_error>
+#include <string_view>
 
 #include <cli/style_text.h>
 #include <compiler/compile_error.h>
 #include <compiler/fileToStr.h>
 #include <compiler/generation/writeFileToDataPack.h>
+#include <compiler/pass_timing.h>
+#include <compiler/tracing.h>
 #include <compiler/translation/constants.h>
+#include <compiler/vfs.h>
 
 /* In this file we add and remove elements from a nested JSON array. The JSON is
  * parsed manually here because we know exactly what the format of the JSON
@@ -36,17 +38,22 @@ namespace helper {
 
 /// Writes to a file \param path in \param outputDirectoru with the call names
 /// \param callNames. Existing call names are kept in place (with the exception
-/// of ones that are under the exposed namespace or hidden namespace).
+/// of ones that are under the exposed namespaces or their hidden namespaces).
 static void writeFuncTagFile(const std::filesystem::path& outputDirectory,
                              const std::filesystem::path& path,
                              const std::vector<std::string>& callNames,
-                             const std::string& exposedNamespace, bool isTickTag);
+                             const std::vector<std::string>& exposedNamespaces, bool isTickTag);
 
-static constexpr size_t constStrlen(const char* c);
+/// Whether \param callName (e.g. "foo:bar") is under one of
+/// \param exposedNamespaces or one of their hidden namespaces.
+static bool isInExposedNamespaces(std::string_view callName,
+                                  const std::vector<std::string>& exposedNamespaces);
 
-static void writeCallNamesToNewFile(const std::filesystem::path& outputDirectory,
-                                    const std::filesystem::path& path,
-                                    const std::vector<std::string>& callNames);
+/// Defined here so that it can be used in constant expressions above the helper
+/// function definitions.
+static constexpr size_t constStrlen(const char* c) {
+  return (*c == '\0') ? 0 : 1 + constStrlen(c + 1);
+}
 
 /// Ensures that \param str at index \param i to the length of \param token
 /// matches \param token.
@@ -58,8 +65,9 @@ static void ensureStrMatchesToken(const std::string& str, size_t i, std::string_
 static size_t getIndexAfterLeadingTokens(const std::string& str, bool isTickTag,
                                          const std::filesystem::path& fullFilePath);
 
-static std::vector<std::string> collectExternalNamespaceCallNames(
-    bool isTickTag, const std::filesystem::path& fullFilePath, const std::string& exposedNamespace);
+static std::vector<std::string>
+collectExternalNamespaceCallNames(bool isTickTag, const std::filesystem::path& fullFilePath,
+                                  const std::vector<std::string>& exposedNamespaces);
 
 } // namespace helper
 } // namespace
@@ -67,68 +75,21 @@ static std::vector<std::string> collectExternalNamespaceCallNames(
 void addTickAndLoadFuncsToSharedTag(const std::filesystem::path& outputDirectory,
                                     const std::vector<std::string>& tickFuncCallNames,
                                     const std::vector<std::string>& loadFuncCallNames,
-                                    const std::string& exposedNamespace) {
+                                    const std::vector<std::string>& exposedNamespaces) {
+  pass_timing::ScopedTimer timer(pass_timing::Pass::ADD_TICK_AND_LOAD_FUNCS);
+  TRACE_SPAN("write function tags");
+
   assert(outputDirectory == outputDirectory.lexically_normal() && "Output dir isn't clean.");
   assert(outputDirectory.is_absolute() && "Output dir isn't absolute.");
   assert(outputDirectory != std::filesystem::current_path() && "Output dir == working dir.");
 
-  helper::writeFuncTagFile(outputDirectory, tickFuncTagPath, tickFuncCallNames, exposedNamespace,
+  helper::writeFuncTagFile(outputDirectory, tickFuncTagPath, tickFuncCallNames, exposedNamespaces,
                            true);
-  helper::writeFuncTagFile(outputDirectory, loadFuncTagPath, loadFuncCallNames, exposedNamespace,
+  helper::writeFuncTagFile(outputDirectory, loadFuncTagPath, loadFuncCallNames, exposedNamespaces,
                            false);
 }
 
-// ---------------------------------------------------------------------------//
-// Helper function definitions beyond this point.
-// ---------------------------------------------------------------------------//
-
-static void helper::writeFuncTagFile(const std::filesystem::path& outputDirectory,
-                                     const std::filesystem::path& path,
-                                     const std::vector<std::string>& callNames,
-                                     const std::string& exposedNamespace, bool isTickTag) {
-  std::filesystem::path fullFilePath = outputDirectory / path;
-
-  std::error_code ec;
-
-  bool exists = std::filesystem::exists(fullFilePath, ec);
-  if (ec) {
-    throw compile_error::CodeGenFailure("Failed to check if the directory " +
-                                        style_text::styleAsCode(fullFilePath.string()) +
-                                        " exists.");
-  }
-
-  // this is the simple path, the file doesn't exist and we can just create it
-  // from scratch (no parsing needed)
-  if (!exists) {
-    helper::writeCallNamesToNewFile(outputDirectory, path, callNames);
-    return;
-  }
-
-  // if we made it here then the file already exists so we need to parse it and
-  // save all of the existing call names that aren't are under our exposed or
-  // hidden namespace before we can write the file.
-
-  std::vector<std::string> externalCallNames =
-      collectExternalNamespaceCallNames(isTickTag, fullFilePath, exposedNamespace);
-
-  // special case in the likely event that there are no external function calls
-  // (this way we don't need to copy anything)
-  if (externalCallNames.empty()) {
-    helper::writeCallNamesToNewFile(outputDirectory, path, callNames);
-    return;
-  }
-
-  externalCallNames.insert(externalCallNames.end(), callNames.begin(), callNames.end());
-  helper::writeCallNamesToNewFile(outputDirectory, path, externalCallNames);
-}
-
-static constexpr size_t helper::constStrlen(const char* c) {
-  return (*c == '\0') ? 0 : 1 + constStrlen(c + 1);
-}
-
-static void helper::writeCallNamesToNewFile(const std::filesystem::path& outputDirectory,
-                                            const std::filesystem::path& path,
-                                            const std::vector<std::string>& callNames) {
+std::string funcTagFileContents(const std::vector<std::string>& callNames) {
   // prefix is 1 shorter if there is no body (no trailing newline)
   constexpr const char prefix[] = "{\n    \"values\": [\n";
   constexpr const size_t prefixSize = helper::constStrlen(prefix);
@@ -173,7 +134,45 @@ static void helper::writeCallNamesToNewFile(const std::filesystem::path& outputD
     contentsStr += suffix;
   }
 
-  writeFileToDataPack(outputDirectory, path, contentsStr);
+  return contentsStr;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static void helper::writeFuncTagFile(const std::filesystem::path& outputDirectory,
+                                     const std::filesystem::path& path,
+                                     const std::vector<std::string>& callNames,
+                                     const std::vector<std::string>& exposedNamespaces,
+                                     bool isTickTag) {
+  std::filesystem::path fullFilePath = outputDirectory / path;
+
+  const bool exists = vfs::exists(fullFilePath);
+
+  // this is the simple path, the file doesn't exist and we can just create it
+  // from scratch (no parsing needed)
+  if (!exists) {
+    writeFileToDataPack(outputDirectory, path, funcTagFileContents(callNames));
+    return;
+  }
+
+  // if we made it here then the file already exists so we need to parse it and
+  // save all of the existing call names that aren't are under our exposed or
+  // hidden namespace before we can write the file.
+
+  std::vector<std::string> externalCallNames =
+      collectExternalNamespaceCallNames(isTickTag, fullFilePath, exposedNamespaces);
+
+  // special case in the likely event that there are no external function calls
+  // (this way we don't need to copy anything)
+  if (externalCallNames.empty()) {
+    writeFileToDataPack(outputDirectory, path, funcTagFileContents(callNames));
+    return;
+  }
+
+  externalCallNames.insert(externalCallNames.end(), callNames.begin(), callNames.end());
+  writeFileToDataPack(outputDirectory, path, funcTagFileContents(externalCallNames));
 }
 
 static void helper::ensureStrMatchesToken(const std::string& str, size_t i, std::string_view token,
@@ -229,7 +228,7 @@ static size_t helper::getIndexAfterLeadingTokens(const std::string& str, bool is
 
 static std::vector<std::string> helper::collectExternalNamespaceCallNames(
     bool isTickTag, const std::filesystem::path& fullFilePath,
-    const std::string& exposedNamespace) {
+    const std::vector<std::string>& exposedNamespaces) {
   std::string existingStr = fileToStr(fullFilePath);
 
   size_t i = helper::getIndexAfterLeadingTokens(existingStr, isTickTag, fullFilePath);
@@ -238,11 +237,9 @@ static std::vector<std::string> helper::collectExternalNamespaceCallNames(
   if (i == 0)
     return {};
 
-  // collect all elements of the JSON array that don't start with the exposed
+  // collect all elements of the JSON array that don't start with an exposed
   // or hidden namespace (validate function call names too)
 
-  const std::string hiddenNamespace = hiddenNamespacePrefix + exposedNamespace;
-
   std::vector<std::string> ret;
 
   bool foundComma = true;
@@ -401,14 +398,10 @@ static std::vector<std::string> helper::collectExternalNamespaceCallNames(
           i, fullFilePath, 1);
     }
 
-    // if what we just added is a part of the exposed or private namespace we
+    // if what we just added is a part of an exposed or private namespace we
     // can remove it
-    if ((std::strncmp(ret.back().c_str(), hiddenNamespace.c_str(), hiddenNamespace.size()) == 0 &&
-         ret.back()[hiddenNamespace.size()] == ':') ||
-        (std::strncmp(ret.back().c_str(), exposedNamespace.c_str(), exposedNamespace.size()) == 0 &&
-         ret.back()[exposedNamespace.size()] == ':')) {
+    if (helper::isInExposedNamespaces(ret.back(), exposedNamespaces))
       ret.pop_back();
-    }
   }
   i++;
 
@@ -438,3 +431,14 @@ static std::vector<std::string> helper::collectExternalNamespaceCallNames(
 
   return ret;
 }
+
+static bool helper::isInExposedNamespaces(std::string_view callName,
+                                          const std::vector<std::string>& exposedNamespaces) {
+  const std::string_view callNamespace = callName.substr(0, callName.find(':'));
+  for (const std::string& exposedNamespace : exposedNamespaces) {
+    if (callNamespace == exposedNamespace ||
+        callNamespace == hiddenNamespacePrefix + exposedNamespace)
+      return true;
+  }
+  return false;
+}
@@ -6,7 +6,14 @@
 #include <compiler/compile_error.h>
 #include <compiler/generation/addTickAndLoadFuncsToSharedTag.h>
 #include <compiler/generation/writeFileToDataPack.h>
+#include <compiler/pass_timing.h>
+#include <compiler/tracing.h>
 #include <compiler/translation/constants.h>
+#include <compiler/vfs.h>
+
+/// How many files are in each traced batch of files written by
+/// \p generateDataPack() .
+static constexpr size_t filesPerOutputBatch = 256;
 
 namespace {
 namespace helper {
@@ -18,36 +25,115 @@ static void removeDirectoryIfItExists(const std::filesystem::path& dir);
 } // namespace
 
 void generateDataPack(const std::filesystem::path& outputDirectory,
-                      const std::string& exposedNamespace,
+                      const std::vector<std::string>& exposedNamespaces,
                       const std::unordered_map<std::filesystem::path, std::string>& fileWriteMap,
+                      const std::unordered_map<std::filesystem::path, std::filesystem::path>&
+                          fileCopyMap,
                       bool clearOutputDirectory, const std::vector<std::string>& tickFuncCallNames,
                       const std::vector<std::string>& loadFuncCallNames) {
+  pass_timing::ScopedTimer timer(pass_timing::Pass::GENERATE_DATA_PACK);
+  TRACE_SPAN("generate data pack");
+
   assert(outputDirectory == outputDirectory.lexically_normal() && "Output dir isn't clean.");
   assert(outputDirectory.is_absolute() && "Output dir isn't absolute.");
   assert(outputDirectory != std::filesystem::current_path() && "Output dir == working dir.");
 
-  std::error_code ec;
-
   if (clearOutputDirectory)
     helper::removeDirectoryIfItExists(outputDirectory);
 
   // create the output directory if it doesn't exist
-  std::filesystem::create_directories(outputDirectory, ec);
-  if (ec) {
+  if (!vfs::createDirectories(outputDirectory)) {
     throw compile_error::CodeGenFailure("Failed to create output directory " +
                                         style_text::styleAsCode(outputDirectory.string()) + '.');
   }
 
   addTickAndLoadFuncsToSharedTag(outputDirectory, tickFuncCallNames, loadFuncCallNames,
-                                 exposedNamespace);
+                                 exposedNamespaces);
 
   // remove the namespace directories if they exist
-  helper::removeDirectoryIfItExists(outputDirectory / exposedNamespace);
-  helper::removeDirectoryIfItExists(outputDirectory / (hiddenNamespacePrefix + exposedNamespace));
+  for (const std::string& exposedNamespace : exposedNamespaces) {
+    helper::removeDirectoryIfItExists(outputDirectory / exposedNamespace);
+    helper::removeDirectoryIfItExists(outputDirectory / (hiddenNamespacePrefix + exposedNamespace));
+  }
 
   // write all files into the data pack
-  for (const auto& [outputPath, contents] : fileWriteMap)
+  // files are written in batches so that each batch can be traced
+  auto it = fileWriteMap.begin();
+  while (it != fileWriteMap.end()) {
+    TRACE_SPAN("write output batch");
+    for (size_t i = 0; i < filesPerOutputBatch && it != fileWriteMap.end(); i++, ++it) {
+      writeFileToDataPack(outputDirectory, it->first, it->second);
+      timer.addBytes(it->second.size());
+    }
+  }
+
+  // the kernel copies these so they never pass through memory here
+  auto copyIt = fileCopyMap.begin();
+  while (copyIt != fileCopyMap.end()) {
+    TRACE_SPAN("copy output batch");
+    for (size_t i = 0; i < filesPerOutputBatch && copyIt != fileCopyMap.end(); i++, ++copyIt)
+      copyFileToDataPack(outputDirectory, copyIt->first, copyIt->second);
+  }
+}
+
+std::vector<std::filesystem::path> dataPackFilePaths(
+    const std::unordered_map<std::filesystem::path, std::string>& fileWriteMap,
+    const std::unordered_map<std::filesystem::path, std::filesystem::path>& fileCopyMap) {
+  std::vector<std::filesystem::path> ret;
+  ret.reserve(fileWriteMap.size() + fileCopyMap.size() + 2);
+  ret.push_back(tickFuncTagPath);
+  ret.push_back(loadFuncTagPath);
+  for (const auto& [outputPath, _] : fileWriteMap)
+    ret.push_back(outputPath);
+  for (const auto& [outputPath, _] : fileCopyMap)
+    ret.push_back(outputPath);
+  return ret;
+}
+
+size_t updateDataPack(
+    const std::filesystem::path& outputDirectory,
+    const std::unordered_map<std::filesystem::path, std::string>& previousFileWriteMap,
+    const std::unordered_map<std::filesystem::path, std::string>& fileWriteMap,
+    const std::unordered_map<std::filesystem::path, std::filesystem::path>& previousFileCopyMap,
+    const std::unordered_map<std::filesystem::path, std::filesystem::path>& fileCopyMap,
+    const std::set<std::filesystem::path>& changedCopySources) {
+  assert(outputDirectory == outputDirectory.lexically_normal() && "Output dir isn't clean.");
+  assert(outputDirectory.is_absolute() && "Output dir isn't absolute.");
+
+  size_t ret = 0;
+
+  const auto removeIfUnused = [&](const std::filesystem::path& outputPath) {
+    if (fileWriteMap.count(outputPath) || fileCopyMap.count(outputPath))
+      return;
+    if (!vfs::removeAll(outputDirectory / outputPath)) {
+      throw compile_error::CodeGenFailure("Failed to remove the file " +
+                                          style_text::styleAsCode(outputPath.string()) + '.');
+    }
+    ret++;
+  };
+  for (const auto& [outputPath, _] : previousFileWriteMap)
+    removeIfUnused(outputPath);
+  for (const auto& [outputPath, _] : previousFileCopyMap)
+    removeIfUnused(outputPath);
+
+  for (const auto& [outputPath, contents] : fileWriteMap) {
+    const auto previous = previousFileWriteMap.find(outputPath);
+    if (previous != previousFileWriteMap.end() && previous->second == contents)
+      continue;
     writeFileToDataPack(outputDirectory, outputPath, contents);
+    ret++;
+  }
+
+  for (const auto& [outputPath, sourcePath] : fileCopyMap) {
+    const auto previous = previousFileCopyMap.find(outputPath);
+    if (previous != previousFileCopyMap.end() && previous->second == sourcePath &&
+        !changedCopySources.count(sourcePath))
+      continue;
+    copyFileToDataPack(outputDirectory, outputPath, sourcePath);
+    ret++;
+  }
+
+  return ret;
 }
 
 // ---------------------------------------------------------------------------//
@@ -57,20 +143,9 @@ void generateDataPack(const std::filesystem::path& outputDirectory,
 static void helper::removeDirectoryIfItExists(const std::filesystem::path& dir) {
   assert(dir.is_absolute() && "removed directories should be absolute");
 
-  std::error_code ec;
-
-  bool exists = std::filesystem::exists(dir, ec);
-  if (ec) {
-    throw compile_error::CodeGenFailure("Failed to check if the directory " +
-                                        style_text::styleAsCode(dir.string()) + " exists.");
-  }
-
-  if (exists) {
-    std::filesystem::remove_all(dir, ec);
-    if (ec) {
-      throw compile_error::CodeGenFailure("Failed to remove the directory " +
-                                          style_text::styleAsCode(dir.string()) +
-                                          " and its contents.");
-    }
+  if (vfs::exists(dir) && !vfs::removeAll(dir)) {
+    throw compile_error::CodeGenFailure("Failed to remove the directory " +
+                                        style_text::styleAsCode(dir.string()) +
+                                        " and its contents.");
   }
 }
@@ -0,0 +1,101 @@
+#include <compiler/generation/generateDepfile.h>
+
+#include <system_error>
+#include <unordered_set>
+
+namespace {
+namespace helper {
+
+/// Adds \param path to \param str escaped so Make and Ninja read it as 1 path.
+/// The path is made relative to \param workingDirectory if it's inside of it.
+static void appendEscapedPath(std::string& str, const std::filesystem::path& path,
+                              const std::filesystem::path& workingDirectory);
+
+/// Whether \param path is \param directory or is inside of it.
+static bool isInDirectory(const std::filesystem::path& path,
+                          const std::filesystem::path& directory);
+
+} // namespace helper
+} // namespace
+
+std::string generateDepfile(const std::vector<std::filesystem::path>& targets,
+                            const std::vector<std::filesystem::path>& inputPaths,
+                            const std::vector<std::filesystem::path>& inputDirectories) {
+  std::vector<std::filesystem::path> dependencies = inputPaths;
+
+  // a directory's modification time changes when a file is added to or removed
+  // from it (but not when a file in a directory inside of it is)
+  std::unordered_set<std::filesystem::path> addedDirectories;
+  for (const std::filesystem::path& inputDirectory : inputDirectories) {
+    if (addedDirectories.insert(inputDirectory).second)
+      dependencies.push_back(inputDirectory);
+  }
+  for (const std::filesystem::path& inputPath : inputPaths) {
+    for (const std::filesystem::path& inputDirectory : inputDirectories) {
+      if (!helper::isInDirectory(inputPath, inputDirectory))
+        continue;
+
+      for (std::filesystem::path dir = inputPath.parent_path();
+           dir != inputDirectory && addedDirectories.insert(dir).second; dir = dir.parent_path()) {
+        dependencies.push_back(dir);
+      }
+      break;
+    }
+  }
+
+  std::error_code ec;
+  const std::filesystem::path workingDirectory = std::filesystem::current_path(ec);
+
+  std::string ret;
+  for (size_t i = 0; i < targets.size(); i++) {
+    if (i != 0)
+      ret += " \\\n ";
+    helper::appendEscapedPath(ret, targets[i], workingDirectory);
+  }
+  ret += ':';
+  for (const std::filesystem::path& dependency : dependencies) {
+    ret += " \\\n ";
+    helper::appendEscapedPath(ret, dependency, workingDirectory);
+  }
+  ret += '\n';
+
+  for (const std::filesystem::path& dependency : dependencies) {
+    ret += '\n';
+    helper::appendEscapedPath(ret, dependency, workingDirectory);
+    ret += ":\n";
+  }
+
+  return ret;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static void helper::appendEscapedPath(std::string& str, const std::filesystem::path& path,
+                                      const std::filesystem::path& workingDirectory) {
+  // Make only knows 2 paths are the same file if they're written the same way
+  // (and rules in a makefile are usually written with relative paths)
+  std::filesystem::path pathToWrite = path;
+  if (!workingDirectory.empty() && isInDirectory(path, workingDirectory))
+    pathToWrite = path.lexically_relative(workingDirectory);
+
+  for (const char c : pathToWrite.string()) {
+    if (c == ' ' || c == '#')
+      str += '\\';
+    else if (c == '$')
+      str += '$';
+    str += c;
+  }
+}
+
+static bool helper::isInDirectory(const std::filesystem::path& path,
+                                  const std::filesystem::path& directory) {
+  auto pathIt = path.begin();
+  auto dirIt = directory.begin();
+  for (; dirIt != directory.end() && *dirIt != ""; ++dirIt, ++pathIt) {
+    if (pathIt == path.end() || *dirIt != *pathIt)
+      return false;
+  }
+  return true;
+}
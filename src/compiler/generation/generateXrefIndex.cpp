@@ -0,0 +1,177 @@
+#include <compiler/generation/generateXrefIndex.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+#include <compiler/XrefIndex.h>
+#include <compiler/syntax_analysis/statement.h>
+#include <compiler/syntax_analysis/symbol.h>
+#include <compiler/tokenization/Token.h>
+
+namespace {
+
+/// An entry before it's written.
+struct Record {
+  std::string name;
+  XrefIndex::Kind kind;
+  uint32_t fileIndex;
+  uint32_t indexInFile;
+
+  bool operator<(const Record& other) const {
+    return std::tie(name, kind, fileIndex, indexInFile) <
+           std::tie(other.name, other.kind, other.fileIndex, other.indexInFile);
+  }
+};
+
+namespace helper {
+
+/// Adds a record for every function call in \param statement (and the
+/// statements inside of it) to \param records .
+static void addCallRecords(const statement::Generic& statement, const std::vector<Token>& tokens,
+                           uint32_t fileIndex, std::vector<Record>& records);
+
+/// Adds the records for every definition, declaration, file write, and import
+/// in \param sourceFile to \param records .
+static void addRecords(const SourceFile& sourceFile, uint32_t fileIndex,
+                       std::vector<Record>& records);
+
+/// Appends \param value to \param out as a little-endian 32-bit integer.
+static void appendU32(std::string& out, size_t value);
+
+} // namespace helper
+} // namespace
+
+std::string generateXrefIndex(const SourceFiles& sourceFiles) {
+  // files are sorted by path so the index doesn't depend on the order they were
+  // given in
+  std::vector<std::pair<std::string, size_t>> filePaths;
+  filePaths.reserve(sourceFiles.size());
+  for (size_t i = 0; i < sourceFiles.size(); i++)
+    filePaths.emplace_back(sourceFiles[i].path().generic_string(), i);
+  std::sort(filePaths.begin(), filePaths.end());
+
+  std::vector<Record> records;
+  for (size_t i = 0; i < filePaths.size(); i++)
+    helper::addRecords(sourceFiles[filePaths[i].second], static_cast<uint32_t>(i), records);
+  std::sort(records.begin(), records.end());
+
+  // every name and the range of its entries
+  std::vector<std::tuple<std::string_view, size_t, size_t>> names;
+  for (size_t i = 0; i < records.size(); i++) {
+    if (names.empty() || std::get<0>(names.back()) != records[i].name)
+      names.emplace_back(records[i].name, i, 0);
+    std::get<2>(names.back())++;
+  }
+
+  std::string strings;
+  std::string ret;
+  ret.reserve(XrefIndex::headerSize + filePaths.size() * XrefIndex::fileRecordSize +
+              names.size() * XrefIndex::nameRecordSize +
+              records.size() * XrefIndex::entryRecordSize);
+
+  ret += XrefIndex::magic;
+  helper::appendU32(ret, XrefIndex::version);
+  helper::appendU32(ret, filePaths.size());
+  helper::appendU32(ret, names.size());
+  helper::appendU32(ret, records.size());
+
+  for (const auto& [filePath, _] : filePaths) {
+    helper::appendU32(ret, strings.size());
+    helper::appendU32(ret, filePath.size());
+    strings += filePath;
+  }
+
+  for (const auto& [name, firstEntry, entryCount] : names) {
+    helper::appendU32(ret, strings.size());
+    helper::appendU32(ret, name.size());
+    helper::appendU32(ret, firstEntry);
+    helper::appendU32(ret, entryCount);
+    strings += name;
+  }
+
+  for (const Record& record : records) {
+    helper::appendU32(ret, static_cast<uint32_t>(record.kind));
+    helper::appendU32(ret, record.fileIndex);
+    helper::appendU32(ret, record.indexInFile);
+  }
+
+  return ret + strings;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static void helper::addCallRecords(const statement::Generic& statement,
+                                   const std::vector<Token>& tokens, uint32_t fileIndex,
+                                   std::vector<Record>& records) {
+  switch (statement.kind()) {
+
+  case statement::Kind::FUNCTION_CALL: {
+    const Token& nameToken =
+        tokens[static_cast<const statement::FunctionCall&>(statement).functionNameTokenIndex()];
+    records.push_back({nameToken.contents(), XrefIndex::Kind::FUNCTION_CALL, fileIndex,
+                       static_cast<uint32_t>(nameToken.indexInFile())});
+    return;
+  }
+
+  case statement::Kind::COMMAND: {
+    const auto& command = static_cast<const statement::Command&>(statement);
+    if (command.hasStatementAfterRun())
+      addCallRecords(*command.statementAfterRun(), tokens, fileIndex, records);
+    return;
+  }
+
+  case statement::Kind::SCOPE:
+    for (const auto& innerStatement : static_cast<const statement::Scope&>(statement).statements())
+      addCallRecords(*innerStatement, tokens, fileIndex, records);
+    return;
+  }
+}
+
+static void helper::addRecords(const SourceFile& sourceFile, uint32_t fileIndex,
+                               std::vector<Record>& records) {
+  const std::vector<Token>& tokens = sourceFile.tokens();
+
+  // The function table merges every declaration and definition of a function
+  // into one symbol, so they're found from the tokens instead. After syntax
+  // analysis 'void' is always followed by 'foo ( )' and then '{' or 'expose'
+  // for a definition or ';' for a declaration.
+  for (size_t i = 0; i + 4 < tokens.size(); i++) {
+    if (tokens[i].kind() != Token::VOID_KW)
+      continue;
+    assert(tokens[i + 1].kind() == Token::WORD && "'void' should be followed by a name");
+    const XrefIndex::Kind kind = (tokens[i + 4].kind() == Token::SEMICOLON)
+                                     ? XrefIndex::Kind::FUNCTION_DECLARATION
+                                     : XrefIndex::Kind::FUNCTION_DEFINITION;
+    records.push_back({tokens[i + 1].contents(), kind, fileIndex,
+                       static_cast<uint32_t>(tokens[i + 1].indexInFile())});
+  }
+
+  for (const symbol::Function& func : sourceFile.functionSymbolTable()) {
+    if (func.isDefined())
+      addCallRecords(func.definition(), tokens, fileIndex, records);
+  }
+
+  for (const symbol::FileWrite& fileWrite : sourceFile.fileWriteSymbolTable()) {
+    records.push_back({fileWrite.relativeOutPath().generic_string(), XrefIndex::Kind::FILE_WRITE,
+                       fileIndex,
+                       static_cast<uint32_t>(fileWrite.relativeOutPathToken().indexInFile())});
+  }
+
+  for (const symbol::Import& importSymbol : sourceFile.importSymbolTable()) {
+    records.push_back({importSymbol.importPath().generic_string(), XrefIndex::Kind::IMPORT,
+                       fileIndex,
+                       static_cast<uint32_t>(importSymbol.importPathToken().indexInFile())});
+  }
+}
+
+static void helper::appendU32(std::string& out, size_t value) {
+  assert(value <= std::numeric_limits<uint32_t>::max() && "the index is too big");
+  for (size_t i = 0; i < 4; i++)
+    out += static_cast<char>((value >> (8 * i)) & 0xff);
+}
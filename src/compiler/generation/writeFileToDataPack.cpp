@@ -1,46 +1,72 @@
 #include <compiler/generation/writeFileToDataPack.h>
 
 #include <cassert>
-#include <fstream>
 
 #include <cli/style_text.h>
 #include <compiler/compile_error.h>
+#include <compiler/vfs.h>
+
+namespace {
+namespace helper {
+
+/// Creates the directories that \param outputPath is in (starting from
+/// \param outputDir ) and returns the full path of the output file.
+static std::filesystem::path createParentDirectories(const std::filesystem::path& outputDir,
+                                                     const std::filesystem::path& outputPath);
+
+} // namespace helper
+} // namespace
 
 void writeFileToDataPack(const std::filesystem::path& outputDir,
                          const std::filesystem::path& outputPath, const std::string& contents) {
+  const std::filesystem::path fullFilePath =
+      helper::createParentDirectories(outputDir, outputPath);
+
+  // write the new file
+
+  if (!vfs::writeFile(fullFilePath, contents))
+    throw compile_error::CouldntOpenFile(fullFilePath, compile_error::CouldntOpenFile::Mode::WRITE);
+}
+
+void copyFileToDataPack(const std::filesystem::path& outputDir,
+                        const std::filesystem::path& outputPath,
+                        const std::filesystem::path& sourcePath) {
+  const std::filesystem::path fullFilePath =
+      helper::createParentDirectories(outputDir, outputPath);
+
+  if (!vfs::isRegularFile(sourcePath))
+    throw compile_error::CouldntOpenFile(sourcePath);
+  if (!vfs::copyFile(sourcePath, fullFilePath))
+    throw compile_error::CouldntOpenFile(fullFilePath, compile_error::CouldntOpenFile::Mode::WRITE);
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static std::filesystem::path
+helper::createParentDirectories(const std::filesystem::path& outputDir,
+                                const std::filesystem::path& outputPath) {
   assert(outputDir.is_absolute() && "outputDir must be absolute (it's a prefix to outputPath)");
   assert(outputPath.is_relative() && "outputPath must be relative (it's a suffix to outputDir)");
-  assert(std::filesystem::exists(outputDir) && std::filesystem::is_directory(outputDir) &&
-         "outputDir must be an existing directory.");
-
-  std::error_code ec;
+  assert(vfs::isDirectory(outputDir) && "outputDir must be an existing directory.");
 
   // where our file will go
-  const std::filesystem::path fullFilePath = outputDir / outputPath;
+  std::filesystem::path fullFilePath = outputDir / outputPath;
 
   // create containing folders (e.g. "foo/bar" for "foo/bar/baz.txt") but only
   // create folders inside outputDir
 
   const std::filesystem::path parentPathToCreate = fullFilePath.parent_path();
   if (parentPathToCreate != outputDir) {
-    std::filesystem::create_directories(parentPathToCreate, ec);
-    if (ec) {
+    if (!vfs::createDirectories(parentPathToCreate)) {
       throw compile_error::CodeGenFailure(
           "Failed to generate parent directories " +
           style_text::styleAsCode(outputPath.lexically_relative(parentPathToCreate).string()) +
           " for output file " + style_text::styleAsCode(fullFilePath.string()) + '.');
     }
   }
-  assert(std::filesystem::exists(parentPathToCreate) && "the parent path wasn't created");
-
-  // write the new file
-
-  std::ofstream file(fullFilePath, std::ios::out | std::ios::trunc);
-  if (!file.is_open() || !file.good())
-    throw compile_error::CouldntOpenFile(fullFilePath, compile_error::CouldntOpenFile::Mode::WRITE);
+  assert(vfs::isDirectory(parentPathToCreate) && "the parent path wasn't created");
 
-  file << contents;
-
-  if (!file.good())
-    throw compile_error::CouldntOpenFile(fullFilePath, compile_error::CouldntOpenFile::Mode::WRITE);
+  return fullFilePath;
 }
@@ -0,0 +1,404 @@
+#include <compiler/json.h>
+
+#include <cassert>
+#include <cstdlib>
+
+namespace {
+namespace helper {
+
+/// Parses JSON text one value at a time.
+class Parser {
+public:
+  explicit Parser(const std::string& text);
+
+  /// Parses the whole text as 1 value.
+  json::Value parseAll();
+
+private:
+  json::Value parseValue();
+  json::Value parseObject();
+  json::Value parseArray();
+  std::string parseString();
+  json::Value parseNumber();
+
+  /// Parses the literal \param word (e.g. "true") or throws.
+  void expectWord(const char* word);
+
+  /// Appends the UTF-8 encoding of \param codePoint to \param str.
+  static void appendUtf8(std::string& str, unsigned long codePoint);
+
+  /// Reads 4 hex digits after a "\u" escape.
+  unsigned long parseHex4();
+
+  void skipWhitespace();
+
+  /// Returns the current character or '\0' at the end of the text.
+  char peek() const;
+
+  [[noreturn]] void fail(const std::string& msg) const;
+
+private:
+  const std::string& m_text;
+  size_t m_i = 0;
+};
+
+} // namespace helper
+} // namespace
+
+// ParseError
+
+json::ParseError::ParseError(const std::string& msg, size_t index)
+    : std::runtime_error(msg + " (at index " + std::to_string(index) + ")"), m_index(index) {}
+
+size_t json::ParseError::index() const { return m_index; }
+
+// Value
+
+json::Value::Value() : m_kind(Kind::NULL_VALUE), m_bool(false), m_number(0) {}
+
+json::Value::Value(bool boolValue) : m_kind(Kind::BOOL), m_bool(boolValue), m_number(0) {}
+
+json::Value::Value(double numberValue)
+    : m_kind(Kind::NUMBER), m_bool(false), m_number(numberValue) {}
+
+json::Value::Value(std::string&& stringValue)
+    : m_kind(Kind::STRING), m_bool(false), m_number(0), m_string(std::move(stringValue)) {}
+
+json::Value::Value(std::vector<Value>&& arrayValue)
+    : m_kind(Kind::ARRAY), m_bool(false), m_number(0), m_array(std::move(arrayValue)) {}
+
+json::Value::Value(std::map<std::string, Value>&& objectValue)
+    : m_kind(Kind::OBJECT), m_bool(false), m_number(0), m_object(std::move(objectValue)) {}
+
+json::Value::Kind json::Value::kind() const { return m_kind; }
+
+bool json::Value::isNull() const { return m_kind == Kind::NULL_VALUE; }
+
+bool json::Value::isBool() const { return m_kind == Kind::BOOL; }
+
+bool json::Value::isNumber() const { return m_kind == Kind::NUMBER; }
+
+bool json::Value::isString() const { return m_kind == Kind::STRING; }
+
+bool json::Value::isArray() const { return m_kind == Kind::ARRAY; }
+
+bool json::Value::isObject() const { return m_kind == Kind::OBJECT; }
+
+bool json::Value::asBool() const {
+  assert(isBool() && "Can't call 'asBool()' on a value that isn't a bool.");
+  return m_bool;
+}
+
+double json::Value::asNumber() const {
+  assert(isNumber() && "Can't call 'asNumber()' on a value that isn't a number.");
+  return m_number;
+}
+
+const std::string& json::Value::asString() const {
+  assert(isString() && "Can't call 'asString()' on a value that isn't a string.");
+  return m_string;
+}
+
+const std::vector<json::Value>& json::Value::asArray() const {
+  assert(isArray() && "Can't call 'asArray()' on a value that isn't an array.");
+  return m_array;
+}
+
+const std::map<std::string, json::Value>& json::Value::asObject() const {
+  assert(isObject() && "Can't call 'asObject()' on a value that isn't an object.");
+  return m_object;
+}
+
+const json::Value& json::Value::operator[](const std::string& key) const {
+  static const Value nullValue;
+
+  if (!isObject())
+    return nullValue;
+  const auto it = m_object.find(key);
+  return (it != m_object.end()) ? it->second : nullValue;
+}
+
+// parse/quote
+
+json::Value json::parse(const std::string& text) { return helper::Parser(text).parseAll(); }
+
+std::string json::quote(const std::string& str) {
+  constexpr const char* hexDigits = "0123456789abcdef";
+
+  std::string ret = "\"";
+  for (const char c : str) {
+    switch (c) {
+    case '"':
+      ret += "\\\"";
+      break;
+    case '\\':
+      ret += "\\\\";
+      break;
+    case '\n':
+      ret += "\\n";
+      break;
+    case '\r':
+      ret += "\\r";
+      break;
+    case '\t':
+      ret += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        ret += "\\u00";
+        ret += hexDigits[(c >> 4) & 0xf];
+        ret += hexDigits[c & 0xf];
+      } else {
+        ret += c;
+      }
+    }
+  }
+  ret += '"';
+  return ret;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+helper::Parser::Parser(const std::string& text) : m_text(text) {}
+
+json::Value helper::Parser::parseAll() {
+  json::Value ret = parseValue();
+  skipWhitespace();
+  if (m_i != m_text.size())
+    fail("Unexpected text after JSON value");
+  return ret;
+}
+
+json::Value helper::Parser::parseValue() {
+  skipWhitespace();
+  switch (peek()) {
+  case '{':
+    return parseObject();
+  case '[':
+    return parseArray();
+  case '"':
+    return json::Value(parseString());
+  case 't':
+    expectWord("true");
+    return json::Value(true);
+  case 'f':
+    expectWord("false");
+    return json::Value(false);
+  case 'n':
+    expectWord("null");
+    return json::Value();
+  default:
+    return parseNumber();
+  }
+}
+
+json::Value helper::Parser::parseObject() {
+  std::map<std::string, json::Value> ret;
+  m_i++; // '{'
+
+  skipWhitespace();
+  if (peek() == '}') {
+    m_i++;
+    return json::Value(std::move(ret));
+  }
+
+  while (true) {
+    skipWhitespace();
+    if (peek() != '"')
+      fail("Expected a string key");
+    std::string key = parseString();
+
+    skipWhitespace();
+    if (peek() != ':')
+      fail("Expected ':'");
+    m_i++;
+
+    ret[std::move(key)] = parseValue();
+
+    skipWhitespace();
+    if (peek() == ',') {
+      m_i++;
+      continue;
+    }
+    if (peek() == '}') {
+      m_i++;
+      return json::Value(std::move(ret));
+    }
+    fail("Expected ',' or '}'");
+  }
+}
+
+json::Value helper::Parser::parseArray() {
+  std::vector<json::Value> ret;
+  m_i++; // '['
+
+  skipWhitespace();
+  if (peek() == ']') {
+    m_i++;
+    return json::Value(std::move(ret));
+  }
+
+  while (true) {
+    ret.push_back(parseValue());
+
+    skipWhitespace();
+    if (peek() == ',') {
+      m_i++;
+      continue;
+    }
+    if (peek() == ']') {
+      m_i++;
+      return json::Value(std::move(ret));
+    }
+    fail("Expected ',' or ']'");
+  }
+}
+
+std::string helper::Parser::parseString() {
+  std::string ret;
+  m_i++; // '"'
+
+  while (true) {
+    if (m_i >= m_text.size())
+      fail("Unterminated string");
+
+    const char c = m_text[m_i++];
+    if (c == '"')
+      return ret;
+    if (static_cast<unsigned char>(c) < 0x20)
+      fail("Control character in string");
+    if (c != '\\') {
+      ret += c;
+      continue;
+    }
+
+    switch (peek()) {
+    case '"':
+    case '\\':
+    case '/':
+      ret += m_text[m_i++];
+      break;
+    case 'b':
+      ret += '\b';
+      m_i++;
+      break;
+    case 'f':
+      ret += '\f';
+      m_i++;
+      break;
+    case 'n':
+      ret += '\n';
+      m_i++;
+      break;
+    case 'r':
+      ret += '\r';
+      m_i++;
+      break;
+    case 't':
+      ret += '\t';
+      m_i++;
+      break;
+    case 'u': {
+      m_i++;
+      unsigned long codePoint = parseHex4();
+      // surrogate pairs are written as 2 escapes
+      if (codePoint >= 0xd800 && codePoint <= 0xdbff) {
+        if (m_text.compare(m_i, 2, "\\u") != 0)
+          fail("Expected a low surrogate");
+        m_i += 2;
+        const unsigned long low = parseHex4();
+        if (low < 0xdc00 || low > 0xdfff)
+          fail("Invalid low surrogate");
+        codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+      }
+      appendUtf8(ret, codePoint);
+    } break;
+    default:
+      fail("Invalid escape sequence");
+    }
+  }
+}
+
+json::Value helper::Parser::parseNumber() {
+  const size_t start = m_i;
+
+  if (peek() == '-')
+    m_i++;
+  if (peek() < '0' || peek() > '9')
+    fail("Expected a value");
+  while (peek() >= '0' && peek() <= '9')
+    m_i++;
+  if (peek() == '.') {
+    m_i++;
+    if (peek() < '0' || peek() > '9')
+      fail("Expected a digit");
+    while (peek() >= '0' && peek() <= '9')
+      m_i++;
+  }
+  if (peek() == 'e' || peek() == 'E') {
+    m_i++;
+    if (peek() == '+' || peek() == '-')
+      m_i++;
+    if (peek() < '0' || peek() > '9')
+      fail("Expected a digit");
+    while (peek() >= '0' && peek() <= '9')
+      m_i++;
+  }
+
+  return json::Value(std::strtod(m_text.substr(start, m_i - start).c_str(), nullptr));
+}
+
+void helper::Parser::expectWord(const char* word) {
+  const std::string wordStr = word;
+  if (m_text.compare(m_i, wordStr.size(), wordStr) != 0)
+    fail("Expected a value");
+  m_i += wordStr.size();
+}
+
+void helper::Parser::appendUtf8(std::string& str, unsigned long codePoint) {
+  if (codePoint < 0x80) {
+    str += static_cast<char>(codePoint);
+  } else if (codePoint < 0x800) {
+    str += static_cast<char>(0xc0 | (codePoint >> 6));
+    str += static_cast<char>(0x80 | (codePoint & 0x3f));
+  } else if (codePoint < 0x10000) {
+    str += static_cast<char>(0xe0 | (codePoint >> 12));
+    str += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+    str += static_cast<char>(0x80 | (codePoint & 0x3f));
+  } else {
+    str += static_cast<char>(0xf0 | (codePoint >> 18));
+    str += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f));
+    str += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+    str += static_cast<char>(0x80 | (codePoint & 0x3f));
+  }
+}
+
+unsigned long helper::Parser::parseHex4() {
+  unsigned long ret = 0;
+  for (int j = 0; j < 4; j++) {
+    const char c = peek();
+    ret <<= 4;
+    if (c >= '0' && c <= '9')
+      ret |= static_cast<unsigned long>(c - '0');
+    else if (c >= 'a' && c <= 'f')
+      ret |= static_cast<unsigned long>(c - 'a' + 10);
+    else if (c >= 'A' && c <= 'F')
+      ret |= static_cast<unsigned long>(c - 'A' + 10);
+    else
+      fail("Invalid unicode escape");
+    m_i++;
+  }
+  return ret;
+}
+
+void helper::Parser::skipWhitespace() {
+  while (m_i < m_text.size() &&
+         (m_text[m_i] == ' ' || m_text[m_i] == '\n' || m_text[m_i] == '\r' || m_text[m_i] == '\t'))
+    m_i++;
+}
+
+char helper::Parser::peek() const { return (m_i < m_text.size()) ? m_text[m_i] : '\0'; }
+
+void helper::Parser::fail(const std::string& msg) const { throw json::ParseError(msg, m_i); }
@@ -0,0 +1,242 @@
+#include <compiler/linking/FunctionCostEstimator.h>
+
+#include <algorithm>
+#include <limits>
+#include <string_view>
+
+#include <compiler/translation/constants.h>
+
+namespace {
+namespace helper {
+
+/// Returns the path of the function file for \param funcCallName (e.g.
+/// "foo/function/bar.mcfunction" for "foo:bar") or an empty path if it isn't a
+/// valid call name.
+static std::filesystem::path funcCallNameToPath(const std::string& funcCallName);
+
+/// Splits a command into its arguments on spaces that aren't inside of quotes
+/// or brackets. Tabs are treated like spaces.
+static std::vector<std::string> splitCommandArgs(const std::string& command);
+
+/// Whether \param selector has an argument that starts with \param argStart
+/// (e.g. "type=" but not "type=!").
+static bool selectorHasArg(const std::string& selector, const std::string& argStart);
+
+/// Returns the value of the argument in \param selector that starts with
+/// \param argStart (e.g. "5" for "limit=" in "@e[limit=5]") or an empty
+/// string if there isn't one.
+static std::string selectorArgValue(const std::string& selector, const std::string& argStart);
+
+/// Adds or multiplies without overflowing (the result is capped at the max).
+static size_t saturatingAdd(size_t a, size_t b);
+static size_t saturatingMul(size_t a, size_t b);
+
+} // namespace helper
+} // namespace
+
+FunctionCostEstimator::FunctionCostEstimator(
+    const std::unordered_map<std::filesystem::path, std::string>& fileWriteMap)
+    : m_fileWriteMap(fileWriteMap) {}
+
+size_t FunctionCostEstimator::functionCost(const std::string& funcCallName) {
+  const auto cached = m_funcCosts.find(funcCallName);
+  if (cached != m_funcCosts.end())
+    return cached->second;
+
+  const auto fileWrite = m_fileWriteMap.find(helper::funcCallNameToPath(funcCallName));
+  if (fileWrite == m_fileWriteMap.end())
+    return 1;
+
+  if (!m_funcsBeingEstimated.insert(funcCallName).second)
+    return 0;
+
+  // Go through each command in the file. Commands that run something are split
+  // over multiple lines (every line but the last ends with '\').
+  const std::string& contents = fileWrite->second;
+  size_t cost = 0;
+  std::string command;
+  for (size_t lineStart = 0; lineStart < contents.size();) {
+    size_t lineEnd = contents.find('\n', lineStart);
+    if (lineEnd == std::string::npos)
+      lineEnd = contents.size();
+    const std::string_view line(contents.data() + lineStart, lineEnd - lineStart);
+    lineStart = lineEnd + 1;
+
+    if (command.empty() && (line.empty() || line[0] == '#'))
+      continue;
+
+    if (!line.empty() && line.back() == '\\') {
+      command.append(line.data(), line.size() - 1);
+      continue;
+    }
+    command.append(line.data(), line.size());
+    cost += commandCost(command);
+    command.clear();
+  }
+  if (!command.empty())
+    cost += commandCost(command);
+
+  m_funcsBeingEstimated.erase(funcCallName);
+  m_funcCosts.emplace(funcCallName, cost);
+  return cost;
+}
+
+size_t FunctionCostEstimator::commandCost(const std::string& command) {
+  const std::vector<std::string> args = helper::splitCommandArgs(command);
+
+  // How many times the rest of the command runs. This grows with each 'as' or
+  // 'at' argument (e.g. 'execute as @e at @s run ...').
+  size_t multiplier = 1;
+  size_t cost = 1;
+
+  for (size_t i = 0; i < args.size(); i++) {
+    const std::string& arg = args[i];
+
+    // every 'run' argument starts another command
+    if (arg == "run") {
+      cost = helper::saturatingAdd(cost, multiplier);
+      continue;
+    }
+
+    // function tags (like '#minecraft:tick') aren't followed
+    if (arg == "function" && i + 1 < args.size() && args[i + 1].find(':') != std::string::npos &&
+        args[i + 1][0] != '#') {
+      i++;
+      cost = helper::saturatingAdd(cost, helper::saturatingMul(multiplier, functionCost(args[i])));
+      continue;
+    }
+
+    if (arg[0] != '@')
+      continue;
+
+    if (isUnfilteredSelector(arg))
+      cost = helper::saturatingAdd(cost, helper::saturatingMul(multiplier, unfilteredSelectorCost));
+    if (i != 0 && (args[i - 1] == "as" || args[i - 1] == "at"))
+      multiplier = helper::saturatingMul(multiplier, selectorEntityCount(arg));
+  }
+
+  return cost;
+}
+
+size_t FunctionCostEstimator::selectorEntityCount(const std::string& selector) {
+  if (selector.size() < 2)
+    return 1;
+
+  size_t count;
+  switch (selector[1]) {
+  case 'a':
+    count = playerCount;
+    break;
+  case 'e':
+    count = (helper::selectorHasArg(selector, "type=")) ? typedEntityCount : entityCount;
+    break;
+  default: // '@s', '@p', '@r', and '@n' only ever match 1 entity
+    return 1;
+  }
+
+  const std::string limit = helper::selectorArgValue(selector, "limit=");
+  if (!limit.empty() && limit.size() <= 9 &&
+      limit.find_first_not_of("0123456789") == std::string::npos)
+    count = std::min(count, static_cast<size_t>(std::stoul(limit)));
+  return count;
+}
+
+bool FunctionCostEstimator::isUnfilteredSelector(const std::string& selector) {
+  return selector.compare(0, 2, "@e") == 0 && !helper::selectorHasArg(selector, "type=") &&
+         !helper::selectorHasArg(selector, "limit=");
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static std::filesystem::path helper::funcCallNameToPath(const std::string& funcCallName) {
+  const size_t colonIndex = funcCallName.find(':');
+  if (colonIndex == std::string::npos || colonIndex == 0 || colonIndex + 1 == funcCallName.size())
+    return {};
+
+  return std::filesystem::path(funcCallName.substr(0, colonIndex)) / funcSubFolder /
+         (funcCallName.substr(colonIndex + 1) + funcFileExt);
+}
+
+static std::vector<std::string> helper::splitCommandArgs(const std::string& command) {
+  std::vector<std::string> ret;
+  std::string arg;
+  size_t depth = 0;
+
+  for (size_t i = 0; i < command.size(); i++) {
+    const char c = command[i];
+    switch (c) {
+    case '[':
+    case '{':
+    case '(':
+      depth++;
+      break;
+    case ']':
+    case '}':
+    case ')':
+      if (depth != 0)
+        depth--;
+      break;
+
+    // copy strings over as they are (escaped characters can't end them)
+    case '"':
+    case '\'': {
+      arg += c;
+      for (i++; i < command.size() && command[i] != c; i++) {
+        arg += command[i];
+        if (command[i] == '\\' && i + 1 < command.size())
+          arg += command[++i];
+      }
+      if (i < command.size())
+        arg += c;
+      continue;
+    }
+
+    case ' ':
+    case '\t':
+      if (depth != 0)
+        break;
+      if (!arg.empty())
+        ret.push_back(std::move(arg));
+      arg.clear();
+      continue;
+    }
+    arg += c;
+  }
+
+  if (!arg.empty())
+    ret.push_back(std::move(arg));
+  return ret;
+}
+
+static bool helper::selectorHasArg(const std::string& selector, const std::string& argStart) {
+  const std::string value = helper::selectorArgValue(selector, argStart);
+  return !value.empty() && value[0] != '!';
+}
+
+static std::string helper::selectorArgValue(const std::string& selector,
+                                            const std::string& argStart) {
+  // arguments follow either the '[' or a ','
+  for (size_t i = selector.find(argStart); i != std::string::npos;
+       i = selector.find(argStart, i + 1)) {
+    if (i == 0 || (selector[i - 1] != '[' && selector[i - 1] != ','))
+      continue;
+
+    const size_t valueStart = i + argStart.size();
+    const size_t valueEnd = selector.find_first_of(",]", valueStart);
+    return selector.substr(valueStart, (valueEnd == std::string::npos) ? std::string::npos
+                                                                       : valueEnd - valueStart);
+  }
+  return "";
+}
+
+static size_t helper::saturatingAdd(size_t a, size_t b) {
+  return (a > std::numeric_limits<size_t>::max() - b) ? std::numeric_limits<size_t>::max() : a + b;
+}
+
+static size_t helper::saturatingMul(size_t a, size_t b) {
+  if (a != 0 && b > std::numeric_limits<size_t>::max() / a)
+    return std::numeric_limits<size_t>::max();
+  return a * b;
+}
@@ -0,0 +1,96 @@
+#include <compiler/linking/addProfilingFunctions.h>
+
+#include <algorithm>
+
+#include <compiler/json.h>
+#include <compiler/translation/constants.h>
+#include <version.h>
+
+namespace {
+namespace helper {
+
+/// A function file's counter and where the file came from.
+struct ProfileCounter {
+  const CompiledSourceFile::FuncFileOrigin* origin;
+  std::string sourceFilePath;
+};
+
+/// Returns where a counter came from (e.g. "scope in foo (a.mcfunc:3)").
+static std::string counterSource(const ProfileCounter& counter);
+
+} // namespace helper
+} // namespace
+
+void addProfilingFunctions(const std::vector<CompiledSourceFile>& compiledSourceFiles,
+                           std::unordered_map<std::filesystem::path, std::string>& fileWriteMap,
+                           std::vector<std::string>& loadFuncCallNames,
+                           const std::string& exposedNamespace) {
+  const std::string hiddenNamespace = hiddenNamespacePrefix + exposedNamespace;
+  const std::string objective = hiddenNamespace + profileObjectiveSuffix;
+
+  // sort by source so the output doesn't depend on the order files were given
+  std::vector<helper::ProfileCounter> counters;
+  for (const CompiledSourceFile& compiledSourceFile : compiledSourceFiles) {
+    const std::string sourceFilePath = compiledSourceFile.sourceFilePath().string();
+    for (const auto& [relativePath, funcFileWrite] : compiledSourceFile.unlinkedFileWrites())
+      counters.push_back({&funcFileWrite.origin, sourceFilePath});
+  }
+  std::sort(counters.begin(), counters.end(),
+            [](const helper::ProfileCounter& a, const helper::ProfileCounter& b) {
+              if (a.sourceFilePath != b.sourceFilePath)
+                return a.sourceFilePath < b.sourceFilePath;
+              if (a.origin->indexInFile != b.origin->indexInFile)
+                return a.origin->indexInFile < b.origin->indexInFile;
+              return a.origin->fileID < b.origin->fileID;
+            });
+
+  fileWriteMap[hiddenNamespace / funcSubFolder / (std::string(profileLoadFuncName) + funcFileExt)] =
+      "# " MCFUNC_BUILD_INFO_MSG "\n\nscoreboard objectives add " + objective + " dummy\n";
+  loadFuncCallNames.insert(loadFuncCallNames.begin(), hiddenNamespace + ':' + profileLoadFuncName);
+
+  std::string dumpContents = "# " MCFUNC_BUILD_INFO_MSG "\n\n";
+  dumpContents += "tellraw @s " +
+                  json::quote("Function file run counts for " + exposedNamespace + ':') + '\n';
+  for (const helper::ProfileCounter& counter : counters) {
+    dumpContents += "tellraw @s [{\"score\":{\"name\":\"#" + counter.origin->fileID +
+                    "\",\"objective\":\"" + objective + "\"}},{\"text\":" +
+                    json::quote("  " + counter.origin->fileID + ' ' +
+                                helper::counterSource(counter)) +
+                    ",\"color\":\"gray\"}]\n";
+  }
+  fileWriteMap[hiddenNamespace / funcSubFolder / (std::string(profileDumpFuncName) + funcFileExt)] =
+      std::move(dumpContents);
+
+  fileWriteMap[hiddenNamespace / funcSubFolder /
+               (std::string(profileResetFuncName) + funcFileExt)] =
+      "# " MCFUNC_BUILD_INFO_MSG "\n\nscoreboard players reset * " + objective + '\n';
+
+  std::string mapContents = "{\n";
+  mapContents += "  \"objective\": " + json::quote(objective) + ",\n";
+  mapContents += "  \"counters\": [";
+  for (size_t i = 0; i < counters.size(); i++) {
+    const CompiledSourceFile::FuncFileOrigin& origin = *counters[i].origin;
+    mapContents += (i == 0) ? "\n" : ",\n";
+    mapContents += "    {\"counter\": " + json::quote('#' + origin.fileID) +
+                   ", \"kind\": " + json::quote(origin.kindName()) +
+                   ", \"function\": " + json::quote(origin.funcName) +
+                   ", \"file\": " + json::quote(counters[i].sourceFilePath) +
+                   ", \"line\": " + std::to_string(origin.line) +
+                   ", \"column\": " + std::to_string(origin.column) + '}';
+  }
+  mapContents += (counters.empty()) ? "]\n}\n" : "\n  ]\n}\n";
+  fileWriteMap[std::filesystem::path(hiddenNamespace) / profileMapFileName] =
+      std::move(mapContents);
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static std::string helper::counterSource(const ProfileCounter& counter) {
+  std::string ret;
+  if (counter.origin->kind != CompiledSourceFile::FuncFileOrigin::Kind::FUNCTION)
+    ret = std::string(counter.origin->kindName()) + " in ";
+  return ret + counter.origin->funcName + " (" + counter.sourceFilePath + ':' +
+         std::to_string(counter.origin->line) + ')';
+}
@@ -0,0 +1,174 @@
+#include <compiler/linking/deduplicateFunctions.h>
+
+#include <iterator>
+#include <string_view>
+#include <unordered_set>
+
+#include <compiler/translation/constants.h>
+
+namespace {
+namespace helper {
+
+/// Returns the call name for a function file in the hidden namespace (e.g.
+/// "zzz__.foo:f_00000_0002b" for
+/// "zzz__.foo/function/f_00000_0002b.mcfunction") or an empty string if
+/// \param path isn't a hidden function file.
+static std::string hiddenFuncCallName(const std::filesystem::path& path,
+                                      const std::string& hiddenNamespace);
+
+/// Whether \param c can be a part of a function call name after the ':'.
+static bool isCallNameChar(char c);
+
+/// Replaces every call name that appears in \param replacements (only ones
+/// following "$HIDDEN_NAMESPACE:") with what it maps to. Returns whether
+/// anything was replaced.
+static bool replaceCallNames(std::string& contents, const std::string& hiddenNamespace,
+                             const std::unordered_map<std::string, std::string>& replacements);
+
+} // namespace helper
+} // namespace
+
+size_t deduplicateFunctions(std::unordered_map<std::filesystem::path, std::string>& fileWriteMap,
+                            const std::string& exposedNamespace,
+                            const std::vector<std::string>& tickFuncCallNames,
+                            const std::vector<std::string>& loadFuncCallNames) {
+  const std::string hiddenNamespace = hiddenNamespacePrefix + exposedNamespace;
+
+  std::unordered_set<std::string> pinnedCallNames;
+  pinnedCallNames.insert(tickFuncCallNames.begin(), tickFuncCallNames.end());
+  pinnedCallNames.insert(loadFuncCallNames.begin(), loadFuncCallNames.end());
+
+  size_t removedCount = 0;
+
+  while (true) {
+    // group function files by their contents; the call name that's kept for a
+    // group is a pinned one if there is one, otherwise the lowest one (so the
+    // output doesn't depend on the map's iteration order)
+    std::unordered_map<std::string_view, std::string> canonicalCallNames;
+    canonicalCallNames.reserve(fileWriteMap.size());
+
+    for (const auto& [path, contents] : fileWriteMap) {
+      std::string callName = helper::hiddenFuncCallName(path, hiddenNamespace);
+      if (callName.empty())
+        continue;
+
+      auto [it, inserted] = canonicalCallNames.try_emplace(contents, callName);
+      if (inserted)
+        continue;
+
+      const bool isPinned = pinnedCallNames.count(callName);
+      const bool existingIsPinned = pinnedCallNames.count(it->second);
+      if ((isPinned && !existingIsPinned) ||
+          (isPinned == existingIsPinned && callName < it->second))
+        it->second = std::move(callName);
+    }
+
+    // every function file that isn't the kept one for its contents (and isn't
+    // pinned) is replaced
+    std::unordered_map<std::string, std::string> replacements;
+    std::vector<std::filesystem::path> pathsToRemove;
+
+    for (const auto& [path, contents] : fileWriteMap) {
+      std::string callName = helper::hiddenFuncCallName(path, hiddenNamespace);
+      if (callName.empty() || pinnedCallNames.count(callName))
+        continue;
+
+      const std::string& canonicalCallName = canonicalCallNames.at(contents);
+      if (callName == canonicalCallName)
+        continue;
+
+      replacements.emplace(std::move(callName), canonicalCallName);
+      pathsToRemove.push_back(path);
+    }
+
+    if (replacements.empty())
+      break;
+
+    // the string views in 'canonicalCallNames' point into the map's contents
+    // so it needs to go before anything is removed or rewritten
+    canonicalCallNames.clear();
+
+    for (const std::filesystem::path& path : pathsToRemove)
+      fileWriteMap.erase(path);
+    removedCount += pathsToRemove.size();
+
+    // rewrite calls in every function file (exposed functions can call the
+    // removed ones too)
+    for (auto& [path, contents] : fileWriteMap) {
+      if (path.extension() != funcFileExt)
+        continue;
+      helper::replaceCallNames(contents, hiddenNamespace, replacements);
+    }
+  }
+
+  return removedCount;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static std::string helper::hiddenFuncCallName(const std::filesystem::path& path,
+                                              const std::string& hiddenNamespace) {
+  if (path.extension() != funcFileExt)
+    return "";
+
+  // hidden function files are never in a sub-directory of the function folder
+  auto it = path.begin();
+  if (it == path.end() || *it != hiddenNamespace)
+    return "";
+  if (++it == path.end() || *it != funcSubFolder)
+    return "";
+  if (++it == path.end() || std::next(it) != path.end())
+    return "";
+
+  return hiddenNamespace + ':' + it->stem().string();
+}
+
+static bool helper::isCallNameChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '.' || c == '-' ||
+         c == '/';
+}
+
+static bool helper::replaceCallNames(
+    std::string& contents, const std::string& hiddenNamespace,
+    const std::unordered_map<std::string, std::string>& replacements) {
+  const std::string prefix = hiddenNamespace + ':';
+
+  size_t i = contents.find(prefix);
+  if (i == std::string::npos)
+    return false;
+
+  std::string result;
+  result.reserve(contents.size());
+  size_t copiedUpTo = 0;
+  bool replacedAny = false;
+
+  for (; i != std::string::npos; i = contents.find(prefix, i)) {
+    // the namespace can't just be the end of a longer namespace
+    if (i != 0 && (helper::isCallNameChar(contents[i - 1]) || contents[i - 1] == ':')) {
+      i += prefix.size();
+      continue;
+    }
+
+    size_t end = i + prefix.size();
+    while (end < contents.size() && helper::isCallNameChar(contents[end]))
+      end++;
+
+    const auto found = replacements.find(contents.substr(i, end - i));
+    if (found != replacements.end()) {
+      result.append(contents, copiedUpTo, i - copiedUpTo);
+      result += found->second;
+      copiedUpTo = end;
+      replacedAny = true;
+    }
+    i = end;
+  }
+
+  if (!replacedAny)
+    return false;
+
+  result.append(contents, copiedUpTo, std::string::npos);
+  contents = std::move(result);
+  return true;
+}
@@ -0,0 +1,95 @@
+#include <compiler/linking/estimateTickCost.h>
+
+#include <algorithm>
+#include <unordered_set>
+
+#include <compiler/linking/FunctionCostEstimator.h>
+#include <compiler/translation/constants.h>
+
+namespace {
+namespace helper {
+
+/// Returns \param cost right-aligned in a column of at least 10 characters.
+static std::string costColumn(size_t cost);
+
+} // namespace helper
+} // namespace
+
+TickCostReport estimateTickCost(
+    const std::unordered_map<std::filesystem::path, std::string>& fileWriteMap,
+    const std::vector<std::string>& tickFuncCallNames,
+    const std::vector<ScheduledTickFunction>& scheduledTickFuncs,
+    const std::string& exposedNamespace) {
+  TickCostReport ret;
+
+  const std::string dispatcherCallName =
+      hiddenNamespacePrefix + exposedNamespace + ':' + tickScheduleFuncName;
+
+  FunctionCostEstimator costEstimator(fileWriteMap);
+  for (const std::string& funcCallName : tickFuncCallNames) {
+    if (funcCallName == dispatcherCallName)
+      continue;
+    const size_t cost = costEstimator.functionCost(funcCallName);
+    ret.tickFuncCosts.push_back({funcCallName, cost});
+    ret.everyTickCost += cost;
+  }
+
+  // the dispatcher always counts ticks for each period and checks the phase of
+  // every function
+  if (!scheduledTickFuncs.empty()) {
+    std::unordered_set<uint32_t> periods;
+    for (const ScheduledTickFunction& func : scheduledTickFuncs)
+      periods.insert(func.tickSchedule.period);
+    ret.everyTickCost += 2 * periods.size() + scheduledTickFuncs.size();
+  }
+
+  ret.busiestTickCost = ret.everyTickCost + busiestScheduledTickCost(scheduledTickFuncs);
+
+  std::stable_sort(ret.tickFuncCosts.begin(), ret.tickFuncCosts.end(),
+                   [](const TickCostReport::FuncCost& a, const TickCostReport::FuncCost& b) {
+                     return a.estimatedCost > b.estimatedCost;
+                   });
+
+  ret.scheduledTickFuncs = scheduledTickFuncs;
+  std::stable_sort(ret.scheduledTickFuncs.begin(), ret.scheduledTickFuncs.end(),
+                   [](const ScheduledTickFunction& a, const ScheduledTickFunction& b) {
+                     return a.estimatedCost > b.estimatedCost;
+                   });
+
+  return ret;
+}
+
+std::string TickCostReport::str() const {
+  std::string ret = "Estimated commands run per tick:\n";
+  ret += "  Every tick:   " + std::to_string(everyTickCost) + '\n';
+  ret += "  Busiest tick: " + std::to_string(busiestTickCost) + '\n';
+
+  if (!tickFuncCosts.empty()) {
+    ret += "Tick functions:\n";
+    for (const FuncCost& funcCost : tickFuncCosts)
+      ret += helper::costColumn(funcCost.estimatedCost) + "  " + funcCost.funcCallName + '\n';
+  }
+
+  if (!scheduledTickFuncs.empty()) {
+    ret += "Scheduled tick functions:\n";
+    for (const ScheduledTickFunction& func : scheduledTickFuncs) {
+      ret += helper::costColumn(func.estimatedCost) + "  " + func.funcCallName + " (" +
+             ((func.tickSchedule.kind == TickSchedule::Kind::EVERY) ? "every " : "spread ") +
+             std::to_string(func.tickSchedule.period) + ", on tick " + std::to_string(func.phase) +
+             ")\n";
+    }
+  }
+
+  return ret;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static std::string helper::costColumn(size_t cost) {
+  std::string ret = std::to_string(cost);
+  if (ret.size() < 10)
+    ret.insert(0, 10 - ret.size(), ' ');
+  return ret;
+}
@@ -0,0 +1,103 @@
+#include <compiler/linking/generateSourceMap.h>
+
+#include <cassert>
+#include <map>
+
+#include <compiler/json.h>
+#include <compiler/translation/constants.h>
+
+namespace {
+namespace helper {
+
+/// Returns the call name for a function file given its path in the data pack
+/// (e.g. "foo/function/bar/baz.mcfunction" -> "foo:bar/baz"), or an empty
+/// string if the path isn't a function file.
+static std::string funcCallNameFromPath(const std::filesystem::path& path);
+
+} // namespace helper
+} // namespace
+
+std::string generateSourceMap(
+    const std::vector<CompiledSourceFile>& compiledSourceFiles,
+    const std::unordered_map<std::filesystem::path, std::string>& fileWriteMap,
+    const std::vector<std::string>& sourceFileNamespaces,
+    const std::vector<std::string>& exposedNamespaces) {
+  assert(sourceFileNamespaces.size() == compiledSourceFiles.size() &&
+         "there should be a namespace for each source file");
+  assert(!exposedNamespaces.empty() && "there should be a main namespace");
+
+  // sorted by call name so the output doesn't change between runs
+  std::map<std::string, std::string> entries;
+
+  for (size_t i = 0; i < compiledSourceFiles.size(); i++) {
+    const CompiledSourceFile& compiledSourceFile = compiledSourceFiles[i];
+    const std::string& exposedNamespace = sourceFileNamespaces[i];
+    const std::string hiddenNamespace = hiddenNamespacePrefix + exposedNamespace;
+    const std::string sourceFileJsonStr = json::quote(compiledSourceFile.sourceFilePath().string());
+
+    for (const auto& [relativePath, funcFileWrite] : compiledSourceFile.unlinkedFileWrites()) {
+      const std::filesystem::path outPath =
+          ((funcFileWrite.belongsInHiddenNamespace) ? hiddenNamespace : exposedNamespace) /
+          relativePath;
+      if (!fileWriteMap.count(outPath))
+        continue;
+
+      const CompiledSourceFile::FuncFileOrigin& origin = funcFileWrite.origin;
+      entries[helper::funcCallNameFromPath(outPath)] =
+          "{\"kind\": " + json::quote(origin.kindName()) +
+          ", \"function\": " + json::quote(origin.funcName) + ", \"file\": " + sourceFileJsonStr +
+          ", \"line\": " + std::to_string(origin.line) +
+          ", \"column\": " + std::to_string(origin.column) + '}';
+    }
+  }
+
+  for (const auto& [path, contents] : fileWriteMap) {
+    std::string funcCallName = helper::funcCallNameFromPath(path);
+    if (!funcCallName.empty() && !entries.count(funcCallName))
+      entries[std::move(funcCallName)] = "{\"kind\": \"generated\"}";
+  }
+
+  std::string ret = "{\n";
+  ret += "  \"namespace\": " + json::quote(exposedNamespaces.front()) + ",\n";
+  ret += "  \"namespaces\": [";
+  for (size_t i = 0; i < exposedNamespaces.size(); i++)
+    ret += ((i == 0) ? "" : ", ") + json::quote(exposedNamespaces[i]);
+  ret += "],\n";
+  ret += "  \"functions\": {";
+  bool isFirst = true;
+  for (const auto& [funcCallName, entry] : entries) {
+    ret += (isFirst) ? "\n" : ",\n";
+    ret += "    " + json::quote(funcCallName) + ": " + entry;
+    isFirst = false;
+  }
+  ret += (entries.empty()) ? "}\n}\n" : "\n  }\n}\n";
+  return ret;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static std::string helper::funcCallNameFromPath(const std::filesystem::path& path) {
+  auto it = path.begin();
+  if (it == path.end())
+    return "";
+  const std::string namespaceStr = it->string();
+
+  ++it;
+  if (it == path.end() || *it != funcSubFolder || path.extension() != funcFileExt)
+    return "";
+
+  std::string ret = namespaceStr + ':';
+  bool isFirst = true;
+  for (++it; it != path.end(); ++it) {
+    if (!isFirst)
+      ret += '/';
+    ret += it->string();
+    isFirst = false;
+  }
+
+  // remove the file extension
+  ret.resize(ret.size() - std::string(funcFileExt).size());
+  return ret;
+}
@@ -1,30 +1,41 @@
 #include <compiler/linking/link.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <filesystem>
+#include <iterator>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include <cli/style_text.h>
+#include <compiler/CompileOptions.h>
 #include <compiler/FileWriteSourceFile.h>
 #include <compiler/SourceFiles.h>
 #include <compiler/compile_error.h>
-#include <compiler/fileToStr.h>
+#include <compiler/linking/addProfilingFunctions.h>
+#include <compiler/linking/deduplicateFunctions.h>
+#include <compiler/linking/estimateTickCost.h>
+#include <compiler/linking/generateSourceMap.h>
+#include <compiler/linking/scheduleTickFunctions.h>
+#include <compiler/pass_timing.h>
 #include <compiler/syntax_analysis/symbol.h>
+#include <compiler/tracing.h>
 #include <compiler/translation/CompiledSourceFile.h>
 #include <compiler/translation/constants.h>
+#include <compiler/vfs.h>
 
 namespace {
 namespace helper {
 
-/// Writes to \param[out] allFuncExposePaths if \param func is exposed. Throws
-/// a compile error if the expose path already exists.
+/// Writes to \param[out] allFuncExposePaths if \param func is exposed (keyed
+/// by its call name in \param exposedNamespace ). Throws a compile error if the
+/// expose path already exists in the namespace.
 static void saveFuncExposePathIfFuncExposed(
     std::unordered_map<std::string, const symbol::Function*>& allFuncExposePaths,
-    const symbol::Function& func);
+    const symbol::Function& func, const std::string& exposedNamespace);
 
 /// Validates that the existing function has the same qualifiers as the new
 /// function (i.e. tick and load keywords match)
@@ -32,109 +43,265 @@ static void ensurePublicFuncQualifiersMatch(const symbol::Function& existingFunc
                                             const symbol::Function& newFunc);
 
 /// Generates a map of function call names for all public functions and ensures
-/// all public functions are defined and unshadowed.
+/// all public functions are defined and unshadowed. A function's call name uses
+/// the namespace of the source file that defines it.
 static std::unordered_map<std::string, std::string> generateAllPublicFuncCallStrings(
     std::unordered_map<std::string, const symbol::Function*> allPublicFuncs,
     std::unordered_map<std::string, const symbol::Function*> allPrivateFuncs,
-    const std::string& exposedNamespace);
+    const std::unordered_map<const SourceFile*, const std::string*>& namespaceOfSourceFile);
+
+/// The namespaces that are exposed during compilation and the namespace that
+/// each source file belongs to.
+struct Namespaces {
+  /// Every exposed namespace, the main one 1st and the rest in the order the
+  /// files exposing them appear.
+  std::vector<std::string> exposed;
+  /// The index in \p exposed of each source file's namespace (lines up with
+  /// the source files).
+  std::vector<size_t> ofSourceFile;
+
+  const std::string& of(size_t sourceFileIndex) const {
+    return exposed[ofSourceFile[sourceFileIndex]];
+  }
+};
 
-/// Replaces all unlinked text sections in unlinked text assuming
-/// \param funcCallStrings contains everything needed.
-static std::string unlinkedTextToText(
-    const UnlinkedText& unlinkedText, const std::string& exposedNamespace,
-    const std::unordered_map<std::string, std::string>& funcCallStrings);
+/// A source file that exposes a namespace belongs to it. Every other source
+/// file belongs to the namespace exposed from the closest directory at or
+/// above its own (if only 1 namespace is exposed every source file belongs to
+/// it). The main namespace is the one exposed from the highest directory (the
+/// one whose name comes 1st if several are equally high).
+static Namespaces assignNamespaces(const SourceFiles& sourceFiles);
 
-struct FuncCallNameMapAndNamespace {
+struct FuncCallNameMapAndNamespaces {
   std::unordered_map<std::string, std::string> funcCallNameMap;
-  std::string exposedNamespace;
+  Namespaces namespaces;
 };
 
-static FuncCallNameMapAndNamespace getFuncCallNameMapAndNamespace(SourceFiles& sourceFiles);
+/// Ensures every function that \param sourceFile calls but doesn't declare
+/// is declared public in one of the files it imports.
+static void ensureImportedFuncCallsAreDeclared(const SourceFile& sourceFile);
+
+/// Only source files marked in \param importsToCheck have their calls to
+/// imported functions checked (all of them are if it's empty).
+static FuncCallNameMapAndNamespaces
+getFuncCallNameMapAndNamespaces(const SourceFiles& sourceFiles,
+                                const std::vector<bool>& importsToCheck);
 
 static LinkResult createListsForTickAndLoadFunctions(
-    const std::vector<CompiledSourceFile>& compiledSourceFiles,
-    const std::string& exposedNamespace);
+    const std::vector<CompiledSourceFile>& compiledSourceFiles, const Namespaces& namespaces);
 
+/// File writes sourced from a snippet are returned and the rest are added to
+/// \param fileCopyMap . The path of every file write source file that's copied
+/// is added to \param readFileWriteSourcePaths (sorted, without duplicates).
+/// \throws compile_error::CouldntOpenFile if a file that's copied isn't a
+/// regular file anymore (so the data pack isn't half written when it's found).
 static std::unordered_map<std::filesystem::path, std::string> collectAllFileWrites(
     const SourceFiles& sourceFiles, const std::vector<FileWriteSourceFile>& fileWriteSourceFiles,
-    const std::string& exposedNamespace);
-
-static std::string fileWriteToStr(const symbol::FileWrite& fileWrite,
-                                  const std::vector<FileWriteSourceFile>& fileWriteSourceFiles);
+    const Namespaces& namespaces,
+    std::unordered_map<std::filesystem::path, std::filesystem::path>& fileCopyMap,
+    std::vector<std::filesystem::path>& readFileWriteSourcePaths);
+
+/// Import path -> the file write source file with that import path, or
+/// \p nullptr if multiple file write source files share it.
+using FileWriteSourceFileMap =
+    std::unordered_map<std::filesystem::path, const FileWriteSourceFile*>;
+
+/// The path of the file write source file that \param fileWrite imports (it
+/// must not be sourced from a snippet).
+static const std::filesystem::path&
+fileWriteSourcePath(const symbol::FileWrite& fileWrite,
+                    const FileWriteSourceFileMap& fileWriteSourceFileMap);
+
+/// Links the compiled source files. If \param sourceFilesToFree and
+/// \param fileWriteSourceFilesToFree aren't \p nullptr they're cleared as soon
+/// as they're no longer needed (they should be the same objects as
+/// \param sourceFiles and \param fileWriteSourceFiles ).
+static LinkResult linkImpl(const std::vector<CompiledSourceFile>& compiledSourceFiles,
+                           const SourceFiles& sourceFiles,
+                           const std::vector<FileWriteSourceFile>& fileWriteSourceFiles,
+                           const CompileOptions& compileOptions,
+                           const std::vector<bool>& importsToCheck, SourceFiles* sourceFilesToFree,
+                           std::vector<FileWriteSourceFile>* fileWriteSourceFilesToFree);
 
 } // namespace helper
 } // namespace
 
 LinkResult link(std::vector<CompiledSourceFile>&& compiledSourceFiles, SourceFiles&& sourceFiles,
-                std::vector<FileWriteSourceFile>&& fileWriteSourceFiles) {
+                std::vector<FileWriteSourceFile>&& fileWriteSourceFiles,
+                const CompileOptions& compileOptions) {
+  return helper::linkImpl(compiledSourceFiles, sourceFiles, fileWriteSourceFiles, compileOptions,
+                          {}, &sourceFiles, &fileWriteSourceFiles);
+}
 
-  // get the namespace and generate a list of all public function call names
-  const auto [funcCallNameMap, exposedNamespace] =
-      helper::getFuncCallNameMapAndNamespace(sourceFiles);
+LinkResult link(const std::vector<CompiledSourceFile>& compiledSourceFiles,
+                const SourceFiles& sourceFiles,
+                const std::vector<FileWriteSourceFile>& fileWriteSourceFiles,
+                const CompileOptions& compileOptions, const std::vector<bool>& importsToCheck) {
+  return helper::linkImpl(compiledSourceFiles, sourceFiles, fileWriteSourceFiles, compileOptions,
+                          importsToCheck, nullptr, nullptr);
+}
 
-  const std::string hiddenNamespace = hiddenNamespacePrefix + exposedNamespace;
+std::string
+unlinkedTextToText(const UnlinkedText& unlinkedText, const std::string& exposedNamespace,
+                   const std::unordered_map<std::string, std::string>& funcCallStrings) {
+  std::string ret;
+  for (const UnlinkedTextSection& section : unlinkedText.sections()) {
+    switch (section.kind()) {
+    case UnlinkedTextSection::Kind::TEXT:
+      ret += section.textContents();
+      break;
+    case UnlinkedTextSection::Kind::FUNCTION:
+      assert(funcCallStrings.count(section.funcName()) && "func call string should be valid");
+      ret += funcCallStrings.at(section.funcName());
+      break;
+    case UnlinkedTextSection::Kind::NAMESPACE:
+      ret += exposedNamespace;
+      break;
+    }
+  }
+  return ret;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static LinkResult helper::linkImpl(const std::vector<CompiledSourceFile>& compiledSourceFiles,
+                                   const SourceFiles& sourceFiles,
+                                   const std::vector<FileWriteSourceFile>& fileWriteSourceFiles,
+                                   const CompileOptions& compileOptions,
+                                   const std::vector<bool>& importsToCheck,
+                                   SourceFiles* sourceFilesToFree,
+                                   std::vector<FileWriteSourceFile>* fileWriteSourceFilesToFree) {
+  pass_timing::ScopedTimer timer(pass_timing::Pass::LINK);
+  TRACE_SPAN("link");
+
+  assert(compiledSourceFiles.size() == sourceFiles.size() &&
+         "compiled source files should line up with source files");
+
+  // get the namespaces and generate a list of all public function call names
+  const auto [funcCallNameMap, namespaces] =
+      helper::getFuncCallNameMapAndNamespaces(sourceFiles, importsToCheck);
+
+  // compiler generated functions go in the main namespace
+  const std::string& exposedNamespace = namespaces.exposed.front();
 
   // create a list of all tick and load functions
-  LinkResult ret =
-      helper::createListsForTickAndLoadFunctions(compiledSourceFiles, exposedNamespace);
+  LinkResult ret = helper::createListsForTickAndLoadFunctions(compiledSourceFiles, namespaces);
 
   // prepend file write path with namespace and get all file write contents
-  ret.fileWriteMap =
-      helper::collectAllFileWrites(sourceFiles, fileWriteSourceFiles, exposedNamespace);
+  {
+    TRACE_SPAN("collect file writes");
+    ret.fileWriteMap = helper::collectAllFileWrites(sourceFiles, fileWriteSourceFiles, namespaces,
+                                                    ret.fileCopyMap, ret.readFileWriteSourcePaths);
+  }
 
   // Here we free a lot of memory. We do this because we no longer need any
   // uncompiled source files and we're about to allocate a lot of memory
   // generating this function's result. We're able to do this because the
   // compiled source files don't *need* their source file reference to work and
-  fileWriteSourceFiles.clear();
-  sourceFiles.clear();
+  if (fileWriteSourceFilesToFree != nullptr)
+    fileWriteSourceFilesToFree->clear();
+  if (sourceFilesToFree != nullptr)
+    sourceFilesToFree->clear();
   // WARNING: do not use CompiledSourceFile::sourceFile() after this point!
 
   // fill in all unlinked sections and generate the rest of the file write map
   // from functions
-  for (const CompiledSourceFile& compiledSourceFile : compiledSourceFiles) {
+  for (size_t i = 0; i < compiledSourceFiles.size(); i++) {
+    TRACE_SPAN("link source file");
+    const std::string& sourceFileNamespace = namespaces.of(i);
+    const std::string hiddenNamespace = hiddenNamespacePrefix + sourceFileNamespace;
+
     // TODO: try making this async (the mutex around the file write map may make
     // it not worth it though)
-    for (const auto& [relativePath, funcFileWrite] : compiledSourceFile.unlinkedFileWrites()) {
+    for (const auto& [relativePath, funcFileWrite] : compiledSourceFiles[i].unlinkedFileWrites()) {
       assert(relativePath == relativePath.lexically_normal() && "path should be normal by now");
       assert(relativePath.is_relative() && "path should be relative by now");
 
-      std::filesystem::path outPath = (funcFileWrite.belongsInHiddenNamespace)
-                                          ? hiddenNamespace / std::filesystem::path(relativePath)
-                                          : exposedNamespace / std::filesystem::path(relativePath);
+      std::filesystem::path outPath =
+          (funcFileWrite.belongsInHiddenNamespace)
+              ? hiddenNamespace / std::filesystem::path(relativePath)
+              : sourceFileNamespace / std::filesystem::path(relativePath);
 
       assert(!ret.fileWriteMap.count(outPath) && "the return map shouldn't already have this path");
 
       ret.fileWriteMap[std::move(outPath)] =
-          helper::unlinkedTextToText(funcFileWrite.unlinkedText, exposedNamespace, funcCallNameMap);
+          unlinkedTextToText(funcFileWrite.unlinkedText, sourceFileNamespace, funcCallNameMap);
+    }
+  }
+
+  // every counter has to be known before they can be printed
+  if (compileOptions.instrument) {
+    addProfilingFunctions(compiledSourceFiles, ret.fileWriteMap, ret.loadFuncCallNames,
+                          exposedNamespace);
+  }
+
+  // scheduled tick functions are placed using the cost of their linked text
+  scheduleTickFunctions(ret.scheduledTickFuncs, ret.fileWriteMap, ret.tickFuncCallNames,
+                        ret.loadFuncCallNames, exposedNamespace);
+
+  // this has to happen before function files are merged so that the call names
+  // for scheduled tick functions are still valid
+  if (compileOptions.reportTickCost || compileOptions.maxTickCommands != 0) {
+    ret.tickCostReport = estimateTickCost(ret.fileWriteMap, ret.tickFuncCallNames,
+                                          ret.scheduledTickFuncs, exposedNamespace);
+    if (compileOptions.maxTickCommands != 0 &&
+        ret.tickCostReport.busiestTickCost > compileOptions.maxTickCommands) {
+      throw compile_error::TickBudgetExceeded(ret.tickCostReport.busiestTickCost,
+                                              compileOptions.maxTickCommands,
+                                              ret.tickCostReport.str());
     }
   }
 
-  ret.exposedNamespace = std::move(exposedNamespace);
+  // identical function files can only be found once everything is linked
+  // (function files are only merged with others in the same namespace)
+  if (compileOptions.deduplicateFunctions) {
+    TRACE_SPAN("deduplicate functions");
+    for (const std::string& ns : namespaces.exposed) {
+      ret.deduplicatedFunctionCount +=
+          deduplicateFunctions(ret.fileWriteMap, ns, ret.tickFuncCallNames, ret.loadFuncCallNames);
+    }
+  }
+
+  // this has to happen last so only function files that are written are listed
+  if (compileOptions.generateSourceMap) {
+    TRACE_SPAN("generate source map");
+    std::vector<std::string> sourceFileNamespaces;
+    sourceFileNamespaces.reserve(compiledSourceFiles.size());
+    for (size_t i = 0; i < compiledSourceFiles.size(); i++)
+      sourceFileNamespaces.push_back(namespaces.of(i));
+    ret.sourceMap = generateSourceMap(compiledSourceFiles, ret.fileWriteMap, sourceFileNamespaces,
+                                      namespaces.exposed);
+  }
+
+  if (timer.isActive()) {
+    for (const auto& [_, contents] : ret.fileWriteMap)
+      timer.addBytes(contents.size());
+  }
+
+  ret.exposedNamespace = exposedNamespace;
+  ret.exposedNamespaces = namespaces.exposed;
   return ret;
 }
 
-// ---------------------------------------------------------------------------//
-// Helper function definitions beyond this point.
-// ---------------------------------------------------------------------------//
-
 static void helper::saveFuncExposePathIfFuncExposed(
     std::unordered_map<std::string, const symbol::Function*>& allFuncExposePaths,
-    const symbol::Function& func) {
+    const symbol::Function& func, const std::string& exposedNamespace) {
 
   if (!func.isExposed())
     return;
 
-  if (allFuncExposePaths.count(func.exposeAddress())) {
-    const symbol::Function& existing = *allFuncExposePaths[func.name()];
+  const auto [it, isNew] =
+      allFuncExposePaths.try_emplace(exposedNamespace + ':' + func.exposeAddress(), &func);
+  if (!isNew) {
+    const symbol::Function& existing = *it->second;
     throw compile_error::DeclarationConflict(
         "Function " + style_text::styleAsCode(existing.name()) +
             " has the same expose path as function " + style_text::styleAsCode(func.name()) +
             " from another source file.",
         existing.exposeAddressToken(), func.exposeAddressToken());
   }
-
-  allFuncExposePaths[func.exposeAddress()] = &func;
 }
 
 static void helper::ensurePublicFuncQualifiersMatch(const symbol::Function& existingFunc,
@@ -150,6 +317,13 @@ static void helper::ensurePublicFuncQualifiersMatch(const symbol::Function& exis
         (existingFunc.isTickFunc()) ? existingFunc.tickKWToken() : existingFunc.nameToken(),
         (newFunc.isTickFunc()) ? newFunc.tickKWToken() : newFunc.nameToken());
   }
+  if (existingFunc.isTickFunc() && existingFunc.tickSchedule() != newFunc.tickSchedule()) {
+    throw compile_error::DeclarationConflict(
+        "All declarations of public function " + style_text::styleAsCode(existingFunc.name()) +
+            " must have the same tick schedule (e.g. " + style_text::styleAsCode("tick(every 20)") +
+            ").",
+        existingFunc.tickKWToken(), newFunc.tickKWToken());
+  }
   if (existingFunc.isLoadFunc() != existingFunc.isLoadFunc()) {
     throw compile_error::DeclarationConflict(
         "All declarations of public function " + style_text::styleAsCode(existingFunc.name()) +
@@ -163,7 +337,7 @@ static void helper::ensurePublicFuncQualifiersMatch(const symbol::Function& exis
 static std::unordered_map<std::string, std::string> helper::generateAllPublicFuncCallStrings(
     std::unordered_map<std::string, const symbol::Function*> allPublicFuncs,
     std::unordered_map<std::string, const symbol::Function*> allPrivateFuncs,
-    const std::string& exposedNamespace) {
+    const std::unordered_map<const SourceFile*, const std::string*>& namespaceOfSourceFile) {
   std::unordered_map<std::string, std::string> ret;
 
   for (const auto& [funcName, func] : allPublicFuncs) {
@@ -185,6 +359,8 @@ static std::unordered_map<std::string, std::string> helper::generateAllPublicFun
     }
 
     // generate a function call name for this function
+    const std::string& exposedNamespace =
+        *namespaceOfSourceFile.at(&func->nameToken().sourceFile());
     ret[funcName] = ((func->isExposed()) ? "" : hiddenNamespacePrefix) + exposedNamespace + ':' +
                     ((func->isExposed()) ? func->exposeAddress() : func->functionID().str());
   }
@@ -192,31 +368,43 @@ static std::unordered_map<std::string, std::string> helper::generateAllPublicFun
   return ret;
 }
 
-static std::string helper::unlinkedTextToText(
-    const UnlinkedText& unlinkedText, const std::string& exposedNamespace,
-    const std::unordered_map<std::string, std::string>& funcCallStrings) {
-  std::string ret;
-  for (const UnlinkedTextSection& section : unlinkedText.sections()) {
-    switch (section.kind()) {
-    case UnlinkedTextSection::Kind::TEXT:
-      ret += section.textContents();
-      break;
-    case UnlinkedTextSection::Kind::FUNCTION:
-      assert(funcCallStrings.count(section.funcName()) && "func call string should be valid");
-      ret += funcCallStrings.at(section.funcName());
-      break;
-    case UnlinkedTextSection::Kind::NAMESPACE:
-      ret += exposedNamespace;
-      break;
+static void helper::ensureImportedFuncCallsAreDeclared(const SourceFile& sourceFile) {
+  // create a set of imported function names
+  std::unordered_set<std::string> importedFunctionNames;
+
+  size_t importedFunctionNameCount = 0;
+  for (const symbol::Import importSymbol : sourceFile.importSymbolTable()) {
+    importedFunctionNameCount +=
+        importSymbol.sourceFile().functionSymbolTable().publicSymbolCount();
+  }
+  importedFunctionNames.reserve(importedFunctionNameCount);
+
+  for (const symbol::Import importSymbol : sourceFile.importSymbolTable()) {
+    for (const symbol::Function& func : importSymbol.sourceFile().functionSymbolTable()) {
+      if (func.isPublic())
+        importedFunctionNames.insert(func.name());
     }
   }
-  return ret;
+
+  // ensure all unresolved functions calls are declared in one of the imported
+  // files for this source file; the 1st call to an unresolved function is the
+  // one that causes the error (the source file isn't changed so it can be
+  // linked again)
+  sourceFile.unresolvedFunctionNames().ensureAllNamesAreIn(importedFunctionNames);
 }
 
-static helper::FuncCallNameMapAndNamespace helper::getFuncCallNameMapAndNamespace(
-    SourceFiles& sourceFiles) {
+static helper::FuncCallNameMapAndNamespaces
+helper::getFuncCallNameMapAndNamespaces(const SourceFiles& sourceFiles,
+                                        const std::vector<bool>& importsToCheck) {
+  assert((importsToCheck.empty() || importsToCheck.size() == sourceFiles.size()) &&
+         "importsToCheck should line up with sourceFiles");
+
+  Namespaces namespaces = helper::assignNamespaces(sourceFiles);
 
-  const Token* exposedNamespaceToken = nullptr;
+  std::unordered_map<const SourceFile*, const std::string*> namespaceOfSourceFile;
+  namespaceOfSourceFile.reserve(sourceFiles.size());
+  for (size_t i = 0; i < sourceFiles.size(); i++)
+    namespaceOfSourceFile[&sourceFiles[i]] = &namespaces.of(i);
 
   std::unordered_map<std::string, const symbol::Function*> allFuncExposePaths;
   std::unordered_map<std::string, const symbol::Function*> allPrivateFuncs;
@@ -225,7 +413,7 @@ static helper::FuncCallNameMapAndNamespace helper::getFuncCallNameMapAndNamespac
   // pre-allocate space for allFuncExposePaths, allPrivateFuncs, and
   // allPublicFuncs
   size_t privateFuncCount = 0, publicFuncCount = 0, exposedFuncCount = 0;
-  for (SourceFile& sourceFile : sourceFiles) {
+  for (const SourceFile& sourceFile : sourceFiles) {
     privateFuncCount += sourceFile.functionSymbolTable().privateSymbolCount();
     publicFuncCount += sourceFile.functionSymbolTable().publicSymbolCount();
     exposedFuncCount += sourceFile.functionSymbolTable().exposedSymbolCount();
@@ -234,56 +422,19 @@ static helper::FuncCallNameMapAndNamespace helper::getFuncCallNameMapAndNamespac
   allPrivateFuncs.reserve(publicFuncCount);
   allPublicFuncs.reserve(exposedFuncCount);
 
-  for (SourceFile& sourceFile : sourceFiles) {
-    // handle any file's exposed namespace
-    if (sourceFile.namespaceExposeSymbol().isSet()) {
-      if (exposedNamespaceToken == nullptr)
-        exposedNamespaceToken = &sourceFile.namespaceExposeSymbol().exposedNamespaceToken();
-      else {
-        // the namespace can't be declared twice
-        throw compile_error::DeclarationConflict(
-            "A namespace can only be exposed once during compilation.", *exposedNamespaceToken,
-            sourceFile.namespaceExposeSymbol().exposedNamespaceToken());
-      }
-    }
-
-    // create a set of imported function names
-    std::unordered_set<std::string> importedFunctionNames;
-
-    size_t importedFunctionNameCount = 0;
-    for (const symbol::Import importSymbol : sourceFile.importSymbolTable()) {
-      importedFunctionNameCount +=
-          importSymbol.sourceFile().functionSymbolTable().publicSymbolCount();
-    }
-    importedFunctionNames.reserve(importedFunctionNameCount);
+  for (size_t i = 0; i < sourceFiles.size(); i++) {
+    const SourceFile& sourceFile = sourceFiles[i];
 
-    for (const symbol::Import importSymbol : sourceFile.importSymbolTable()) {
-      for (const symbol::Function& func : importSymbol.sourceFile().functionSymbolTable()) {
-        if (func.isPublic())
-          importedFunctionNames.insert(func.name());
-      }
-    }
-
-    // ensure all unresolved functions calls are declared in one of the imported
-    // files for this source file; doing it like this ensures the 1st call to an
-    // unresolved function is the one that causes the error, although it is a
-    // little slower (worth it for reproducibility).
-    // TODO: refactor this, it's really weird because of UnresolvedFunctionNames
-    std::vector<std::string> unresolvedFuncNamesToRemove;
-    unresolvedFuncNamesToRemove.reserve(sourceFile.unresolvedFunctionNames().size());
-    for (const std::string& unresolvedFuncName : sourceFile.unresolvedFunctionNames()) {
-      if (importedFunctionNames.count(unresolvedFuncName))
-        unresolvedFuncNamesToRemove.emplace_back(unresolvedFuncName);
-    }
-    for (const std::string& unresolvedFuncName : unresolvedFuncNamesToRemove)
-      sourceFile.unresolvedFunctionNames().remove(unresolvedFuncName);
-    sourceFile.unresolvedFunctionNames().ensureTableIsEmpty();
+    // a source file's imports only need to be checked again if it changed or
+    // if the interface of a file it imports changed
+    if (importsToCheck.empty() || importsToCheck[i])
+      helper::ensureImportedFuncCallsAreDeclared(sourceFile);
 
     // save all public and private functions to their maps (we're saving private
     // functions so we can detect name shadowing later)
     for (const symbol::Function& func : sourceFile.functionSymbolTable()) {
       // save all expose paths
-      helper::saveFuncExposePathIfFuncExposed(allFuncExposePaths, func);
+      helper::saveFuncExposePathIfFuncExposed(allFuncExposePaths, func, namespaces.of(i));
 
       // add just the 1st appearance of the private function so that if the name
       // shadows something public what we throw with is the 1st time it showed
@@ -321,21 +472,101 @@ static helper::FuncCallNameMapAndNamespace helper::getFuncCallNameMapAndNamespac
     }
   }
 
-  // if no namespace was ever exposed
-  if (exposedNamespaceToken == nullptr)
-    throw compile_error::NoExposedNamespace();
-
   // finish validating functions (all defined, nothing shadowed) and generate
   // the call names for all public functions (e.g. creating the string
   // "my_namespace:foo/bar")
   return {helper::generateAllPublicFuncCallStrings(allPublicFuncs, allPrivateFuncs,
-                                                   exposedNamespaceToken->contents()),
-          exposedNamespaceToken->contents()};
+                                                   namespaceOfSourceFile),
+          std::move(namespaces)};
+}
+
+static helper::Namespaces helper::assignNamespaces(const SourceFiles& sourceFiles) {
+  Namespaces ret;
+
+  // the directory each namespace was exposed from -> its index in ret.exposed
+  std::unordered_map<std::filesystem::path, size_t> namespaceDirectories;
+  std::vector<const Token*> exposedNamespaceTokens;
+  // the index in ret.exposed of the main namespace and how deep its directory is
+  size_t mainIndex = 0;
+  size_t mainDepth = 0;
+
+  for (const SourceFile& sourceFile : sourceFiles) {
+    if (!sourceFile.namespaceExposeSymbol().isSet())
+      continue;
+    const Token& token = sourceFile.namespaceExposeSymbol().exposedNamespaceToken();
+
+    // a namespace can't be exposed twice
+    for (const Token* existingToken : exposedNamespaceTokens) {
+      if (existingToken->contents() == token.contents()) {
+        throw compile_error::DeclarationConflict(
+            "Namespace " + style_text::styleAsCode(token.contents()) +
+                " can only be exposed once during compilation.",
+            *existingToken, token);
+      }
+    }
+
+    const std::filesystem::path directory = sourceFile.path().parent_path().lexically_normal();
+    const auto [it, isNew] = namespaceDirectories.try_emplace(directory, ret.exposed.size());
+    if (!isNew) {
+      throw compile_error::DeclarationConflict(
+          "Only 1 namespace can be exposed from each directory.",
+          *exposedNamespaceTokens[it->second], token);
+    }
+
+    // the main namespace shouldn't depend on the order of the source files
+    const size_t depth =
+        static_cast<size_t>(std::distance(directory.begin(), directory.end()));
+    if (ret.exposed.empty() || depth < mainDepth ||
+        (depth == mainDepth && token.contents() < ret.exposed[mainIndex])) {
+      mainIndex = ret.exposed.size();
+      mainDepth = depth;
+    }
+
+    exposedNamespaceTokens.push_back(&token);
+    ret.exposed.push_back(token.contents());
+  }
+
+  // if no namespace was ever exposed
+  if (ret.exposed.empty())
+    throw compile_error::NoExposedNamespace();
+
+  // move the main namespace to the front
+  std::rotate(ret.exposed.begin(), ret.exposed.begin() + mainIndex,
+              ret.exposed.begin() + mainIndex + 1);
+  for (auto& [_, index] : namespaceDirectories) {
+    if (index == mainIndex)
+      index = 0;
+    else if (index < mainIndex)
+      index++;
+  }
+
+  // with only 1 namespace every source file belongs to it
+  if (ret.exposed.size() == 1) {
+    ret.ofSourceFile.assign(sourceFiles.size(), 0);
+    return ret;
+  }
+
+  ret.ofSourceFile.reserve(sourceFiles.size());
+  for (const SourceFile& sourceFile : sourceFiles) {
+    // walk up until we find a directory a namespace was exposed from
+    std::filesystem::path directory = sourceFile.path().parent_path().lexically_normal();
+    while (true) {
+      const auto it = namespaceDirectories.find(directory);
+      if (it != namespaceDirectories.end()) {
+        ret.ofSourceFile.push_back(it->second);
+        break;
+      }
+      if (!directory.has_relative_path())
+        throw compile_error::NoExposedNamespace(sourceFile.path());
+      directory = directory.parent_path();
+    }
+  }
+
+  return ret;
 }
 
 static LinkResult helper::createListsForTickAndLoadFunctions(
-    const std::vector<CompiledSourceFile>& compiledSourceFiles,
-    const std::string& exposedNamespace) {
+    const std::vector<CompiledSourceFile>& compiledSourceFiles, const Namespaces& namespaces) {
 
   LinkResult ret;
 
@@ -352,14 +583,21 @@ static LinkResult helper::createListsForTickAndLoadFunctions(
   ret.tickFuncCallNames.reserve(tickFuncCount);
   ret.loadFuncCallNames.reserve(loadFuncCount);
 
-  for (const CompiledSourceFile& compiledSourceFile : compiledSourceFiles) {
+  for (size_t i = 0; i < compiledSourceFiles.size(); i++) {
+    const CompiledSourceFile& compiledSourceFile = compiledSourceFiles[i];
+    const std::string& exposedNamespace = namespaces.of(i);
+
     for (const UnlinkedText& unlinkedText : compiledSourceFile.tickFunctions()) {
       ret.tickFuncCallNames.emplace_back(
-          helper::unlinkedTextToText(unlinkedText, exposedNamespace, dummyMap));
+          unlinkedTextToText(unlinkedText, exposedNamespace, dummyMap));
+    }
+    for (const auto& [unlinkedText, tickSchedule] : compiledSourceFile.scheduledTickFunctions()) {
+      ret.scheduledTickFuncs.push_back(
+          {unlinkedTextToText(unlinkedText, exposedNamespace, dummyMap), tickSchedule});
     }
     for (const UnlinkedText& unlinkedText : compiledSourceFile.loadFunctions()) {
       ret.loadFuncCallNames.emplace_back(
-          helper::unlinkedTextToText(unlinkedText, exposedNamespace, dummyMap));
+          unlinkedTextToText(unlinkedText, exposedNamespace, dummyMap));
     }
   }
 
@@ -368,8 +606,11 @@ static LinkResult helper::createListsForTickAndLoadFunctions(
 
 static std::unordered_map<std::filesystem::path, std::string> helper::collectAllFileWrites(
     const SourceFiles& sourceFiles, const std::vector<FileWriteSourceFile>& fileWriteSourceFiles,
-    const std::string& exposedNamespace) {
+    const Namespaces& namespaces,
+    std::unordered_map<std::filesystem::path, std::filesystem::path>& fileCopyMap,
+    std::vector<std::filesystem::path>& readFileWriteSourcePaths) {
 
+  // output path (starting with the namespace) -> file write
   std::unordered_map<std::filesystem::path, const symbol::FileWrite*> allFileWrites;
 
   // pre-allocate space for allFileWrites
@@ -378,15 +619,16 @@ static std::unordered_map<std::filesystem::path, std::string> helper::collectAll
     fileWriteCount += sourceFile.fileWriteSymbolTable().size();
   allFileWrites.reserve(fileWriteCount);
 
-  for (const SourceFile& sourceFile : sourceFiles) {
-    for (const symbol::FileWrite& fileWrite : sourceFile.fileWriteSymbolTable()) {
+  for (size_t i = 0; i < sourceFiles.size(); i++) {
+    for (const symbol::FileWrite& fileWrite : sourceFiles[i].fileWriteSymbolTable()) {
+      std::filesystem::path outPath = namespaces.of(i) / fileWrite.relativeOutPath();
 
       assert(fileWrite.relativeOutPath().is_relative() && "relative out path should be relative");
       assert(fileWrite.relativeOutPath() == fileWrite.relativeOutPath().lexically_normal() &&
              "relative out path should be normal by now");
 
       // if we ecounter a new file write we just save it (validate 1st)
-      if (!allFileWrites.count(fileWrite.relativeOutPath())) {
+      if (!allFileWrites.count(outPath)) {
         // ensure the file path doesn't start in the functions directory
         for (const std::filesystem::path& part : fileWrite.relativeOutPath()) {
           assert(part != ".." && "backtracking should have been caught by now");
@@ -405,7 +647,7 @@ static std::unordered_map<std::filesystem::path, std::string> helper::collectAll
           break;
         }
 
-        allFileWrites[fileWrite.relativeOutPath()] = &fileWrite;
+        allFileWrites[std::move(outPath)] = &fileWrite;
         continue;
       }
       // if we encounter a repeat of an existing file write we need to
@@ -415,7 +657,7 @@ static std::unordered_map<std::filesystem::path, std::string> helper::collectAll
       if (!fileWrite.hasContents())
         continue;
 
-      const symbol::FileWrite& existingFileWrite = *allFileWrites[fileWrite.relativeOutPath()];
+      const symbol::FileWrite& existingFileWrite = *allFileWrites[outPath];
 
       // file write can't be defined twice
       if (existingFileWrite.hasContents()) {
@@ -426,56 +668,81 @@ static std::unordered_map<std::filesystem::path, std::string> helper::collectAll
       }
 
       // replace symbol in map with this one because this one is defined
-      allFileWrites[fileWrite.relativeOutPath()] = &fileWrite;
+      allFileWrites[outPath] = &fileWrite;
     }
   }
 
   // ensure all file writes are defined
-  for (const auto& [path, fileWrite] : allFileWrites) {
+  for (const auto& [_, fileWrite] : allFileWrites) {
     if (!fileWrite->hasContents()) {
-      throw compile_error::UnresolvedSymbol("File write " + style_text::styleAsCode(path.string()) +
+      const std::string pathStr = fileWrite->relativeOutPath().string();
+      throw compile_error::UnresolvedSymbol("File write " + style_text::styleAsCode(pathStr) +
                                                 " was never defined.",
                                             fileWrite->relativeOutPathToken());
     }
   }
 
+  FileWriteSourceFileMap fileWriteSourceFileMap;
+  fileWriteSourceFileMap.reserve(fileWriteSourceFiles.size());
+  for (const FileWriteSourceFile& fileWriteSourceFile : fileWriteSourceFiles) {
+    const auto [it, isNew] =
+        fileWriteSourceFileMap.try_emplace(fileWriteSourceFile.importPath(), &fileWriteSourceFile);
+    if (!isNew)
+      it->second = nullptr;
+  }
+
   std::unordered_map<std::filesystem::path, std::string> ret;
   ret.reserve(fileWriteCount);
 
+  // file write source files are copied into the data pack later (so their
+  // contents are never held in memory)
   for (const auto& [path, fileWrite] : allFileWrites) {
-    ret[exposedNamespace / path] = helper::fileWriteToStr(*fileWrite, fileWriteSourceFiles);
+    assert(fileWrite->hasContents() && "file write needs contents by this point");
+    if (fileWrite->contentsToken().kind() == Token::Kind::SNIPPET) {
+      ret[path] = fileWrite->contents();
+      continue;
+    }
+    const std::filesystem::path& sourcePath =
+        helper::fileWriteSourcePath(*fileWrite, fileWriteSourceFileMap);
+    fileCopyMap[path] = sourcePath;
+    readFileWriteSourcePaths.push_back(sourcePath);
   }
 
-  return ret;
-}
+  // the same file can be read by more than 1 file write
+  std::sort(readFileWriteSourcePaths.begin(), readFileWriteSourcePaths.end());
+  readFileWriteSourcePaths.erase(
+      std::unique(readFileWriteSourcePaths.begin(), readFileWriteSourcePaths.end()),
+      readFileWriteSourcePaths.end());
 
-static std::string helper::fileWriteToStr(
-    const symbol::FileWrite& fileWrite,
-    const std::vector<FileWriteSourceFile>& fileWriteSourceFiles) {
-  assert(fileWrite.hasContents() && "file write needs contents by this point");
+  for (const std::filesystem::path& sourcePath : readFileWriteSourcePaths) {
+    if (!vfs::isRegularFile(sourcePath))
+      throw compile_error::CouldntOpenFile(sourcePath);
+  }
 
-  if (fileWrite.contentsToken().kind() == Token::Kind::SNIPPET)
-    return fileWrite.contents();
+  return ret;
+}
 
+static const std::filesystem::path&
+helper::fileWriteSourcePath(const symbol::FileWrite& fileWrite,
+                            const FileWriteSourceFileMap& fileWriteSourceFileMap) {
   assert(fileWrite.contentsToken().kind() == Token::Kind::STRING &&
          "contents should be a snippet or a string");
 
   std::filesystem::path targetImportPath = fileWrite.contents();
 
-  const FileWriteSourceFile* found = nullptr;
-  for (const FileWriteSourceFile& fileWriteSourceFile : fileWriteSourceFiles) {
-    if (targetImportPath != fileWriteSourceFile.importPath())
-      continue;
-
-    if (found) {
-      throw compile_error::ImportError("Import for file write failed because multiple file write "
-                                       "source files share the import path " +
-                                           style_text::styleAsCode(targetImportPath.string()) + '.',
-                                       fileWrite.contentsToken());
-    }
-
-    found = &fileWriteSourceFile;
+  const auto it = fileWriteSourceFileMap.find(targetImportPath);
+  if (it == fileWriteSourceFileMap.end()) {
+    throw compile_error::ImportError("Import for file write failed because no file write source "
+                                     "file has the import path " +
+                                         style_text::styleAsCode(targetImportPath.string()) + '.',
+                                     fileWrite.contentsToken());
+  }
+  if (!it->second) {
+    throw compile_error::ImportError("Import for file write failed because multiple file write "
+                                     "source files share the import path " +
+                                         style_text::styleAsCode(targetImportPath.string()) + '.',
+                                     fileWrite.contentsToken());
   }
 
-  return fileToStr(found->path());
+  return it->second->path();
 }
@@ -0,0 +1,225 @@
+#include <compiler/linking/scheduleTickFunctions.h>
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <map>
+#include <numeric>
+
+#include <compiler/linking/FunctionCostEstimator.h>
+#include <compiler/translation/constants.h>
+#include <version.h>
+
+namespace {
+namespace helper {
+
+/// The longest cycle of ticks that is balanced as a whole. If the periods of
+/// all scheduled functions don't repeat together within this many ticks, the
+/// functions with each period are balanced on their own.
+constexpr uint64_t maxCycleLength = 1 << 16;
+
+/// Returns how long it takes for every schedule to repeat together (the result
+/// is only exact if it's at most \p maxCycleLength).
+static uint64_t cycleLength(const std::vector<ScheduledTickFunction>& scheduledTickFuncs);
+
+/// Returns the estimated cost of the busiest tick in a cycle of
+/// \param cycleLength ticks (every function's period must divide it).
+static size_t busiestTickCost(const std::vector<const ScheduledTickFunction*>& funcs,
+                              uint64_t cycleLength);
+
+/// Sets the phase of every function in \param funcs. The cost of each tick is
+/// tracked over \param cycleLength ticks (every function's period must divide
+/// it).
+static void balancePhases(std::vector<ScheduledTickFunction*>& funcs, uint64_t cycleLength);
+
+/// Returns the contents of the dispatcher function that runs every scheduled
+/// tick function on its phase, counting ticks with fake players on the
+/// \param objective scoreboard.
+static std::string dispatcherContents(const std::vector<ScheduledTickFunction>& scheduledTickFuncs,
+                                      const std::string& objective);
+
+} // namespace helper
+} // namespace
+
+void scheduleTickFunctions(std::vector<ScheduledTickFunction>& scheduledTickFuncs,
+                           std::unordered_map<std::filesystem::path, std::string>& fileWriteMap,
+                           std::vector<std::string>& tickFuncCallNames,
+                           std::vector<std::string>& loadFuncCallNames,
+                           const std::string& exposedNamespace) {
+  if (scheduledTickFuncs.empty())
+    return;
+
+  const std::string hiddenNamespace = hiddenNamespacePrefix + exposedNamespace;
+
+  FunctionCostEstimator costEstimator(fileWriteMap);
+  for (ScheduledTickFunction& func : scheduledTickFuncs) {
+    assert(func.tickSchedule.kind != TickSchedule::Kind::EVERY_TICK &&
+           "Functions that run every tick shouldn't be scheduled.");
+    func.estimatedCost = costEstimator.functionCost(func.funcCallName);
+    func.phase = 0;
+  }
+
+  const uint64_t cycleLength = helper::cycleLength(scheduledTickFuncs);
+  if (cycleLength <= helper::maxCycleLength) {
+    std::vector<ScheduledTickFunction*> funcs;
+    funcs.reserve(scheduledTickFuncs.size());
+    for (ScheduledTickFunction& func : scheduledTickFuncs)
+      funcs.push_back(&func);
+    helper::balancePhases(funcs, cycleLength);
+  } else {
+    std::map<uint32_t, std::vector<ScheduledTickFunction*>> funcsByPeriod;
+    for (ScheduledTickFunction& func : scheduledTickFuncs)
+      funcsByPeriod[func.tickSchedule.period].push_back(&func);
+    for (auto& [period, funcs] : funcsByPeriod)
+      helper::balancePhases(funcs, period);
+  }
+
+  // the dispatcher runs every tick and the scoreboard it uses is created on load
+  fileWriteMap[hiddenNamespace / funcSubFolder /
+               (std::string(tickScheduleFuncName) + funcFileExt)] =
+      helper::dispatcherContents(scheduledTickFuncs, hiddenNamespace);
+  tickFuncCallNames.push_back(hiddenNamespace + ':' + tickScheduleFuncName);
+
+  fileWriteMap[hiddenNamespace / funcSubFolder /
+               (std::string(tickScheduleLoadFuncName) + funcFileExt)] =
+      "# " MCFUNC_BUILD_INFO_MSG "\n\nscoreboard objectives add " + hiddenNamespace + " dummy\n";
+  loadFuncCallNames.insert(loadFuncCallNames.begin(),
+                           hiddenNamespace + ':' + tickScheduleLoadFuncName);
+}
+
+size_t busiestScheduledTickCost(const std::vector<ScheduledTickFunction>& scheduledTickFuncs) {
+  if (scheduledTickFuncs.empty())
+    return 0;
+
+  const uint64_t cycleLength = helper::cycleLength(scheduledTickFuncs);
+  if (cycleLength <= helper::maxCycleLength) {
+    std::vector<const ScheduledTickFunction*> funcs;
+    funcs.reserve(scheduledTickFuncs.size());
+    for (const ScheduledTickFunction& func : scheduledTickFuncs)
+      funcs.push_back(&func);
+    return helper::busiestTickCost(funcs, cycleLength);
+  }
+
+  // the busiest ticks for each period might not line up so this is only an
+  // upper bound
+  std::map<uint32_t, std::vector<const ScheduledTickFunction*>> funcsByPeriod;
+  for (const ScheduledTickFunction& func : scheduledTickFuncs)
+    funcsByPeriod[func.tickSchedule.period].push_back(&func);
+
+  size_t ret = 0;
+  for (const auto& [period, funcs] : funcsByPeriod)
+    ret += helper::busiestTickCost(funcs, period);
+  return ret;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static uint64_t helper::cycleLength(const std::vector<ScheduledTickFunction>& scheduledTickFuncs) {
+  uint64_t ret = 1;
+  for (const ScheduledTickFunction& func : scheduledTickFuncs) {
+    ret = std::lcm(ret, static_cast<uint64_t>(func.tickSchedule.period));
+    if (ret > helper::maxCycleLength)
+      break;
+  }
+  return ret;
+}
+
+static size_t helper::busiestTickCost(const std::vector<const ScheduledTickFunction*>& funcs,
+                                      uint64_t cycleLength) {
+  std::vector<size_t> tickCosts(cycleLength, 0);
+  for (const ScheduledTickFunction* func : funcs) {
+    for (uint64_t tick = func->phase; tick < cycleLength; tick += func->tickSchedule.period)
+      tickCosts[tick] += func->estimatedCost;
+  }
+  return *std::max_element(tickCosts.begin(), tickCosts.end());
+}
+
+static void helper::balancePhases(std::vector<ScheduledTickFunction*>& funcs,
+                                  uint64_t cycleLength) {
+  std::vector<size_t> tickCosts(cycleLength, 0);
+
+  // functions that run every N ticks always run on the 1st of those ticks
+  for (const ScheduledTickFunction* func : funcs) {
+    if (func->tickSchedule.kind != TickSchedule::Kind::EVERY)
+      continue;
+    for (uint64_t tick = 0; tick < cycleLength; tick += func->tickSchedule.period)
+      tickCosts[tick] += func->estimatedCost;
+  }
+
+  // Spread functions are placed from most to least expensive, each on the phase
+  // where the busiest tick it would run on is the least busy (ties are broken
+  // by the total cost of those ticks, then the lowest phase). The order is
+  // fully decided by cost and name so the output doesn't change between runs.
+  std::vector<ScheduledTickFunction*> spreadFuncs;
+  for (ScheduledTickFunction* func : funcs) {
+    if (func->tickSchedule.kind == TickSchedule::Kind::SPREAD)
+      spreadFuncs.push_back(func);
+  }
+  std::sort(spreadFuncs.begin(), spreadFuncs.end(),
+            [](const ScheduledTickFunction* a, const ScheduledTickFunction* b) {
+              if (a->estimatedCost != b->estimatedCost)
+                return a->estimatedCost > b->estimatedCost;
+              if (a->tickSchedule.period != b->tickSchedule.period)
+                return a->tickSchedule.period < b->tickSchedule.period;
+              return a->funcCallName < b->funcCallName;
+            });
+
+  for (ScheduledTickFunction* func : spreadFuncs) {
+    const uint32_t period = func->tickSchedule.period;
+
+    uint32_t bestPhase = 0;
+    size_t bestMaxCost = std::numeric_limits<size_t>::max();
+    size_t bestTotalCost = std::numeric_limits<size_t>::max();
+    for (uint32_t phase = 0; phase < period; phase++) {
+      size_t maxCost = 0, totalCost = 0;
+      for (uint64_t tick = phase; tick < cycleLength; tick += period) {
+        maxCost = std::max(maxCost, tickCosts[tick]);
+        totalCost += tickCosts[tick];
+      }
+      if (maxCost < bestMaxCost || (maxCost == bestMaxCost && totalCost < bestTotalCost)) {
+        bestPhase = phase;
+        bestMaxCost = maxCost;
+        bestTotalCost = totalCost;
+      }
+    }
+
+    func->phase = bestPhase;
+    for (uint64_t tick = bestPhase; tick < cycleLength; tick += period)
+      tickCosts[tick] += func->estimatedCost;
+  }
+}
+
+static std::string helper::dispatcherContents(
+    const std::vector<ScheduledTickFunction>& scheduledTickFuncs, const std::string& objective) {
+
+  // sort by period, then phase, then name
+  std::map<uint32_t, std::vector<const ScheduledTickFunction*>> funcsByPeriod;
+  for (const ScheduledTickFunction& func : scheduledTickFuncs)
+    funcsByPeriod[func.tickSchedule.period].push_back(&func);
+
+  std::string ret = "# " MCFUNC_BUILD_INFO_MSG "\n\n";
+
+  for (auto& [period, funcs] : funcsByPeriod) {
+    std::sort(funcs.begin(), funcs.end(),
+              [](const ScheduledTickFunction* a, const ScheduledTickFunction* b) {
+                if (a->phase != b->phase)
+                  return a->phase < b->phase;
+                return a->funcCallName < b->funcCallName;
+              });
+
+    // count from 0 to (period - 1) and then wrap back around
+    const std::string counter = "#period_" + std::to_string(period) + ' ' + objective;
+    ret += "scoreboard players add " + counter + " 1\n";
+    ret += "execute if score " + counter + " matches " + std::to_string(period) +
+           ".. run scoreboard players set " + counter + " 0\n";
+
+    for (const ScheduledTickFunction* func : funcs) {
+      ret += "execute if score " + counter + " matches " + std::to_string(func->phase) +
+             " run function " + func->funcCallName + '\n';
+    }
+  }
+
+  return ret;
+}
@@ -0,0 +1,260 @@
+#include <compiler/pass_timing.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+namespace {
+
+struct PassStats {
+  /// Time spent in the pass on each thread, added up.
+  std::atomic<int64_t> busyNs = 0;
+  std::atomic<int64_t> cpuNs = 0;
+  /// When the first timer for the pass started and the last one ended (on any
+  /// thread).
+  std::atomic<int64_t> firstStartNs = std::numeric_limits<int64_t>::max();
+  std::atomic<int64_t> lastEndNs = std::numeric_limits<int64_t>::min();
+  /// The process's high-water mark for resident memory when the pass last
+  /// ended.
+  std::atomic<uint64_t> peakRssBytes = 0;
+  std::atomic<uint64_t> bytes = 0;
+  std::atomic<uint64_t> tokens = 0;
+  std::atomic<uint64_t> timerCount = 0;
+};
+
+constexpr size_t passCount = static_cast<size_t>(pass_timing::Pass::GENERATE_DATA_PACK) + 1;
+
+std::array<PassStats, passCount> passStats;
+
+/// The innermost timer on each thread.
+thread_local pass_timing::ScopedTimer* currentTimer = nullptr;
+
+namespace helper {
+
+static const char* passName(size_t pass);
+
+static int64_t wallTimeNs();
+
+/// The CPU time used by the calling thread (0 if it can't be measured).
+static int64_t threadCpuTimeNs();
+
+/// The most memory the process has had resident at once (0 if it can't be
+/// measured).
+static uint64_t peakRssBytes();
+
+/// Sets \param value to \param newValue if \param newValue is smaller.
+template <typename T> static void storeMin(std::atomic<T>& value, T newValue);
+
+/// Sets \param value to \param newValue if \param newValue is larger.
+template <typename T> static void storeMax(std::atomic<T>& value, T newValue);
+
+} // namespace helper
+} // namespace
+
+namespace pass_timing {
+
+ReportFormat reportFormat = ReportFormat::NONE;
+
+ScopedTimer::ScopedTimer(Pass pass)
+    : m_pass(pass), m_isActive(reportFormat != ReportFormat::NONE) {
+  if (!m_isActive)
+    return;
+
+  m_parent = currentTimer;
+  currentTimer = this;
+  m_startWallNs = helper::wallTimeNs();
+  m_startCpuNs = helper::threadCpuTimeNs();
+}
+
+ScopedTimer::~ScopedTimer() {
+  if (!m_isActive)
+    return;
+
+  const int64_t endWallNs = helper::wallTimeNs();
+  const int64_t wallNs = endWallNs - m_startWallNs;
+  const int64_t cpuNs = helper::threadCpuTimeNs() - m_startCpuNs;
+
+  currentTimer = m_parent;
+  if (m_parent != nullptr) {
+    m_parent->m_childWallNs += wallNs;
+    m_parent->m_childCpuNs += cpuNs;
+  }
+
+  PassStats& stats = passStats[static_cast<size_t>(m_pass)];
+  stats.busyNs += wallNs - m_childWallNs;
+  stats.cpuNs += cpuNs - m_childCpuNs;
+  helper::storeMin(stats.firstStartNs, m_startWallNs);
+  helper::storeMax(stats.lastEndNs, endWallNs);
+  stats.bytes += m_bytes;
+  stats.tokens += m_tokens;
+  stats.timerCount++;
+  helper::storeMax(stats.peakRssBytes, helper::peakRssBytes());
+}
+
+bool ScopedTimer::isActive() const { return m_isActive; }
+
+void ScopedTimer::addBytes(size_t bytes) { m_bytes += bytes; }
+
+void ScopedTimer::addTokens(size_t tokens) { m_tokens += tokens; }
+
+std::string report() {
+  int64_t totalBusyNs = 0;
+  int64_t totalCpuNs = 0;
+  int64_t firstStartNs = std::numeric_limits<int64_t>::max();
+  int64_t lastEndNs = std::numeric_limits<int64_t>::min();
+  for (const PassStats& stats : passStats) {
+    totalBusyNs += stats.busyNs;
+    totalCpuNs += stats.cpuNs;
+    firstStartNs = std::min<int64_t>(firstStartNs, stats.firstStartNs);
+    lastEndNs = std::max<int64_t>(lastEndNs, stats.lastEndNs);
+  }
+
+  // the time from the first timer starting to the last one ending (0 if the
+  // pass never ran)
+  const auto spanNs = [](int64_t startNs, int64_t endNs) -> int64_t {
+    return (startNs <= endNs) ? endNs - startNs : 0;
+  };
+
+  const auto toMs = [](int64_t ns) { return static_cast<double>(ns) / 1e6; };
+  const auto toMiB = [](uint64_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); };
+
+  std::string ret;
+  char line[160];
+
+  if (reportFormat == ReportFormat::JSON) {
+    ret += "{\n  \"passes\": [";
+    for (size_t i = 0; i < passCount; i++) {
+      const PassStats& stats = passStats[i];
+      std::snprintf(line, sizeof(line),
+                    "%s\n    {\"pass\": \"%s\", \"spanMs\": %.3f, \"busyMs\": %.3f, "
+                    "\"cpuMs\": %.3f, \"processPeakRssBytes\": %llu, ",
+                    (i == 0) ? "" : ",", helper::passName(i),
+                    toMs(spanNs(stats.firstStartNs, stats.lastEndNs)), toMs(stats.busyNs),
+                    toMs(stats.cpuNs), static_cast<unsigned long long>(stats.peakRssBytes));
+      ret += line;
+      std::snprintf(line, sizeof(line), "\"bytes\": %llu, \"tokens\": %llu, \"count\": %llu}",
+                    static_cast<unsigned long long>(stats.bytes),
+                    static_cast<unsigned long long>(stats.tokens),
+                    static_cast<unsigned long long>(stats.timerCount));
+      ret += line;
+    }
+    std::snprintf(line, sizeof(line),
+                  "\n  ],\n  \"totalSpanMs\": %.3f,\n  \"totalBusyMs\": %.3f,\n"
+                  "  \"totalCpuMs\": %.3f,\n  \"processPeakRssBytes\": %llu\n}\n",
+                  toMs(spanNs(firstStartNs, lastEndNs)), toMs(totalBusyNs), toMs(totalCpuNs),
+                  static_cast<unsigned long long>(helper::peakRssBytes()));
+    ret += line;
+    return ret;
+  }
+
+  ret += "Pass                      Span (ms)  Busy (ms)   CPU (ms)  Process peak RSS (MiB)"
+         "        Bytes     Tokens\n";
+  for (size_t i = 0; i < passCount; i++) {
+    const PassStats& stats = passStats[i];
+    std::snprintf(line, sizeof(line), "%-24s %10.3f %10.3f %10.3f %23.1f %12llu %10llu\n",
+                  helper::passName(i), toMs(spanNs(stats.firstStartNs, stats.lastEndNs)),
+                  toMs(stats.busyNs), toMs(stats.cpuNs), toMiB(stats.peakRssBytes),
+                  static_cast<unsigned long long>(stats.bytes),
+                  static_cast<unsigned long long>(stats.tokens));
+    ret += line;
+  }
+  std::snprintf(line, sizeof(line), "%-24s %10.3f %10.3f %10.3f %23.1f\n", "total",
+                toMs(spanNs(firstStartNs, lastEndNs)), toMs(totalBusyNs), toMs(totalCpuNs),
+                toMiB(helper::peakRssBytes()));
+  ret += line;
+  ret += "(Span is the time from a pass first starting to it last ending, including any\n"
+         "passes nested in it. Busy and CPU times are added up across threads. Process\n"
+         "peak RSS is the most memory the whole process had resident by the time the\n"
+         "pass last ended.)\n";
+
+  return ret;
+}
+
+void reset() {
+  for (PassStats& stats : passStats) {
+    stats.busyNs = 0;
+    stats.cpuNs = 0;
+    stats.firstStartNs = std::numeric_limits<int64_t>::max();
+    stats.lastEndNs = std::numeric_limits<int64_t>::min();
+    stats.peakRssBytes = 0;
+    stats.bytes = 0;
+    stats.tokens = 0;
+    stats.timerCount = 0;
+  }
+}
+
+} // namespace pass_timing
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static const char* helper::passName(size_t pass) {
+  switch (static_cast<pass_timing::Pass>(pass)) {
+  case pass_timing::Pass::TOKENIZE:
+    return "tokenize";
+  case pass_timing::Pass::ANALYZE_SYNTAX:
+    return "analyze syntax";
+  case pass_timing::Pass::TRANSLATE:
+    return "translate";
+  case pass_timing::Pass::LINK:
+    return "link";
+  case pass_timing::Pass::ADD_TICK_AND_LOAD_FUNCS:
+    return "add tick/load functions";
+  case pass_timing::Pass::GENERATE_DATA_PACK:
+    return "generate data pack";
+  }
+  return "";
+}
+
+static int64_t helper::wallTimeNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static int64_t helper::threadCpuTimeNs() {
+#if defined(__unix__) || defined(__APPLE__)
+  timespec time;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+    return 0;
+  return static_cast<int64_t>(time.tv_sec) * 1000000000 + static_cast<int64_t>(time.tv_nsec);
+#else
+  return 0;
+#endif
+}
+
+static uint64_t helper::peakRssBytes() {
+#if defined(__unix__) || defined(__APPLE__)
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#if defined(__APPLE__)
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+  return 0;
+#endif
+}
+
+template <typename T> static void helper::storeMin(std::atomic<T>& value, T newValue) {
+  T previousValue = value;
+  while (newValue < previousValue && !value.compare_exchange_weak(previousValue, newValue)) {
+  }
+}
+
+template <typename T> static void helper::storeMax(std::atomic<T>& value, T newValue) {
+  T previousValue = value;
+  while (newValue > previousValue && !value.compare_exchange_weak(previousValue, newValue)) {
+  }
+}
@@ -0,0 +1,68 @@
+#include <compiler/runInParallel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <compiler/Jobserver.h>
+
+/// Whether this thread is running a task from \p runInParallel() .
+static thread_local bool isRunningTask = false;
+
+void runInParallel(size_t taskCount, const std::function<void(size_t)>& task) {
+  if (taskCount == 0)
+    return;
+
+  // every thread is already busy with the outer call's tasks
+  if (isRunningTask) {
+    for (size_t i = 0; i < taskCount; i++)
+      task(i);
+    return;
+  }
+
+  // at most this many extra threads are spawned (less if there aren't many
+  // tasks)
+  const size_t maxExtraThreadCount =
+      std::min<size_t>(taskCount, std::max(1u, std::thread::hardware_concurrency())) - 1;
+
+  std::atomic<size_t> nextTask = 0;
+  const auto runTasks = [&task, taskCount, &nextTask]() {
+    isRunningTask = true;
+    for (size_t i = nextTask++; i < taskCount; i = nextTask++)
+      task(i);
+    isRunningTask = false;
+  };
+
+  // Without a jobserver every extra thread is spawned right away, otherwise an
+  // extra thread is only spawned once it has a token (checked before every
+  // task) and gives it back as soon as there's nothing left to do.
+  Jobserver jobserver;
+  std::vector<std::thread> threads;
+  threads.reserve(maxExtraThreadCount);
+
+  if (!jobserver.isConnected()) {
+    for (size_t i = 0; i < maxExtraThreadCount; i++)
+      threads.emplace_back(runTasks);
+    runTasks();
+  } else {
+    const auto runTasksWithToken = [&runTasks, &jobserver]() {
+      runTasks();
+      jobserver.release();
+    };
+
+    isRunningTask = true;
+    for (size_t i = nextTask++; i < taskCount; i = nextTask++) {
+      while (threads.size() < maxExtraThreadCount && nextTask < taskCount &&
+             jobserver.tryAcquire()) {
+        threads.emplace_back(runTasksWithToken);
+      }
+      task(i);
+    }
+    isRunningTask = false;
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+}
@@ -2,15 +2,20 @@
 
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <vector>
 
 #include <cli/style_text.h>
+#include <compiler/TickSchedule.h>
 #include <compiler/compile_error.h>
+#include <compiler/pass_timing.h>
 #include <compiler/syntax_analysis/statement.h>
 #include <compiler/syntax_analysis/symbol.h>
 #include <compiler/tokenization/Token.h>
+#include <compiler/tracing.h>
 #include <compiler/translation/constants.h>
 
 namespace {
@@ -35,6 +40,10 @@ static void forceMatchTokenPattern(const std::vector<Token>& tokens, size_t star
 static void forceMatchToken(const std::vector<Token>& tokens, size_t index,
                             const std::initializer_list<Token::Kind>& matchKinds);
 
+/// Returns the schedule for a tick function given the 2 words in something like
+/// 'tick(every 20)' or throws.
+static TickSchedule parseTickSchedule(const Token& kindToken, const Token& periodToken);
+
 /// Given the index of the next statement it returns the statement or throws.
 std::unique_ptr<statement::Generic> collectStatement(
     const std::vector<Token>& tokens, const symbol::FunctionTable& functionTable,
@@ -47,10 +56,21 @@ static statement::Scope collectScope(const std::vector<Token>& tokens,
                                      symbol::UnresolvedFunctionNames& unresolvedFunctionNames,
                                      size_t firstIndex);
 
+/// The index of \param sourceFile in \param sourceFiles (0 if it isn't in
+/// it).
+static uint32_t fileNumberOf(const SourceFile& sourceFile, const SourceFiles& sourceFiles);
+
 } // namespace helper
 } // namespace
 
 void SourceFile::analyzeSyntax(const SourceFiles& sourceFiles) {
+  pass_timing::ScopedTimer timer(pass_timing::Pass::ANALYZE_SYNTAX);
+  TRACE_SPAN("analyze syntax");
+  timer.addTokens(m_tokens.size());
+
+  // every ID this file hands out is made again, so their numbers start over
+  m_fileNumber = helper::fileNumberOf(*this, sourceFiles);
+  m_nextIDNumber = 1;
 
   // this needs to be here or there might be out of bounds access
   if (m_tokens.empty())
@@ -61,6 +81,7 @@ void SourceFile::analyzeSyntax(const SourceFiles& sourceFiles) {
     const Token* publicTokenPtr = nullptr;
     const Token* tickTokenPtr = nullptr;
     const Token* loadTokenPtr = nullptr;
+    TickSchedule tickSchedule;
 
   switchStatementBeginning:
     switch (m_tokens[i].kind()) {
@@ -119,6 +140,12 @@ void SourceFile::analyzeSyntax(const SourceFiles& sourceFiles) {
       goto getNextQualifierKeyword;
     case Token::TICK_KW:
       tickTokenPtr = &m_tokens[i];
+      // tick functions can have a schedule (e.g. 'tick(every 20) void foo();')
+      if (helper::tryMatchPattern(m_tokens, i + 1, {Token::L_PAREN})) {
+        helper::forceMatchTokenPattern(m_tokens, i + 2, {Token::WORD, Token::WORD, Token::R_PAREN});
+        tickSchedule = helper::parseTickSchedule(m_tokens[i + 2], m_tokens[i + 3]);
+        i += 4; // set to index of ')'
+      }
       goto getNextQualifierKeyword;
     case Token::LOAD_KW:
       loadTokenPtr = &m_tokens[i];
@@ -139,6 +166,8 @@ void SourceFile::analyzeSyntax(const SourceFiles& sourceFiles) {
       helper::forceMatchTokenPattern(m_tokens, i, {Token::WORD, Token::L_PAREN, Token::R_PAREN});
 
       symbol::Function thisSymbol(&m_tokens[i], publicTokenPtr, tickTokenPtr, loadTokenPtr);
+      if (tickTokenPtr != nullptr)
+        thisSymbol.setTickSchedule(tickSchedule);
 
       i += 3; // set to index of definition, ending semicolon, or 'expose'
       helper::forceMatchToken(m_tokens, i, {Token::L_BRACE, Token::SEMICOLON, Token::EXPOSE_KW});
@@ -327,6 +356,50 @@ static void helper::forceMatchToken(const std::vector<Token>& tokens, size_t ind
                                        tokens[index]);
 }
 
+static TickSchedule helper::parseTickSchedule(const Token& kindToken, const Token& periodToken) {
+  TickSchedule ret;
+
+  if (kindToken.contents() == "every")
+    ret.kind = TickSchedule::Kind::EVERY;
+  else if (kindToken.contents() == "spread")
+    ret.kind = TickSchedule::Kind::SPREAD;
+  else {
+    throw compile_error::UnexpectedToken("Expected " + style_text::styleAsCode("every") + " or " +
+                                             style_text::styleAsCode("spread") + " but got " +
+                                             style_text::styleAsCode(kindToken.contents()) + '.',
+                                         kindToken);
+  }
+
+  // the period is a whole number of ticks (not too large to fit in a score)
+  constexpr uint32_t maxPeriod = 1'000'000;
+  uint64_t period = 0;
+  for (char c : periodToken.contents()) {
+    if (c < '0' || c > '9') {
+      throw compile_error::UnexpectedToken("Expected a whole number of ticks but got " +
+                                               style_text::styleAsCode(periodToken.contents()) +
+                                               '.',
+                                           periodToken);
+    }
+    period = period * 10 + (c - '0');
+    if (period > maxPeriod)
+      break;
+  }
+  if (period == 0 || period > maxPeriod) {
+    throw compile_error::UnexpectedToken("The number of ticks in a tick schedule must be between " +
+                                             style_text::styleAsCode('1') + " and " +
+                                             style_text::styleAsCode(std::to_string(maxPeriod)) +
+                                             '.',
+                                         periodToken);
+  }
+  ret.period = static_cast<uint32_t>(period);
+
+  // running once every tick is the same as not having a schedule
+  if (ret.period == 1)
+    ret.kind = TickSchedule::Kind::EVERY_TICK;
+
+  return ret;
+}
+
 std::unique_ptr<statement::Generic> helper::collectStatement(
     const std::vector<Token>& tokens, const symbol::FunctionTable& functionTable,
     symbol::UnresolvedFunctionNames& unresolvedFunctionNames, size_t firstIndex) {
@@ -399,3 +472,11 @@ static statement::Scope helper::collectScope(
   throw compile_error::BadClosingChar(
       "Missing closing counterpart for " + style_text::styleAsCode('{') + '.', tokens[firstIndex]);
 }
+
+static uint32_t helper::fileNumberOf(const SourceFile& sourceFile, const SourceFiles& sourceFiles) {
+  const std::less<const SourceFile*> less;
+  if (less(&sourceFile, sourceFiles.data()) ||
+      !less(&sourceFile, sourceFiles.data() + sourceFiles.size()))
+    return 0;
+  return static_cast<uint32_t>(&sourceFile - sourceFiles.data());
+}
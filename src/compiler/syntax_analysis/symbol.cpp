@@ -36,13 +36,15 @@ Function::Function(const Token* nameTokenPtr, const Token* publicTokenPtr,
                    const Token* tickTokenPtr, const Token* loadTokenPtr,
                    const Token* exposeAddressTokenPtr, std::optional<statement::Scope>&& definition)
     : m_nameTokenPtr(nameTokenPtr), m_publicTokenPtr(publicTokenPtr), m_tickTokenPtr(tickTokenPtr),
-      m_loadTokenPtr(loadTokenPtr), m_exposeAddressTokenPtr(exposeAddressTokenPtr),
+      m_tickSchedule(), m_loadTokenPtr(loadTokenPtr),
+      m_exposeAddressTokenPtr(exposeAddressTokenPtr),
       m_exposeAddressPath((exposeAddressTokenPtr == nullptr)
                               ? ""
                               : filePathFromToken(exposeAddressTokenPtr, false, false)),
       m_definition(std::move(definition)),
       m_functionID((m_definition.has_value())
-                       ? std::optional<UniqueID>(UniqueID(UniqueID::Kind::FUNCTION))
+                       ? std::optional<UniqueID>(
+                             nameTokenPtr->sourceFile().newID(UniqueID::Kind::FUNCTION))
                        : std::nullopt) {
 
   assert(nameTokenPtr != nullptr && "Name token can't be 'nullptr'.");
@@ -71,6 +73,16 @@ const Token& Function::tickKWToken() const {
   return *m_tickTokenPtr;
 }
 
+const TickSchedule& Function::tickSchedule() const {
+  assert(isTickFunc() && "bad call to 'tickSchedule()'.");
+  return m_tickSchedule;
+}
+
+void Function::setTickSchedule(const TickSchedule& tickSchedule) {
+  assert(isTickFunc() && "Setting the tick schedule of a function that isn't a tick function.");
+  m_tickSchedule = tickSchedule;
+}
+
 bool Function::isLoadFunc() const { return m_loadTokenPtr != nullptr; };
 
 const Token& Function::loadKWToken() const {
@@ -117,7 +129,7 @@ const statement::Scope& Function::definition() const {
 void Function::setDefinition(std::optional<statement::Scope>&& definition) {
   assert(!isDefined() && "Overriding non-null definition.");
   m_definition = std::move(definition);
-  m_functionID = UniqueID(UniqueID::Kind::FUNCTION);
+  m_functionID = nameToken().sourceFile().newID(UniqueID::Kind::FUNCTION);
 }
 
 UniqueID Function::functionID() const {
@@ -180,6 +192,13 @@ void FunctionTable::merge(Function&& newSymbol) {
         (existing.isTickFunc()) ? existing.tickKWToken() : existing.nameToken(),
         (newSymbol.isTickFunc()) ? newSymbol.tickKWToken() : newSymbol.nameToken());
   }
+  if (existing.isTickFunc() && existing.tickSchedule() != newSymbol.tickSchedule()) {
+    throw compile_error::DeclarationConflict(
+        "All declarations of function " + style_text::styleAsCode(existing.name()) +
+            " must have the same tick schedule (e.g. " + style_text::styleAsCode("tick(every 20)") +
+            ").",
+        existing.tickKWToken(), newSymbol.tickKWToken());
+  }
   if (existing.isLoadFunc() != newSymbol.isLoadFunc()) {
     throw compile_error::DeclarationConflict(
         "All declarations of function " + style_text::styleAsCode(existing.name()) +
@@ -216,6 +235,8 @@ void FunctionTable::merge(Function&& newSymbol) {
 void FunctionTable::clear() {
   m_symbolsVec.clear();
   m_indexMap.clear();
+  m_publicSymbolCount = 0;
+  m_exposedSymbolCount = 0;
 }
 
 size_t FunctionTable::size() const { return m_symbolsVec.size(); }
@@ -246,7 +267,10 @@ void UnresolvedFunctionNames::remove(const std::string& symbolName) {
 
 bool UnresolvedFunctionNames::empty() const { return m_symbolNames.size() == 0; }
 
-void UnresolvedFunctionNames::clear() { m_symbolNames.clear(); }
+void UnresolvedFunctionNames::clear() {
+  m_symbolNames.clear();
+  m_calledFunctionNameTokens.clear();
+}
 
 size_t UnresolvedFunctionNames::size() const { return m_symbolNames.size(); }
 
@@ -270,6 +294,19 @@ void UnresolvedFunctionNames::ensureTableIsEmpty() const {
   assert(false && "This point should never be reached");
 }
 
+void UnresolvedFunctionNames::ensureAllNamesAreIn(
+    const std::unordered_set<std::string>& resolvedNames) const {
+  // the tokens are in the order they appear in the file, so the first one that
+  // isn't resolved is the one that's reported
+  for (const Token* token : m_calledFunctionNameTokens) {
+    if (m_symbolNames.count(token->contents()) == 0 || resolvedNames.count(token->contents()))
+      continue;
+
+    throw compile_error::UnresolvedSymbol(
+        "Function " + style_text::styleAsCode(token->contents()) + " was never defined.", *token);
+  }
+}
+
 // FileWrite
 
 FileWrite::FileWrite(const Token* relativeOutPathTokenPtr, const Token* contentsTokenPtr)
@@ -343,7 +380,6 @@ size_t FileWriteTable::size() const { return m_symbolsVec.size(); }
 
 // Import
 
-/// \todo This could be optimized a lot by maybe using a hashset or hashmap idk.
 static const SourceFile& findSourceFileFromToken(const Token* importPathTokenPtr,
                                                  const SourceFiles& sourceFiles) {
   assert(importPathTokenPtr->kind() == Token::STRING && "File path must be of 'STRING' kind.");
@@ -351,23 +387,16 @@ static const SourceFile& findSourceFileFromToken(const Token* importPathTokenPtr
   const std::filesystem::path importPath =
       generateImportPath(filePathFromToken(importPathTokenPtr));
 
-  bool found = false;
-  const SourceFile* ret;
-
-  for (const SourceFile& sourceFile : sourceFiles) {
-    if (sourceFile.importPath() == importPath) {
-      if (found) {
-        throw compile_error::ImportError(
-            "Import failed because multiple source files share the import path " +
-                style_text::styleAsCode(importPath.string()) + '.',
-            *importPathTokenPtr);
-      }
+  const SourceFile* ret = nullptr;
+  const size_t matchCount = sourceFiles.findByImportPath(importPath, ret);
 
-      ret = &sourceFile;
-      found = true;
-    }
+  if (matchCount > 1) {
+    throw compile_error::ImportError(
+        "Import failed because multiple source files share the import path " +
+            style_text::styleAsCode(importPath.string()) + '.',
+        *importPathTokenPtr);
   }
-  if (!found) {
+  if (matchCount == 0) {
     throw compile_error::ImportError("Import failed because no source file has the import path " +
                                          style_text::styleAsCode(importPath.string()) + '.',
                                      *importPathTokenPtr);
@@ -9,7 +9,10 @@
 
 #include <compiler/compile_error.h>
 #include <compiler/fileToStr.h>
+#include <compiler/fnv1aHash.h>
+#include <compiler/pass_timing.h>
 #include <compiler/tokenization/Token.h>
+#include <compiler/tracing.h>
 
 #include <cli/style_text.h>
 
@@ -47,8 +50,17 @@ static size_t getLengthOfPossibleComment(const std::string& str, size_t i);
 } // namespace
 
 void SourceFile::tokenize() {
+  pass_timing::ScopedTimer timer(pass_timing::Pass::TOKENIZE);
+  TRACE_SPAN("tokenize");
+
   const std::string str = fileToStr(path());
 
+  std::vector<size_t> lineStarts = {0};
+  for (size_t i = 0; i < str.size(); i++) {
+    if (str[i] == '\n')
+      lineStarts.push_back(i + 1);
+  }
+
   std::vector<Token> ret;
 
   std::vector<helper::ClosingChar> closingCharStack;
@@ -250,6 +262,31 @@ void SourceFile::tokenize() {
 
   // modify source file
   m_tokens = std::move(ret);
+  m_lineStarts = std::move(lineStarts);
+  m_contentHash = fnv1aHash(str);
+
+  timer.addBytes(str.size());
+  timer.addTokens(m_tokens.size());
+}
+
+void SourceFile::copyTokensFrom(const SourceFile& other) {
+  pass_timing::ScopedTimer timer(pass_timing::Pass::TOKENIZE);
+  TRACE_SPAN("copy tokens");
+
+  // tokens can't just be copied because they refer to their source file
+  std::vector<Token> ret;
+  ret.reserve(other.m_tokens.size());
+  for (const Token& token : other.m_tokens) {
+    if (token.hasContents())
+      ret.emplace_back(token.kind(), token.indexInFile(), *this, token.contents());
+    else
+      ret.emplace_back(token.kind(), token.indexInFile(), *this);
+  }
+  m_tokens = std::move(ret);
+  m_lineStarts = other.m_lineStarts;
+  m_contentHash = other.m_contentHash;
+
+  timer.addTokens(m_tokens.size());
 }
 
 // ---------------------------------------------------------------------------//
@@ -0,0 +1,162 @@
+#include <compiler/tracing.h>
+
+#if defined(DO_TRACING)
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <compiler/generation/writeFileToDataPack.h>
+#include <compiler/json.h>
+
+namespace {
+
+struct Event {
+  const char* name;
+  std::string detail;
+  int64_t startNs;
+  int64_t durationNs;
+};
+
+/// Every span recorded on 1 thread (only that thread adds to it).
+struct ThreadEvents {
+  size_t threadID;
+  std::vector<Event> events;
+};
+
+std::atomic<bool> isTracing = false;
+std::filesystem::path traceOutputPath;
+std::chrono::steady_clock::time_point traceStartTime;
+
+/// Kept after the threads end so their spans can still be written.
+std::vector<std::unique_ptr<ThreadEvents>> allThreadEvents;
+std::mutex allThreadEventsMutex;
+
+thread_local ThreadEvents* currentThreadEvents = nullptr;
+
+namespace helper {
+
+/// The nanoseconds since \p tracing::start() was called.
+static int64_t nanosecondsSinceStart();
+
+/// The events of the calling thread (created the first time a thread asks).
+static ThreadEvents& threadEvents();
+
+/// Adds \param ns as microseconds (what the trace format uses) to \param str .
+static void appendMicroseconds(std::string& str, int64_t ns);
+
+} // namespace helper
+} // namespace
+
+void tracing::start(std::filesystem::path&& outputPath) {
+  traceOutputPath = std::move(outputPath);
+  traceStartTime = std::chrono::steady_clock::now();
+  isTracing = true;
+
+  // the main thread gets the first ID
+  helper::threadEvents();
+}
+
+bool tracing::isEnabled() { return isTracing; }
+
+void tracing::write() {
+  if (!isTracing)
+    return;
+
+  std::string contents = "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  bool isFirstEvent = true;
+  const auto startEvent = [&contents, &isFirstEvent]() {
+    contents += (isFirstEvent) ? "\n" : ",\n";
+    isFirstEvent = false;
+  };
+
+  std::lock_guard<std::mutex> lock(allThreadEventsMutex);
+  for (const std::unique_ptr<ThreadEvents>& threadEvents : allThreadEvents) {
+    // threads that ended before the last reset have nothing to show
+    if (threadEvents->events.empty() && threadEvents->threadID != 0)
+      continue;
+
+    const std::string threadID = std::to_string(threadEvents->threadID);
+    const std::string threadName =
+        (threadEvents->threadID == 0) ? "main" : "worker " + threadID;
+
+    startEvent();
+    contents += "{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": " + threadID +
+                ", \"args\": {\"name\": " + json::quote(threadName) + "}}";
+
+    for (const Event& event : threadEvents->events) {
+      startEvent();
+      contents += "{\"ph\": \"X\", \"name\": ";
+      contents += json::quote((event.detail.empty()) ? std::string(event.name)
+                                                     : event.name + (' ' + event.detail));
+      contents += ", \"pid\": 1, \"tid\": " + threadID + ", \"ts\": ";
+      helper::appendMicroseconds(contents, event.startNs);
+      contents += ", \"dur\": ";
+      helper::appendMicroseconds(contents, event.durationNs);
+      contents += '}';
+    }
+  }
+  contents += "\n]}\n";
+
+  writeFileToDataPack(traceOutputPath.parent_path(), traceOutputPath.filename(), contents);
+}
+
+void tracing::reset() {
+  // threads keep a pointer to their events so they're only emptied
+  std::lock_guard<std::mutex> lock(allThreadEventsMutex);
+  for (const std::unique_ptr<ThreadEvents>& threadEvents : allThreadEvents)
+    threadEvents->events.clear();
+  traceStartTime = std::chrono::steady_clock::now();
+}
+
+void tracing::stop() {
+  isTracing = false;
+  reset();
+  traceOutputPath.clear();
+}
+
+tracing::Span::Span(const char* name) : m_name(name), m_isActive(isTracing) {
+  if (m_isActive)
+    m_startNs = helper::nanosecondsSinceStart();
+}
+
+tracing::Span::~Span() {
+  if (!m_isActive)
+    return;
+
+  const int64_t endNs = helper::nanosecondsSinceStart();
+  helper::threadEvents().events.push_back(
+      {m_name, std::move(m_detail), m_startNs, endNs - m_startNs});
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static int64_t helper::nanosecondsSinceStart() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                              traceStartTime)
+      .count();
+}
+
+static ThreadEvents& helper::threadEvents() {
+  if (currentThreadEvents == nullptr) {
+    std::lock_guard<std::mutex> lock(allThreadEventsMutex);
+    allThreadEvents.push_back(std::make_unique<ThreadEvents>());
+    allThreadEvents.back()->threadID = allThreadEvents.size() - 1;
+    currentThreadEvents = allThreadEvents.back().get();
+  }
+  return *currentThreadEvents;
+}
+
+static void helper::appendMicroseconds(std::string& str, int64_t ns) {
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%lld.%03lld", static_cast<long long>(ns / 1000),
+                static_cast<long long>(ns % 1000));
+  str += buffer;
+}
+
+#endif
@@ -2,6 +2,8 @@
 
 #include <cassert>
 
+#include <compiler/SourceFiles.h>
+
 // UnlinkedTextSection
 
 // NOTE: We're really only passing in the kind to the contructor so it's more
@@ -99,7 +101,20 @@ void UnlinkedText::addUnlinkedNamespace() {
 
 // CompiledSourceFile
 
-CompiledSourceFile::CompiledSourceFile(SourceFile& sourceFile) : m_sourceFile(&sourceFile) {}
+const char* CompiledSourceFile::FuncFileOrigin::kindName() const {
+  switch (kind) {
+  case Kind::FUNCTION:
+    return "function";
+  case Kind::SCOPE:
+    return "scope";
+  case Kind::EXECUTE_GROUP:
+    return "execute group";
+  }
+  return "";
+}
+
+CompiledSourceFile::CompiledSourceFile(SourceFile& sourceFile)
+    : m_sourceFile(&sourceFile), m_sourceFilePath(sourceFile.path()) {}
 
 void CompiledSourceFile::addFileWrite(std::filesystem::path&& outPath,
                                       FuncFileWrite&& unlinkedFileWrite) {
@@ -110,6 +125,10 @@ void CompiledSourceFile::addFileWrite(std::filesystem::path&& outPath,
 const SourceFile& CompiledSourceFile::sourceFile() const { return *m_sourceFile; }
 SourceFile& CompiledSourceFile::sourceFile() { return *m_sourceFile; }
 
+const std::filesystem::path& CompiledSourceFile::sourceFilePath() const {
+  return m_sourceFilePath;
+}
+
 const CompiledSourceFile::FileWriteMap& CompiledSourceFile::unlinkedFileWrites() const {
   return m_unlinkedFileWriteMap;
 }
@@ -122,6 +141,14 @@ const std::vector<UnlinkedText>& CompiledSourceFile::tickFunctions() const {
 }
 std::vector<UnlinkedText>& CompiledSourceFile::tickFunctions() { return m_tickFunctions; }
 
+const std::vector<CompiledSourceFile::ScheduledTickFunc>&
+CompiledSourceFile::scheduledTickFunctions() const {
+  return m_scheduledTickFunctions;
+}
+std::vector<CompiledSourceFile::ScheduledTickFunc>& CompiledSourceFile::scheduledTickFunctions() {
+  return m_scheduledTickFunctions;
+}
+
 const std::vector<UnlinkedText>& CompiledSourceFile::loadFunctions() const {
   return m_loadFunctions;
 }
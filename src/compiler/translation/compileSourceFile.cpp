@@ -1,8 +1,19 @@
 #include <compiler/translation/compileSourceFile.h>
 
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <compiler/CompileOptions.h>
+#include <compiler/TickSchedule.h>
 #include <compiler/UniqueID.h>
+#include <compiler/pass_timing.h>
 #include <compiler/syntax_analysis/statement.h>
 #include <compiler/syntax_analysis/symbol.h>
+#include <compiler/tracing.h>
 #include <compiler/translation/CompiledSourceFile.h>
 #include <compiler/translation/constants.h>
 #include <version.h>
@@ -12,12 +23,100 @@ namespace helper {
 
 /// Compiles the scope as a new scope without a known name and returns the scope
 /// as an unlinked file write. Any unlinked file writes that are generated as a
-/// result of any sub-scopes are added to \param ret.
-static UnlinkedText compileScope(const statement::Scope& scope, CompiledSourceFile& ret);
+/// result of any sub-scopes are added to \param ret. \param function is the
+/// function the scope is in and \param fileID is the ID of the function file
+/// the scope is written to.
+static UnlinkedText compileScope(const statement::Scope& scope, const symbol::Function& function,
+                                 UniqueID fileID, CompiledSourceFile& ret,
+                                 const CompileOptions& compileOptions);
+
+/// Compiles a single statement from a scope in \param function, adding its text
+/// to \param resultFileWrite. Any unlinked file writes that are generated as a
+/// result of any sub-scopes are added to \param ret. \param chainStoresResult
+/// should be true if the statement is run by a command that stores its result.
+static void compileStatement(const statement::Generic* stmntPtr, bool chainStoresResult,
+                             const symbol::Function& function, UnlinkedText& resultFileWrite,
+                             CompiledSourceFile& ret, const CompileOptions& compileOptions);
 
 /// Compiles the function's scope as using it's expose address if known. Adds
 /// the unlinked file write to ret, along with any sub-scopes.
-static void compileFunction(const symbol::Function& function, CompiledSourceFile& ret);
+static void compileFunction(const symbol::Function& function, CompiledSourceFile& ret,
+                            const CompileOptions& compileOptions);
+
+/// Returns the only statement in \param scope if the scope can be replaced by
+/// that statement without changing what it does, otherwise \p nullptr is
+/// returned (the scope needs its own function file).
+static const statement::Generic* inlinableScopeStatement(const statement::Scope& scope,
+                                                         const std::vector<Token>& tokens);
+
+/// Whether a command has a 'store' argument (e.g. 'execute store result ...').
+/// The result of running a function is different from the result of running
+/// the command inside of it, so what a command like this runs can't be
+/// inlined.
+static bool commandStoresResult(const std::string& commandContents);
+
+/// Whether a command is a macro line (starts with '$') or could return from
+/// the function it's in (e.g. 'return 1' or 'execute if ... run return 1').
+/// Moving a command like this out of its scope's function could change what it
+/// does.
+static bool commandCantBeInlined(const std::string& commandContents);
+
+/// Returns the modifiers of an execute command that runs something (e.g.
+/// "as @e at @s" for '/execute as @e at @s run say hi;') if the statement is a
+/// command that can be moved into a function run behind those modifiers,
+/// otherwise an empty string is returned. Modifiers that store a result or
+/// check a condition are never returned since running the commands behind
+/// them together could change what they do. Modifiers that aren't fixed (see
+/// \p prefixIsFixed() ) are only returned for commands that just print
+/// something (see \p commandOnlyPrints() ).
+static std::string factorableExecutePrefix(const statement::Generic& stmnt,
+                                           const std::vector<Token>& tokens);
+
+/// Whether the execute modifiers \param prefix only use the executing entity
+/// ('as @s') and fixed positions, rotations, and dimensions, so that no
+/// command run behind them can change what they do.
+static bool prefixIsFixed(const std::string& prefix);
+
+/// Whether a command only prints something (e.g. 'say' or 'particle'), so it
+/// can't change which entities a selector finds or what other commands do.
+static bool commandOnlyPrints(const std::string& commandContents);
+
+/// Returns the index of the space before the first 'run' argument in
+/// \param commandContents that isn't inside of quotes or brackets (or
+/// \p std::string::npos). Commands followed by 'run:' end with a 'run'
+/// argument.
+static size_t findTopLevelRunArg(const std::string& commandContents);
+
+/// Adds what a command with an execute prefix of length \param prefixSize runs
+/// (everything after 'execute <prefix> run') to \param resultFileWrite.
+static void compileExecutePrefixBody(const statement::Command& command, size_t prefixSize,
+                                     const symbol::Function& function,
+                                     UnlinkedText& resultFileWrite, CompiledSourceFile& ret,
+                                     const CompileOptions& compileOptions);
+
+/// Adds a command to \param resultFileWrite that adds 1 to the counter for the
+/// function file \param fileID on the '--instrument' scoreboard.
+static void addProfileCounter(UniqueID fileID, const SourceFile& sourceFile,
+                              UnlinkedText& resultFileWrite);
+
+/// Returns where the function file \param fileID came from given the token its
+/// code starts at.
+static CompiledSourceFile::FuncFileOrigin funcFileOrigin(
+    CompiledSourceFile::FuncFileOrigin::Kind kind, UniqueID fileID,
+    const symbol::Function& function, const Token& firstToken);
+
+/// Sets the line and column of every file write's origin in \param ret from
+/// its index in the source file.
+static void setFuncFileOriginLines(CompiledSourceFile& ret);
+
+/// Adds the hidden namespace (e.g. "zzz__.foo") given the source file.
+static void addHiddenNamespaceToUnlinkedText(const SourceFile& sourceFile,
+                                             UnlinkedText& unlinkedText);
+
+/// Adds the call name for a scope's function file (e.g.
+/// "zzz__.foo:w_00000_0002b") given the scope's ID and source file.
+static void addScopeFuncNameToUnlinkedText(UniqueID scopeID, const SourceFile& sourceFile,
+                                           UnlinkedText& funcCallName);
 
 /// Adds the text/unlinked elements for a function call given the function
 /// symbol and source file. \param funcCallName is an output.
@@ -27,14 +126,18 @@ static void addFuncNameToUnlinkedText(const symbol::Function& function,
 } // namespace helper
 } // namespace
 
-CompiledSourceFile compileSourceFile(SourceFile& sourceFile) {
+CompiledSourceFile compileSourceFile(SourceFile& sourceFile, const CompileOptions& compileOptions) {
+  pass_timing::ScopedTimer timer(pass_timing::Pass::TRANSLATE);
+  TRACE_SPAN("translate");
+  timer.addTokens(sourceFile.tokens().size());
+
   CompiledSourceFile ret(sourceFile);
   for (const symbol::Function& func : sourceFile.functionSymbolTable()) {
     // skip externally defined functions
     if (!func.isDefined())
       continue;
 
-    helper::compileFunction(func, ret);
+    helper::compileFunction(func, ret, compileOptions);
 
     if (!func.isTickFunc() && !func.isLoadFunc())
       continue;
@@ -43,14 +146,20 @@ CompiledSourceFile compileSourceFile(SourceFile& sourceFile) {
     helper::addFuncNameToUnlinkedText(func, sourceFile, funcCallName);
 
     if (func.isTickFunc()) {
-      if (func.isLoadFunc())
-        ret.tickFunctions().emplace_back(funcCallName);
+      UnlinkedText tickFuncCallName = (func.isLoadFunc()) ? funcCallName : std::move(funcCallName);
+      if (func.tickSchedule().kind == TickSchedule::Kind::EVERY_TICK)
+        ret.tickFunctions().emplace_back(std::move(tickFuncCallName));
       else
-        ret.tickFunctions().emplace_back(std::move(funcCallName));
+        ret.scheduledTickFunctions().push_back({std::move(tickFuncCallName), func.tickSchedule()});
     }
     if (func.isLoadFunc())
       ret.loadFunctions().emplace_back(std::move(funcCallName));
   }
+
+  if ((compileOptions.instrument || compileOptions.generateSourceMap) &&
+      !ret.unlinkedFileWrites().empty())
+    helper::setFuncFileOriginLines(ret);
+
   return ret;
 }
 
@@ -58,75 +167,139 @@ CompiledSourceFile compileSourceFile(SourceFile& sourceFile) {
 // Helper function definitions beyond this point.
 // ---------------------------------------------------------------------------//
 
-static UnlinkedText helper::compileScope(const statement::Scope& scope, CompiledSourceFile& ret) {
+static UnlinkedText helper::compileScope(const statement::Scope& scope,
+                                        const symbol::Function& function, UniqueID fileID,
+                                        CompiledSourceFile& ret,
+                                        const CompileOptions& compileOptions) {
   UnlinkedText resultFileWrite;
   resultFileWrite.addText("# " MCFUNC_BUILD_INFO_MSG "\n\n");
 
-  for (const std::unique_ptr<statement::Generic>& stmntUPtr : scope.statements()) {
-    const statement::Generic* stmntPtr = stmntUPtr.get();
+  if (compileOptions.instrument)
+    helper::addProfileCounter(fileID, ret.sourceFile(), resultFileWrite);
 
-  statementKindSwitchStart:
-    switch (stmntPtr->kind()) {
-    case statement::Kind::SCOPE: {
-      UniqueID funcID(UniqueID::Kind::SCOPE_FILE_WRITE);
-      resultFileWrite.addText("function ");
-      resultFileWrite.addText(hiddenNamespacePrefix);
-      if (ret.sourceFile().namespaceExposeSymbol().isSet())
-        resultFileWrite.addText(ret.sourceFile().namespaceExposeSymbol().exposedNamespace());
-      else
-        resultFileWrite.addUnlinkedNamespace();
-      resultFileWrite.addText(':');
-      resultFileWrite.addText(funcID.str());
-      resultFileWrite.addText('\n');
+  const std::vector<std::unique_ptr<statement::Generic>>& statements = scope.statements();
+  const std::vector<Token>& tokens = ret.sourceFile().tokens();
 
-      ret.addFileWrite(
-          funcSubFolder / (std::string(funcID.str()) + funcFileExt),
-          {compileScope(*reinterpret_cast<const statement::Scope*>(stmntPtr), ret), true});
-    } break;
+  for (size_t i = 0; i < statements.size(); i++) {
+    // Adjacent commands that share the same execute prefix are moved into a
+    // function that is run behind that prefix once (so the prefix is only
+    // evaluated once instead of once per command).
+    if (compileOptions.factorExecutePrefixes) {
+      const std::string prefix = helper::factorableExecutePrefix(*statements[i], tokens);
+      size_t groupEnd = i + 1;
+      while (!prefix.empty() && groupEnd < statements.size() &&
+             helper::factorableExecutePrefix(*statements[groupEnd], tokens) == prefix)
+        groupEnd++;
 
-    case statement::Kind::COMMAND: {
-      const statement::Command& command = *reinterpret_cast<const statement::Command*>(stmntPtr);
-      resultFileWrite.addText(ret.sourceFile().tokens()[command.firstTokenIndex()].contents());
-      if (!command.hasStatementAfterRun()) {
+      if (groupEnd - i >= 2) {
+        const UniqueID funcID = ret.sourceFile().newID(UniqueID::Kind::SCOPE_FILE_WRITE);
+
+        UnlinkedText groupFileWrite;
+        groupFileWrite.addText("# " MCFUNC_BUILD_INFO_MSG "\n\n");
+        if (compileOptions.instrument)
+          helper::addProfileCounter(funcID, ret.sourceFile(), groupFileWrite);
+        CompiledSourceFile::FuncFileOrigin groupOrigin = helper::funcFileOrigin(
+            CompiledSourceFile::FuncFileOrigin::Kind::EXECUTE_GROUP, funcID, function,
+            tokens[statements[i]->firstTokenIndex()]);
+        for (; i < groupEnd; i++) {
+          helper::compileExecutePrefixBody(
+              *reinterpret_cast<const statement::Command*>(statements[i].get()), prefix.size(),
+              function, groupFileWrite, ret, compileOptions);
+        }
+        i--;
+
+        resultFileWrite.addText("execute " + prefix + " run function ");
+        helper::addScopeFuncNameToUnlinkedText(funcID, ret.sourceFile(), resultFileWrite);
         resultFileWrite.addText('\n');
-        break;
+
+        ret.addFileWrite(funcSubFolder / (std::string(funcID.str()) + funcFileExt),
+                         {std::move(groupFileWrite), true, std::move(groupOrigin)});
+        continue;
       }
-      // handle sub-statements of commands by reassigning the statement and
-      /// re-entering the switch statement
-      resultFileWrite.addText(" \\\n\t");
-      stmntPtr = reinterpret_cast<const statement::Generic*>(command.statementAfterRun().get());
-      goto statementKindSwitchStart;
     }
 
-    case statement::Kind::FUNCTION_CALL: {
-      resultFileWrite.addText("function ");
-
-      const Token& funcNameToken =
-          ret.sourceFile().tokens()[reinterpret_cast<const statement::FunctionCall*>(stmntPtr)
-                                        ->firstTokenIndex()];
-
-      // see if this is a function defined here
-      const symbol::FunctionTable& funcTable = ret.sourceFile().functionSymbolTable();
-      if (funcTable.hasSymbol(funcNameToken.contents())) {
-        const symbol::Function& func = funcTable.getSymbol(funcNameToken.contents());
-        if (func.isDefined())
-          helper::addFuncNameToUnlinkedText(func, ret.sourceFile(), resultFileWrite);
-        else
-          goto funcNotFound;
-      } else {
-      funcNotFound:
-        resultFileWrite.addUnlinkedFunction(&funcNameToken);
+    helper::compileStatement(statements[i].get(), false, function, resultFileWrite, ret,
+                             compileOptions);
+  }
+
+  return resultFileWrite;
+}
+
+static void helper::compileStatement(const statement::Generic* stmntPtr, bool chainStoresResult,
+                                     const symbol::Function& function,
+                                     UnlinkedText& resultFileWrite, CompiledSourceFile& ret,
+                                     const CompileOptions& compileOptions) {
+statementKindSwitchStart:
+  switch (stmntPtr->kind()) {
+  case statement::Kind::SCOPE: {
+    // scopes with 1 statement can just be that statement (the scope's
+    // statement is compiled in place by re-entering the switch statement)
+    if (compileOptions.inlineTrivialScopes && !chainStoresResult) {
+      const statement::Generic* inlinedStmntPtr = helper::inlinableScopeStatement(
+          *reinterpret_cast<const statement::Scope*>(stmntPtr), ret.sourceFile().tokens());
+      if (inlinedStmntPtr != nullptr) {
+        stmntPtr = inlinedStmntPtr;
+        goto statementKindSwitchStart;
       }
+    }
+
+    const UniqueID funcID = ret.sourceFile().newID(UniqueID::Kind::SCOPE_FILE_WRITE);
+    resultFileWrite.addText("function ");
+    helper::addScopeFuncNameToUnlinkedText(funcID, ret.sourceFile(), resultFileWrite);
+    resultFileWrite.addText('\n');
+
+    const statement::Scope& scope = *reinterpret_cast<const statement::Scope*>(stmntPtr);
+    ret.addFileWrite(funcSubFolder / (std::string(funcID.str()) + funcFileExt),
+                     {compileScope(scope, function, funcID, ret, compileOptions), true,
+                      helper::funcFileOrigin(CompiledSourceFile::FuncFileOrigin::Kind::SCOPE,
+                                             funcID, function,
+                                             ret.sourceFile().tokens()[scope.firstTokenIndex()])});
+  } break;
 
+  case statement::Kind::COMMAND: {
+    const statement::Command& command = *reinterpret_cast<const statement::Command*>(stmntPtr);
+    const std::string& commandContents =
+        ret.sourceFile().tokens()[command.firstTokenIndex()].contents();
+    resultFileWrite.addText(commandContents);
+    if (!command.hasStatementAfterRun()) {
       resultFileWrite.addText('\n');
-    } break;
+      break;
     }
+    chainStoresResult = chainStoresResult || helper::commandStoresResult(commandContents);
+    // handle sub-statements of commands by reassigning the statement and
+    /// re-entering the switch statement
+    resultFileWrite.addText(" \\\n\t");
+    stmntPtr = reinterpret_cast<const statement::Generic*>(command.statementAfterRun().get());
+    goto statementKindSwitchStart;
   }
 
-  return resultFileWrite;
+  case statement::Kind::FUNCTION_CALL: {
+    resultFileWrite.addText("function ");
+
+    const Token& funcNameToken =
+        ret.sourceFile().tokens()[reinterpret_cast<const statement::FunctionCall*>(stmntPtr)
+                                      ->firstTokenIndex()];
+
+    // see if this is a function defined here
+    const symbol::FunctionTable& funcTable = ret.sourceFile().functionSymbolTable();
+    if (funcTable.hasSymbol(funcNameToken.contents())) {
+      const symbol::Function& func = funcTable.getSymbol(funcNameToken.contents());
+      if (func.isDefined())
+        helper::addFuncNameToUnlinkedText(func, ret.sourceFile(), resultFileWrite);
+      else
+        goto funcNotFound;
+    } else {
+    funcNotFound:
+      resultFileWrite.addUnlinkedFunction(&funcNameToken);
+    }
+
+    resultFileWrite.addText('\n');
+  } break;
+  }
 }
 
-static void helper::compileFunction(const symbol::Function& function, CompiledSourceFile& ret) {
+static void helper::compileFunction(const symbol::Function& function, CompiledSourceFile& ret,
+                                    const CompileOptions& compileOptions) {
   assert(function.isDefined() && "can't compile a function that isn't defined");
 
   std::filesystem::path path = funcSubFolder;
@@ -140,7 +313,273 @@ static void helper::compileFunction(const symbol::Function& function, CompiledSo
   }
   path.concat(funcFileExt);
   ret.addFileWrite(std::move(path),
-                   {compileScope(function.definition(), ret), belongsInHiddenNamespace});
+                   {compileScope(function.definition(), function, function.functionID(), ret,
+                                 compileOptions),
+                    belongsInHiddenNamespace,
+                    helper::funcFileOrigin(CompiledSourceFile::FuncFileOrigin::Kind::FUNCTION,
+                                           function.functionID(), function, function.nameToken())});
+}
+
+static const statement::Generic* helper::inlinableScopeStatement(const statement::Scope& scope,
+                                                                 const std::vector<Token>& tokens) {
+  if (scope.statements().size() != 1)
+    return nullptr;
+
+  // Follow the statement through any commands it runs to make sure nothing that
+  // would end up in this scope's place can't be inlined. Scopes that won't be
+  // inlined themselves get their own function file, so what's inside of them
+  // doesn't matter.
+  const statement::Generic* stmntPtr = scope.statements().front().get();
+  while (true) {
+    switch (stmntPtr->kind()) {
+    case statement::Kind::FUNCTION_CALL:
+      return scope.statements().front().get();
+
+    case statement::Kind::SCOPE: {
+      const statement::Generic* innerStmntPtr =
+          inlinableScopeStatement(*reinterpret_cast<const statement::Scope*>(stmntPtr), tokens);
+      if (innerStmntPtr == nullptr)
+        return scope.statements().front().get();
+      stmntPtr = innerStmntPtr;
+    } break;
+
+    case statement::Kind::COMMAND: {
+      const statement::Command& command = *reinterpret_cast<const statement::Command*>(stmntPtr);
+      const std::string& commandContents = tokens[command.firstTokenIndex()].contents();
+      if (helper::commandCantBeInlined(commandContents))
+        return nullptr;
+      if (!command.hasStatementAfterRun())
+        return scope.statements().front().get();
+      // a scope after a command that stores its result won't be inlined
+      if (helper::commandStoresResult(commandContents))
+        return scope.statements().front().get();
+      stmntPtr = command.statementAfterRun().get();
+    } break;
+    }
+  }
+}
+
+static bool helper::commandStoresResult(const std::string& commandContents) {
+  // whitespace in commands has already been reduced to single spaces
+  return (' ' + commandContents + ' ').find(" store ") != std::string::npos;
+}
+
+static bool helper::commandCantBeInlined(const std::string& commandContents) {
+  if (!commandContents.empty() && commandContents[0] == '$')
+    return true;
+  return (' ' + commandContents + ' ').find(" return ") != std::string::npos;
+}
+
+static std::string helper::factorableExecutePrefix(const statement::Generic& stmnt,
+                                                   const std::vector<Token>& tokens) {
+  constexpr std::string_view executeStr = "execute ";
+
+  if (stmnt.kind() != statement::Kind::COMMAND)
+    return "";
+  const statement::Command& command = *reinterpret_cast<const statement::Command*>(&stmnt);
+  const std::string& commandContents = tokens[command.firstTokenIndex()].contents();
+
+  if (commandContents.compare(0, executeStr.size(), executeStr) != 0)
+    return "";
+
+  // the prefix ends at the first 'run' argument
+  const size_t runIndex = helper::findTopLevelRunArg(commandContents);
+  if (runIndex == std::string::npos || runIndex < executeStr.size())
+    return "";
+  const std::string prefix =
+      commandContents.substr(executeStr.size(), runIndex - executeStr.size());
+
+  const std::string paddedPrefix = ' ' + prefix + ' ';
+  if (paddedPrefix.find(" store ") != std::string::npos ||
+      paddedPrefix.find(" if ") != std::string::npos ||
+      paddedPrefix.find(" unless ") != std::string::npos)
+    return "";
+
+  // Nothing that ends up in the new function can return from (or be a macro
+  // line of) the function it was written in. Scopes and function calls get
+  // their own function so what's inside of them doesn't matter.
+  const statement::Generic* stmntPtr = &stmnt;
+  while (stmntPtr->kind() == statement::Kind::COMMAND) {
+    const statement::Command& chainCommand =
+        *reinterpret_cast<const statement::Command*>(stmntPtr);
+    if (helper::commandCantBeInlined(tokens[chainCommand.firstTokenIndex()].contents()))
+      return "";
+    if (!chainCommand.hasStatementAfterRun())
+      break;
+    stmntPtr = chainCommand.statementAfterRun().get();
+  }
+
+  // Other modifiers (e.g. 'as @e[tag=x]') are evaluated once for the whole
+  // group instead of once per command, and each entity runs every command
+  // before the next one runs any of them. A command like 'tag @s remove x'
+  // would change which entities the next command runs for, so only commands
+  // that can't change anything are factored behind them.
+  if (helper::prefixIsFixed(prefix))
+    return prefix;
+
+  // what's run is either the rest of the command or the command after 'run:'
+  constexpr std::string_view runStr = " run ";
+  std::string runContents;
+  if (commandContents.size() > runIndex + runStr.size())
+    runContents = commandContents.substr(runIndex + runStr.size());
+  else if (command.hasStatementAfterRun() &&
+           command.statementAfterRun()->kind() == statement::Kind::COMMAND)
+    runContents = tokens[command.statementAfterRun()->firstTokenIndex()].contents();
+
+  return helper::commandOnlyPrints(runContents) ? prefix : "";
+}
+
+static bool helper::prefixIsFixed(const std::string& prefix) {
+  // whitespace in commands has already been reduced to single spaces
+  std::vector<std::string_view> args;
+  for (size_t start = 0; start < prefix.size();) {
+    const size_t end = std::min(prefix.find(' ', start), prefix.size());
+    args.push_back(std::string_view(prefix).substr(start, end - start));
+    start = end + 1;
+  }
+
+  for (size_t i = 0; i < args.size();) {
+    const std::string_view modifier = args[i];
+    const std::string_view firstArg = (i + 1 < args.size()) ? args[i + 1] : std::string_view();
+
+    // how many arguments the modifier takes
+    size_t argCount;
+    if (modifier == "as" && firstArg == "@s")
+      argCount = 1;
+    else if (modifier == "anchored" || modifier == "align" || modifier == "in")
+      argCount = 1;
+    else if (modifier == "rotated" && firstArg != "as")
+      argCount = 2;
+    else if ((modifier == "positioned" && firstArg != "as" && firstArg != "over") ||
+             (modifier == "facing" && firstArg != "entity"))
+      argCount = 3;
+    else
+      return false;
+
+    i += 1 + argCount;
+  }
+  return true;
+}
+
+static bool helper::commandOnlyPrints(const std::string& commandContents) {
+  constexpr std::string_view printCommands[] = {
+      "say", "tellraw", "title", "particle", "playsound", "stopsound",
+      "me",  "msg",     "tell",  "w",        "teammsg",   "tm"};
+  const std::string_view name =
+      std::string_view(commandContents).substr(0, commandContents.find(' '));
+  return std::find(std::begin(printCommands), std::end(printCommands), name) !=
+         std::end(printCommands);
+}
+
+static size_t helper::findTopLevelRunArg(const std::string& commandContents) {
+  constexpr std::string_view runStr = " run";
+
+  size_t depth = 0;
+  for (size_t i = 0; i < commandContents.size(); i++) {
+    switch (commandContents[i]) {
+    case '(':
+    case '[':
+    case '{':
+      depth++;
+      break;
+    case ')':
+    case ']':
+    case '}':
+      if (depth != 0)
+        depth--;
+      break;
+
+    // skip over strings (escaped characters can't end them)
+    case '"':
+    case '\'': {
+      const char quote = commandContents[i];
+      for (i++; i < commandContents.size() && commandContents[i] != quote; i++) {
+        if (commandContents[i] == '\\')
+          i++;
+      }
+    } break;
+
+    case ' ':
+      if (depth == 0 && commandContents.compare(i, runStr.size(), runStr) == 0 &&
+          (i + runStr.size() == commandContents.size() ||
+           commandContents[i + runStr.size()] == ' '))
+        return i;
+      break;
+    }
+  }
+  return std::string::npos;
+}
+
+static void helper::compileExecutePrefixBody(const statement::Command& command, size_t prefixSize,
+                                             const symbol::Function& function,
+                                             UnlinkedText& resultFileWrite,
+                                             CompiledSourceFile& ret,
+                                             const CompileOptions& compileOptions) {
+  constexpr size_t executeStrSize = std::string_view("execute ").size();
+  constexpr size_t runStrSize = std::string_view(" run ").size();
+
+  const std::string& commandContents =
+      ret.sourceFile().tokens()[command.firstTokenIndex()].contents();
+
+  // '/execute <prefix> run: ...' just runs the statement after 'run:'
+  if (commandContents.size() < executeStrSize + prefixSize + runStrSize) {
+    helper::compileStatement(command.statementAfterRun().get(), false, function, resultFileWrite,
+                             ret, compileOptions);
+    return;
+  }
+
+  const std::string rest = commandContents.substr(executeStrSize + prefixSize + runStrSize);
+  resultFileWrite.addText(rest);
+  if (!command.hasStatementAfterRun()) {
+    resultFileWrite.addText('\n');
+    return;
+  }
+  resultFileWrite.addText(" \\\n\t");
+  helper::compileStatement(command.statementAfterRun().get(), helper::commandStoresResult(rest),
+                           function, resultFileWrite, ret, compileOptions);
+}
+
+static void helper::addProfileCounter(UniqueID fileID, const SourceFile& sourceFile,
+                                      UnlinkedText& resultFileWrite) {
+  resultFileWrite.addText(std::string("scoreboard players add #") + fileID.str() + ' ');
+  helper::addHiddenNamespaceToUnlinkedText(sourceFile, resultFileWrite);
+  resultFileWrite.addText(std::string(profileObjectiveSuffix) + " 1\n");
+}
+
+static CompiledSourceFile::FuncFileOrigin helper::funcFileOrigin(
+    CompiledSourceFile::FuncFileOrigin::Kind kind, UniqueID fileID,
+    const symbol::Function& function, const Token& firstToken) {
+  return {kind, fileID.str(), function.name(), firstToken.indexInFile()};
+}
+
+static void helper::setFuncFileOriginLines(CompiledSourceFile& ret) {
+  const std::vector<size_t>& lineStarts = ret.sourceFile().lineStarts();
+  assert(!lineStarts.empty() && "the source file should have been tokenized");
+
+  for (auto& [relativePath, funcFileWrite] : ret.unlinkedFileWrites()) {
+    CompiledSourceFile::FuncFileOrigin& origin = funcFileWrite.origin;
+    const auto lineEnd =
+        std::upper_bound(lineStarts.begin(), lineStarts.end(), origin.indexInFile);
+    origin.line = static_cast<size_t>(lineEnd - lineStarts.begin());
+    origin.column = origin.indexInFile - *(lineEnd - 1) + 1;
+  }
+}
+
+static void helper::addHiddenNamespaceToUnlinkedText(const SourceFile& sourceFile,
+                                                     UnlinkedText& unlinkedText) {
+  unlinkedText.addText(hiddenNamespacePrefix);
+
+  if (sourceFile.namespaceExposeSymbol().isSet())
+    unlinkedText.addText(sourceFile.namespaceExposeSymbol().exposedNamespace());
+  else
+    unlinkedText.addUnlinkedNamespace();
+}
+
+static void helper::addScopeFuncNameToUnlinkedText(UniqueID scopeID, const SourceFile& sourceFile,
+                                                   UnlinkedText& funcCallName) {
+  helper::addHiddenNamespaceToUnlinkedText(sourceFile, funcCallName);
+  funcCallName.addText(':');
+  funcCallName.addText(scopeID.str());
 }
 
 static void helper::addFuncNameToUnlinkedText(const symbol::Function& function,
@@ -13,3 +13,17 @@ const std::filesystem::path tickFuncTagPath =
 
 const std::filesystem::path loadFuncTagPath =
     std::filesystem::path(sharedNamespace) / "tags" / funcSubFolder / "load.json";
+
+const char* const tickScheduleFuncName = "tick_schedule";
+
+const char* const tickScheduleLoadFuncName = "tick_schedule_load";
+
+const char* const profileObjectiveSuffix = ".profile";
+
+const char* const profileLoadFuncName = "profile_load";
+
+const char* const profileDumpFuncName = "profile_dump";
+
+const char* const profileResetFuncName = "profile_reset";
+
+const char* const profileMapFileName = "profile_map.json";
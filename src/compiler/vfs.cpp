@@ -0,0 +1,660 @@
+#include <compiler/vfs.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <compiler/Jobserver.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <unistd.h>
+#endif
+
+using namespace vfs;
+
+namespace {
+namespace helper {
+
+/// Whether \param path is \param directory or is inside of it (both must be
+/// absolute and normal).
+static bool isInside(const std::filesystem::path& path, const std::filesystem::path& directory);
+
+/// \param path as an absolute and normal path without a trailing separator.
+static std::filesystem::path absoluteNormal(const std::filesystem::path& path);
+
+/// Reads the entries directly inside of \param directory on the disk, adding
+/// files to \param files and directories to \param subdirectories (unless
+/// \param filter rejects them). Symlinks to directories aren't followed.
+static bool readDiskDirectory(const std::filesystem::path& directory, const ListFilter& filter,
+                              std::vector<DirectoryEntry>& files,
+                              std::vector<std::filesystem::path>& subdirectories);
+
+/// Whether \param directory (inside of \param root ) and every directory
+/// between them is accepted by \param filter . Answers are saved in
+/// \param acceptedDirectories .
+static bool isDirectoryListed(
+    const std::filesystem::path& directory, const std::filesystem::path& root,
+    const ListFilter& filter,
+    std::unordered_map<std::filesystem::path, bool>& acceptedDirectories);
+
+/// Sorts the entries in \param entries from \param firstIndex onwards by path.
+static void sortEntries(std::vector<DirectoryEntry>& entries, size_t firstIndex);
+
+/// Copies the file at \param from to \param to on the disk without reading it
+/// into memory (see \p vfs::copyFile() ).
+static bool copyDiskFile(const std::filesystem::path& from, const std::filesystem::path& to);
+
+} // namespace helper
+
+/// Every mounted directory and its file system.
+struct MountTable {
+  std::mutex mutex;
+  std::map<std::filesystem::path, std::shared_ptr<FileSystem>> mounts;
+};
+
+/// The number of mounts (checked before locking so that paths on the disk
+/// don't pay for the lock when nothing is mounted).
+std::atomic<size_t> mountCount = 0;
+
+MountTable& mountTable() {
+  static MountTable ret;
+  return ret;
+}
+
+std::shared_ptr<FileSystem> disk() {
+  static const std::shared_ptr<FileSystem> ret = std::make_shared<DiskFileSystem>();
+  return ret;
+}
+
+/// The mounted file system that handles \param path (or \p nullptr ).
+/// \param path must be absolute and normal.
+std::shared_ptr<FileSystem> mountedFileSystemFor(const std::filesystem::path& path) {
+  if (mountCount == 0)
+    return nullptr;
+
+  MountTable& table = mountTable();
+  std::lock_guard lock(table.mutex);
+  const std::pair<const std::filesystem::path, std::shared_ptr<FileSystem>>* innermost = nullptr;
+  for (const auto& mount : table.mounts) {
+    if (helper::isInside(path, mount.first) &&
+        (!innermost || helper::isInside(mount.first, innermost->first)))
+      innermost = &mount;
+  }
+  return (innermost) ? innermost->second : nullptr;
+}
+
+} // namespace
+
+// DiskFileSystem
+
+bool DiskFileSystem::readFile(const std::filesystem::path& path, std::string& contents) const {
+  if (!isRegularFile(path))
+    return false;
+
+  std::ifstream file(path);
+  if (!file.is_open())
+    return false;
+
+  contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return !file.bad();
+}
+
+bool DiskFileSystem::writeFile(const std::filesystem::path& path, const std::string& contents) {
+  std::ofstream file(path, std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!file.is_open() || !file.good())
+    return false;
+
+  file << contents;
+  return file.good();
+}
+
+bool DiskFileSystem::isRegularFile(const std::filesystem::path& path) const {
+  std::error_code ec;
+  return std::filesystem::is_regular_file(path, ec) && !ec;
+}
+
+bool DiskFileSystem::isDirectory(const std::filesystem::path& path) const {
+  std::error_code ec;
+  return std::filesystem::is_directory(path, ec) && !ec;
+}
+
+bool DiskFileSystem::createDirectories(const std::filesystem::path& path) {
+  std::error_code ec;
+  std::filesystem::create_directories(path, ec);
+  return !ec;
+}
+
+bool DiskFileSystem::removeAll(const std::filesystem::path& path) {
+  std::error_code ec;
+  std::filesystem::remove_all(path, ec);
+  return !ec;
+}
+
+bool DiskFileSystem::listFiles(const std::filesystem::path& directory,
+                               std::vector<DirectoryEntry>& entries,
+                               const ListFilter& filter) const {
+  if (!isDirectory(directory))
+    return false;
+
+  // Each thread takes a directory from the queue, reads it, and adds the
+  // directories inside of it to the queue. Threads stop once the queue is empty
+  // and no other thread is reading a directory. Only this thread runs at first,
+  // another one is started whenever there are more directories in the queue
+  // than idle threads to read them (up to 1 thread per core, and only with a
+  // token if there's a make jobserver).
+  std::mutex mutex;
+  std::condition_variable queueChanged;
+  std::vector<std::filesystem::path> queue = {directory};
+  size_t readingCount = 0;
+  size_t idleCount = 0;
+  bool failed = false;
+
+  const size_t maxThreadCount = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::vector<DirectoryEntry>> threadEntries(maxThreadCount);
+  std::vector<std::thread> extraThreads;
+  extraThreads.reserve(maxThreadCount - 1);
+  Jobserver jobserver;
+
+  std::function<void(size_t)> walk = [&](size_t threadIndex) {
+    std::vector<std::filesystem::path> subdirectories;
+    std::unique_lock lock(mutex);
+    while (true) {
+      idleCount++;
+      queueChanged.wait(lock, [&]() { return !queue.empty() || readingCount == 0; });
+      idleCount--;
+      if (queue.empty())
+        return;
+      const std::filesystem::path current = std::move(queue.back());
+      queue.pop_back();
+      readingCount++;
+      lock.unlock();
+
+      subdirectories.clear();
+      const bool didRead =
+          helper::readDiskDirectory(current, filter, threadEntries[threadIndex], subdirectories);
+
+      lock.lock();
+      readingCount--;
+      failed = failed || !didRead;
+      for (std::filesystem::path& subdirectory : subdirectories)
+        queue.push_back(std::move(subdirectory));
+
+      if (queue.size() > idleCount && extraThreads.size() + 1 < maxThreadCount &&
+          (!jobserver.isConnected() || jobserver.tryAcquire())) {
+        extraThreads.emplace_back([&walk, &jobserver, index = extraThreads.size() + 1]() {
+          walk(index);
+          if (jobserver.isConnected())
+            jobserver.release();
+        });
+      }
+      queueChanged.notify_all();
+    }
+  };
+  walk(0);
+
+  // no more threads are started once the walk is over
+  for (std::thread& thread : extraThreads)
+    thread.join();
+
+  const size_t firstIndex = entries.size();
+  for (std::vector<DirectoryEntry>& found : threadEntries) {
+    for (DirectoryEntry& entry : found)
+      entries.push_back(std::move(entry));
+  }
+  helper::sortEntries(entries, firstIndex);
+  return !failed;
+}
+
+// MemoryFileSystem
+
+bool MemoryFileSystem::readFile(const std::filesystem::path& path, std::string& contents) const {
+  std::lock_guard lock(m_mutex);
+  const auto it = m_files.find(path);
+  if (it == m_files.end())
+    return false;
+  contents = it->second;
+  return true;
+}
+
+bool MemoryFileSystem::writeFile(const std::filesystem::path& path, const std::string& contents) {
+  std::lock_guard lock(m_mutex);
+  if (!isDirectoryLocked(path.parent_path()) || isDirectoryLocked(path))
+    return false;
+  m_files.insert_or_assign(path, contents);
+  return true;
+}
+
+bool MemoryFileSystem::isRegularFile(const std::filesystem::path& path) const {
+  std::lock_guard lock(m_mutex);
+  return m_files.count(path) != 0;
+}
+
+bool MemoryFileSystem::isDirectory(const std::filesystem::path& path) const {
+  std::lock_guard lock(m_mutex);
+  return isDirectoryLocked(path);
+}
+
+bool MemoryFileSystem::createDirectories(const std::filesystem::path& path) {
+  std::lock_guard lock(m_mutex);
+  // a file can't have anything inside of it
+  for (std::filesystem::path parent = path; parent.has_relative_path();
+       parent = parent.parent_path()) {
+    if (m_files.count(parent))
+      return false;
+  }
+  m_directories.insert(path);
+  return true;
+}
+
+bool MemoryFileSystem::removeAll(const std::filesystem::path& path) {
+  std::lock_guard lock(m_mutex);
+  m_files.erase(path);
+  m_directories.erase(path);
+
+  // everything inside of a directory comes right after it
+  auto file = m_files.upper_bound(path);
+  while (file != m_files.end() && helper::isInside(file->first, path))
+    file = m_files.erase(file);
+  auto directory = m_directories.upper_bound(path);
+  while (directory != m_directories.end() && helper::isInside(*directory, path))
+    directory = m_directories.erase(directory);
+  return true;
+}
+
+bool MemoryFileSystem::listFiles(const std::filesystem::path& directory,
+                                 std::vector<DirectoryEntry>& entries,
+                                 const ListFilter& filter) const {
+  std::lock_guard lock(m_mutex);
+  if (!isDirectoryLocked(directory))
+    return false;
+
+  std::unordered_map<std::filesystem::path, bool> acceptedDirectories;
+  for (auto it = m_files.upper_bound(directory);
+       it != m_files.end() && helper::isInside(it->first, directory); ++it) {
+    if (!filter || (helper::isDirectoryListed(it->first.parent_path(), directory, filter,
+                                              acceptedDirectories) &&
+                    filter(it->first, false)))
+      entries.push_back({it->first, true});
+  }
+  return true;
+}
+
+bool MemoryFileSystem::isDirectoryLocked(const std::filesystem::path& path) const {
+  if (m_directories.count(path))
+    return true;
+
+  // a directory exists if anything is inside of it
+  const auto file = m_files.upper_bound(path);
+  if (file != m_files.end() && helper::isInside(file->first, path))
+    return true;
+  const auto directory = m_directories.upper_bound(path);
+  return directory != m_directories.end() && helper::isInside(*directory, path);
+}
+
+// OverlayFileSystem
+
+OverlayFileSystem::OverlayFileSystem(std::shared_ptr<FileSystem> upper,
+                                     std::shared_ptr<FileSystem> lower)
+    : m_upper(std::move(upper)), m_lower(std::move(lower)) {}
+
+bool OverlayFileSystem::readFile(const std::filesystem::path& path, std::string& contents) const {
+  return m_upper->readFile(path, contents) || m_lower->readFile(path, contents);
+}
+
+bool OverlayFileSystem::writeFile(const std::filesystem::path& path, const std::string& contents) {
+  // the upper file system may not have the parent directory yet
+  return (isDirectory(path.parent_path()) && m_upper->createDirectories(path.parent_path()) &&
+          m_upper->writeFile(path, contents));
+}
+
+bool OverlayFileSystem::isRegularFile(const std::filesystem::path& path) const {
+  return m_upper->isRegularFile(path) || m_lower->isRegularFile(path);
+}
+
+bool OverlayFileSystem::isDirectory(const std::filesystem::path& path) const {
+  return m_upper->isDirectory(path) || m_lower->isDirectory(path);
+}
+
+bool OverlayFileSystem::createDirectories(const std::filesystem::path& path) {
+  return m_upper->createDirectories(path);
+}
+
+bool OverlayFileSystem::removeAll(const std::filesystem::path& path) {
+  return m_upper->removeAll(path);
+}
+
+bool OverlayFileSystem::listFiles(const std::filesystem::path& directory,
+                                  std::vector<DirectoryEntry>& entries,
+                                  const ListFilter& filter) const {
+  std::vector<DirectoryEntry> upperEntries;
+  const bool upperIsDirectory = m_upper->listFiles(directory, upperEntries, filter);
+  std::vector<DirectoryEntry> lowerEntries;
+  const bool lowerIsDirectory = m_lower->listFiles(directory, lowerEntries, filter);
+  if (!upperIsDirectory && !lowerIsDirectory)
+    return false;
+
+  const size_t firstIndex = entries.size();
+
+  std::unordered_set<std::filesystem::path> upperPaths;
+  for (DirectoryEntry& entry : upperEntries) {
+    upperPaths.insert(entry.path);
+    entries.push_back(std::move(entry));
+  }
+  for (DirectoryEntry& entry : lowerEntries) {
+    if (!upperPaths.count(entry.path))
+      entries.push_back(std::move(entry));
+  }
+  helper::sortEntries(entries, firstIndex);
+  return true;
+}
+
+// Mount
+
+Mount::Mount(const std::filesystem::path& directory, std::shared_ptr<FileSystem> fileSystem)
+    : m_path(helper::absoluteNormal(directory)) {
+  MountTable& table = mountTable();
+  std::lock_guard lock(table.mutex);
+  const auto it = table.mounts.find(m_path);
+  if (it != table.mounts.end())
+    m_hiddenFileSystem = std::move(it->second);
+  table.mounts.insert_or_assign(m_path, std::move(fileSystem));
+  mountCount = table.mounts.size();
+}
+
+Mount::Mount(std::shared_ptr<FileSystem> fileSystem)
+    : Mount(
+          [] {
+            static std::atomic<size_t> nextMountNumber = 0;
+            const auto time = std::chrono::steady_clock::now().time_since_epoch().count();
+            std::error_code ec;
+            return std::filesystem::temp_directory_path(ec) /
+                   ("mcfunc_mount_" + std::to_string(time) + '_' +
+                    std::to_string(nextMountNumber++));
+          }(),
+          std::move(fileSystem)) {}
+
+Mount::~Mount() {
+  MountTable& table = mountTable();
+  std::lock_guard lock(table.mutex);
+  if (m_hiddenFileSystem)
+    table.mounts.insert_or_assign(m_path, std::move(m_hiddenFileSystem));
+  else
+    table.mounts.erase(m_path);
+  mountCount = table.mounts.size();
+}
+
+const std::filesystem::path& Mount::path() const { return m_path; }
+
+// free functions
+
+std::shared_ptr<FileSystem> vfs::fileSystemFor(const std::filesystem::path& path) {
+  if (mountCount == 0)
+    return disk();
+  std::shared_ptr<FileSystem> ret = mountedFileSystemFor(helper::absoluteNormal(path));
+  return (ret) ? ret : disk();
+}
+
+bool vfs::isOnDisk(const std::filesystem::path& path) {
+  return mountCount == 0 || !mountedFileSystemFor(helper::absoluteNormal(path));
+}
+
+bool vfs::readFile(const std::filesystem::path& path, std::string& contents) {
+  const std::filesystem::path fullPath = helper::absoluteNormal(path);
+  return fileSystemFor(fullPath)->readFile(fullPath, contents);
+}
+
+bool vfs::writeFile(const std::filesystem::path& path, const std::string& contents) {
+  const std::filesystem::path fullPath = helper::absoluteNormal(path);
+  return fileSystemFor(fullPath)->writeFile(fullPath, contents);
+}
+
+bool vfs::isRegularFile(const std::filesystem::path& path) {
+  const std::filesystem::path fullPath = helper::absoluteNormal(path);
+  return fileSystemFor(fullPath)->isRegularFile(fullPath);
+}
+
+bool vfs::isDirectory(const std::filesystem::path& path) {
+  const std::filesystem::path fullPath = helper::absoluteNormal(path);
+  return fileSystemFor(fullPath)->isDirectory(fullPath);
+}
+
+bool vfs::exists(const std::filesystem::path& path) {
+  const std::filesystem::path fullPath = helper::absoluteNormal(path);
+  const std::shared_ptr<FileSystem> fileSystem = fileSystemFor(fullPath);
+  return fileSystem->isRegularFile(fullPath) || fileSystem->isDirectory(fullPath);
+}
+
+bool vfs::createDirectories(const std::filesystem::path& path) {
+  const std::filesystem::path fullPath = helper::absoluteNormal(path);
+  return fileSystemFor(fullPath)->createDirectories(fullPath);
+}
+
+bool vfs::removeAll(const std::filesystem::path& path) {
+  const std::filesystem::path fullPath = helper::absoluteNormal(path);
+  return fileSystemFor(fullPath)->removeAll(fullPath);
+}
+
+bool vfs::listFiles(const std::filesystem::path& directory, std::vector<DirectoryEntry>& entries,
+                    const ListFilter& filter) {
+  const std::filesystem::path fullPath = helper::absoluteNormal(directory);
+  return fileSystemFor(fullPath)->listFiles(fullPath, entries, filter);
+}
+
+bool vfs::copyFile(const std::filesystem::path& from, const std::filesystem::path& to) {
+  const std::filesystem::path fullFrom = helper::absoluteNormal(from);
+  const std::filesystem::path fullTo = helper::absoluteNormal(to);
+  if (isOnDisk(fullFrom) && isOnDisk(fullTo))
+    return helper::copyDiskFile(fullFrom, fullTo);
+
+  std::string contents;
+  return fileSystemFor(fullFrom)->readFile(fullFrom, contents) &&
+         fileSystemFor(fullTo)->writeFile(fullTo, contents);
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static bool helper::isInside(const std::filesystem::path& path,
+                             const std::filesystem::path& directory) {
+  auto pathPart = path.begin();
+  for (auto directoryPart = directory.begin(); directoryPart != directory.end();
+       ++directoryPart, ++pathPart) {
+    // a trailing separator (an empty part) matches anything
+    if (directoryPart->empty() && std::next(directoryPart) == directory.end())
+      return true;
+    if (pathPart == path.end() || *pathPart != *directoryPart)
+      return false;
+  }
+  return true;
+}
+
+static std::filesystem::path helper::absoluteNormal(const std::filesystem::path& path) {
+  std::error_code ec;
+  std::filesystem::path ret = (path.is_absolute())
+                                  ? path.lexically_normal()
+                                  : std::filesystem::absolute(path, ec).lexically_normal();
+
+  // "foo/bar/" -> "foo/bar" (so that there's only 1 way to write each path)
+  if (!ret.has_filename() && ret.has_relative_path())
+    ret = ret.parent_path();
+  return ret;
+}
+
+static bool helper::readDiskDirectory(const std::filesystem::path& directory,
+                                      const ListFilter& filter,
+                                      std::vector<DirectoryEntry>& files,
+                                      std::vector<std::filesystem::path>& subdirectories) {
+#if defined(__unix__) || defined(__APPLE__)
+  DIR* dir = opendir(directory.c_str());
+  if (dir == nullptr)
+    return false;
+
+  while (true) {
+    errno = 0;
+    const dirent* entry = readdir(dir);
+    if (entry == nullptr)
+      break;
+    if (std::strcmp(entry->d_name, ".") == 0 || std::strcmp(entry->d_name, "..") == 0)
+      continue;
+    std::filesystem::path path = directory / entry->d_name;
+
+    // the type only has to be looked up for symlinks and on file systems that
+    // don't fill in 'd_type'
+    bool isDirectory = entry->d_type == DT_DIR;
+    bool isRegularFile = entry->d_type == DT_REG;
+    bool isSymlink = entry->d_type == DT_LNK;
+    struct stat pathStat;
+    if (entry->d_type == DT_UNKNOWN && lstat(path.c_str(), &pathStat) == 0) {
+      isDirectory = S_ISDIR(pathStat.st_mode);
+      isRegularFile = S_ISREG(pathStat.st_mode);
+      isSymlink = S_ISLNK(pathStat.st_mode);
+    }
+    if (isSymlink) {
+      const bool didStat = stat(path.c_str(), &pathStat) == 0;
+      if (didStat && S_ISDIR(pathStat.st_mode))
+        continue;
+      isRegularFile = didStat && S_ISREG(pathStat.st_mode);
+    }
+
+    if (filter && !filter(path, isDirectory))
+      continue;
+    if (isDirectory)
+      subdirectories.push_back(std::move(path));
+    else
+      files.push_back({std::move(path), isRegularFile});
+  }
+
+  const bool ret = errno == 0;
+  closedir(dir);
+  return ret;
+#else
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+    // the entry's type is cached while iterating so these don't have to stat
+    const bool isSymlink = entry.is_symlink(ec);
+    const bool isDirectory = entry.is_directory(ec) && !ec;
+    if (isDirectory && isSymlink)
+      continue;
+    const bool isRegularFile = !isDirectory && entry.is_regular_file(ec) && !ec;
+    ec.clear();
+
+    if (filter && !filter(entry.path(), isDirectory))
+      continue;
+    if (isDirectory)
+      subdirectories.push_back(entry.path());
+    else
+      files.push_back({entry.path(), isRegularFile});
+  }
+  return !ec;
+#endif
+}
+
+static bool helper::isDirectoryListed(
+    const std::filesystem::path& directory, const std::filesystem::path& root,
+    const ListFilter& filter,
+    std::unordered_map<std::filesystem::path, bool>& acceptedDirectories) {
+  if (directory == root)
+    return true;
+
+  const auto it = acceptedDirectories.find(directory);
+  if (it != acceptedDirectories.end())
+    return it->second;
+
+  // a directory inside of one that was rejected is never checked
+  const bool ret =
+      isDirectoryListed(directory.parent_path(), root, filter, acceptedDirectories) &&
+      filter(directory, true);
+  acceptedDirectories[directory] = ret;
+  return ret;
+}
+
+static void helper::sortEntries(std::vector<DirectoryEntry>& entries, size_t firstIndex) {
+  std::sort(entries.begin() + firstIndex, entries.end(),
+            [](const DirectoryEntry& a, const DirectoryEntry& b) { return a.path < b.path; });
+}
+
+static bool helper::copyDiskFile(const std::filesystem::path& from,
+                                 const std::filesystem::path& to) {
+#if defined(__linux__)
+  const int fromFd = open(from.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fromFd == -1)
+    return false;
+  struct stat fromStat;
+  if (fstat(fromFd, &fromStat) != 0 || !S_ISREG(fromStat.st_mode)) {
+    close(fromFd);
+    return false;
+  }
+
+  const int toFd = open(to.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0666);
+  if (toFd == -1) {
+    close(fromFd);
+    return false;
+  }
+  struct stat toStat;
+  bool ret = fstat(toFd, &toStat) == 0;
+
+  // truncating a file that's being copied onto itself would empty it
+  if (ret && (toStat.st_dev != fromStat.st_dev || toStat.st_ino != fromStat.st_ino)) {
+    ret = ftruncate(toFd, 0) == 0;
+
+    // share the data blocks if the file system can (e.g. btrfs or XFS),
+    // otherwise have the kernel copy the data ('sendfile()' works when
+    // 'copy_file_range()' can't copy between the 2 file systems)
+    if (ret && ioctl(toFd, FICLONE, fromFd) != 0) {
+      constexpr size_t chunkSize = size_t(1) << 30;
+      bool useSendfile = false;
+      while (true) {
+        const ssize_t copied = (useSendfile)
+                                   ? sendfile(toFd, fromFd, nullptr, chunkSize)
+                                   : copy_file_range(fromFd, nullptr, toFd, nullptr, chunkSize, 0);
+        if (copied > 0)
+          continue;
+        if (copied == 0)
+          break;
+        if (errno == EINTR)
+          continue;
+        if (!useSendfile && (errno == EXDEV || errno == ENOSYS || errno == EINVAL ||
+                             errno == EOPNOTSUPP)) {
+          useSendfile = true;
+          continue;
+        }
+        ret = false;
+        break;
+      }
+    }
+  }
+
+  close(fromFd);
+  return close(toFd) == 0 && ret;
+#else
+  std::error_code ec;
+  std::filesystem::copy_file(from, to, std::filesystem::copy_options::overwrite_existing, ec);
+  return !ec;
+#endif
+}
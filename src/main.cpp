@@ -1,23 +1,47 @@
 #include <cstdlib>
 #include <iostream>
+#include <string_view>
 
+#include <cli/PackBuild.h>
+#include <cli/batch.h>
+#include <cli/lsp.h>
 #include <cli/parseArgs.h>
+#include <cli/symbolize.h>
+#include <cli/watch.h>
+#include <cli/xref.h>
 #include <compiler/compile_error.h>
-#include <compiler/generation/generateDataPack.h>
-#include <compiler/linking/link.h>
-#include <compiler/translation/CompiledSourceFile.h>
+#include <compiler/generation/BuildStamp.h>
+#include <compiler/pass_timing.h>
+#include <compiler/tracing.h>
 
 int main(int argc, const char** argv) {
+  if (argc >= 2 && std::string_view(argv[1]) == "symbolize")
+    return symbolize(argc, argv);
+  if (argc >= 2 && std::string_view(argv[1]) == "xref")
+    return xref(argc, argv);
+  if (argc >= 2 && std::string_view(argv[1]) == "batch")
+    return batch(argc, argv);
+  if (argc >= 2 && std::string_view(argv[1]) == "lsp")
+    return lsp(argc, argv);
+
   try {
 
-    auto [outputDirectory, sourceFiles, fileWriteSourceFiles, clearOutputDirectory] =
-        parseArgs(argc, argv);
+    ParseArgsResult parsedArgs = parseArgs(argc, argv);
+    if (parsedArgs.watchForChanges)
+      return watch(argc, argv, std::move(parsedArgs));
+
+    PackBuild build(BuildStamp::keyFromArgs(argc, argv), std::move(parsedArgs));
+
+    // skip the build if nothing changed since the last one
+    if (build.skipIfUpToDate(std::cout))
+      return EXIT_SUCCESS;
+
+    build.linkAndWrite(build.sourceFiles().evaluateAll(build.compileOptions()), std::cout);
 
-    auto [fileWriteMap, tickFuncCallNames, loadFuncCallNames, exposedNamespace] =
-        link(sourceFiles.evaluateAll(), std::move(sourceFiles), std::move(fileWriteSourceFiles));
+    if (pass_timing::reportFormat != pass_timing::ReportFormat::NONE)
+      std::cerr << pass_timing::report();
 
-    generateDataPack(outputDirectory, exposedNamespace, fileWriteMap, clearOutputDirectory,
-                     tickFuncCallNames, loadFuncCallNames);
+    TRACE_WRITE();
 
   } catch (const compile_error::Generic& e) {
     std::cerr << e.what();
@@ -0,0 +1,56 @@
+#pragma once
+/// \file Contains the \p TempDirectory class that tests and benchmarks use to
+/// put files on the disk.
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <system_error>
+
+/// A new, empty directory in the system's temporary directory that is removed
+/// (with everything in it) when the object is destroyed. Every directory gets a
+/// random name so tests running at the same time never share one.
+class TempDirectory {
+public:
+  /// \param namePrefix is the start of the directory's name (e.g. the name of
+  /// the test).
+  explicit TempDirectory(const std::string& namePrefix) {
+    std::random_device randomDevice;
+    std::mt19937_64 random(
+        (static_cast<uint64_t>(randomDevice()) << 32) ^ randomDevice() ^
+        static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+
+    const std::filesystem::path tempDir = std::filesystem::temp_directory_path();
+    do {
+      m_path = tempDir / (namePrefix + '_' + std::to_string(random()));
+    } while (!std::filesystem::create_directory(m_path));
+  }
+
+  ~TempDirectory() {
+    std::error_code ec;
+    std::filesystem::remove_all(m_path, ec);
+  }
+
+  TempDirectory(const TempDirectory&) = delete;
+  TempDirectory& operator=(const TempDirectory&) = delete;
+
+  const std::filesystem::path& path() const { return m_path; }
+
+  /// Writes \param contents to \param relativePath (inside of the directory),
+  /// replacing anything that's there and creating any parent directories.
+  /// Returns the full path of the file.
+  std::filesystem::path writeFile(const std::filesystem::path& relativePath,
+                                  const std::string& contents) const {
+    const std::filesystem::path path = m_path / relativePath;
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+    return path;
+  }
+
+private:
+  std::filesystem::path m_path;
+};
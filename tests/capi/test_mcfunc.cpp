@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+#include <capi/mcfunc.h>
+
+/// Adds a file with the contents \p contents to \p project .
+static mcfunc_status addFile(mcfunc_project* project, const char* path, const char* contents) {
+  return mcfunc_project_add_file(project, path, contents, std::strlen(contents));
+}
+
+/// Every output in \p result (path -> contents).
+static std::unordered_map<std::string, std::string> outputs(const mcfunc_result* result) {
+  std::unordered_map<std::string, std::string> ret;
+  for (size_t i = 0; i < mcfunc_result_output_count(result); i++) {
+    mcfunc_output output;
+    EXPECT_EQ(mcfunc_result_output(result, i, &output), MCFUNC_OK);
+    ret.emplace(output.path, std::string(output.contents, output.size));
+  }
+  return ret;
+}
+
+TEST(test_mcfunc, compiles_in_memory_project) {
+  ASSERT_EQ(mcfunc_api_version(), MCFUNC_API_VERSION);
+
+  mcfunc_project* project = mcfunc_project_create();
+  ASSERT_NE(project, nullptr);
+
+  // nothing here exists on the disk
+  ASSERT_EQ(addFile(project, "main.mcfunc",
+                    "expose \"example\";\n"
+                    "import \"lib/util.mcfunc\";\n"
+                    "tick void main() {\n"
+                    "  /say main;\n"
+                    "  helper();\n"
+                    "}\n"
+                    "file \"info.json\" = \"resources/info.json\";\n"),
+            MCFUNC_OK);
+  ASSERT_EQ(addFile(project, "lib/util.mcfunc", "public void helper() { /say helper; }"),
+            MCFUNC_OK);
+  ASSERT_EQ(addFile(project, "resources/info.json", "{}"), MCFUNC_OK);
+
+  ASSERT_EQ(addFile(project, "../outside.mcfunc", ""), MCFUNC_INVALID_ARGUMENT);
+  ASSERT_EQ(mcfunc_project_set_option(project, MCFUNC_OPTION_INLINE_TRIVIAL_SCOPES, 1), MCFUNC_OK);
+
+  mcfunc_result* result = mcfunc_compile(project);
+  ASSERT_NE(result, nullptr);
+  ASSERT_TRUE(mcfunc_result_succeeded(result));
+  ASSERT_EQ(mcfunc_result_diagnostic_count(result), 0);
+
+  const std::unordered_map<std::string, std::string> files = outputs(result);
+  ASSERT_EQ(files.count("example/function/main.mcfunction"), 0); // not exposed
+  ASSERT_EQ(files.at("example/info.json"), "{}"); // copied byte for byte
+  ASSERT_EQ(files.at("minecraft/tags/function/load.json"), "{\n    \"values\": []\n}\n");
+  ASSERT_NE(files.at("minecraft/tags/function/tick.json").find("zzz__.example:"),
+            std::string::npos);
+
+  mcfunc_output output;
+  ASSERT_EQ(mcfunc_result_output(result, files.size(), &output), MCFUNC_INVALID_ARGUMENT);
+  mcfunc_result_destroy(result);
+
+  // the project can be changed and compiled again
+  ASSERT_EQ(addFile(project, "lib/util.mcfunc", "public void helper() {\n  missing();\n}\n"),
+            MCFUNC_OK);
+  result = mcfunc_compile(project);
+  ASSERT_NE(result, nullptr);
+  ASSERT_FALSE(mcfunc_result_succeeded(result));
+  ASSERT_EQ(mcfunc_result_output_count(result), 0);
+  ASSERT_EQ(mcfunc_result_diagnostic_count(result), 1);
+
+  mcfunc_diagnostic diagnostic;
+  ASSERT_EQ(mcfunc_result_diagnostic(result, 0, &diagnostic), MCFUNC_OK);
+  ASSERT_STREQ(diagnostic.file, "lib/util.mcfunc");
+  ASSERT_EQ(diagnostic.line, 2);
+  ASSERT_EQ(diagnostic.column, 3);
+  ASSERT_NE(std::strlen(diagnostic.message), 0);
+  ASSERT_NE(std::string(diagnostic.full_message).find(diagnostic.message), std::string::npos);
+  mcfunc_result_destroy(result);
+
+  ASSERT_EQ(mcfunc_project_remove_file(project, "lib/util.mcfunc"), MCFUNC_OK);
+  ASSERT_EQ(mcfunc_project_remove_file(project, "lib/util.mcfunc"), MCFUNC_INVALID_ARGUMENT);
+  result = mcfunc_compile(project);
+  ASSERT_FALSE(mcfunc_result_succeeded(result));
+  mcfunc_result_destroy(result);
+
+  mcfunc_project_destroy(project);
+}
+
+TEST(test_mcfunc, compiles_again_and_again) {
+  // every function and scope gets an ID, and a long-lived process has to keep
+  // compiling after handing out more IDs than 1 compile can use (2^20)
+  constexpr size_t functionCount = 200;
+  constexpr size_t scopeDepth = 20;
+  constexpr size_t compileCount = 0x100000 / (functionCount * (scopeDepth + 1)) + 1;
+
+  std::string contents = "expose \"example\";\n";
+  for (size_t i = 0; i < functionCount; i++) {
+    contents += "void f" + std::to_string(i) + "() {";
+    for (size_t j = 0; j < scopeDepth; j++)
+      contents += " /say a; {";
+    contents += " /say b; " + std::string(scopeDepth, '}') + " }\n";
+  }
+
+  mcfunc_project* project = mcfunc_project_create();
+  ASSERT_EQ(addFile(project, "main.mcfunc", contents.c_str()), MCFUNC_OK);
+
+  std::unordered_map<std::string, std::string> firstFiles;
+  for (size_t i = 0; i < compileCount; i++) {
+    mcfunc_result* result = mcfunc_compile(project);
+    ASSERT_NE(result, nullptr);
+    ASSERT_TRUE(mcfunc_result_succeeded(result));
+    if (i == 0)
+      firstFiles = outputs(result);
+    mcfunc_result_destroy(result);
+  }
+  ASSERT_EQ(firstFiles.size(), functionCount * (scopeDepth + 1) + 2);
+
+  // every compile gives the same names
+  mcfunc_result* result = mcfunc_compile(project);
+  ASSERT_EQ(outputs(result), firstFiles);
+  mcfunc_result_destroy(result);
+
+  mcfunc_project_destroy(project);
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <cli/FileWatcher.h>
+#include <compiler/CompileOptions.h>
+#include <compiler/IncrementalBuild.h>
+#include <compiler/SourceFiles.h>
+#include <compiler/fileToStr.h>
+#include <TempDirectory.h>
+
+TEST(test_FileWatcher, rebuild_changed_file) {
+  const TempDirectory dir("mcfunc_test_FileWatcher");
+  const std::filesystem::path srcDir = dir.path() / "src";
+  const std::filesystem::path libPath =
+      dir.writeFile("src/lib.mcfunc", "public void a() expose \"a\" { /say a; }\n");
+  const std::filesystem::path mainPath =
+      dir.writeFile("src/main.mcfunc", "expose \"example\";\nimport \"lib.mcfunc\";\n"
+                                       "void main() expose \"main\" { /say main; a(); }\n");
+  const std::filesystem::path outputDir = dir.path() / "data";
+
+  // the same steps '--watch' takes
+  FileWatcher fileWatcher({libPath, mainPath}, {srcDir});
+  SourceFiles sourceFiles;
+  sourceFiles.emplace_back(libPath, srcDir);
+  sourceFiles.emplace_back(mainPath, srcDir);
+  IncrementalBuild build(std::filesystem::path(outputDir), std::move(sourceFiles), {},
+                         CompileOptions(), {}, {});
+  build.buildAll(true);
+
+  const std::filesystem::path libFunctionPath = outputDir / "example/function/a.mcfunction";
+  const std::filesystem::path mainFunctionPath = outputDir / "example/function/main.mcfunction";
+  const auto mainWriteTime = std::filesystem::last_write_time(mainFunctionPath);
+
+  dir.writeFile("src/lib.mcfunc", "public void a() expose \"a\" { /say changed; }\n");
+  const std::vector<std::filesystem::path> changedPaths = fileWatcher.waitForChanges();
+  ASSERT_NE(std::find(changedPaths.begin(), changedPaths.end(), libPath), changedPaths.end());
+  ASSERT_EQ(std::find(changedPaths.begin(), changedPaths.end(), mainPath), changedPaths.end());
+
+  // only the edited file is compiled again and only its output is written
+  const IncrementalBuild::UpdateResult result = build.update(changedPaths);
+  ASSERT_TRUE(result.rebuilt);
+  ASSERT_EQ(result.recompiledSourceFileCount, 1);
+  ASSERT_EQ(result.changedOutputFileCount, 1);
+  ASSERT_NE(fileToStr(libFunctionPath).find("say changed\n"), std::string::npos);
+  ASSERT_EQ(std::filesystem::last_write_time(mainFunctionPath), mainWriteTime);
+}
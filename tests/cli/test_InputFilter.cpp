@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cli/InputFilter.h>
+#include <compiler/vfs.h>
+
+TEST(test_InputFilter, glob_matches) {
+  ASSERT_TRUE(InputFilter::globMatches("*.png", "a.png"));
+  ASSERT_FALSE(InputFilter::globMatches("*.png", "dir/a.png"));
+  ASSERT_TRUE(InputFilter::globMatches("**/*.png", "a.png"));
+  ASSERT_TRUE(InputFilter::globMatches("**/*.png", "dir/sub/a.png"));
+  ASSERT_TRUE(InputFilter::globMatches("assets/**", "assets/a/b.json"));
+  ASSERT_FALSE(InputFilter::globMatches("assets/**", "src/a.mcfunc"));
+  ASSERT_TRUE(InputFilter::globMatches("src/*/util.mcfunc", "src/lib/util.mcfunc"));
+  ASSERT_FALSE(InputFilter::globMatches("src/*/util.mcfunc", "src/lib/x/util.mcfunc"));
+  ASSERT_TRUE(InputFilter::globMatches("file?.txt", "file1.txt"));
+  ASSERT_FALSE(InputFilter::globMatches("a?b", "a/b"));
+  ASSERT_TRUE(InputFilter::globMatches("", ""));
+  ASSERT_FALSE(InputFilter::globMatches("", "a"));
+}
+
+TEST(test_InputFilter, list_input_directory) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::filesystem::path& root = mount.path();
+
+  ASSERT_TRUE(files->createDirectories(root / "src" / "lib"));
+  ASSERT_TRUE(files->createDirectories(root / "assets" / "textures"));
+  ASSERT_TRUE(files->createDirectories(root / "build"));
+  for (const char* path : {"src/main.mcfunc", "src/lib/util.mcfunc", "src/lib/notes.md",
+                           "src/loot.json", "assets/textures/a.png", "assets/readme.md",
+                           "build/out.mcfunc", "build.txt"})
+    ASSERT_TRUE(files->writeFile(root / path, ""));
+  ASSERT_TRUE(files->writeFile(root / std::string(InputFilter::ignoreFileName),
+                               "# build output\n"
+                               "build/\n"
+                               "\n"
+                               "  /assets/textures  \n"));
+
+  const auto list = [&root](const InputFilter& filter) {
+    std::vector<vfs::DirectoryEntry> entries;
+    EXPECT_TRUE(vfs::listFiles(root, entries,
+                               [&](const std::filesystem::path& path, bool isDirectory) {
+                                 return filter.includes(root, path, isDirectory);
+                               }));
+    std::vector<std::string> ret;
+    for (const vfs::DirectoryEntry& entry : entries)
+      ret.push_back(entry.path.lexically_relative(root).generic_string());
+    return ret;
+  };
+
+  // without an ignore file only the ignore file itself is skipped
+  ASSERT_EQ(list(InputFilter()).size(), 8);
+
+  // ('build/' only matches directories)
+  InputFilter filter;
+  filter.readIgnoreFile(root);
+  ASSERT_EQ(list(filter),
+            (std::vector<std::string>{"assets/readme.md", "build.txt", "src/lib/notes.md",
+                                      "src/lib/util.mcfunc", "src/loot.json", "src/main.mcfunc"}));
+
+  // include globs only keep matching files (or files in matching directories)
+  filter = InputFilter({"*.mcfunc", "/assets"}, {"lib/"});
+  filter.readIgnoreFile(root);
+  ASSERT_EQ(list(filter), (std::vector<std::string>{"assets/readme.md", "src/main.mcfunc"}));
+
+  ASSERT_TRUE(filter.includesFile(root, root / "src" / "new.mcfunc"));
+  ASSERT_FALSE(filter.includesFile(root, root / "src" / "new.json"));
+  ASSERT_FALSE(filter.includesFile(root, root / "src" / "lib" / "new.mcfunc"));
+  ASSERT_FALSE(filter.includesFile(root, root / "build" / "new.mcfunc"));
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include <cli/PackBuild.h>
+#include <cli/parseArgs.h>
+#include <compiler/generation/BuildStamp.h>
+#include <compiler/translation/constants.h>
+#include <TempDirectory.h>
+
+/// Builds the pack in \p dir (from 'src' into 'data') unless it's up to date.
+/// Returns whether it was built.
+static bool build(const TempDirectory& dir) {
+  const std::string srcDir = (dir.path() / "src").string();
+  const std::string dataDir = (dir.path() / "data").string();
+  const char* argv[] = {"mcfunc", "-i", srcDir.c_str(), "-o", dataDir.c_str(), "-MD"};
+  constexpr int argc = sizeof(argv) / sizeof(argv[0]);
+
+  PackBuild packBuild(BuildStamp::keyFromArgs(argc, argv), parseArgs(argc, argv, false));
+  std::ostringstream out;
+  if (packBuild.skipIfUpToDate(out))
+    return false;
+  packBuild.linkAndWrite(packBuild.sourceFiles().evaluateAll(packBuild.compileOptions()), out);
+  return true;
+}
+
+TEST(test_PackBuild, function_tags_are_outputs) {
+  const TempDirectory dir("mcfunc_test_PackBuild");
+  dir.writeFile("src/main.mcfunc", "expose \"example\";\ntick void main() { /say hi; }\n");
+
+  ASSERT_TRUE(build(dir));
+  ASSERT_FALSE(build(dir));
+
+  // a missing function tag is written again
+  const std::filesystem::path tickTagPath = dir.path() / "data" / tickFuncTagPath;
+  ASSERT_TRUE(std::filesystem::remove(tickTagPath));
+  ASSERT_TRUE(build(dir));
+  ASSERT_TRUE(std::filesystem::exists(tickTagPath));
+  ASSERT_FALSE(build(dir));
+}
+
+TEST(test_PackBuild, function_tags_are_depfile_targets) {
+  const TempDirectory dir("mcfunc_test_PackBuild");
+  dir.writeFile("src/main.mcfunc", "expose \"example\";\ntick void main() { /say hi; }\n");
+  ASSERT_TRUE(build(dir));
+
+  std::ifstream depfile(dir.path() / "data.d", std::ios::binary);
+  ASSERT_TRUE(depfile.is_open());
+  const std::string contents((std::istreambuf_iterator<char>(depfile)),
+                             std::istreambuf_iterator<char>());
+  const std::string targets = contents.substr(0, contents.find(':'));
+  EXPECT_NE(targets.find((dir.path() / "data" / tickFuncTagPath).generic_string()),
+            std::string::npos);
+  EXPECT_NE(targets.find((dir.path() / "data" / loadFuncTagPath).generic_string()),
+            std::string::npos);
+}
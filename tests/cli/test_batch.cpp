@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cli/batch.h>
+#include <compiler/json.h>
+#include <compiler/vfs.h>
+
+TEST(test_batch, pack_args_from_manifest) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::string src = (mount.path() / "src").string();
+  const std::string file = (mount.path() / "main.mcfunc").string();
+  ASSERT_TRUE(files->createDirectories(src));
+  ASSERT_TRUE(files->writeFile(file, ""));
+
+  using Args = std::vector<std::vector<std::string>>;
+  ASSERT_EQ(packArgsFromManifest(R"({
+    "args": ["--dedup-functions"],
+    "packs": [
+      {"inputs": [")" + src + R"(", ")" + file + R"("], "output": "out/a"},
+      {"inputs": [")" + file + R"("], "output": "out/b", "args": ["--fresh"]}
+    ]
+  })"),
+            (Args{{"-i", src, file, "-o", "out/a", "--dedup-functions"},
+                  {file, "-o", "out/b", "--dedup-functions", "--fresh"}}));
+
+  ASSERT_TRUE(packArgsFromManifest(R"({"packs": []})").empty());
+  ASSERT_THROW(packArgsFromManifest("[]"), json::ParseError);
+  ASSERT_THROW(packArgsFromManifest(R"({"packs": [{"inputs": []}]})"), json::ParseError);
+  ASSERT_THROW(packArgsFromManifest(R"({"packs": [{"inputs": [1], "output": "x"}]})"),
+               json::ParseError);
+  ASSERT_THROW(packArgsFromManifest(R"({"args": "--fresh", "packs": []})"), json::ParseError);
+}
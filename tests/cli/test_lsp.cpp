@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cli/lsp.h>
+#include <compiler/json.h>
+#include <compiler/vfs.h>
+
+/// \p body as a message.
+static std::string message(const std::string& body) {
+  return "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+}
+
+/// Parses every message in \p text .
+static std::vector<json::Value> parseMessages(const std::string& text) {
+  std::vector<json::Value> ret;
+  size_t i = 0;
+  while (i < text.size()) {
+    const size_t headerEnd = text.find("\r\n\r\n", i);
+    EXPECT_NE(headerEnd, std::string::npos);
+    const size_t length = std::stoul(text.substr(i + 16, headerEnd - (i + 16)));
+    ret.push_back(json::parse(text.substr(headerEnd + 4, length)));
+    i = headerEnd + 4 + length;
+  }
+  return ret;
+}
+
+TEST(test_lsp, language_server) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::string rootUri = "file://" + mount.path().generic_string();
+  const std::string mainUri = rootUri + "/main.mcfunc";
+  ASSERT_TRUE(files->createDirectories(mount.path()));
+  ASSERT_TRUE(files->writeFile(mount.path() / "main.mcfunc", "void main() {\n  missing();\n}\n"));
+
+  std::istringstream in(
+      message(R"({"jsonrpc":"2.0","id":1,"method":"initialize","params":{"rootUri":")" +
+              rootUri + R"("}})") +
+      message(R"({"jsonrpc":"2.0","method":"initialized","params":{}})") +
+      message(R"({"jsonrpc":"2.0","method":"textDocument/didOpen","params":{"textDocument":{)"
+              R"("uri":")" +
+              mainUri +
+              R"(","text":"void main() { other(); }\nvoid other() {}\n"}}})") +
+      message(R"({"jsonrpc":"2.0","id":"def","method":"textDocument/definition","params":{)"
+              R"("textDocument":{"uri":")" +
+              mainUri + R"("},"position":{"line":0,"character":15}}})") +
+      message(R"({"jsonrpc":"2.0","id":2,"method":"unknown"})") +
+      message(R"({"jsonrpc":"2.0","id":3,"method":"shutdown"})") +
+      message(R"({"jsonrpc":"2.0","method":"exit"})"));
+  std::ostringstream out;
+
+  ASSERT_EQ(runLanguageServer(in, out), EXIT_SUCCESS);
+  const std::vector<json::Value> messages = parseMessages(out.str());
+  ASSERT_EQ(messages.size(), 6);
+
+  ASSERT_EQ(messages[0]["id"].asNumber(), 1);
+  ASSERT_TRUE(messages[0]["result"]["capabilities"]["definitionProvider"].asBool());
+
+  // the saved file has an error
+  ASSERT_EQ(messages[1]["method"].asString(), "textDocument/publishDiagnostics");
+  ASSERT_EQ(messages[1]["params"]["uri"].asString(), mainUri);
+  const json::Value& diagnostic = messages[1]["params"]["diagnostics"].asArray().at(0);
+  ASSERT_EQ(diagnostic["range"]["start"]["line"].asNumber(), 1);
+  ASSERT_EQ(diagnostic["range"]["start"]["character"].asNumber(), 2);
+  ASSERT_EQ(diagnostic["range"]["end"]["character"].asNumber(), 9);
+
+  // the unsaved buffer fixes it
+  ASSERT_TRUE(messages[2]["params"]["diagnostics"].asArray().empty());
+
+  ASSERT_EQ(messages[3]["id"].asString(), "def");
+  const json::Value& location = messages[3]["result"].asArray().at(0);
+  ASSERT_EQ(location["uri"].asString(), mainUri);
+  ASSERT_EQ(location["range"]["start"]["line"].asNumber(), 1);
+  ASSERT_EQ(location["range"]["start"]["character"].asNumber(), 5);
+
+  ASSERT_EQ(messages[4]["error"]["code"].asNumber(), -32601);
+  ASSERT_TRUE(messages[5]["result"].isNull());
+}
+
+TEST(test_lsp, position_encodings) {
+  // 'missing' starts at byte 27 (or UTF-16 code unit 24)
+  for (const bool isUtf8 : {false, true}) {
+    auto files = std::make_shared<vfs::MemoryFileSystem>();
+    const vfs::Mount mount(files);
+    const std::string rootUri = "file://" + mount.path().generic_string();
+    const std::string mainUri = rootUri + "/main.mcfunc";
+    ASSERT_TRUE(files->createDirectories(mount.path()));
+    // 'é' is 2 bytes (1 code unit) and '😀' is 4 bytes (2 code units)
+    ASSERT_TRUE(files->writeFile(mount.path() / "main.mcfunc",
+                                 "void main() { /say \xC3\xA9\xF0\x9F\x98\x80; missing(); }\n"));
+
+    const std::string capabilities =
+        isUtf8 ? R"({"general":{"positionEncodings":["utf-16","utf-8"]}})" : "{}";
+    std::istringstream in(
+        message(R"({"jsonrpc":"2.0","id":1,"method":"initialize","params":{"rootUri":")" +
+                rootUri + R"(","capabilities":)" + capabilities + "}}") +
+        message(R"({"jsonrpc":"2.0","method":"initialized","params":{}})") +
+        message(R"({"jsonrpc":"2.0","id":2,"method":"textDocument/references","params":{)"
+                R"("textDocument":{"uri":")" +
+                mainUri + R"("},"position":{"line":0,"character":)" +
+                (isUtf8 ? "28" : "25") + "}}}") +
+        message(R"({"jsonrpc":"2.0","id":3,"method":"shutdown"})") +
+        message(R"({"jsonrpc":"2.0","method":"exit"})"));
+    std::ostringstream out;
+
+    ASSERT_EQ(runLanguageServer(in, out), EXIT_SUCCESS);
+    const std::vector<json::Value> messages = parseMessages(out.str());
+    ASSERT_EQ(messages.size(), 4);
+
+    ASSERT_EQ(messages[0]["result"]["capabilities"]["positionEncoding"].asString(),
+              isUtf8 ? "utf-8" : "utf-16");
+
+    const json::Value& range = messages[1]["params"]["diagnostics"].asArray().at(0)["range"];
+    ASSERT_EQ(range["start"]["character"].asNumber(), isUtf8 ? 27 : 24);
+    ASSERT_EQ(range["end"]["character"].asNumber(), isUtf8 ? 34 : 31);
+
+    const json::Value& location = messages[2]["result"].asArray().at(0);
+    ASSERT_EQ(location["range"]["start"]["character"].asNumber(), isUtf8 ? 27 : 24);
+  }
+}
+
+TEST(test_lsp, initialize_again) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::string rootUri = "file://" + mount.path().generic_string();
+  const std::string mainUri = rootUri + "/main.mcfunc";
+  ASSERT_TRUE(files->createDirectories(mount.path()));
+  ASSERT_TRUE(files->writeFile(mount.path() / "main.mcfunc", "void main() {\n  missing();\n}\n"));
+
+  const std::string initialize =
+      message(R"({"jsonrpc":"2.0","id":1,"method":"initialize","params":{"rootUri":")" +
+              rootUri + R"("}})") +
+      message(R"({"jsonrpc":"2.0","method":"initialized","params":{}})");
+  std::istringstream in(
+      initialize + initialize +
+      message(R"({"jsonrpc":"2.0","method":"textDocument/didOpen","params":{"textDocument":{)"
+              R"("uri":")" +
+              mainUri + R"(","text":"void main() {}\n"}}})") +
+      message(R"({"jsonrpc":"2.0","id":3,"method":"shutdown"})") +
+      message(R"({"jsonrpc":"2.0","method":"exit"})"));
+  std::ostringstream out;
+
+  ASSERT_EQ(runLanguageServer(in, out), EXIT_SUCCESS);
+  const std::vector<json::Value> messages = parseMessages(out.str());
+  ASSERT_EQ(messages.size(), 6);
+
+  // the new workspace still sees the saved file and the unsaved buffer
+  ASSERT_EQ(messages[2]["id"].asNumber(), 1);
+  ASSERT_EQ(messages[3]["params"]["diagnostics"].asArray().size(), 1);
+  ASSERT_EQ(messages[4]["params"]["uri"].asString(), mainUri);
+  ASSERT_TRUE(messages[4]["params"]["diagnostics"].asArray().empty());
+}
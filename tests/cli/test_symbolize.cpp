@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <cli/symbolize.h>
+#include <compiler/json.h>
+
+TEST(test_symbolize, symbolize_text) {
+  const std::string sourceMap = R"({
+  "namespace": "foo",
+  "functions": {
+    "foo:bar": {"kind": "function", "function": "bar", "file": "a.mcfunc", "line": 1, "column": 6},
+    "zzz__.foo:f_00002": {"kind": "function", "function": "baz", "file": "a.mcfunc", "line": 3, "column": 6},
+    "zzz__.foo:w_00003": {"kind": "scope", "function": "baz", "file": "a.mcfunc", "line": 4, "column": 22},
+    "zzz__.foo:tick_schedule": {"kind": "generated"}
+  }
+})";
+
+  ASSERT_EQ(symbolizeText("[00] zzz__.foo:f_00002 (3)\n"
+                          "[01] | function zzz__.foo:w_00003\n"
+                          "[02] foo:bar zzz__.foo:tick_schedule zzz__.foo:f_000022 foo:barx\n",
+                          sourceMap),
+            "[00] zzz__.foo:f_00002 (baz at a.mcfunc:3:6) (3)\n"
+            "[01] | function zzz__.foo:w_00003 (scope in baz at a.mcfunc:4:22)\n"
+            "[02] foo:bar (bar at a.mcfunc:1:6) zzz__.foo:tick_schedule zzz__.foo:f_000022 "
+            "foo:barx\n");
+
+  ASSERT_THROW(symbolizeText("", "{}"), json::ParseError);
+  ASSERT_THROW(symbolizeText("", "not json"), json::ParseError);
+}
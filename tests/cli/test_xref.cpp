@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include <cli/xref.h>
+#include <compiler/XrefIndex.h>
+#include <compiler/generation/generateXrefIndex.h>
+#include <compiler/vfs.h>
+
+TEST(test_xref, xref_text) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::filesystem::path mainPath = mount.path() / "main.mcfunc";
+  const std::filesystem::path indexPath = mount.path() / "index.bin";
+  ASSERT_TRUE(files->createDirectories(mount.path()));
+  ASSERT_TRUE(files->writeFile(mainPath, "void main() {\n"
+                                         "  foo();\n"
+                                         "}\n"
+                                         "void foo() {}\n"));
+
+  SourceFiles sourceFiles;
+  sourceFiles.emplace_back(mainPath, mount.path());
+  sourceFiles.evaluateAll(CompileOptions());
+  ASSERT_TRUE(files->writeFile(indexPath, generateXrefIndex(sourceFiles)));
+  const XrefIndex index(indexPath);
+
+  const std::string path = mainPath.generic_string();
+  ASSERT_EQ(xrefText(index, "foo"), path + ":4:6: definition\n" + path + ":2:3: call\n");
+  ASSERT_EQ(xrefText(index, "missing"), "");
+
+  // only the byte offset is known once the file is gone
+  ASSERT_TRUE(files->removeAll(mainPath));
+  ASSERT_EQ(xrefText(index, "main"), path + " (byte 5): definition\n");
+}
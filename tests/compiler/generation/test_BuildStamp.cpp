@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+
+#include <compiler/generation/BuildStamp.h>
+#include <TempDirectory.h>
+
+TEST(test_BuildStamp, up_to_date) {
+  const TempDirectory dir("mcfunc_test_BuildStamp");
+  const std::filesystem::path input = dir.writeFile("main.mcfunc", "void foo() {}\n");
+  const std::filesystem::path output = dir.writeFile("out.mcfunction", "say foo\n");
+  const std::filesystem::path stampPath = dir.path() / BuildStamp::fileName;
+  const std::filesystem::file_time_type outputTime = std::filesystem::last_write_time(output);
+
+  BuildStamp("key", {input}).write(stampPath, {output}, "Merged 0 functions.\n");
+  ASSERT_EQ(BuildStamp("key", {input}).messagesIfUpToDate(stampPath), "Merged 0 functions.\n");
+
+  // different arguments or input files
+  ASSERT_FALSE(BuildStamp("other key", {input}).messagesIfUpToDate(stampPath));
+  ASSERT_FALSE(BuildStamp("key", {input, output}).messagesIfUpToDate(stampPath));
+  ASSERT_FALSE(BuildStamp("key", {}).messagesIfUpToDate(stampPath));
+
+  // an output that was changed, even if its size is the same
+  dir.writeFile("out.mcfunction", "say something else\n");
+  ASSERT_FALSE(BuildStamp("key", {input}).messagesIfUpToDate(stampPath));
+  dir.writeFile("out.mcfunction", "say bar\n");
+  std::filesystem::last_write_time(output, outputTime + std::chrono::seconds(1));
+  ASSERT_FALSE(BuildStamp("key", {input}).messagesIfUpToDate(stampPath));
+  dir.writeFile("out.mcfunction", "say foo\n");
+  std::filesystem::last_write_time(output, outputTime);
+  ASSERT_TRUE(BuildStamp("key", {input}).messagesIfUpToDate(stampPath));
+
+  // an input that was changed
+  dir.writeFile("main.mcfunc", "void foo() { /say hi; }\n");
+  ASSERT_FALSE(BuildStamp("key", {input}).messagesIfUpToDate(stampPath));
+}
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+#include <compiler/generation/generateDepfile.h>
+
+TEST(test_generateDepfile, dependencies_and_escaping) {
+  // paths outside of the working directory are written as they are
+  const std::filesystem::path root = "/mcfunc_test_generateDepfile";
+
+  const std::string depfile = generateDepfile(
+      {root / "data/.mcfunc_stamp", root / "data/$out.json"},
+      {root / "src/main.mcfunc", root / "src/sub dir/a#b.json"}, {root / "src"});
+
+  ASSERT_EQ(depfile, "/mcfunc_test_generateDepfile/data/.mcfunc_stamp \\\n"
+                     " /mcfunc_test_generateDepfile/data/$$out.json: \\\n"
+                     " /mcfunc_test_generateDepfile/src/main.mcfunc \\\n"
+                     " /mcfunc_test_generateDepfile/src/sub\\ dir/a\\#b.json \\\n"
+                     " /mcfunc_test_generateDepfile/src \\\n"
+                     " /mcfunc_test_generateDepfile/src/sub\\ dir\n"
+                     "\n"
+                     "/mcfunc_test_generateDepfile/src/main.mcfunc:\n"
+                     "\n"
+                     "/mcfunc_test_generateDepfile/src/sub\\ dir/a\\#b.json:\n"
+                     "\n"
+                     "/mcfunc_test_generateDepfile/src:\n"
+                     "\n"
+                     "/mcfunc_test_generateDepfile/src/sub\\ dir:\n");
+}
+
+TEST(test_generateDepfile, relative_to_working_directory) {
+  const std::filesystem::path workingDirectory = std::filesystem::current_path();
+
+  const std::string depfile =
+      generateDepfile({workingDirectory / "data/.mcfunc_stamp"},
+                      {workingDirectory / "src/main.mcfunc"}, {workingDirectory / "src"});
+
+  ASSERT_EQ(depfile, "data/.mcfunc_stamp: \\\n"
+                     " src/main.mcfunc \\\n"
+                     " src\n"
+                     "\n"
+                     "src/main.mcfunc:\n"
+                     "\n"
+                     "src:\n");
+}
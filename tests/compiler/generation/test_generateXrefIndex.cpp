@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <compiler/XrefIndex.h>
+#include <compiler/compile_error.h>
+#include <compiler/generation/generateXrefIndex.h>
+#include <compiler/vfs.h>
+
+using Entries = std::vector<std::tuple<XrefIndex::Kind, std::string, size_t>>;
+
+/// Every entry in \p entries as (kind, file path, index in file).
+static Entries toTuples(const std::vector<XrefIndex::Entry>& entries) {
+  Entries ret;
+  for (const XrefIndex::Entry& entry : entries)
+    ret.emplace_back(entry.kind, std::string(entry.filePath), entry.indexInFile);
+  return ret;
+}
+
+TEST(test_generateXrefIndex, write_and_query) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::filesystem::path& root = mount.path();
+  const std::string mainPath = (root / "main.mcfunc").generic_string();
+  const std::string declarationPath = (root / "lib" / "helper.mcfunc").generic_string();
+  const std::string definitionPath = (root / "lib" / "helper_impl.mcfunc").generic_string();
+
+  const std::string mainContents = "import \"lib/helper.mcfunc\";\n"
+                                   "file \"data.json\" = \"{}\";\n"
+                                   "void main() {\n"
+                                   "  helper();\n"
+                                   "  { helper(); }\n"
+                                   "}\n";
+  const std::string declarationContents = "import \"lib/helper_impl.mcfunc\";\n"
+                                          "public void helper();\n";
+  const std::string definitionContents = "public void helper() {\n"
+                                         "  /execute as @a run: helper();\n"
+                                         "}\n";
+  ASSERT_TRUE(files->createDirectories(root / "lib"));
+  ASSERT_TRUE(files->writeFile(mainPath, mainContents));
+  ASSERT_TRUE(files->writeFile(declarationPath, declarationContents));
+  ASSERT_TRUE(files->writeFile(definitionPath, definitionContents));
+
+  SourceFiles sourceFiles;
+  sourceFiles.emplace_back(mainPath, root);
+  sourceFiles.emplace_back(declarationPath, root);
+  sourceFiles.emplace_back(definitionPath, root);
+  sourceFiles.evaluateAll(CompileOptions());
+
+  const std::filesystem::path indexPath = root / "index.bin";
+  ASSERT_TRUE(files->writeFile(indexPath, generateXrefIndex(sourceFiles)));
+  const XrefIndex index(indexPath);
+
+  // file paths are sorted
+  ASSERT_EQ(index.fileCount(), 3);
+  ASSERT_EQ(index.filePath(0), declarationPath);
+  ASSERT_EQ(index.filePath(1), definitionPath);
+  ASSERT_EQ(index.filePath(2), mainPath);
+
+  using Kind = XrefIndex::Kind;
+  // entries are sorted by kind, file, and index in file
+  ASSERT_EQ(
+      toTuples(index.find("helper")),
+      (Entries{{Kind::FUNCTION_DEFINITION, definitionPath, definitionContents.find("helper")},
+               {Kind::FUNCTION_DECLARATION, declarationPath, declarationContents.find("helper(")},
+               {Kind::FUNCTION_CALL, definitionPath, definitionContents.rfind("helper")},
+               {Kind::FUNCTION_CALL, mainPath, mainContents.find("helper();")},
+               {Kind::FUNCTION_CALL, mainPath, mainContents.rfind("helper();")}}));
+  ASSERT_EQ(toTuples(index.find("helper", Kind::FUNCTION_CALL)).size(), 3);
+  ASSERT_TRUE(index.find("helper", Kind::IMPORT).empty());
+  ASSERT_EQ(toTuples(index.find("main")),
+            (Entries{{Kind::FUNCTION_DEFINITION, mainPath, mainContents.find("main")}}));
+  ASSERT_EQ(toTuples(index.find("data.json")),
+            (Entries{{Kind::FILE_WRITE, mainPath, mainContents.find("\"data.json\"")}}));
+  ASSERT_EQ(toTuples(index.find("lib/helper.mcfunc")),
+            (Entries{{Kind::IMPORT, mainPath, mainContents.find("\"lib/helper.mcfunc\"")}}));
+  ASSERT_TRUE(index.find("missing").empty());
+  ASSERT_TRUE(index.find("").empty());
+}
+
+TEST(test_generateXrefIndex, invalid_indices) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::filesystem::path path = mount.path() / "index.bin";
+  ASSERT_TRUE(files->createDirectories(mount.path()));
+
+  ASSERT_THROW(XrefIndex{path}, compile_error::CouldntOpenFile);
+
+  ASSERT_TRUE(files->writeFile(path, "not an index"));
+  ASSERT_THROW(XrefIndex{path}, XrefIndex::FormatError);
+
+  // a header that says there are more files than there are
+  std::string header(XrefIndex::magic);
+  header += std::string("\x01\0\0\0\x05\0\0\0\0\0\0\0\0\0\0\0", 16);
+  ASSERT_TRUE(files->writeFile(path, header));
+  ASSERT_THROW(XrefIndex{path}, XrefIndex::FormatError);
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+#include <compiler/linking/FunctionCostEstimator.h>
+
+using FileWriteMap = std::unordered_map<std::filesystem::path, std::string>;
+
+TEST(test_FunctionCostEstimator, counts_commands) {
+  const FileWriteMap fileWriteMap = {
+      {"foo/function/a.mcfunction", "# comment\n\nsay 1\nsay 2\n"},
+      {"foo/function/b.mcfunction", "say 1\nfunction foo:a\nexecute if entity @s run \\\n\t"
+                                    "function foo:a\n"},
+  };
+  FunctionCostEstimator costEstimator(fileWriteMap);
+
+  ASSERT_EQ(costEstimator.functionCost("foo:a"), 2);
+  ASSERT_EQ(costEstimator.functionCost("foo:b"), 1 + (1 + 2) + (2 + 2));
+  // functions from other data packs can't be seen
+  ASSERT_EQ(costEstimator.functionCost("bar:a"), 1);
+  // function tags aren't followed
+  ASSERT_EQ(costEstimator.commandCost("function #foo:a"), 1);
+}
+
+TEST(test_FunctionCostEstimator, recursion) {
+  const FileWriteMap fileWriteMap = {
+      {"foo/function/a.mcfunction", "say 1\nfunction foo:b\n"},
+      {"foo/function/b.mcfunction", "say 1\nfunction foo:a\n"},
+  };
+  FunctionCostEstimator costEstimator(fileWriteMap);
+
+  ASSERT_EQ(costEstimator.functionCost("foo:a"), 4);
+}
+
+TEST(test_FunctionCostEstimator, selectors) {
+  ASSERT_EQ(FunctionCostEstimator::selectorEntityCount("@s"), 1);
+  ASSERT_EQ(FunctionCostEstimator::selectorEntityCount("@a"), FunctionCostEstimator::playerCount);
+  ASSERT_EQ(FunctionCostEstimator::selectorEntityCount("@e"), FunctionCostEstimator::entityCount);
+  ASSERT_EQ(FunctionCostEstimator::selectorEntityCount("@e[type=pig]"),
+            FunctionCostEstimator::typedEntityCount);
+  ASSERT_EQ(FunctionCostEstimator::selectorEntityCount("@e[type=!pig]"),
+            FunctionCostEstimator::entityCount);
+  ASSERT_EQ(FunctionCostEstimator::selectorEntityCount("@e[tag=x,limit=3]"), 3);
+
+  ASSERT_TRUE(FunctionCostEstimator::isUnfilteredSelector("@e"));
+  ASSERT_TRUE(FunctionCostEstimator::isUnfilteredSelector("@e[tag=x]"));
+  ASSERT_FALSE(FunctionCostEstimator::isUnfilteredSelector("@e[type=pig]"));
+  ASSERT_FALSE(FunctionCostEstimator::isUnfilteredSelector("@e[limit=1]"));
+  ASSERT_FALSE(FunctionCostEstimator::isUnfilteredSelector("@a"));
+}
+
+TEST(test_FunctionCostEstimator, fan_out) {
+  const FileWriteMap fileWriteMap;
+  FunctionCostEstimator costEstimator(fileWriteMap);
+
+  constexpr size_t players = FunctionCostEstimator::playerCount;
+  constexpr size_t entities = FunctionCostEstimator::entityCount;
+  constexpr size_t scan = FunctionCostEstimator::unfilteredSelectorCost;
+
+  ASSERT_EQ(costEstimator.commandCost("execute as @a at @s run say hi"), 1 + players);
+  ASSERT_EQ(costEstimator.commandCost("kill @e"), 1 + scan);
+  ASSERT_EQ(costEstimator.commandCost("execute as @e run execute as @a run say hi"),
+            1 + scan + entities * (1 + players));
+  // selectors in strings and brackets aren't arguments
+  ASSERT_EQ(costEstimator.commandCost("execute as @a[name=\"as @e\"] run say hi"), 1 + players);
+}
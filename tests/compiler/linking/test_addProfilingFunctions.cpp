@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <compiler/CompileOptions.h>
+#include <compiler/SourceFiles.h>
+#include <compiler/linking/link.h>
+#include <TempDirectory.h>
+
+TEST(test_addProfilingFunctions, counters_and_map) {
+  const TempDirectory dir("mcfunc_test_addProfilingFunctions");
+  dir.writeFile("main.mcfunc", "expose \"example\";\n"
+                               "void main() {\n"
+                               "  /say hi;\n"
+                               "  {\n"
+                               "    /say scoped;\n"
+                               "  }\n"
+                               "}\n");
+
+  SourceFiles sourceFiles;
+  sourceFiles.emplace_back(dir.path() / "main.mcfunc", dir.path());
+  CompileOptions compileOptions;
+  compileOptions.instrument = true;
+  std::vector<CompiledSourceFile> compiledSourceFiles = sourceFiles.evaluateAll(compileOptions);
+  const LinkResult result =
+      link(std::move(compiledSourceFiles), std::move(sourceFiles), {}, compileOptions);
+
+  const std::filesystem::path functionDir = "zzz__.example/function";
+  const std::string objective = "zzz__.example.profile";
+
+  // the scoreboard is created before anything else loads
+  ASSERT_FALSE(result.loadFuncCallNames.empty());
+  ASSERT_EQ(result.loadFuncCallNames[0], "zzz__.example:profile_load");
+  ASSERT_NE(result.fileWriteMap.at(functionDir / "profile_load.mcfunction")
+                .find("scoreboard objectives add " + objective + " dummy\n"),
+            std::string::npos);
+  ASSERT_NE(result.fileWriteMap.at(functionDir / "profile_reset.mcfunction")
+                .find("scoreboard players reset * " + objective + '\n'),
+            std::string::npos);
+
+  // every generated function file adds to its own counter, which is printed
+  const std::string& dumpContents = result.fileWriteMap.at(functionDir / "profile_dump.mcfunction");
+  size_t counterCount = 0;
+  for (const auto& [path, contents] : result.fileWriteMap) {
+    if (path.parent_path() != functionDir || path.stem().string().rfind("profile_", 0) == 0)
+      continue;
+    const std::string counter = '#' + path.stem().string();
+    ASSERT_NE(contents.find("scoreboard players add " + counter + ' ' + objective + " 1\n"),
+              std::string::npos);
+    ASSERT_NE(dumpContents.find("\"name\":\"" + counter + "\",\"objective\":\"" + objective),
+              std::string::npos);
+    counterCount++;
+  }
+  ASSERT_EQ(counterCount, 2);
+
+  // the map points each counter at where its code starts
+  const std::string& mapContents = result.fileWriteMap.at("zzz__.example/profile_map.json");
+  ASSERT_NE(mapContents.find("\"objective\": \"" + objective + '"'), std::string::npos);
+  ASSERT_NE(mapContents.find("\"kind\": \"function\", \"function\": \"main\""), std::string::npos);
+  ASSERT_NE(mapContents.find("\"line\": 2, \"column\": 6}"), std::string::npos);
+  ASSERT_NE(mapContents.find("\"kind\": \"scope\", \"function\": \"main\""), std::string::npos);
+  ASSERT_NE(mapContents.find("\"line\": 4, \"column\": 3}"), std::string::npos);
+}
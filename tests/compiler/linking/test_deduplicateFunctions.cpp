@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+#include <compiler/linking/deduplicateFunctions.h>
+
+TEST(test_deduplicateFunctions, merges_identical_files) {
+  const std::filesystem::path functionDir = "zzz__.example/function";
+  std::unordered_map<std::filesystem::path, std::string> fileWriteMap = {
+      {functionDir / "f_1.mcfunction", "say same\n"},
+      {functionDir / "f_2.mcfunction", "say same\n"},
+      {functionDir / "f_3.mcfunction", "say different\n"},
+      // these only become identical once 'f_2' is merged into 'f_1'
+      {functionDir / "f_4.mcfunction", "function zzz__.example:f_1\n"},
+      {functionDir / "f_5.mcfunction", "function zzz__.example:f_2\n"},
+      // exposed functions aren't merged but their calls are rewritten
+      {"example/function/main.mcfunction",
+       "function zzz__.example:f_2\nfunction zzz__.example:f_5\n"},
+      {"example/function/copy.mcfunction", "say same\n"}};
+
+  ASSERT_EQ(deduplicateFunctions(fileWriteMap, "example", {}, {}), 2);
+
+  ASSERT_EQ(fileWriteMap.size(), 5);
+  ASSERT_EQ(fileWriteMap.count(functionDir / "f_2.mcfunction"), 0);
+  ASSERT_EQ(fileWriteMap.count(functionDir / "f_5.mcfunction"), 0);
+  ASSERT_EQ(fileWriteMap.at(functionDir / "f_4.mcfunction"), "function zzz__.example:f_1\n");
+  ASSERT_EQ(fileWriteMap.at("example/function/main.mcfunction"),
+            "function zzz__.example:f_1\nfunction zzz__.example:f_4\n");
+  ASSERT_EQ(fileWriteMap.at("example/function/copy.mcfunction"), "say same\n");
+}
+
+TEST(test_deduplicateFunctions, keeps_tick_and_load_functions) {
+  const std::filesystem::path functionDir = "zzz__.example/function";
+  std::unordered_map<std::filesystem::path, std::string> fileWriteMap = {
+      {functionDir / "f_1.mcfunction", "say same\n"},
+      {functionDir / "f_2.mcfunction", "say same\n"},
+      {functionDir / "f_3.mcfunction", "say same\n"},
+      {functionDir / "f_4.mcfunction", "function zzz__.example:f_1\n"}};
+
+  // the tick and load functions stay (and the tick function replaces 'f_1')
+  ASSERT_EQ(deduplicateFunctions(fileWriteMap, "example", {"zzz__.example:f_2"},
+                                 {"zzz__.example:f_3"}),
+            1);
+  ASSERT_EQ(fileWriteMap.count(functionDir / "f_1.mcfunction"), 0);
+  ASSERT_EQ(fileWriteMap.count(functionDir / "f_2.mcfunction"), 1);
+  ASSERT_EQ(fileWriteMap.count(functionDir / "f_3.mcfunction"), 1);
+  ASSERT_EQ(fileWriteMap.at(functionDir / "f_4.mcfunction"), "function zzz__.example:f_2\n");
+}
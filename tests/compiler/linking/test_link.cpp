@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <compiler/FileWriteSourceFile.h>
+#include <compiler/SourceFiles.h>
+#include <compiler/compile_error.h>
+#include <compiler/linking/link.h>
+#include <compiler/vfs.h>
+
+/// Links the files in \p filePaths (relative to \p root , which is also the
+/// import directory).
+static LinkResult linkFiles(const std::filesystem::path& root,
+                            const std::vector<std::filesystem::path>& filePaths) {
+  SourceFiles sourceFiles;
+  for (const std::filesystem::path& filePath : filePaths)
+    sourceFiles.emplace_back(root / filePath, root);
+  std::vector<CompiledSourceFile> compiledSourceFiles = sourceFiles.evaluateAll(CompileOptions());
+  return link(std::move(compiledSourceFiles), std::move(sourceFiles), {}, CompileOptions());
+}
+
+TEST(test_link, multiple_namespaces) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::filesystem::path& root = mount.path();
+
+  ASSERT_TRUE(files->createDirectories(root / "alpha"));
+  ASSERT_TRUE(files->createDirectories(root / "beta" / "sub"));
+  ASSERT_TRUE(files->createDirectories(root / "lib"));
+  ASSERT_TRUE(files->writeFile(root / "alpha" / "main.mcfunc",
+                               "expose \"alpha\";\n"
+                               "import \"lib/util.mcfunc\";\n"
+                               "import \"beta/sub/greet.mcfunc\";\n"
+                               "load void start() { util(); greet(); }\n"
+                               "file \"data.json\" = `{}`;\n"));
+  ASSERT_TRUE(files->writeFile(root / "beta" / "main.mcfunc",
+                               "expose \"beta\";\n"
+                               "import \"lib/util.mcfunc\";\n"
+                               "tick void update() { util(); }\n"
+                               "file \"data.json\" = `[]`;\n"));
+  ASSERT_TRUE(files->writeFile(root / "beta" / "sub" / "greet.mcfunc",
+                               "public void greet() expose \"hi\" { /say hi; }\n"));
+  ASSERT_TRUE(files->writeFile(root / "core.mcfunc", "expose \"core\";\n"));
+  ASSERT_TRUE(
+      files->writeFile(root / "lib" / "util.mcfunc", "public void util() { /say util; }\n"));
+
+  const LinkResult result =
+      linkFiles(root, {"alpha/main.mcfunc", "beta/main.mcfunc", "beta/sub/greet.mcfunc",
+                       "core.mcfunc", "lib/util.mcfunc"});
+
+  ASSERT_EQ(result.exposedNamespace, "core");
+  ASSERT_EQ(result.exposedNamespaces, (std::vector<std::string>{"core", "alpha", "beta"}));
+
+  // each file's functions and file writes go in its namespace
+  ASSERT_EQ(result.loadFuncCallNames.size(), 1);
+  ASSERT_EQ(result.loadFuncCallNames[0].rfind("zzz__.alpha:", 0), 0);
+  ASSERT_EQ(result.tickFuncCallNames.size(), 1);
+  ASSERT_EQ(result.tickFuncCallNames[0].rfind("zzz__.beta:", 0), 0);
+  ASSERT_EQ(result.fileWriteMap.at("alpha/data.json"), "{}");
+  ASSERT_EQ(result.fileWriteMap.at("beta/data.json"), "[]");
+  ASSERT_TRUE(result.fileWriteMap.count("beta/function/hi.mcfunction"));
+
+  // calls to public functions use the namespace of the file that defines them
+  size_t utilFileCount = 0;
+  for (const auto& [path, contents] : result.fileWriteMap) {
+    if (contents.find("say util") != std::string::npos) {
+      ASSERT_EQ(*path.begin(), "zzz__.core");
+      utilFileCount++;
+    }
+  }
+  ASSERT_EQ(utilFileCount, 1);
+  const std::string startCallName = result.loadFuncCallNames[0];
+  const std::filesystem::path startPath =
+      std::filesystem::path("zzz__.alpha") / "function" /
+      (startCallName.substr(startCallName.find(':') + 1) + ".mcfunction");
+  const std::string& startContents = result.fileWriteMap.at(startPath);
+  ASSERT_NE(startContents.find("function zzz__.core:"), std::string::npos);
+  ASSERT_NE(startContents.find("function beta:hi"), std::string::npos);
+}
+
+TEST(test_link, main_namespace) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::filesystem::path& root = mount.path();
+
+  ASSERT_TRUE(files->createDirectories(root / "a" / "sub"));
+  ASSERT_TRUE(files->createDirectories(root / "b"));
+  ASSERT_TRUE(files->createDirectories(root / "lib"));
+  ASSERT_TRUE(files->writeFile(root / "a" / "main.mcfunc", "expose \"zeta\";\n"));
+  ASSERT_TRUE(files->writeFile(root / "a" / "sub" / "main.mcfunc", "expose \"alpha\";\n"));
+  ASSERT_TRUE(files->writeFile(root / "b" / "main.mcfunc", "expose \"beta\";\n"));
+  ASSERT_TRUE(files->writeFile(root / "lib" / "main.mcfunc", "expose \"lib\";\n"));
+  ASSERT_TRUE(files->writeFile(root / "main.mcfunc", "expose \"zzz\";\n"));
+
+  // the namespace exposed from the highest directory, whatever the file order
+  ASSERT_EQ(linkFiles(root, {"a/sub/main.mcfunc", "a/main.mcfunc", "main.mcfunc"}).exposedNamespace,
+            "zzz");
+  ASSERT_EQ(linkFiles(root, {"main.mcfunc", "a/main.mcfunc", "a/sub/main.mcfunc"}).exposedNamespace,
+            "zzz");
+  ASSERT_EQ(linkFiles(root, {"a/sub/main.mcfunc", "a/main.mcfunc"}).exposedNamespace, "zeta");
+
+  // equally high directories go by name
+  const LinkResult result = linkFiles(root, {"a/main.mcfunc", "lib/main.mcfunc", "b/main.mcfunc"});
+  ASSERT_EQ(result.exposedNamespace, "beta");
+  ASSERT_EQ(result.exposedNamespaces, (std::vector<std::string>{"beta", "zeta", "lib"}));
+}
+
+TEST(test_link, namespace_errors) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::filesystem::path& root = mount.path();
+
+  ASSERT_TRUE(files->createDirectories(root / "a"));
+  ASSERT_TRUE(files->createDirectories(root / "b"));
+  ASSERT_TRUE(files->createDirectories(root / "c"));
+  ASSERT_TRUE(files->writeFile(root / "a" / "one.mcfunc", "expose \"one\";\n"));
+  ASSERT_TRUE(files->writeFile(root / "a" / "two.mcfunc", "expose \"two\";\n"));
+  ASSERT_TRUE(files->writeFile(root / "b" / "one.mcfunc", "expose \"one\";\n"));
+  ASSERT_TRUE(files->writeFile(root / "c" / "three.mcfunc", "expose \"three\";\n"));
+  ASSERT_TRUE(files->writeFile(root / "loose.mcfunc", "void loose() {}\n"));
+
+  // with 1 namespace every file belongs to it
+  ASSERT_NO_THROW(linkFiles(root, {"a/one.mcfunc", "loose.mcfunc"}));
+
+  // 2 namespaces from the same directory or the same namespace twice
+  ASSERT_THROW(linkFiles(root, {"a/one.mcfunc", "a/two.mcfunc"}),
+               compile_error::DeclarationConflict);
+  ASSERT_THROW(linkFiles(root, {"a/one.mcfunc", "b/one.mcfunc"}),
+               compile_error::DeclarationConflict);
+
+  // a file that no namespace covers
+  ASSERT_THROW(linkFiles(root, {"a/one.mcfunc", "c/three.mcfunc", "loose.mcfunc"}),
+               compile_error::NoExposedNamespace);
+  ASSERT_THROW(linkFiles(root, {"loose.mcfunc"}), compile_error::NoExposedNamespace);
+}
+
+TEST(test_link, tick_schedules) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::filesystem::path& root = mount.path();
+
+  ASSERT_TRUE(files->createDirectories(root));
+  ASSERT_TRUE(files->writeFile(root / "main.mcfunc",
+                               "expose \"example\";\n"
+                               "tick void every_tick() expose \"every_tick\" { /say 0; }\n"
+                               "tick(every 20) void slow() expose \"slow\" { /say 1; }\n"
+                               "tick(spread 2) void big() expose \"big\" { /say 1; /say 2; }\n"
+                               "tick(spread 2) void small() expose \"small\" { /say 1; }\n"
+                               "load void start() expose \"start\" {}\n"));
+
+  const LinkResult result = linkFiles(root, {"main.mcfunc"});
+
+  // only the dispatcher and unscheduled functions run every tick
+  ASSERT_EQ(result.tickFuncCallNames,
+            (std::vector<std::string>{"example:every_tick", "zzz__.example:tick_schedule"}));
+  // the dispatcher's scoreboard is created before anything else loads
+  ASSERT_EQ(result.loadFuncCallNames,
+            (std::vector<std::string>{"zzz__.example:tick_schedule_load", "example:start"}));
+  ASSERT_EQ(result.scheduledTickFuncs.size(), 3);
+
+  ASSERT_NE(result.fileWriteMap.at("zzz__.example/function/tick_schedule_load.mcfunction")
+                .find("scoreboard objectives add zzz__.example dummy\n"),
+            std::string::npos);
+
+  // the 2 spread functions end up on different ticks and the more expensive
+  // one avoids the tick that the 'every' function runs on
+  const std::string& dispatcher =
+      result.fileWriteMap.at("zzz__.example/function/tick_schedule.mcfunction");
+  const std::string expected = "scoreboard players add #period_2 zzz__.example 1\n"
+                               "execute if score #period_2 zzz__.example matches 2.. run "
+                               "scoreboard players set #period_2 zzz__.example 0\n"
+                               "execute if score #period_2 zzz__.example matches 0 run "
+                               "function example:small\n"
+                               "execute if score #period_2 zzz__.example matches 1 run "
+                               "function example:big\n"
+                               "scoreboard players add #period_20 zzz__.example 1\n"
+                               "execute if score #period_20 zzz__.example matches 20.. run "
+                               "scoreboard players set #period_20 zzz__.example 0\n"
+                               "execute if score #period_20 zzz__.example matches 0 run "
+                               "function example:slow\n";
+  ASSERT_EQ(dispatcher.substr(dispatcher.find("\n\n") + 2), expected);
+}
+
+TEST(test_link, missing_file_write_source) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::filesystem::path& root = mount.path();
+
+  ASSERT_TRUE(files->createDirectories(root));
+  ASSERT_TRUE(files->writeFile(root / "main.mcfunc", "expose \"example\";\n"
+                                                     "file \"data.json\" = \"data.json\";\n"));
+  ASSERT_TRUE(files->writeFile(root / "data.json", "{}"));
+
+  SourceFiles sourceFiles;
+  sourceFiles.emplace_back(root / "main.mcfunc", root);
+  const std::vector<CompiledSourceFile> compiledSourceFiles =
+      sourceFiles.evaluateAll(CompileOptions());
+  const std::vector<FileWriteSourceFile> fileWriteSourceFiles = {
+      FileWriteSourceFile(root / "data.json", root)};
+
+  const LinkResult result =
+      link(compiledSourceFiles, sourceFiles, fileWriteSourceFiles, CompileOptions());
+  ASSERT_EQ(result.fileCopyMap.at("example/data.json"), root / "data.json");
+
+  // a file that's gone is found before anything is written to the data pack
+  ASSERT_TRUE(files->removeAll(root / "data.json"));
+  ASSERT_THROW(link(compiledSourceFiles, sourceFiles, fileWriteSourceFiles, CompileOptions()),
+               compile_error::CouldntOpenFile);
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <compiler/linking/scheduleTickFunctions.h>
+
+using FileWriteMap = std::unordered_map<std::filesystem::path, std::string>;
+
+TEST(test_scheduleTickFunctions, balances_spread_functions) {
+  FileWriteMap fileWriteMap = {
+      {"foo/function/a.mcfunction", "say 1\nsay 2\nsay 3\nsay 4\n"},
+      {"foo/function/b.mcfunction", "say 1\nsay 2\nsay 3\n"},
+      {"foo/function/c.mcfunction", "say 1\nsay 2\n"},
+      {"foo/function/d.mcfunction", "say 1\n"},
+  };
+  std::vector<ScheduledTickFunction> funcs = {
+      {"foo:a", {TickSchedule::Kind::EVERY, 4}},
+      {"foo:b", {TickSchedule::Kind::SPREAD, 4}},
+      {"foo:c", {TickSchedule::Kind::SPREAD, 2}},
+      {"foo:d", {TickSchedule::Kind::SPREAD, 2}},
+  };
+  std::vector<std::string> tickFuncCallNames, loadFuncCallNames = {"foo:load"};
+  scheduleTickFunctions(funcs, fileWriteMap, tickFuncCallNames, loadFuncCallNames, "foo");
+
+  // 'every' functions stay on the 1st tick and the rest are placed around them
+  ASSERT_EQ(funcs[0].phase, 0);
+  ASSERT_EQ(funcs[0].estimatedCost, 4);
+  ASSERT_NE(funcs[1].phase, 0);
+  ASSERT_NE(funcs[2].phase, funcs[3].phase);
+  ASSERT_EQ(busiestScheduledTickCost(funcs), 5);
+
+  ASSERT_EQ(tickFuncCallNames, (std::vector<std::string>{"zzz__.foo:tick_schedule"}));
+  ASSERT_EQ(loadFuncCallNames,
+            (std::vector<std::string>{"zzz__.foo:tick_schedule_load", "foo:load"}));
+  ASSERT_TRUE(fileWriteMap.count("zzz__.foo/function/tick_schedule.mcfunction"));
+  ASSERT_TRUE(fileWriteMap.count("zzz__.foo/function/tick_schedule_load.mcfunction"));
+}
+
+TEST(test_scheduleTickFunctions, nothing_scheduled) {
+  FileWriteMap fileWriteMap;
+  std::vector<ScheduledTickFunction> funcs;
+  std::vector<std::string> tickFuncCallNames, loadFuncCallNames;
+  scheduleTickFunctions(funcs, fileWriteMap, tickFuncCallNames, loadFuncCallNames, "foo");
+
+  ASSERT_TRUE(fileWriteMap.empty());
+  ASSERT_TRUE(tickFuncCallNames.empty());
+  ASSERT_TRUE(loadFuncCallNames.empty());
+  ASSERT_EQ(busiestScheduledTickCost(funcs), 0);
+}
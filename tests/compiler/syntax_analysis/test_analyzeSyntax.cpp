@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include <compiler/SourceFiles.h>
+#include <compiler/TickSchedule.h>
+#include <compiler/compile_error.h>
+#include <compiler/vfs.h>
+
+/// Tokenizes and analyzes the syntax of a file with the contents
+/// \param contents and returns it.
+static SourceFiles analyzeFile(const std::string& contents) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  EXPECT_TRUE(files->createDirectories(mount.path()));
+  EXPECT_TRUE(files->writeFile(mount.path() / "main.mcfunc", contents));
+
+  SourceFiles sourceFiles;
+  sourceFiles.emplace_back(mount.path() / "main.mcfunc", mount.path());
+  sourceFiles.back().tokenize();
+  sourceFiles.back().analyzeSyntax(sourceFiles);
+  return sourceFiles;
+}
+
+TEST(test_analyzeSyntax, tick_schedules) {
+  const SourceFiles sourceFiles = analyzeFile("tick void a() {}\n"
+                                              "tick(every 20) void b() {}\n"
+                                              "public tick(spread 4) load void c() {}\n"
+                                              "tick(every 1) void d() {}\n");
+  const symbol::FunctionTable& functions = sourceFiles.back().functionSymbolTable();
+
+  ASSERT_EQ(functions.getSymbol("a").tickSchedule(), TickSchedule());
+  ASSERT_EQ(functions.getSymbol("b").tickSchedule(),
+            (TickSchedule{TickSchedule::Kind::EVERY, 20}));
+  ASSERT_EQ(functions.getSymbol("c").tickSchedule(),
+            (TickSchedule{TickSchedule::Kind::SPREAD, 4}));
+  ASSERT_TRUE(functions.getSymbol("c").isPublic());
+  ASSERT_TRUE(functions.getSymbol("c").isLoadFunc());
+  // running every tick is the same as having no schedule
+  ASSERT_EQ(functions.getSymbol("d").tickSchedule(), TickSchedule());
+}
+
+TEST(test_analyzeSyntax, bad_tick_schedules) {
+  ASSERT_THROW(analyzeFile("tick(often 20) void a() {}\n"), compile_error::UnexpectedToken);
+  ASSERT_THROW(analyzeFile("tick(every 0) void a() {}\n"), compile_error::UnexpectedToken);
+  ASSERT_THROW(analyzeFile("tick(every 2x) void a() {}\n"), compile_error::UnexpectedToken);
+  ASSERT_THROW(analyzeFile("tick(every 1000001) void a() {}\n"), compile_error::UnexpectedToken);
+  ASSERT_THROW(analyzeFile("tick(every) void a() {}\n"), compile_error::UnexpectedToken);
+
+  // every declaration needs the same schedule
+  ASSERT_NO_THROW(analyzeFile("tick(every 20) void a();\ntick(every 20) void a() {}\n"));
+  ASSERT_THROW(analyzeFile("tick(every 20) void a();\ntick(spread 20) void a() {}\n"),
+               compile_error::DeclarationConflict);
+  ASSERT_THROW(analyzeFile("tick(every 20) void a();\ntick void a() {}\n"),
+               compile_error::DeclarationConflict);
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include <compiler/ImportGraph.h>
+#include <compiler/SourceFiles.h>
+#include <TempDirectory.h>
+
+/// Tokenizes and analyzes the source file at \p index in \p sourceFiles.
+static void evaluate(SourceFiles& sourceFiles, size_t index) {
+  sourceFiles[index].clearEvaluation();
+  sourceFiles[index].tokenize();
+  sourceFiles[index].analyzeSyntax(sourceFiles);
+}
+
+TEST(test_ImportGraph, importers_and_interface_hash) {
+  const TempDirectory dir("mcfunc_test_ImportGraph");
+  dir.writeFile("lib.mcfunc", "public void a() { /say a; }\nvoid b() { /say b; }\n");
+  dir.writeFile("main.mcfunc", "import \"lib.mcfunc\";\nvoid c() { a(); }\n");
+
+  SourceFiles sourceFiles;
+  sourceFiles.emplace_back(dir.path() / "lib.mcfunc", dir.path());
+  sourceFiles.emplace_back(dir.path() / "main.mcfunc", dir.path());
+  evaluate(sourceFiles, 0);
+  evaluate(sourceFiles, 1);
+
+  ImportGraph importGraph(sourceFiles);
+  ASSERT_EQ(importGraph.importsOf(1), std::vector<size_t>{0});
+  ASSERT_EQ(importGraph.importersOf(0), std::vector<size_t>{1});
+  ASSERT_TRUE(importGraph.importersOf(1).empty());
+
+  const uint64_t hash = ImportGraph::interfaceHash(sourceFiles[0]);
+
+  // bodies and private functions aren't part of the interface
+  dir.writeFile("lib.mcfunc", "void b2() {}\npublic void a() { /say changed; }\n");
+  evaluate(sourceFiles, 0);
+  ASSERT_EQ(ImportGraph::interfaceHash(sourceFiles[0]), hash);
+
+  // qualifiers are
+  dir.writeFile("lib.mcfunc", "public tick void a() { /say a; }\n");
+  evaluate(sourceFiles, 0);
+  ASSERT_NE(ImportGraph::interfaceHash(sourceFiles[0]), hash);
+
+  // removing an import removes the edge in both directions
+  dir.writeFile("main.mcfunc", "void c() {}\n");
+  evaluate(sourceFiles, 1);
+  importGraph.updateImports(sourceFiles, 1);
+  ASSERT_TRUE(importGraph.importsOf(1).empty());
+  ASSERT_TRUE(importGraph.importersOf(0).empty());
+}
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+
+#include <compiler/CompileOptions.h>
+#include <compiler/IncrementalBuild.h>
+#include <compiler/SourceFiles.h>
+#include <compiler/fileToStr.h>
+#include <TempDirectory.h>
+
+TEST(test_IncrementalBuild, rebuild_after_edit) {
+  const TempDirectory dir("mcfunc_test_IncrementalBuild");
+  const std::filesystem::path libPath =
+      dir.writeFile("src/lib.mcfunc", "public void a() { /say a; }\n");
+  const std::filesystem::path mainPath =
+      dir.writeFile("src/main.mcfunc", "expose \"example\";\nimport \"lib.mcfunc\";\n"
+                                       "void main() expose \"main\" { /say main; a(); }\n");
+  const std::filesystem::path outputDir = dir.path() / "data";
+
+  SourceFiles sourceFiles;
+  sourceFiles.emplace_back(libPath, dir.path() / "src");
+  sourceFiles.emplace_back(mainPath, dir.path() / "src");
+  IncrementalBuild build(std::filesystem::path(outputDir), std::move(sourceFiles), {},
+                         CompileOptions(), {}, {});
+  build.buildAll(true);
+
+  const std::filesystem::path mainFunctionPath = outputDir / "example/function/main.mcfunction";
+  ASSERT_NE(fileToStr(mainFunctionPath).find("say main\n"), std::string::npos);
+
+  // saving a file without changing it doesn't rebuild anything
+  ASSERT_FALSE(build.update({mainPath}).rebuilt);
+
+  // only the edited file is compiled again (and its interface didn't change so
+  // the file that imports it isn't checked)
+  dir.writeFile("src/lib.mcfunc", "public void a() { /say changed; }\n");
+  const IncrementalBuild::UpdateResult libResult = build.update({libPath});
+  ASSERT_TRUE(libResult.rebuilt);
+  ASSERT_EQ(libResult.recompiledSourceFileCount, 1);
+  ASSERT_EQ(libResult.checkedImporterCount, 0);
+
+  dir.writeFile("src/main.mcfunc", "expose \"example\";\nimport \"lib.mcfunc\";\n"
+                                   "void main() expose \"main\" { /say edited; a(); }\n");
+  const IncrementalBuild::UpdateResult mainResult = build.update({mainPath});
+  ASSERT_TRUE(mainResult.rebuilt);
+  ASSERT_EQ(mainResult.recompiledSourceFileCount, 1);
+  ASSERT_NE(fileToStr(mainFunctionPath).find("say edited\n"), std::string::npos);
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <string>
+
+#include <compiler/Jobserver.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+
+TEST(test_Jobserver, pipe_tokens) {
+  int pipeFDs[2];
+  ASSERT_EQ(pipe(pipeFDs), 0);
+  ASSERT_EQ(write(pipeFDs[1], "++", 2), 2);
+
+  const std::string makeFlags = "-j3 --jobserver-auth=" + std::to_string(pipeFDs[0]) + ',' +
+                                std::to_string(pipeFDs[1]);
+  setenv("MAKEFLAGS", makeFlags.c_str(), 1);
+
+  {
+    Jobserver jobserver;
+    ASSERT_TRUE(jobserver.isConnected());
+    ASSERT_TRUE(jobserver.tryAcquire());
+    ASSERT_TRUE(jobserver.tryAcquire());
+    ASSERT_FALSE(jobserver.tryAcquire()) << "There should only be 2 tokens.";
+
+    jobserver.release();
+    ASSERT_TRUE(jobserver.tryAcquire()) << "The released token should be back.";
+
+    // both tokens are given back when the jobserver is destroyed
+  }
+
+  fcntl(pipeFDs[0], F_SETFL, O_NONBLOCK);
+  char tokens[3];
+  ASSERT_EQ(read(pipeFDs[0], tokens, 3), 2);
+  ASSERT_EQ(std::string(tokens, 2), "++");
+
+  // a jobserver that was closed by make isn't used
+  close(pipeFDs[0]);
+  close(pipeFDs[1]);
+  ASSERT_FALSE(Jobserver().isConnected());
+
+  unsetenv("MAKEFLAGS");
+}
+
+TEST(test_Jobserver, no_jobserver) {
+  setenv("MAKEFLAGS", "-j1 --no-print-directory", 1);
+  Jobserver jobserver;
+  ASSERT_FALSE(jobserver.isConnected());
+  ASSERT_FALSE(jobserver.tryAcquire());
+  unsetenv("MAKEFLAGS");
+}
+
+#endif
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include <compiler/SourceFiles.h>
+#include <compiler/compile_error.h>
+#include <compiler/vfs.h>
+
+TEST(test_SourceFiles, evaluate_batch) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::filesystem::path& root = mount.path();
+  ASSERT_TRUE(files->createDirectories(root / "lib"));
+  ASSERT_TRUE(files->writeFile(root / "lib" / "shared.mcfunc", "public void shared() {}\n"));
+  ASSERT_TRUE(files->writeFile(root / "a.mcfunc", "import \"shared.mcfunc\";\n"
+                                                  "void main() { shared(); }\n"));
+  ASSERT_TRUE(files->writeFile(root / "b.mcfunc", "void main( {}\n"));
+
+  // (the shared file is imported relative to the library directory)
+  SourceFiles first;
+  first.emplace_back(root / "a.mcfunc", root);
+  first.emplace_back(root / "lib" / "shared.mcfunc", root / "lib");
+  SourceFiles second;
+  second.emplace_back(root / "lib" / "shared.mcfunc", root / "lib");
+  second.emplace_back(root / "b.mcfunc", root);
+  SourceFiles third;
+  third.emplace_back(root / "lib" / "shared.mcfunc", root / "lib");
+
+  std::vector<SourceFiles::BatchResult> results =
+      SourceFiles::evaluateBatch({&first, &second, &third}, std::vector<CompileOptions>(3));
+  ASSERT_EQ(results.size(), 3);
+
+  ASSERT_FALSE(results[0].exception);
+  ASSERT_EQ(results[0].compiledSourceFiles.size(), 2);
+  ASSERT_FALSE(results[2].exception);
+  ASSERT_EQ(results[2].compiledSourceFiles.size(), 1);
+
+  // the list with the error doesn't stop the others
+  ASSERT_TRUE(results[1].exception);
+  ASSERT_THROW(std::rethrow_exception(results[1].exception), compile_error::Generic);
+
+  // copied tokens refer to the source file they were copied into
+  ASSERT_EQ(third[0].tokens().size(), first[1].tokens().size());
+  for (size_t i = 0; i < third[0].tokens().size(); i++) {
+    ASSERT_EQ(&third[0].tokens()[i].sourceFile(), &third[0]);
+    ASSERT_EQ(third[0].tokens()[i].kind(), first[1].tokens()[i].kind());
+    ASSERT_EQ(third[0].tokens()[i].indexInFile(), first[1].tokens()[i].indexInFile());
+  }
+}
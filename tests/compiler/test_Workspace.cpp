@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <compiler/Workspace.h>
+#include <compiler/vfs.h>
+
+using Paths = std::vector<std::filesystem::path>;
+
+/// \p location as (path, line, column, length) so it can be compared.
+static std::tuple<std::filesystem::path, size_t, size_t, size_t>
+toTuple(const Workspace::Location& location) {
+  return {location.path, location.line, location.column, location.length};
+}
+
+/// Every location in \p locations as (path, line, column, length).
+static std::vector<std::tuple<std::filesystem::path, size_t, size_t, size_t>>
+toTuples(const std::vector<Workspace::Location>& locations) {
+  std::vector<std::tuple<std::filesystem::path, size_t, size_t, size_t>> ret;
+  for (const Workspace::Location& location : locations)
+    ret.push_back(toTuple(location));
+  return ret;
+}
+
+TEST(test_Workspace, diagnostics_and_updates) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::filesystem::path& root = mount.path();
+
+  ASSERT_TRUE(files->createDirectories(root / "lib"));
+  ASSERT_TRUE(files->writeFile(root / "main.mcfunc", "import \"lib/util.mcfunc\";\n"
+                                                     "void main() {\n"
+                                                     "  helper();\n"
+                                                     "}\n"));
+  ASSERT_TRUE(files->writeFile(root / "lib" / "util.mcfunc", "public void helper() {}\n"));
+  ASSERT_TRUE(files->writeFile(root / "lib" / "broken.mcfunc", "void oops( {}\n"));
+  ASSERT_TRUE(files->writeFile(root / "lib" / "notes.txt", ""));
+
+  Workspace workspace(root);
+  ASSERT_EQ(workspace.sourceFileCount(), 3);
+  ASSERT_EQ(workspace.pathsWithDiagnostics(), Paths{root / "lib" / "broken.mcfunc"});
+
+  // renaming a public function in an unsaved buffer breaks the file importing
+  // it (without changing the saved file)
+  ASSERT_EQ(workspace.setBuffer(root / "lib" / "util.mcfunc", "public void renamed() {}\n"),
+            Paths{root / "main.mcfunc"});
+  const Workspace::Diagnostic* diagnostic = workspace.diagnostic(root / "main.mcfunc");
+  ASSERT_NE(diagnostic, nullptr);
+  ASSERT_EQ(diagnostic->line, 3);
+  ASSERT_EQ(diagnostic->column, 3);
+  ASSERT_EQ(diagnostic->length, 6);
+  std::string contents;
+  ASSERT_TRUE(files->readFile(root / "lib" / "util.mcfunc", contents));
+  ASSERT_EQ(contents, "public void helper() {}\n");
+
+  // function bodies don't affect other files
+  ASSERT_TRUE(workspace.setBuffer(root / "lib" / "util.mcfunc",
+                                  "public void renamed() { /say hi; }\n")
+                  .empty());
+
+  // closing the buffer goes back to the saved file
+  ASSERT_EQ(workspace.closeBuffer(root / "lib" / "util.mcfunc"), Paths{root / "main.mcfunc"});
+  ASSERT_EQ(workspace.diagnostic(root / "main.mcfunc"), nullptr);
+
+  // saved changes
+  ASSERT_TRUE(files->writeFile(root / "lib" / "broken.mcfunc", "void oops() {}\n"));
+  ASSERT_EQ(workspace.fileChanged(root / "lib" / "broken.mcfunc"),
+            Paths{root / "lib" / "broken.mcfunc"});
+  ASSERT_TRUE(workspace.fileChanged(root / "lib" / "broken.mcfunc").empty());
+  ASSERT_TRUE(workspace.pathsWithDiagnostics().empty());
+
+  // new files can fix files that failed to import them
+  ASSERT_EQ(workspace.setBuffer(root / "new.mcfunc", "import \"later.mcfunc\";\n"),
+            Paths{root / "new.mcfunc"});
+  ASSERT_TRUE(files->writeFile(root / "later.mcfunc", "public void later() {}\n"));
+  ASSERT_EQ(workspace.fileChanged(root / "later.mcfunc"), Paths{root / "new.mcfunc"});
+  ASSERT_EQ(workspace.sourceFileCount(), 5);
+
+  // removing files
+  ASSERT_TRUE(files->removeAll(root / "lib"));
+  ASSERT_EQ(workspace.fileChanged(root / "lib"), Paths{root / "main.mcfunc"});
+  ASSERT_EQ(workspace.sourceFileCount(), 3);
+
+  // paths outside of the workspace are ignored
+  ASSERT_TRUE(workspace.setBuffer(root.parent_path() / "outside.mcfunc", "").empty());
+  ASSERT_TRUE(workspace.fileChanged(root).empty());
+}
+
+TEST(test_Workspace, many_edits) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::filesystem::path& root = mount.path();
+  ASSERT_TRUE(files->createDirectories(root));
+  ASSERT_TRUE(files->writeFile(root / "main.mcfunc", ""));
+  Workspace workspace(root);
+
+  // every edit analyzes the file again (giving its functions new IDs), which
+  // can't run out no matter how long the editor is open
+  constexpr size_t functionCount = 1000;
+  std::string contents;
+  for (size_t i = 0; i < functionCount; i++)
+    contents += "void f" + std::to_string(i) + "() {}\n";
+  for (size_t i = 0; i < 0x100000 / functionCount + 1; i++) {
+    const std::string edit = "void g" + std::to_string(i % 2) + "() {}\n";
+    ASSERT_TRUE(workspace.setBuffer(root / "main.mcfunc", contents + edit).empty());
+  }
+  ASSERT_TRUE(workspace.pathsWithDiagnostics().empty());
+}
+
+TEST(test_Workspace, definition_and_references) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  const std::filesystem::path& root = mount.path();
+  const std::filesystem::path mainPath = root / "main.mcfunc";
+  const std::filesystem::path declarationPath = root / "lib" / "helper.mcfunc";
+  const std::filesystem::path definitionPath = root / "lib" / "helper_impl.mcfunc";
+
+  ASSERT_TRUE(files->createDirectories(root / "lib"));
+  ASSERT_TRUE(files->writeFile(mainPath, "import \"lib/helper.mcfunc\";\n"
+                                         "void main() {\n"
+                                         "  helper();\n"
+                                         "  local();\n"
+                                         "}\n"
+                                         "void local() { helper(); }\n"));
+  // (like a header for the file that defines it)
+  ASSERT_TRUE(files->writeFile(declarationPath, "import \"lib/helper_impl.mcfunc\";\n"
+                                                "public void helper();\n"));
+  ASSERT_TRUE(files->writeFile(definitionPath, "public void helper() {\n"
+                                               "  /execute as @a run: helper();\n"
+                                               "}\n"));
+  ASSERT_TRUE(files->writeFile(root / "other.mcfunc", "void local() { local(); }\n"));
+
+  const Workspace workspace(root);
+  ASSERT_TRUE(workspace.pathsWithDiagnostics().empty());
+
+  // the cursor can be on or just after the name
+  using Expected = std::vector<std::tuple<std::filesystem::path, size_t, size_t, size_t>>;
+  ASSERT_EQ(toTuples(workspace.definitionAt(mainPath, 3, 3)),
+            (Expected{{definitionPath, 1, 13, 6}}));
+  ASSERT_EQ(toTuples(workspace.definitionAt(mainPath, 3, 9)),
+            (Expected{{definitionPath, 1, 13, 6}}));
+  ASSERT_EQ(toTuples(workspace.definitionAt(mainPath, 4, 3)), (Expected{{mainPath, 6, 6, 5}}));
+  ASSERT_TRUE(workspace.definitionAt(mainPath, 2, 1).empty()); // 'void'
+  ASSERT_TRUE(workspace.definitionAt(mainPath, 99, 1).empty());
+
+  ASSERT_EQ(toTuples(workspace.referencesAt(definitionPath, 1, 13, true)),
+            (Expected{{declarationPath, 2, 13, 6},
+                      {definitionPath, 1, 13, 6},
+                      {definitionPath, 2, 23, 6},
+                      {mainPath, 3, 3, 6},
+                      {mainPath, 6, 16, 6}}));
+
+  // private functions with the same name in other files aren't included
+  ASSERT_EQ(toTuples(workspace.referencesAt(mainPath, 6, 6, false)),
+            (Expected{{mainPath, 4, 3, 5}}));
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <compiler/json.h>
+
+TEST(test_json, parse_values) {
+  const json::Value value = json::parse(
+      " {\"a\": [1, -2.5e1, true, false, null], \"b\": {\"c\": \"d\"}, \"e\": {}, \"f\": []} ");
+
+  ASSERT_TRUE(value.isObject());
+  ASSERT_EQ(value.asObject().size(), 4);
+
+  const std::vector<json::Value>& a = value["a"].asArray();
+  ASSERT_EQ(a.size(), 5);
+  ASSERT_EQ(a[0].asNumber(), 1);
+  ASSERT_EQ(a[1].asNumber(), -25);
+  ASSERT_TRUE(a[2].asBool());
+  ASSERT_FALSE(a[3].asBool());
+  ASSERT_TRUE(a[4].isNull());
+
+  ASSERT_EQ(value["b"]["c"].asString(), "d");
+  ASSERT_TRUE(value["e"].asObject().empty());
+  ASSERT_TRUE(value["f"].asArray().empty());
+
+  // missing members (or members of things that aren't objects) are null
+  ASSERT_TRUE(value["g"].isNull());
+  ASSERT_TRUE(value["a"]["b"].isNull());
+}
+
+TEST(test_json, strings) {
+  ASSERT_EQ(json::parse("\"a\\\"b\\\\c\\/d\\n\\t\"").asString(), "a\"b\\c/d\n\t");
+  ASSERT_EQ(json::parse("\"\\u0041\\u00e9\\u20ac\\ud83d\\ude00\"").asString(),
+            "A\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80");
+
+  const std::string str = "quote \" backslash \\ newline \n tab \t bell \a";
+  ASSERT_EQ(json::quote(str), "\"quote \\\" backslash \\\\ newline \\n tab \\t bell \\u0007\"");
+  ASSERT_EQ(json::parse(json::quote(str)).asString(), str);
+}
+
+TEST(test_json, invalid) {
+  ASSERT_THROW(json::parse(""), json::ParseError);
+  ASSERT_THROW(json::parse("{"), json::ParseError);
+  ASSERT_THROW(json::parse("{\"a\" 1}"), json::ParseError);
+  ASSERT_THROW(json::parse("{a: 1}"), json::ParseError);
+  ASSERT_THROW(json::parse("[1,]"), json::ParseError);
+  ASSERT_THROW(json::parse("\"abc"), json::ParseError);
+  ASSERT_THROW(json::parse("\"\\x\""), json::ParseError);
+  ASSERT_THROW(json::parse("tru"), json::ParseError);
+  ASSERT_THROW(json::parse("1."), json::ParseError);
+  ASSERT_THROW(json::parse("1 2"), json::ParseError);
+
+  try {
+    json::parse("[1, 2, x]");
+  } catch (const json::ParseError& e) {
+    ASSERT_EQ(e.index(), 7);
+  }
+}
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <compiler/pass_timing.h>
+
+TEST(test_pass_timing, counts_and_formats) {
+  pass_timing::reset();
+
+  // nothing is recorded unless there's a report format
+  {
+    pass_timing::ScopedTimer timer(pass_timing::Pass::TOKENIZE);
+    ASSERT_FALSE(timer.isActive());
+    timer.addBytes(1000);
+  }
+
+  pass_timing::reportFormat = pass_timing::ReportFormat::JSON;
+  {
+    pass_timing::ScopedTimer outer(pass_timing::Pass::GENERATE_DATA_PACK);
+    ASSERT_TRUE(outer.isActive());
+    outer.addBytes(12);
+    {
+      pass_timing::ScopedTimer inner(pass_timing::Pass::ADD_TICK_AND_LOAD_FUNCS);
+      inner.addTokens(3);
+    }
+  }
+  const std::string json = pass_timing::report();
+
+  pass_timing::reportFormat = pass_timing::ReportFormat::TABLE;
+  const std::string table = pass_timing::report();
+
+  pass_timing::reportFormat = pass_timing::ReportFormat::NONE;
+  pass_timing::reset();
+
+  ASSERT_NE(json.find("{\"pass\": \"tokenize\", "), std::string::npos) << json;
+  ASSERT_NE(json.find("\"bytes\": 0, \"tokens\": 0, \"count\": 0}"), std::string::npos) << json;
+  ASSERT_NE(json.find("\"bytes\": 0, \"tokens\": 3, \"count\": 1}"), std::string::npos) << json;
+  ASSERT_NE(json.find("\"bytes\": 12, \"tokens\": 0, \"count\": 1}"), std::string::npos) << json;
+
+  // passes that never ran have no span
+  ASSERT_NE(json.find("{\"pass\": \"tokenize\", \"spanMs\": 0.000, \"busyMs\": 0.000, "),
+            std::string::npos)
+      << json;
+  ASSERT_NE(json.find("\"processPeakRssBytes\": "), std::string::npos) << json;
+
+  ASSERT_EQ(table.compare(0, 4, "Pass"), 0) << table;
+  ASSERT_NE(table.find("\ngenerate data pack "), std::string::npos) << table;
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <thread>
+
+#include <compiler/fileToStr.h>
+#include <compiler/json.h>
+#include <compiler/tracing.h>
+#include <TempDirectory.h>
+
+TEST(test_tracing, chrome_trace_format) {
+#if !defined(DO_TRACING)
+  GTEST_SKIP() << "Tracing isn't compiled in (configure with -DDO_TRACING=ON).";
+#else
+  const TempDirectory dir("mcfunc_test_tracing");
+  const std::filesystem::path tracePath = dir.path() / "trace.json";
+
+  ASSERT_FALSE(TRACE_IS_ENABLED());
+  { TRACE_SPAN("before tracing started"); }
+
+  tracing::start(std::filesystem::path(tracePath));
+  ASSERT_TRUE(TRACE_IS_ENABLED());
+  { TRACE_SPAN("before reset"); }
+  TRACE_RESET();
+
+  {
+    TRACE_SPAN("outer");
+    TRACE_SPAN_DETAIL("inner", "main.mcfunc");
+  }
+  std::thread([]() { TRACE_SPAN("on a worker"); }).join();
+
+  TRACE_WRITE();
+  tracing::stop();
+  ASSERT_FALSE(TRACE_IS_ENABLED());
+
+  // span name -> thread ID
+  std::map<std::string, double> spanThreads;
+  const json::Value trace = json::parse(fileToStr(tracePath));
+  for (const json::Value& event : trace["traceEvents"].asArray()) {
+    if (event["ph"].asString() != "X")
+      continue;
+    ASSERT_TRUE(event["ts"].isNumber());
+    ASSERT_TRUE(event["dur"].isNumber());
+    spanThreads[event["name"].asString()] = event["tid"].asNumber();
+  }
+
+  ASSERT_FALSE(spanThreads.count("before tracing started"));
+  ASSERT_FALSE(spanThreads.count("before reset"));
+  ASSERT_TRUE(spanThreads.count("outer"));
+  ASSERT_TRUE(spanThreads.count("inner main.mcfunc"));
+  ASSERT_TRUE(spanThreads.count("on a worker"));
+  ASSERT_EQ(spanThreads["outer"], spanThreads["inner main.mcfunc"]);
+  ASSERT_NE(spanThreads["outer"], spanThreads["on a worker"]);
+#endif
+}
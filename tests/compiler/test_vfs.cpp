@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <compiler/compile_error.h>
+#include <compiler/fileToStr.h>
+#include <compiler/generation/generateDataPack.h>
+#include <compiler/vfs.h>
+#include <TempDirectory.h>
+
+/// The paths of every file in \p directory (sorted).
+static std::vector<std::filesystem::path> listFiles(const vfs::FileSystem& fileSystem,
+                                                    const std::filesystem::path& directory,
+                                                    const vfs::ListFilter& filter = nullptr) {
+  std::vector<vfs::DirectoryEntry> entries;
+  EXPECT_TRUE(fileSystem.listFiles(directory, entries, filter));
+  std::vector<std::filesystem::path> ret;
+  for (const vfs::DirectoryEntry& entry : entries)
+    ret.push_back(entry.path);
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+TEST(test_vfs, memory_file_system) {
+  vfs::MemoryFileSystem fileSystem;
+  std::string contents;
+
+  // parent directories have to exist first
+  ASSERT_FALSE(fileSystem.writeFile("/a/b/file.txt", "hi"));
+  ASSERT_TRUE(fileSystem.createDirectories("/a/b"));
+  ASSERT_TRUE(fileSystem.writeFile("/a/b/file.txt", "hi"));
+  ASSERT_TRUE(fileSystem.writeFile("/a/b0.txt", "sibling"));
+  ASSERT_TRUE(fileSystem.createDirectories("/a/b/empty"));
+
+  ASSERT_TRUE(fileSystem.readFile("/a/b/file.txt", contents));
+  ASSERT_EQ(contents, "hi");
+  ASSERT_FALSE(fileSystem.readFile("/a/b", contents));
+  ASSERT_TRUE(fileSystem.isDirectory("/a"));
+  ASSERT_TRUE(fileSystem.isDirectory("/a/b/empty"));
+  ASSERT_FALSE(fileSystem.isDirectory("/a/b/file.txt"));
+  ASSERT_TRUE(fileSystem.isRegularFile("/a/b/file.txt"));
+  // a file can't hold anything and a directory can't be replaced by a file
+  ASSERT_FALSE(fileSystem.createDirectories("/a/b/file.txt/c"));
+  ASSERT_FALSE(fileSystem.writeFile("/a/b", ""));
+
+  ASSERT_EQ(listFiles(fileSystem, "/a"),
+            (std::vector<std::filesystem::path>{"/a/b/file.txt", "/a/b0.txt"}));
+  ASSERT_EQ(listFiles(fileSystem, "/a",
+                      [](const std::filesystem::path& path, bool isDirectory) {
+                        return !isDirectory || path.filename() != "b";
+                      }),
+            (std::vector<std::filesystem::path>{"/a/b0.txt"}));
+
+  ASSERT_TRUE(fileSystem.removeAll("/a/b"));
+  ASSERT_FALSE(fileSystem.isDirectory("/a/b"));
+  ASSERT_FALSE(fileSystem.isDirectory("/a/b/empty"));
+  ASSERT_TRUE(fileSystem.isRegularFile("/a/b0.txt"));
+  ASSERT_TRUE(fileSystem.removeAll("/does/not/exist"));
+}
+
+TEST(test_vfs, disk_file_system) {
+  const TempDirectory tempDir("mcfunc_test_vfs_disk_file_system");
+  const std::filesystem::path& root = tempDir.path();
+  std::filesystem::create_directories(root / "src" / "lib");
+  std::filesystem::create_directories(root / "assets" / "deep");
+  for (const char* path : {"src/main.mcfunc", "src/lib/util.mcfunc", "assets/deep/a.png"})
+    ASSERT_TRUE(vfs::writeFile(root / path, ""));
+  std::filesystem::create_directory_symlink(root / "src", root / "linked_dir");
+
+  vfs::DiskFileSystem fileSystem;
+
+  // symlinks to directories aren't followed
+  ASSERT_EQ(listFiles(fileSystem, root),
+            (std::vector<std::filesystem::path>{root / "assets" / "deep" / "a.png",
+                                                root / "src" / "lib" / "util.mcfunc",
+                                                root / "src" / "main.mcfunc"}));
+
+  // rejected directories aren't read
+  std::atomic<bool> sawInsideAssets = false;
+  ASSERT_EQ(listFiles(fileSystem, root,
+                      [&root, &sawInsideAssets](const std::filesystem::path& path,
+                                                bool isDirectory) {
+                        if (path.parent_path() == root / "assets")
+                          sawInsideAssets = true;
+                        return !(isDirectory && path.filename() == "assets");
+                      }),
+            (std::vector<std::filesystem::path>{root / "src" / "lib" / "util.mcfunc",
+                                                root / "src" / "main.mcfunc"}));
+  ASSERT_FALSE(sawInsideAssets);
+
+  std::vector<vfs::DirectoryEntry> entries;
+  ASSERT_FALSE(fileSystem.listFiles(root / "missing", entries, nullptr));
+
+  // copies keep every byte, replace what was there and can't empty a file
+  // copied onto itself
+  const std::string bytes = "{\r\n  \"a\": 1\r\n}";
+  std::string contents;
+  ASSERT_TRUE(vfs::writeFile(root / "assets" / "data.json", bytes));
+  ASSERT_TRUE(vfs::writeFile(root / "copy.json", "longer than the copied file's contents"));
+  ASSERT_TRUE(vfs::copyFile(root / "assets" / "data.json", root / "copy.json"));
+  ASSERT_TRUE(vfs::readFile(root / "copy.json", contents));
+  ASSERT_EQ(contents, bytes);
+  ASSERT_TRUE(vfs::copyFile(root / "copy.json", root / "copy.json"));
+  ASSERT_TRUE(vfs::readFile(root / "copy.json", contents));
+  ASSERT_EQ(contents, bytes);
+  ASSERT_FALSE(vfs::copyFile(root / "missing.json", root / "copy.json"));
+  ASSERT_FALSE(vfs::copyFile(root / "assets", root / "copy.json"));
+}
+
+TEST(test_vfs, overlay_file_system) {
+  auto upper = std::make_shared<vfs::MemoryFileSystem>();
+  auto lower = std::make_shared<vfs::MemoryFileSystem>();
+  ASSERT_TRUE(lower->createDirectories("/project/lib"));
+  ASSERT_TRUE(lower->writeFile("/project/main.mcfunc", "saved"));
+  ASSERT_TRUE(lower->writeFile("/project/lib/util.mcfunc", "saved"));
+  vfs::OverlayFileSystem overlay(upper, lower);
+
+  // an unsaved buffer hides the saved file
+  ASSERT_TRUE(overlay.writeFile("/project/main.mcfunc", "unsaved"));
+  ASSERT_TRUE(overlay.writeFile("/project/lib/new.mcfunc", "unsaved"));
+  std::string contents;
+  ASSERT_TRUE(overlay.readFile("/project/main.mcfunc", contents));
+  ASSERT_EQ(contents, "unsaved");
+  ASSERT_TRUE(lower->readFile("/project/main.mcfunc", contents));
+  ASSERT_EQ(contents, "saved");
+
+  ASSERT_EQ(listFiles(overlay, "/project"),
+            (std::vector<std::filesystem::path>{
+                "/project/lib/new.mcfunc", "/project/lib/util.mcfunc", "/project/main.mcfunc"}));
+
+  // closing the buffer reveals the saved file
+  ASSERT_TRUE(overlay.removeAll("/project/main.mcfunc"));
+  ASSERT_TRUE(overlay.readFile("/project/main.mcfunc", contents));
+  ASSERT_EQ(contents, "saved");
+}
+
+TEST(test_vfs, mount) {
+  auto fileSystem = std::make_shared<vfs::MemoryFileSystem>();
+  std::filesystem::path root;
+  {
+    const vfs::Mount mount(fileSystem);
+    root = mount.path();
+    ASSERT_TRUE(root.is_absolute());
+    ASSERT_FALSE(vfs::isOnDisk(root / "src" / "main.mcfunc"));
+    ASSERT_TRUE(vfs::isOnDisk(root.parent_path()));
+
+    ASSERT_TRUE(vfs::createDirectories(root / "src"));
+    ASSERT_TRUE(vfs::writeFile(root / "src" / "main.mcfunc", "no newline"));
+    ASSERT_EQ(fileToStr(root / "src" / ".." / "src" / "main.mcfunc"), "no newline\n");
+    ASSERT_THROW(fileToStr(root / "src" / "missing.mcfunc"), compile_error::CouldntOpenFile);
+
+    // a data pack can be written (and updated) without touching the disk
+    const std::unordered_map<std::filesystem::path, std::string> fileWriteMap = {
+        {"example/function/main.mcfunction", "say hi\n"}};
+    const std::unordered_map<std::filesystem::path, std::filesystem::path> fileCopyMap = {
+        {"example/raw.txt", root / "src" / "main.mcfunc"}};
+    // (the tags written by another data pack are kept)
+    generateDataPack(root / "data", {"other"}, {}, {}, true, {"other:main"}, {});
+    generateDataPack(root / "data", {"example"}, fileWriteMap, fileCopyMap, false,
+                     {"example:main"}, {});
+    std::string contents;
+    ASSERT_TRUE(fileSystem->readFile(root / "data" / "example" / "function" / "main.mcfunction",
+                                     contents));
+    ASSERT_EQ(contents, "say hi\n");
+    ASSERT_TRUE(fileSystem->readFile(root / "data" / "example" / "raw.txt", contents));
+    ASSERT_EQ(contents, "no newline");
+    ASSERT_TRUE(fileSystem->readFile(root / "data" / "minecraft" / "tags" / "function" /
+                                         "tick.json",
+                                     contents));
+    ASSERT_NE(contents.find("other:main"), std::string::npos);
+    ASSERT_NE(contents.find("example:main"), std::string::npos);
+    ASSERT_FALSE(std::filesystem::exists(root));
+  }
+
+  // paths go back to the disk once it's unmounted
+  ASSERT_TRUE(vfs::isOnDisk(root));
+  ASSERT_FALSE(vfs::exists(root / "src" / "main.mcfunc"));
+}
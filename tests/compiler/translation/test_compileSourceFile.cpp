@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <compiler/CompileOptions.h>
+#include <compiler/SourceFiles.h>
+#include <compiler/linking/link.h>
+#include <compiler/vfs.h>
+
+/// Compiles and links a file (that exposes the namespace "example") with the
+/// contents \param contents and returns the result.
+static LinkResult linkFile(const std::string& contents, const CompileOptions& compileOptions) {
+  auto files = std::make_shared<vfs::MemoryFileSystem>();
+  const vfs::Mount mount(files);
+  EXPECT_TRUE(files->createDirectories(mount.path()));
+  EXPECT_TRUE(files->writeFile(mount.path() / "main.mcfunc", "expose \"example\";\n" + contents));
+
+  SourceFiles sourceFiles;
+  sourceFiles.emplace_back(mount.path() / "main.mcfunc", mount.path());
+  std::vector<CompiledSourceFile> compiledSourceFiles = sourceFiles.evaluateAll(compileOptions);
+  return link(std::move(compiledSourceFiles), std::move(sourceFiles), {}, compileOptions);
+}
+
+/// The contents of the function exposed as \param name in \param result
+/// (without the comment at the top).
+static std::string exposedFunction(const LinkResult& result, const std::string& name) {
+  const std::string& contents =
+      result.fileWriteMap.at(std::filesystem::path("example/function") / (name + ".mcfunction"));
+  return contents.substr(contents.find("\n\n") + 2);
+}
+
+TEST(test_compileSourceFile, inline_trivial_scopes) {
+  CompileOptions compileOptions;
+  compileOptions.inlineTrivialScopes = true;
+  const LinkResult result =
+      linkFile("void inlined() expose \"inlined\" {\n"
+               "  /execute as @a run: { /execute at @s run: { /say hi; } }\n"
+               "}\n"
+               "void returns() expose \"returns\" { /execute as @a run: { /return 1; } }\n"
+               "void macro() expose \"macro\" { /execute as @a run: { /$say $(name); } }\n"
+               "void stores() expose \"stores\" {\n"
+               "  /execute store result score @s x run: { /say hi; }\n"
+               "}\n"
+               "void several() expose \"several\" { /execute as @a run: { /say a; /say b; } }\n",
+               compileOptions);
+
+  ASSERT_EQ(exposedFunction(result, "inlined"),
+            "execute as @a run \\\n\texecute at @s run \\\n\tsay hi\n");
+
+  // scopes that could change what they do when they're inlined keep their own
+  // function file
+  ASSERT_EQ(exposedFunction(result, "returns").rfind("execute as @a run \\\n\tfunction ", 0), 0);
+  ASSERT_EQ(exposedFunction(result, "macro").rfind("execute as @a run \\\n\tfunction ", 0), 0);
+  ASSERT_EQ(exposedFunction(result, "stores")
+                .rfind("execute store result score @s x run \\\n\tfunction ", 0),
+            0);
+  ASSERT_EQ(exposedFunction(result, "several").rfind("execute as @a run \\\n\tfunction ", 0), 0);
+
+  // nothing is inlined without the option
+  const LinkResult withoutOption = linkFile(
+      "void f() expose \"f\" { /execute as @a run: { /say hi; } }\n", CompileOptions());
+  ASSERT_EQ(exposedFunction(withoutOption, "f").rfind("execute as @a run \\\n\tfunction ", 0), 0);
+}
+
+TEST(test_compileSourceFile, factor_execute_prefixes) {
+  CompileOptions compileOptions;
+  compileOptions.factorExecutePrefixes = true;
+  const LinkResult result =
+      linkFile("void factored() expose \"factored\" {\n"
+               "  /execute as @e[type=zombie] at @s run say a;\n"
+               "  /execute as @e[type=zombie] at @s run say b;\n"
+               "  /say c;\n"
+               "}\n"
+               "void conditions() expose \"conditions\" {\n"
+               "  /execute if entity @a run say a;\n"
+               "  /execute if entity @a run say b;\n"
+               "  /execute unless entity @a run say a;\n"
+               "  /execute unless entity @a run say b;\n"
+               "  /execute store result score @s x run say a;\n"
+               "  /execute store result score @s x run say b;\n"
+               "}\n"
+               "void selectors() expose \"selectors\" {\n"
+               "  /execute as @e[tag=x] run tag @s remove x;\n"
+               "  /execute as @e[tag=x] run say a;\n"
+               "  /execute as @e[tag=x] run: { /say b; }\n"
+               "}\n"
+               "void fixed() expose \"fixed\" {\n"
+               "  /execute as @s positioned ~ ~1 ~ in minecraft:overworld run tag @s remove x;\n"
+               "  /execute as @s positioned ~ ~1 ~ in minecraft:overworld run kill @s;\n"
+               "}\n",
+               compileOptions);
+
+  // the adjacent commands are moved into 1 function behind their prefix
+  const std::string factored = exposedFunction(result, "factored");
+  const std::string callPrefix = "execute as @e[type=zombie] at @s run function ";
+  ASSERT_EQ(factored.rfind(callPrefix, 0), 0);
+  const size_t callNameEnd = factored.find('\n');
+  ASSERT_EQ(factored.substr(callNameEnd), "\nsay c\n");
+  const std::string callName = factored.substr(callPrefix.size(), callNameEnd - callPrefix.size());
+  const std::string& group = result.fileWriteMap.at(
+      std::filesystem::path("zzz__.example/function") /
+      (callName.substr(callName.find(':') + 1) + ".mcfunction"));
+  ASSERT_EQ(group.substr(group.find("\n\n") + 2), "say a\nsay b\n");
+
+  // prefixes that check a condition or store a result aren't factored
+  ASSERT_EQ(exposedFunction(result, "conditions"),
+            "execute if entity @a run say a\n"
+            "execute if entity @a run say b\n"
+            "execute unless entity @a run say a\n"
+            "execute unless entity @a run say b\n"
+            "execute store result score @s x run say a\n"
+            "execute store result score @s x run say b\n");
+
+  // commands that could change which entities a selector finds (or scopes,
+  // which could run anything) aren't factored behind one
+  const std::string selectors = exposedFunction(result, "selectors");
+  ASSERT_EQ(selectors.rfind("execute as @e[tag=x] run tag @s remove x\n"
+                            "execute as @e[tag=x] run say a\n"
+                            "execute as @e[tag=x] run \\\n\tfunction ",
+                            0),
+            0);
+
+  // but any command is factored behind modifiers that don't depend on them
+  ASSERT_EQ(exposedFunction(result, "fixed")
+                .rfind("execute as @s positioned ~ ~1 ~ in minecraft:overworld run function ", 0),
+            0);
+}
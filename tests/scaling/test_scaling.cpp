@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <compiler/CompileOptions.h>
+#include <compiler/FileWriteSourceFile.h>
+#include <compiler/SourceFiles.h>
+#include <compiler/generation/generateDataPack.h>
+#include <compiler/linking/link.h>
+#include <compiler/translation/compileSourceFile.h>
+#include <generateProject.h>
+#include <TempDirectory.h>
+
+// Every allocation made with 'new' in this executable is counted (which is why
+// these tests aren't part of 'run_tests').
+
+static std::atomic<size_t> allocationCount = 0;
+
+void* operator new(std::size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc((size == 0) ? 1 : size))
+    return ptr;
+  throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+/// How many times bigger each project is than the smallest one.
+static constexpr std::array<double, 3> projectScales = {1, 4, 16};
+
+/// The number of source files in the smallest project.
+static constexpr size_t baseFileCount = 128;
+
+/// Each stage is run this many times per project and the fastest run is kept.
+static constexpr size_t repetitions = 3;
+
+/// The highest growth exponents allowed (e.g. 2 is quadratic). Time is noisy
+/// and stages can be O(n log n) (~1.16 over these sizes) so it gets more
+/// leeway. A linear scan per import fit to ~1.4 here.
+static constexpr double maxTimeExponent = 1.2;
+static constexpr double maxAllocationExponent = 1.1;
+
+/// The time limit used unless \p checkTimeEnvVar is set. A busy machine or a
+/// debug build can push a linear stage past \p maxTimeExponent , but not to
+/// quadratic (2), so this still catches a stage doing work for every pair of
+/// source files.
+static constexpr double maxLooseTimeExponent = 1.6;
+
+/// Time is only held to \p maxTimeExponent when this environment variable is
+/// set (e.g. for a release build on a quiet machine).
+static constexpr const char* checkTimeEnvVar = "MCFUNC_SCALING_CHECK_TIME";
+
+enum Stage : size_t { TOKENIZE, ANALYZE_SYNTAX, TRANSLATE, LINK, GENERATE_DATA_PACK, STAGE_COUNT };
+static constexpr std::array<const char*, STAGE_COUNT> stageNames = {
+    "tokenize", "analyze syntax", "translate", "link", "generate data pack"};
+/// Writing the data pack mostly times the disk (which is too noisy to check),
+/// so only its allocations are checked.
+static constexpr std::array<bool, STAGE_COUNT> stageTimeIsChecked = {true, true, true, true,
+                                                                     false};
+
+/// The fastest time and the fewest allocations of a stage at each scale.
+struct StageCost {
+  std::array<double, projectScales.size()> seconds;
+  std::array<double, projectScales.size()> allocations;
+};
+
+/// Runs \p func and lowers \p cost for scale \p scaleIndex if it was cheaper.
+template <typename Func>
+static void measure(StageCost& cost, size_t scaleIndex, Func&& func) {
+  const size_t startAllocations = allocationCount;
+  const auto startTime = std::chrono::steady_clock::now();
+  func();
+  const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - startTime;
+
+  cost.seconds[scaleIndex] = std::min(cost.seconds[scaleIndex], seconds.count());
+  const double allocations = static_cast<double>(allocationCount - startAllocations);
+  cost.allocations[scaleIndex] = std::min(cost.allocations[scaleIndex], allocations);
+}
+
+/// The exponent k that best fits \p values growing like scale^k (the slope of a
+/// least squares line through the log-log points).
+static double growthExponent(const std::array<double, projectScales.size()>& values) {
+  double meanX = 0;
+  double meanY = 0;
+  for (size_t i = 0; i < projectScales.size(); i++) {
+    meanX += std::log(projectScales[i]) / projectScales.size();
+    meanY += std::log(std::max(values[i], 1e-9)) / projectScales.size();
+  }
+
+  double covariance = 0;
+  double variance = 0;
+  for (size_t i = 0; i < projectScales.size(); i++) {
+    const double dx = std::log(projectScales[i]) - meanX;
+    covariance += dx * (std::log(std::max(values[i], 1e-9)) - meanY);
+    variance += dx * dx;
+  }
+  return covariance / variance;
+}
+
+TEST(test_scaling, stages_grow_linearly) {
+  const TempDirectory tempDir("mcfunc_test_scaling");
+  const std::filesystem::path& dir = tempDir.path();
+
+  const bool checkTime = std::getenv(checkTimeEnvVar) != nullptr;
+
+  std::array<StageCost, STAGE_COUNT> costs;
+  for (StageCost& cost : costs) {
+    cost.seconds.fill(std::numeric_limits<double>::infinity());
+    cost.allocations.fill(std::numeric_limits<double>::infinity());
+  }
+
+  for (size_t scaleIndex = 0; scaleIndex < projectScales.size(); scaleIndex++) {
+    std::filesystem::remove_all(dir / "src");
+
+    ProjectShape shape;
+    shape.seed = 1;
+    shape.fileCount = static_cast<size_t>(baseFileCount * projectScales[scaleIndex]);
+    // small files so that work done across files stands out
+    shape.functionsPerFile = 4;
+    shape.commandsPerFunction = 2;
+    shape.copyWritesPerFile = 1;
+    const std::vector<GeneratedFile> project = generateProject(shape);
+    writeProject(project, dir / "src");
+
+    for (size_t rep = 0; rep < repetitions; rep++) {
+      SourceFiles sourceFiles;
+      std::vector<FileWriteSourceFile> fileWriteSourceFiles;
+      for (const GeneratedFile& file : project) {
+        if (file.path.extension() == ".mcfunc")
+          sourceFiles.emplace_back(dir / "src" / file.path, dir / "src");
+        else
+          fileWriteSourceFiles.emplace_back(dir / "src" / file.path, dir / "src");
+      }
+
+      // stages are run 1 at a time on 1 thread so that they can be measured
+      const CompileOptions compileOptions;
+      std::vector<CompiledSourceFile> compiledSourceFiles;
+      LinkResult linkResult;
+
+      measure(costs[TOKENIZE], scaleIndex, [&]() {
+        for (SourceFile& sourceFile : sourceFiles)
+          sourceFile.tokenize();
+      });
+      measure(costs[ANALYZE_SYNTAX], scaleIndex, [&]() {
+        for (SourceFile& sourceFile : sourceFiles)
+          sourceFile.analyzeSyntax(sourceFiles);
+      });
+      measure(costs[TRANSLATE], scaleIndex, [&]() {
+        for (SourceFile& sourceFile : sourceFiles)
+          compiledSourceFiles.push_back(compileSourceFile(sourceFile, compileOptions));
+      });
+      measure(costs[LINK], scaleIndex, [&]() {
+        linkResult = link(compiledSourceFiles, sourceFiles, fileWriteSourceFiles, compileOptions);
+      });
+      measure(costs[GENERATE_DATA_PACK], scaleIndex, [&]() {
+        generateDataPack(dir / "data", linkResult.exposedNamespaces, linkResult.fileWriteMap,
+                         linkResult.fileCopyMap, true, linkResult.tickFuncCallNames,
+                         linkResult.loadFuncCallNames);
+      });
+    }
+  }
+
+  for (size_t stage = 0; stage < STAGE_COUNT; stage++) {
+    const double timeExponent = growthExponent(costs[stage].seconds);
+    const double allocationExponent = growthExponent(costs[stage].allocations);
+
+    std::ostringstream summary;
+    summary << stageNames[stage] << " at " << baseFileCount << "x(";
+    for (size_t i = 0; i < projectScales.size(); i++)
+      summary << ((i == 0) ? "" : ", ") << projectScales[i];
+    summary << ") source files:\n  seconds:";
+    for (double seconds : costs[stage].seconds)
+      summary << ' ' << seconds;
+    summary << " (exponent " << timeExponent << ")\n  allocations:";
+    for (double allocations : costs[stage].allocations)
+      summary << ' ' << allocations;
+    summary << " (exponent " << allocationExponent << ")\n";
+    std::cout << summary.str();
+
+    double maxStageTimeExponent = std::numeric_limits<double>::infinity();
+    if (stageTimeIsChecked[stage])
+      maxStageTimeExponent = checkTime ? maxTimeExponent : maxLooseTimeExponent;
+    EXPECT_LE(timeExponent, maxStageTimeExponent) << summary.str();
+    EXPECT_LE(allocationExponent, maxAllocationExponent) << summary.str();
+  }
+}
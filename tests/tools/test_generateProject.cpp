@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <vector>
+
+#include <compiler/CompileOptions.h>
+#include <compiler/FileWriteSourceFile.h>
+#include <compiler/SourceFiles.h>
+#include <compiler/linking/link.h>
+#include <generateProject.h>
+#include <TempDirectory.h>
+
+/// Whether \p a and \p b have the same files with the same contents.
+static bool sameProject(const std::vector<GeneratedFile>& a, const std::vector<GeneratedFile>& b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].path != b[i].path || a[i].contents != b[i].contents)
+      return false;
+  }
+  return true;
+}
+
+TEST(test_generateProject, deterministic) {
+  ProjectShape shape;
+  shape.seed = 42;
+  shape.copyWritesPerFile = 1;
+
+  ASSERT_TRUE(sameProject(generateProject(shape), generateProject(shape)));
+
+  ProjectShape otherSeed = shape;
+  otherSeed.seed = 43;
+  ASSERT_FALSE(sameProject(generateProject(shape), generateProject(otherSeed)));
+
+  // a fixed value catches the output changing between platforms and versions
+  ProjectShape small;
+  small.fileCount = 2;
+  small.functionsPerFile = 2;
+  small.importsPerFile = 1;
+  small.callsPerFunction = 1;
+  small.maxScopeDepth = 0;
+  small.publicRatio = 1;
+  small.commandsPerFunction = 1;
+  small.minCommandLength = 0;
+  small.maxCommandLength = 0;
+  small.snippetWritesPerFile = 0;
+  const std::vector<GeneratedFile> project = generateProject(small);
+  ASSERT_EQ(project.size(), 2);
+  ASSERT_EQ(project[1].path, std::filesystem::path("dir_0") / "file_1.mcfunc");
+  ASSERT_EQ(project[1].contents,
+            "import \"dir_0/file_0.mcfunc\";\n"
+            "\n"
+            "public void f1_0() {\n"
+            "  /data modify storage bench:data file_1.value_0 set value \"\";\n"
+            "  f0_0();\n"
+            "}\n"
+            "\n"
+            "public void f1_1() {\n"
+            "  /data modify storage bench:data file_1.value_1 set value \"\";\n"
+            "  f0_1();\n"
+            "}\n"
+            "\n");
+}
+
+TEST(test_generateProject, builds) {
+  const TempDirectory tempDir("mcfunc_test_generateProject");
+  const std::filesystem::path& dir = tempDir.path();
+
+  ProjectShape shape;
+  shape.fileCount = 40;
+  shape.filesPerDirectory = 8;
+  shape.importsPerFile = 3;
+  shape.importFanIn = 6;
+  shape.maxScopeDepth = 3;
+  shape.copyWritesPerFile = 2;
+  const std::vector<GeneratedFile> project = generateProject(shape);
+  writeProject(project, dir);
+
+  SourceFiles sourceFiles;
+  std::vector<FileWriteSourceFile> fileWriteSourceFiles;
+  for (const GeneratedFile& file : project) {
+    if (file.path.extension() == ".mcfunc")
+      sourceFiles.emplace_back(dir / file.path, dir);
+    else
+      fileWriteSourceFiles.emplace_back(dir / file.path, dir);
+  }
+  ASSERT_EQ(sourceFiles.size(), shape.fileCount);
+
+  const CompileOptions compileOptions;
+  std::vector<CompiledSourceFile> compiledSourceFiles = sourceFiles.evaluateAll(compileOptions);
+  const LinkResult linkResult = link(std::move(compiledSourceFiles), std::move(sourceFiles),
+                                     std::move(fileWriteSourceFiles), compileOptions);
+
+  ASSERT_EQ(linkResult.exposedNamespace, "bench");
+  ASSERT_TRUE(linkResult.fileWriteMap.count("bench/function/main.mcfunction"));
+  ASSERT_EQ(linkResult.fileCopyMap.at("bench/generated/file_39_copy_1.json").filename(),
+            "file_39_1.json");
+}
@@ -0,0 +1,273 @@
+#include <generateProject.h>
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+/// A small random number generator (splitmix64). The distributions in <random>
+/// aren't the same on every standard library so they aren't used.
+class Random {
+public:
+  explicit Random(uint64_t seed) : m_state(seed) {}
+
+  uint64_t next() {
+    uint64_t z = (m_state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+
+  /// A number from \param min to \param max (inclusive).
+  size_t between(size_t min, size_t max) {
+    if (max <= min)
+      return min;
+    return min + static_cast<size_t>(next() % (max - min + 1));
+  }
+
+  /// True with a \param chance from 0 to 1.
+  bool chance(double chance) { return static_cast<double>(next() >> 11) * 0x1.0p-53 < chance; }
+
+private:
+  uint64_t m_state;
+};
+
+/// What the random numbers for part of a file are used for (each gets its own
+/// stream so that changing one part of the shape doesn't change the others).
+enum class Stream : uint64_t { PUBLIC_FUNCTIONS, IMPORTS, FUNCTION_BODIES, FILE_WRITES };
+
+/// A public function (that can be called by files that import its file).
+struct PublicFunction {
+  size_t fileIndex;
+  size_t functionIndex;
+};
+
+namespace helper {
+
+/// The random number generator for \param stream of file \param fileIndex .
+static Random fileRandom(uint64_t seed, size_t fileIndex, Stream stream);
+
+/// The path of source file \param fileIndex (relative to the project root).
+static std::filesystem::path sourceFilePath(const ProjectShape& shape, size_t fileIndex);
+
+/// The name of function \param functionIndex in file \param fileIndex .
+/// Private functions share names across files.
+static std::string functionName(size_t fileIndex, size_t functionIndex, bool isPublic);
+
+/// Picks which files file \param fileIndex imports.
+static std::vector<size_t> pickImports(const ProjectShape& shape, size_t fileIndex);
+
+/// Adds \param length random lowercase letters to \param str .
+static void appendRandomText(std::string& str, Random& random, size_t length);
+
+/// Adds a command \param length bytes long (or the shortest command possible)
+/// to \param str .
+static void appendCommand(std::string& str, Random& random, size_t fileIndex, size_t commandIndex,
+                          size_t length);
+
+/// JSON file contents that are \param size bytes long (or the shortest
+/// possible).
+static std::string fileWriteContents(Random& random, size_t size);
+
+} // namespace helper
+} // namespace
+
+std::vector<GeneratedFile> generateProject(const ProjectShape& shape) {
+  std::vector<GeneratedFile> ret;
+  ret.reserve(shape.fileCount * (1 + shape.copyWritesPerFile));
+
+  // every file's public functions have to be known before any calls are made
+  std::vector<std::vector<bool>> isPublic(shape.fileCount);
+  for (size_t i = 0; i < shape.fileCount; i++) {
+    Random random = helper::fileRandom(shape.seed, i, Stream::PUBLIC_FUNCTIONS);
+    isPublic[i].resize(shape.functionsPerFile);
+    for (size_t j = 0; j < shape.functionsPerFile; j++)
+      isPublic[i][j] = random.chance(shape.publicRatio);
+  }
+
+  for (size_t i = 0; i < shape.fileCount; i++) {
+    std::string code;
+    if (i == 0)
+      code += "expose \"bench\";\n\n";
+
+    std::vector<PublicFunction> importedFunctions;
+    for (size_t importedFile : helper::pickImports(shape, i)) {
+      code += "import \"" + helper::sourceFilePath(shape, importedFile).generic_string() + "\";\n";
+      for (size_t j = 0; j < shape.functionsPerFile; j++) {
+        if (isPublic[importedFile][j])
+          importedFunctions.push_back({importedFile, j});
+      }
+    }
+    if (!importedFunctions.empty())
+      code += '\n';
+
+    Random random = helper::fileRandom(shape.seed, i, Stream::FUNCTION_BODIES);
+    size_t commandIndex = 0;
+    for (size_t j = 0; j < shape.functionsPerFile; j++) {
+      if (isPublic[i][j])
+        code += "public ";
+      code += "void " + helper::functionName(i, j, isPublic[i][j]) + "()";
+      if (i == 0 && j == 0)
+        code += " expose \"main\"";
+      code += " {\n";
+
+      std::string indent = "  ";
+      const size_t scopeDepth = random.between(0, shape.maxScopeDepth);
+      for (size_t depth = 0; depth < scopeDepth; depth++) {
+        code += indent + "/execute as @e[tag=depth_" + std::to_string(depth) + "] at @s run: {\n";
+        indent += "  ";
+      }
+
+      for (size_t k = 0; k < shape.commandsPerFunction; k++) {
+        code += indent + '/';
+        helper::appendCommand(code, random, i, commandIndex++,
+                              random.between(shape.minCommandLength, shape.maxCommandLength));
+        code += ";\n";
+      }
+
+      for (size_t k = 0; k < shape.callsPerFunction; k++) {
+        // calls within a file only go backwards so a file's call graph is a DAG
+        if (!importedFunctions.empty() && (j == 0 || random.chance(0.5))) {
+          const PublicFunction& callee =
+              importedFunctions[random.between(0, importedFunctions.size() - 1)];
+          code += indent + helper::functionName(callee.fileIndex, callee.functionIndex, true) +
+                  "();\n";
+        } else if (j != 0) {
+          const size_t callee = random.between(0, j - 1);
+          code += indent + helper::functionName(i, callee, isPublic[i][callee]) + "();\n";
+        }
+      }
+
+      for (size_t depth = 0; depth < scopeDepth; depth++) {
+        indent.resize(indent.size() - 2);
+        code += indent + "}\n";
+      }
+      code += "}\n\n";
+    }
+
+    random = helper::fileRandom(shape.seed, i, Stream::FILE_WRITES);
+    const std::string fileWritePrefix = "generated/file_" + std::to_string(i) + '_';
+    for (size_t k = 0; k < shape.snippetWritesPerFile; k++) {
+      code += "file \"" + fileWritePrefix + "snippet_" + std::to_string(k) + ".json\" = `" +
+              helper::fileWriteContents(random, shape.snippetWriteSize) + "`;\n";
+    }
+    for (size_t k = 0; k < shape.copyWritesPerFile; k++) {
+      const std::string copiedPath =
+          "resources/file_" + std::to_string(i) + '_' + std::to_string(k) + ".json";
+      code += "file \"" + fileWritePrefix + "copy_" + std::to_string(k) + ".json\" = \"" +
+              copiedPath + "\";\n";
+      ret.push_back({copiedPath, helper::fileWriteContents(random, shape.copyWriteSize)});
+    }
+
+    ret.push_back({helper::sourceFilePath(shape, i), std::move(code)});
+  }
+
+  return ret;
+}
+
+void writeProject(const std::vector<GeneratedFile>& project,
+                  const std::filesystem::path& directory) {
+  for (const GeneratedFile& file : project) {
+    const std::filesystem::path path = directory / file.path;
+
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    std::ofstream outFile(path, std::ios::binary | std::ios::trunc);
+    outFile.write(file.contents.data(), static_cast<std::streamsize>(file.contents.size()));
+    outFile.close();
+    if (!outFile)
+      throw std::runtime_error("Failed to write '" + path.string() + "'.");
+  }
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static Random helper::fileRandom(uint64_t seed, size_t fileIndex, Stream stream) {
+  Random random(seed);
+  random = Random(random.next() ^ static_cast<uint64_t>(fileIndex));
+  random = Random(random.next() ^ static_cast<uint64_t>(stream));
+  return random;
+}
+
+static std::filesystem::path helper::sourceFilePath(const ProjectShape& shape, size_t fileIndex) {
+  const size_t directoryIndex = fileIndex / std::max<size_t>(shape.filesPerDirectory, 1);
+  return std::filesystem::path("dir_" + std::to_string(directoryIndex)) /
+         ("file_" + std::to_string(fileIndex) + ".mcfunc");
+}
+
+static std::string helper::functionName(size_t fileIndex, size_t functionIndex, bool isPublic) {
+  if (isPublic)
+    return "f" + std::to_string(fileIndex) + '_' + std::to_string(functionIndex);
+  return "helper_" + std::to_string(functionIndex);
+}
+
+static std::vector<size_t> helper::pickImports(const ProjectShape& shape, size_t fileIndex) {
+  // imports point into a pool of files small enough that each file in it is
+  // imported about 'importFanIn' times
+  const size_t fanIn = std::max<size_t>(shape.importFanIn, 1);
+  const size_t poolSize = std::clamp<size_t>(
+      (shape.fileCount * shape.importsPerFile + fanIn - 1) / fanIn, 1, shape.fileCount);
+
+  const size_t candidateCount = (fileIndex < poolSize) ? poolSize - 1 : poolSize;
+  const size_t importCount = std::min(shape.importsPerFile, candidateCount);
+
+  Random random = fileRandom(shape.seed, fileIndex, Stream::IMPORTS);
+  std::vector<size_t> ret;
+  ret.reserve(importCount);
+
+  // when most candidates are picked shuffling is faster than guessing
+  if (importCount * 2 >= candidateCount) {
+    std::vector<size_t> candidates;
+    candidates.reserve(poolSize);
+    for (size_t i = 0; i < poolSize; i++) {
+      if (i != fileIndex)
+        candidates.push_back(i);
+    }
+    for (size_t i = 0; i < importCount; i++) {
+      std::swap(candidates[i], candidates[random.between(i, candidates.size() - 1)]);
+      ret.push_back(candidates[i]);
+    }
+    return ret;
+  }
+
+  while (ret.size() < importCount) {
+    const size_t candidate = random.between(0, poolSize - 1);
+    if (candidate != fileIndex && std::find(ret.begin(), ret.end(), candidate) == ret.end())
+      ret.push_back(candidate);
+  }
+  return ret;
+}
+
+static void helper::appendRandomText(std::string& str, Random& random, size_t length) {
+  uint64_t bits = 0;
+  for (size_t i = 0; i < length; i++) {
+    // 1 random number is enough for 8 letters
+    if (i % 8 == 0)
+      bits = random.next();
+    str += static_cast<char>('a' + (bits & 0xff) % 26);
+    bits >>= 8;
+  }
+}
+
+static void helper::appendCommand(std::string& str, Random& random, size_t fileIndex,
+                                  size_t commandIndex, size_t length) {
+  const size_t startSize = str.size();
+  str += "data modify storage bench:data file_" + std::to_string(fileIndex) + ".value_" +
+         std::to_string(commandIndex) + " set value \"";
+
+  const size_t lengthSoFar = str.size() - startSize + 1;
+  appendRandomText(str, random, (length > lengthSoFar) ? length - lengthSoFar : 0);
+  str += '"';
+}
+
+static std::string helper::fileWriteContents(Random& random, size_t size) {
+  std::string ret = "{\"value\": \"";
+  const size_t lengthSoFar = ret.size() + 3;
+  appendRandomText(ret, random, (size > lengthSoFar) ? size - lengthSoFar : 0);
+  ret += "\"}\n";
+  return ret;
+}
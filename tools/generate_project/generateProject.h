@@ -0,0 +1,63 @@
+#pragma once
+/// \file Generates MCFunc projects of a controlled size and shape (for
+/// benchmarks and scaling tests). The same shape (including the seed) always
+/// generates the same project on every platform.
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/// The shape of a generated project.
+struct ProjectShape {
+  uint64_t seed = 0;
+
+  size_t fileCount = 16;
+  /// Files are spread over directories with at most this many files each.
+  size_t filesPerDirectory = 32;
+  size_t functionsPerFile = 16;
+
+  /// How many other files each file imports (fan-out).
+  size_t importsPerFile = 2;
+  /// How many files import each imported file on average (fan-in). Imports all
+  /// point into the first `fileCount * importsPerFile / importFanIn` files.
+  size_t importFanIn = 2;
+  /// How many functions each function calls. A call is either to a function
+  /// earlier in the same file or to a public function from an imported file.
+  size_t callsPerFunction = 2;
+
+  /// Each function nests its commands in 0 to this many 'run: { }' scopes.
+  size_t maxScopeDepth = 2;
+  /// The chance (0 to 1) that a function is public.
+  double publicRatio = 0.25;
+
+  size_t commandsPerFunction = 8;
+  /// Command lengths (in bytes, without the '/' or ';') are picked uniformly
+  /// from this range (commands can't be shorter than ~60 bytes).
+  size_t minCommandLength = 64;
+  size_t maxCommandLength = 160;
+
+  /// File writes with snippet contents per file.
+  size_t snippetWritesPerFile = 1;
+  size_t snippetWriteSize = 256;
+  /// File writes that copy a (generated) input file per file.
+  size_t copyWritesPerFile = 0;
+  size_t copyWriteSize = 1024;
+};
+
+/// A file in a generated project.
+struct GeneratedFile {
+  /// Relative to the project's root directory (the input directory).
+  std::filesystem::path path;
+  std::string contents;
+};
+
+/// Generates a project shaped like \param shape . File 0 exposes the namespace
+/// "bench" and exposes its first function as "main".
+std::vector<GeneratedFile> generateProject(const ProjectShape& shape);
+
+/// Writes every file in \param project into \param directory .
+/// \throws std::runtime_error if a file can't be written.
+void writeProject(const std::vector<GeneratedFile>& project,
+                  const std::filesystem::path& directory);
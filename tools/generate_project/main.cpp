@@ -0,0 +1,182 @@
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <cli/style_text.h>
+#include <generateProject.h>
+
+namespace {
+namespace helper {
+
+/// Prints the help page.
+static void printHelp(const char* arg0);
+
+/// Prints "CLI Error: " and \param message then exits.
+[[noreturn]] static void exitWithError(const char* arg0, const std::string& message);
+
+/// Parses \param str as a whole number (or exits with an error for
+/// \param flag ).
+static uint64_t parseNumber(const char* arg0, std::string_view flag, const std::string& str);
+
+} // namespace helper
+} // namespace
+
+int main(int argc, const char** argv) {
+  ProjectShape shape;
+  std::filesystem::path outputDirectory;
+
+  const std::pair<std::string_view, size_t*> sizeFlags[] = {
+      {"--files", &shape.fileCount},
+      {"--files-per-dir", &shape.filesPerDirectory},
+      {"--functions", &shape.functionsPerFile},
+      {"--imports", &shape.importsPerFile},
+      {"--fan-in", &shape.importFanIn},
+      {"--calls", &shape.callsPerFunction},
+      {"--depth", &shape.maxScopeDepth},
+      {"--commands", &shape.commandsPerFunction},
+      {"--min-command-length", &shape.minCommandLength},
+      {"--max-command-length", &shape.maxCommandLength},
+      {"--snippet-writes", &shape.snippetWritesPerFile},
+      {"--snippet-size", &shape.snippetWriteSize},
+      {"--copy-writes", &shape.copyWritesPerFile},
+      {"--copy-size", &shape.copyWriteSize},
+  };
+
+  for (int i = 1; i < argc; i++) {
+    const std::string_view arg = argv[i];
+
+    if (arg == "-h" || arg == "--help") {
+      helper::printHelp(argv[0]);
+      return EXIT_SUCCESS;
+    }
+
+    if (arg.empty() || arg[0] != '-') {
+      if (!outputDirectory.empty())
+        helper::exitWithError(argv[0], "Only 1 output directory can be given.");
+      outputDirectory = arg;
+      continue;
+    }
+
+    if (i + 1 >= argc) {
+      helper::exitWithError(argv[0], "Expected a value after " +
+                                         style_text::styleAsCode(std::string(arg)) + '.');
+    }
+    const std::string value = argv[++i];
+
+    if (arg == "--seed") {
+      shape.seed = helper::parseNumber(argv[0], arg, value);
+      continue;
+    }
+    if (arg == "--public-ratio") {
+      size_t charsRead = 0;
+      try {
+        shape.publicRatio = std::stod(value, &charsRead);
+      } catch (const std::exception&) {
+      }
+      if (charsRead != value.size() || !(shape.publicRatio >= 0 && shape.publicRatio <= 1)) {
+        helper::exitWithError(argv[0], style_text::styleAsCode("--public-ratio") +
+                                           " expects a number from 0 to 1.");
+      }
+      continue;
+    }
+
+    bool found = false;
+    for (const auto& [flag, member] : sizeFlags) {
+      if (arg == flag) {
+        *member = static_cast<size_t>(helper::parseNumber(argv[0], arg, value));
+        found = true;
+        break;
+      }
+    }
+    if (!found) {
+      helper::exitWithError(argv[0], "Unknown flag " + style_text::styleAsCode(std::string(arg)) +
+                                         '.');
+    }
+  }
+
+  if (outputDirectory.empty())
+    helper::exitWithError(argv[0], "No output directory was given.");
+  if (shape.minCommandLength > shape.maxCommandLength) {
+    helper::exitWithError(argv[0], style_text::styleAsCode("--min-command-length") +
+                                       " can't be more than " +
+                                       style_text::styleAsCode("--max-command-length") + '.');
+  }
+
+  // never mix a generated project with other files
+  std::error_code ec;
+  if (std::filesystem::exists(outputDirectory, ec) &&
+      !std::filesystem::is_empty(outputDirectory, ec)) {
+    helper::exitWithError(argv[0], "The output directory " +
+                                       style_text::styleAsCode(outputDirectory.string()) +
+                                       " isn't empty.");
+  }
+
+  try {
+    writeProject(generateProject(shape), outputDirectory);
+  } catch (const std::runtime_error& e) {
+    std::cerr << style_text::styleAsError("Error: ") << e.what() << '\n';
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------//
+// Helper function definitions beyond this point.
+// ---------------------------------------------------------------------------//
+
+static void helper::printHelp(const char* arg0) {
+  const ProjectShape defaults;
+  const auto line = [](std::string_view flag, std::string_view description, size_t defaultValue) {
+    std::cout << "  " << flag << std::string(30 - 2 - flag.size(), ' ') << description
+              << " (default " << defaultValue << ").\n";
+  };
+
+  std::cout << "Usage: " << arg0 << " <OUTPUT_DIRECTORY> [options]\n"
+            << "Generates an MCFunc project (the same options always generate the same\n"
+            << "project). Build it with 'mcfunc -i <OUTPUT_DIRECTORY>'.\n"
+            << "Options:\n";
+  line("--seed <N>", "Random seed", defaults.seed);
+  line("--files <N>", "Source files", defaults.fileCount);
+  line("--files-per-dir <N>", "Source files per directory", defaults.filesPerDirectory);
+  line("--functions <N>", "Functions per file", defaults.functionsPerFile);
+  line("--imports <N>", "Imports per file (fan-out)", defaults.importsPerFile);
+  line("--fan-in <N>", "Importers per imported file", defaults.importFanIn);
+  line("--calls <N>", "Function calls per function", defaults.callsPerFunction);
+  line("--depth <N>", "Max 'run: { }' nesting depth", defaults.maxScopeDepth);
+  std::cout << "  --public-ratio <R>          Chance a function is public (default "
+            << defaults.publicRatio << ").\n";
+  line("--commands <N>", "Commands per function", defaults.commandsPerFunction);
+  line("--min-command-length <N>", "Shortest command", defaults.minCommandLength);
+  line("--max-command-length <N>", "Longest command", defaults.maxCommandLength);
+  line("--snippet-writes <N>", "Snippet file writes per file", defaults.snippetWritesPerFile);
+  line("--snippet-size <N>", "Bytes per snippet", defaults.snippetWriteSize);
+  line("--copy-writes <N>", "Copying file writes per file", defaults.copyWritesPerFile);
+  line("--copy-size <N>", "Bytes per copied file", defaults.copyWriteSize);
+}
+
+[[noreturn]] static void helper::exitWithError(const char* arg0, const std::string& message) {
+  std::cerr << style_text::styleAsError("CLI Error: ") << message << "\nTry running "
+            << style_text::styleAsCode(std::string(arg0) + " -h") << " for help info.\n";
+  std::exit(EXIT_FAILURE);
+}
+
+static uint64_t helper::parseNumber(const char* arg0, std::string_view flag,
+                                    const std::string& str) {
+  size_t charsRead = 0;
+  uint64_t ret = 0;
+  try {
+    if (!str.empty() && str[0] != '-')
+      ret = std::stoull(str, &charsRead);
+  } catch (const std::exception&) {
+  }
+  if (str.empty() || charsRead != str.size()) {
+    exitWithError(arg0, style_text::styleAsCode(std::string(flag)) +
+                            " expects a whole number (got " + style_text::styleAsCode(str) + ").");
+  }
+  return ret;
+}